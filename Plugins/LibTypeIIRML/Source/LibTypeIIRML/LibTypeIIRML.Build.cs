@@ -16,6 +16,11 @@ public class LibTypeIIRML : ModuleRules
 	{
 		get { return Path.Combine(ModulePath, "../ThirdParty"); }
 	}
+
+	private string TypeIIRMLSourcePath
+	{
+		get { return Path.Combine(ModulePath, "Private", "TypeIIRML"); }
+	}
 	
 	public LibTypeIIRML(ReadOnlyTargetRules Target) : base(Target)
 	{
@@ -66,13 +71,40 @@ public class LibTypeIIRML : ModuleRules
 		}
 		);
 
-        // load the .lib file of the library.
-        if (Target.Platform == UnrealTargetPlatform.Win64)
+		// The headers are needed on every platform, also when the library is built from source.
+		PublicIncludePaths.Add(Path.Combine(LibTypeIIRMLPath, "include"));
+
+		// Build from source if the sources of the library are placed in Private/TypeIIRML.
+		// UBT compiles them as part of this module, so the library gets the same optimization (and LTO/PGO) as the game.
+		// ReflexxesAPI is then exported by this module, so the sources also link in modular targets (editor).
+		// Only one of sources and prebuilt library is used, both together would define every symbol twice.
+		bool bHasSources = Directory.Exists(TypeIIRMLSourcePath) && Directory.GetFiles(TypeIIRMLSourcePath, "*.cpp").Length > 0;
+		string LinuxLibraryPath = Path.Combine(LibTypeIIRMLPath, "lib", "Linux", "libTypeIIRML.a");
+		PrivateDefinitions.Add("WITH_TYPEIIRML_SOURCES=" + (bHasSources ? "1" : "0"));
+		if (bHasSources)
 		{
-			PublicAdditionalLibraries.Add(Path.Combine(LibTypeIIRMLPath, "lib", "TypeIIRML.lib"));
-			PublicIncludePaths.Add(Path.Combine(LibTypeIIRMLPath, "include"));
+			// The library is written in plain C++ and does not know the engine headers.
+			bUseUnity = false;
+			bEnableShadowVariableWarnings = false;
+			OptimizeCode = CodeOptimization.Always;
 
-			PublicDefinitions.Add("WITH_TypeIIRML=1");
+			PublicDefinitions.Add("TYPEIIRML_API=LIBTYPEIIRML_API");
+		}
+		// load the .lib file of the library.
+		else if (Target.Platform == UnrealTargetPlatform.Win64)
+		{
+			PublicAdditionalLibraries.Add(Path.Combine(LibTypeIIRMLPath, "lib", "TypeIIRML.lib"));
+		}
+		// load the static library built for Linux (see ThirdParty/TypeIIRML/README.md).
+		else if (Target.Platform == UnrealTargetPlatform.Linux && File.Exists(LinuxLibraryPath))
+		{
+			PublicAdditionalLibraries.Add(LinuxLibraryPath);
+		}
+		else
+		{
+			// Modules that do not use the library still build, the others fail at link time.
+			Console.WriteLine("Warning: LibTypeIIRML: No TypeIIRML library for " + Target.Platform.ToString()
+				+ ". Place the sources in Private/TypeIIRML or build lib/Linux/libTypeIIRML.a, see ThirdParty/TypeIIRML/README.md.");
 		}
 	}
 }
@@ -0,0 +1,111 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "RMLClosedFormVelocity.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define CLOSED_FORM_TEST_DOFS (3)
+#define CLOSED_FORM_TEST_CYCLE_TIME (0.001)
+#define CLOSED_FORM_TEST_TOLERANCE (1e-9)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRMLClosedFormVelocityTest, "LibTypeIIRML.ClosedFormVelocity", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Compares RMLClosedFormVelocity with RMLVelocityAtAGivenSampleTime of the library for a sweep of states, targets and limits
+bool FRMLClosedFormVelocityTest::RunTest(const FString& Parameters)
+{
+	const double Velocities[] = { -1.5, -0.3, 0.0, 0.4, 2.0 };
+	const double Accelerations[] = { 0.5, 2.0, 10.0 };
+	const double SampleTimes[] = { CLOSED_FORM_TEST_CYCLE_TIME, 0.01666, 0.1, 0.5, 1.0, 5.0 };
+
+	// Every combination of current velocity, target velocity and limit, the other degrees of freedom get other combinations.
+	const int32 NumVelocities = ARRAY_COUNT(Velocities);
+	const int32 NumCombinations = NumVelocities * NumVelocities * ARRAY_COUNT(Accelerations);
+	const int32 DofStrides[CLOSED_FORM_TEST_DOFS] = { 1, 7, 31 };
+
+	ReflexxesAPI RML(CLOSED_FORM_TEST_DOFS, CLOSED_FORM_TEST_CYCLE_TIME);
+	RMLVelocityInputParameters IP(CLOSED_FORM_TEST_DOFS);
+	RMLVelocityOutputParameters OP(CLOSED_FORM_TEST_DOFS);
+	RMLVelocityFlags Flags;
+
+	RMLFixedVelocityInputParameters<CLOSED_FORM_TEST_DOFS> Input;
+	RMLFixedVelocityOutputParameters<CLOSED_FORM_TEST_DOFS> Output;
+	Input.MaxJerkVector.Set(10.0);
+	Input.SelectionVector.Set(true);
+
+	int32 NumCompared = 0;
+	for (int32 Combination = 0; Combination < NumCombinations; ++Combination)
+	{
+		for (int32 i = 0; i < CLOSED_FORM_TEST_DOFS; ++i)
+		{
+			const int32 DofCombination = (Combination * DofStrides[i]) % NumCombinations;
+			Input.CurrentPositionVector[i] = 0.5 * i - 1.0;
+			Input.CurrentVelocityVector[i] = Velocities[DofCombination % NumVelocities];
+			Input.TargetVelocityVector[i] = Velocities[(DofCombination / NumVelocities) % NumVelocities];
+			Input.MaxAccelerationVector[i] = Accelerations[DofCombination / (NumVelocities * NumVelocities)];
+
+			// Type II trajectories do not limit the jerk, the current acceleration must not change the result.
+			Input.CurrentAccelerationVector[i] = Combination % 2 == 0 ? 0.0 : 0.7;
+		}
+
+		if (!TestTrue(FString::Printf(TEXT("Combination %d can be evaluated in closed form"), Combination), RMLClosedFormVelocity<CLOSED_FORM_TEST_DOFS>::CanEvaluate(Input, Flags)))
+		{
+			continue;
+		}
+
+		Input.CopyTo(IP);
+		if (RML.RMLVelocity(IP, &OP, Flags) < 0)
+		{
+			AddError(FString::Printf(TEXT("Combination %d: the library failed."), Combination));
+			continue;
+		}
+
+		for (const double SampleTime : SampleTimes)
+		{
+			const int32 ClosedFormResult = RMLClosedFormVelocity<CLOSED_FORM_TEST_DOFS>::Evaluate(Input, Output, SampleTime);
+			const int32 LibraryResult = RML.RMLVelocityAtAGivenSampleTime(SampleTime, &OP);
+
+			const FString What = FString::Printf(TEXT("Combination %d at %f s"), Combination, SampleTime);
+			TestEqual(What + TEXT(": result"), ClosedFormResult, LibraryResult);
+			if (FMath::Abs(Output.SynchronizationTime - OP.SynchronizationTime) > CLOSED_FORM_TEST_TOLERANCE)
+			{
+				AddError(FString::Printf(TEXT("%s: synchronization time %.12f, library %.12f."), *What, Output.SynchronizationTime, OP.SynchronizationTime));
+			}
+
+			for (int32 i = 0; i < CLOSED_FORM_TEST_DOFS; ++i)
+			{
+				const double PositionDeviation = FMath::Abs(Output.NewPositionVector[i] - OP.NewPositionVector->VecData[i]);
+				const double VelocityDeviation = FMath::Abs(Output.NewVelocityVector[i] - OP.NewVelocityVector->VecData[i]);
+				if (PositionDeviation > CLOSED_FORM_TEST_TOLERANCE || VelocityDeviation > CLOSED_FORM_TEST_TOLERANCE)
+				{
+					AddError(FString::Printf(TEXT("%s, DOF %d: position deviates by %e, velocity by %e."), *What, i, PositionDeviation, VelocityDeviation));
+				}
+			}
+			++NumCompared;
+		}
+	}
+	AddInfo(FString::Printf(TEXT("Compared %d samples."), NumCompared));
+
+	// The library is still needed for synchronization and for invalid input values.
+	RMLVelocityFlags SynchronizedFlags;
+	SynchronizedFlags.SynchronizationBehavior = RMLFlags::PHASE_SYNCHRONIZATION_IF_POSSIBLE;
+	TestFalse(TEXT("Synchronized trajectories use the library"), RMLClosedFormVelocity<CLOSED_FORM_TEST_DOFS>::CanEvaluate(Input, SynchronizedFlags));
+
+	RMLFixedVelocityInputParameters<CLOSED_FORM_TEST_DOFS> InvalidInput = Input;
+	InvalidInput.MaxAccelerationVector[1] = 0.0;
+	TestFalse(TEXT("A zero acceleration limit uses the library"), RMLClosedFormVelocity<CLOSED_FORM_TEST_DOFS>::CanEvaluate(InvalidInput, Flags));
+
+	InvalidInput = Input;
+	InvalidInput.TargetVelocityVector[2] = NAN;
+	TestFalse(TEXT("A target that is not finite uses the library"), RMLClosedFormVelocity<CLOSED_FORM_TEST_DOFS>::CanEvaluate(InvalidInput, Flags));
+
+	InvalidInput = Input;
+	InvalidInput.SelectionVector[0] = false;
+	TestFalse(TEXT("Unselected degrees of freedom use the library"), RMLClosedFormVelocity<CLOSED_FORM_TEST_DOFS>::CanEvaluate(InvalidInput, Flags));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,200 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "ReflexxesAPI.h"
+#include "RMLVelocityFlags.h"
+#include "RMLFixedVelocityParameters.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Degrees of freedom of the interpolator: x, y and the yaw
+#define FIXED_VECTOR_BENCHMARK_DOFS (3)
+#define FIXED_VECTOR_BENCHMARK_CYCLE_TIME (0.001)
+// Calls per measurement, so each one takes a few milliseconds at least.
+#define FIXED_VECTOR_BENCHMARK_CALLS (1000 * 1000)
+#define FIXED_VECTOR_BENCHMARK_SETUP_CALLS (100 * 1000)
+
+typedef RMLFixedVelocityInputParameters<FIXED_VECTOR_BENCHMARK_DOFS> FFixedVectorBenchmarkInput;
+typedef RMLFixedVelocityOutputParameters<FIXED_VECTOR_BENCHMARK_DOFS> FFixedVectorBenchmarkOutput;
+
+// Target velocity of a call, changes now and then like ROS commands
+static FORCEINLINE double GetFixedVectorBenchmarkTarget(const int32 Call, const int32 Dof)
+{
+	return ((Call >> 10) % 2 == 0 ? 0.5 : -0.5) * (Dof + 1);
+}
+
+// Parameters of one interpolator as the library objects, each vector is an allocation of its own
+static FORCENOINLINE double SetUpDynamicParameters()
+{
+	RMLVelocityInputParameters IP(FIXED_VECTOR_BENCHMARK_DOFS);
+	RMLVelocityOutputParameters OP(FIXED_VECTOR_BENCHMARK_DOFS);
+	IP.TargetVelocityVector->VecData[0] = 1.0;
+	return IP.TargetVelocityVector->VecData[0] + OP.NewPositionVector->GetVecDim();
+}
+
+// Parameters of one interpolator as the fixed-size vectors, one block on the stack
+static FORCENOINLINE double SetUpFixedParameters()
+{
+	FFixedVectorBenchmarkInput Input;
+	FFixedVectorBenchmarkOutput Output;
+	Input.TargetVelocityVector[0] = 1.0;
+	return Input.TargetVelocityVector[0] + Output.NewPositionVector.GetVecDim();
+}
+
+// State of one cycle as the interpolator handled it before: the target into the library input and the output fed back into it
+static FORCENOINLINE void HandleDynamicState(RMLVelocityInputParameters& IP, const RMLVelocityOutputParameters& OP, const int32 Call)
+{
+	for (int32 i = 0; i < FIXED_VECTOR_BENCHMARK_DOFS; ++i)
+	{
+		IP.TargetVelocityVector->VecData[i] = GetFixedVectorBenchmarkTarget(Call, i);
+	}
+	*IP.CurrentPositionVector = *OP.NewPositionVector;
+	*IP.CurrentVelocityVector = *OP.NewVelocityVector;
+	*IP.CurrentAccelerationVector = *OP.NewAccelerationVector;
+}
+
+// State of one cycle as MWControllerInterpolator handles it now: the fixed input to the library and its output back into the fixed input
+static FORCENOINLINE void HandleFixedState(FFixedVectorBenchmarkInput& Input, FFixedVectorBenchmarkOutput& Output,
+	RMLVelocityInputParameters& IP, const RMLVelocityOutputParameters& OP, const int32 Call)
+{
+	for (int32 i = 0; i < FIXED_VECTOR_BENCHMARK_DOFS; ++i)
+	{
+		Input.TargetVelocityVector[i] = GetFixedVectorBenchmarkTarget(Call, i);
+	}
+	Input.CopyStateTo(IP);
+	Output.CopyFrom(OP);
+	Output.FeedBack(Input);
+}
+
+// Whole cycle before: the library objects are fed back into themselves
+static FORCENOINLINE int32 RunDynamicCycle(ReflexxesAPI& RML, RMLVelocityInputParameters& IP, RMLVelocityOutputParameters& OP,
+	const RMLVelocityFlags& Flags, const int32 Call)
+{
+	for (int32 i = 0; i < FIXED_VECTOR_BENCHMARK_DOFS; ++i)
+	{
+		IP.TargetVelocityVector->VecData[i] = GetFixedVectorBenchmarkTarget(Call, i);
+	}
+	const int32 Result = RML.RMLVelocity(IP, &OP, Flags);
+	*IP.CurrentPositionVector = *OP.NewPositionVector;
+	*IP.CurrentVelocityVector = *OP.NewVelocityVector;
+	*IP.CurrentAccelerationVector = *OP.NewAccelerationVector;
+	return Result;
+}
+
+// Whole cycle of MWControllerInterpolator::get_next_twist
+static FORCENOINLINE int32 RunFixedCycle(ReflexxesAPI& RML, FFixedVectorBenchmarkInput& Input, FFixedVectorBenchmarkOutput& Output,
+	RMLVelocityInputParameters& IP, RMLVelocityOutputParameters& OP, const RMLVelocityFlags& Flags, const int32 Call)
+{
+	for (int32 i = 0; i < FIXED_VECTOR_BENCHMARK_DOFS; ++i)
+	{
+		Input.TargetVelocityVector[i] = GetFixedVectorBenchmarkTarget(Call, i);
+	}
+	Input.CopyStateTo(IP);
+	const int32 Result = RML.RMLVelocity(IP, &OP, Flags);
+	Output.CopyFrom(OP);
+	Output.FeedBack(Input);
+	return Result;
+}
+
+// Limits of the benchmark, to both the fixed input and the library input
+static void InitFixedVectorBenchmark(FFixedVectorBenchmarkInput& Input, RMLVelocityInputParameters& IP)
+{
+	Input = FFixedVectorBenchmarkInput();
+	Input.MaxAccelerationVector.Set(2.0);
+	Input.MaxJerkVector.Set(10.0);
+	Input.SelectionVector.Set(true);
+	Input.CopyTo(IP);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRMLFixedVectorBenchmark, "LibTypeIIRML.Benchmark.FixedVector", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Time per call of the library objects against the fixed-size vectors of the interpolator: the set up of the parameters,
+// the state handling of a cycle alone and a whole cycle with RMLVelocity. Both ways give the same trajectory bit by bit.
+// FPlatformTime counts timer ticks, not CPU cycles, so the calls are reported in ns.
+bool FRMLFixedVectorBenchmark::RunTest(const FString& Parameters)
+{
+	double Sink = 0.0;
+	double Start = FPlatformTime::Seconds();
+	for (int32 Call = 0; Call < FIXED_VECTOR_BENCHMARK_SETUP_CALLS; ++Call)
+	{
+		Sink += SetUpDynamicParameters();
+	}
+	const double DynamicSetUpSeconds = FPlatformTime::Seconds() - Start;
+
+	Start = FPlatformTime::Seconds();
+	for (int32 Call = 0; Call < FIXED_VECTOR_BENCHMARK_SETUP_CALLS; ++Call)
+	{
+		Sink += SetUpFixedParameters();
+	}
+	const double FixedSetUpSeconds = FPlatformTime::Seconds() - Start;
+	TestTrue(TEXT("Both set ups give the same values"), Sink == 2.0 * FIXED_VECTOR_BENCHMARK_SETUP_CALLS * (1.0 + FIXED_VECTOR_BENCHMARK_DOFS));
+
+	ReflexxesAPI DynamicRML(FIXED_VECTOR_BENCHMARK_DOFS, FIXED_VECTOR_BENCHMARK_CYCLE_TIME);
+	RMLVelocityInputParameters DynamicIP(FIXED_VECTOR_BENCHMARK_DOFS);
+	RMLVelocityOutputParameters DynamicOP(FIXED_VECTOR_BENCHMARK_DOFS);
+
+	ReflexxesAPI FixedRML(FIXED_VECTOR_BENCHMARK_DOFS, FIXED_VECTOR_BENCHMARK_CYCLE_TIME);
+	RMLVelocityInputParameters FixedIP(FIXED_VECTOR_BENCHMARK_DOFS);
+	RMLVelocityOutputParameters FixedOP(FIXED_VECTOR_BENCHMARK_DOFS);
+	FFixedVectorBenchmarkInput Input;
+	FFixedVectorBenchmarkOutput Output;
+	RMLVelocityFlags Flags;
+
+	// The state handling alone, the output of the library stays as it is.
+	InitFixedVectorBenchmark(Input, DynamicIP);
+	InitFixedVectorBenchmark(Input, FixedIP);
+	Start = FPlatformTime::Seconds();
+	for (int32 Call = 0; Call < FIXED_VECTOR_BENCHMARK_CALLS; ++Call)
+	{
+		HandleDynamicState(DynamicIP, DynamicOP, Call);
+	}
+	const double DynamicStateSeconds = FPlatformTime::Seconds() - Start;
+
+	Start = FPlatformTime::Seconds();
+	for (int32 Call = 0; Call < FIXED_VECTOR_BENCHMARK_CALLS; ++Call)
+	{
+		HandleFixedState(Input, Output, FixedIP, FixedOP, Call);
+	}
+	const double FixedStateSeconds = FPlatformTime::Seconds() - Start;
+
+	// Whole cycles, each way runs its own trajectory from the same start.
+	InitFixedVectorBenchmark(Input, DynamicIP);
+	InitFixedVectorBenchmark(Input, FixedIP);
+	int32 DynamicResults = 0;
+	Start = FPlatformTime::Seconds();
+	for (int32 Call = 0; Call < FIXED_VECTOR_BENCHMARK_CALLS; ++Call)
+	{
+		DynamicResults += RunDynamicCycle(DynamicRML, DynamicIP, DynamicOP, Flags, Call);
+	}
+	const double DynamicCycleSeconds = FPlatformTime::Seconds() - Start;
+
+	int32 FixedResults = 0;
+	Start = FPlatformTime::Seconds();
+	for (int32 Call = 0; Call < FIXED_VECTOR_BENCHMARK_CALLS; ++Call)
+	{
+		FixedResults += RunFixedCycle(FixedRML, Input, Output, FixedIP, FixedOP, Flags, Call);
+	}
+	const double FixedCycleSeconds = FPlatformTime::Seconds() - Start;
+
+	TestEqual(TEXT("Results of the library"), FixedResults, DynamicResults);
+	const SIZE_T Size = sizeof(Input.CurrentPositionVector.VecData);
+	TestTrue(TEXT("Both ways end at the same state"),
+		FMemory::Memcmp(Input.CurrentPositionVector.VecData, DynamicIP.CurrentPositionVector->VecData, Size) == 0
+		&& FMemory::Memcmp(Input.CurrentVelocityVector.VecData, DynamicIP.CurrentVelocityVector->VecData, Size) == 0
+		&& FMemory::Memcmp(Input.CurrentAccelerationVector.VecData, DynamicIP.CurrentAccelerationVector->VecData, Size) == 0);
+
+	const auto Report = [this](const TCHAR* Name, const double DynamicSeconds, const double FixedSeconds, const int32 NumCalls)
+	{
+		AddInfo(FString::Printf(TEXT("%s: library objects %.2f ns, fixed-size vectors %.2f ns per call (%.2fx)."), Name,
+			DynamicSeconds / NumCalls * 1e9, FixedSeconds / NumCalls * 1e9, DynamicSeconds / FMath::Max(FixedSeconds, 1e-12)));
+	};
+	Report(TEXT("Set up of the parameters"), DynamicSetUpSeconds, FixedSetUpSeconds, FIXED_VECTOR_BENCHMARK_SETUP_CALLS);
+	Report(TEXT("State of a cycle"), DynamicStateSeconds, FixedStateSeconds, FIXED_VECTOR_BENCHMARK_CALLS);
+	Report(TEXT("Whole cycle"), DynamicCycleSeconds, FixedCycleSeconds, FIXED_VECTOR_BENCHMARK_CALLS);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,169 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "ReflexxesAPI.h"
+#include "RMLVelocityFlags.h"
+#include "RMLFixedVelocityParameters.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define FIXED_PARAMETERS_TEST_DOFS (3)
+#define FIXED_PARAMETERS_TEST_CYCLE_TIME (0.001)
+#define FIXED_PARAMETERS_TEST_CYCLES (2000)
+#define FIXED_PARAMETERS_TEST_TARGET_PERIOD (400)
+
+// Compares a vector of the fixed parameters with one of the library, bit by bit
+template <class T>
+static bool IsSameVector(const RMLFixedVector<T, FIXED_PARAMETERS_TEST_DOFS>& Fixed, const RMLVector<T>& Vector)
+{
+	return Vector.GetVecDim() == FIXED_PARAMETERS_TEST_DOFS && FMemory::Memcmp(Fixed.VecData, Vector.VecData, sizeof(Fixed.VecData)) == 0;
+}
+
+// Target velocity of a cycle of the trajectory test, changes now and then like ROS commands
+static void GetFixedParametersTestTarget(const int32 Cycle, double* Target)
+{
+	const int32 Period = Cycle / FIXED_PARAMETERS_TEST_TARGET_PERIOD;
+	const double Direction = Period % 2 == 0 ? 1.0 : -1.0;
+	Target[0] = Direction * 0.5;
+	Target[1] = Period % 3 == 0 ? 0.0 : -0.25;
+	Target[2] = Direction * 0.1 * Period;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRMLFixedVelocityParametersTest, "LibTypeIIRML.FixedParameters", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Checks that the fixed-size parameters hold the same state as the input and output objects of the library,
+// for the single copies and for a whole trajectory driven the old way (library objects only) and the new way.
+bool FRMLFixedVelocityParametersTest::RunTest(const FString& Parameters)
+{
+	RMLFixedVelocityInputParameters<FIXED_PARAMETERS_TEST_DOFS> Input;
+	for (int32 i = 0; i < FIXED_PARAMETERS_TEST_DOFS; ++i)
+	{
+		Input.CurrentPositionVector[i] = 1.0 + i;
+		Input.CurrentVelocityVector[i] = -0.1 * i;
+		Input.CurrentAccelerationVector[i] = 0.01 * i;
+		Input.TargetVelocityVector[i] = 0.3 - i;
+		Input.MaxAccelerationVector[i] = 2.0 + i;
+		Input.MaxJerkVector[i] = 10.0 + i;
+		Input.SelectionVector[i] = i != 1;
+	}
+	Input.MinimumSynchronizationTime = 0.25;
+
+	// All values to the library.
+	RMLVelocityInputParameters IP(FIXED_PARAMETERS_TEST_DOFS);
+	Input.CopyTo(IP);
+	TestTrue(TEXT("CopyTo: current position"), IsSameVector(Input.CurrentPositionVector, *IP.CurrentPositionVector));
+	TestTrue(TEXT("CopyTo: current velocity"), IsSameVector(Input.CurrentVelocityVector, *IP.CurrentVelocityVector));
+	TestTrue(TEXT("CopyTo: current acceleration"), IsSameVector(Input.CurrentAccelerationVector, *IP.CurrentAccelerationVector));
+	TestTrue(TEXT("CopyTo: target velocity"), IsSameVector(Input.TargetVelocityVector, *IP.TargetVelocityVector));
+	TestTrue(TEXT("CopyTo: maximum acceleration"), IsSameVector(Input.MaxAccelerationVector, *IP.MaxAccelerationVector));
+	TestTrue(TEXT("CopyTo: maximum jerk"), IsSameVector(Input.MaxJerkVector, *IP.MaxJerkVector));
+	TestTrue(TEXT("CopyTo: selection"), IsSameVector(Input.SelectionVector, *IP.SelectionVector));
+	TestTrue(TEXT("CopyTo: minimum synchronization time"), IP.MinimumSynchronizationTime == Input.MinimumSynchronizationTime);
+
+	// Only the state of motion and the target, the limits of the library stay.
+	const RMLFixedVelocityInputParameters<FIXED_PARAMETERS_TEST_DOFS> OldInput = Input;
+	Input.CurrentPositionVector.Set(-7.0);
+	Input.CurrentVelocityVector.Set(0.7);
+	Input.CurrentAccelerationVector.Set(-0.07);
+	Input.TargetVelocityVector.Set(1.5);
+	Input.MaxAccelerationVector.Set(99.0);
+	Input.MaxJerkVector.Set(99.0);
+	Input.SelectionVector.Set(true);
+	Input.CopyStateTo(IP);
+	TestTrue(TEXT("CopyStateTo: current position"), IsSameVector(Input.CurrentPositionVector, *IP.CurrentPositionVector));
+	TestTrue(TEXT("CopyStateTo: current velocity"), IsSameVector(Input.CurrentVelocityVector, *IP.CurrentVelocityVector));
+	TestTrue(TEXT("CopyStateTo: current acceleration"), IsSameVector(Input.CurrentAccelerationVector, *IP.CurrentAccelerationVector));
+	TestTrue(TEXT("CopyStateTo: target velocity"), IsSameVector(Input.TargetVelocityVector, *IP.TargetVelocityVector));
+	TestTrue(TEXT("CopyStateTo keeps the maximum acceleration"), IsSameVector(OldInput.MaxAccelerationVector, *IP.MaxAccelerationVector));
+	TestTrue(TEXT("CopyStateTo keeps the maximum jerk"), IsSameVector(OldInput.MaxJerkVector, *IP.MaxJerkVector));
+	TestTrue(TEXT("CopyStateTo keeps the selection"), IsSameVector(OldInput.SelectionVector, *IP.SelectionVector));
+
+	// The next state of motion from the library.
+	RMLVelocityOutputParameters OP(FIXED_PARAMETERS_TEST_DOFS);
+	for (int32 i = 0; i < FIXED_PARAMETERS_TEST_DOFS; ++i)
+	{
+		OP.NewPositionVector->VecData[i] = 3.0 * i - 1.0;
+		OP.NewVelocityVector->VecData[i] = 0.5 + i;
+		OP.NewAccelerationVector->VecData[i] = -2.0 * i;
+	}
+	OP.SynchronizationTime = 1.25;
+	OP.ANewCalculationWasPerformed = true;
+
+	RMLFixedVelocityOutputParameters<FIXED_PARAMETERS_TEST_DOFS> Output;
+	Output.CopyFrom(OP);
+	TestTrue(TEXT("CopyFrom: new position"), IsSameVector(Output.NewPositionVector, *OP.NewPositionVector));
+	TestTrue(TEXT("CopyFrom: new velocity"), IsSameVector(Output.NewVelocityVector, *OP.NewVelocityVector));
+	TestTrue(TEXT("CopyFrom: new acceleration"), IsSameVector(Output.NewAccelerationVector, *OP.NewAccelerationVector));
+	TestTrue(TEXT("CopyFrom: synchronization time"), Output.SynchronizationTime == OP.SynchronizationTime);
+	TestTrue(TEXT("CopyFrom: new calculation"), Output.bANewCalculationWasPerformed);
+
+	// The new state becomes the current one, the target and the limits stay.
+	const RMLFixedVelocityInputParameters<FIXED_PARAMETERS_TEST_DOFS> InputBeforeFeedBack = Input;
+	Output.FeedBack(Input);
+	TestTrue(TEXT("FeedBack: position"), Input.CurrentPositionVector == Output.NewPositionVector);
+	TestTrue(TEXT("FeedBack: velocity"), Input.CurrentVelocityVector == Output.NewVelocityVector);
+	TestTrue(TEXT("FeedBack: acceleration"), Input.CurrentAccelerationVector == Output.NewAccelerationVector);
+	TestTrue(TEXT("FeedBack keeps the target velocity"), Input.TargetVelocityVector == InputBeforeFeedBack.TargetVelocityVector);
+	TestTrue(TEXT("FeedBack keeps the limits"), Input.MaxAccelerationVector == InputBeforeFeedBack.MaxAccelerationVector && Input.MaxJerkVector == InputBeforeFeedBack.MaxJerkVector);
+
+	// A whole trajectory: the library objects fed back into themselves (as the interpolator did before)
+	// against the fixed parameters that are copied in and out every cycle (as the interpolator does now).
+	ReflexxesAPI ReferenceRML(FIXED_PARAMETERS_TEST_DOFS, FIXED_PARAMETERS_TEST_CYCLE_TIME);
+	RMLVelocityInputParameters ReferenceIP(FIXED_PARAMETERS_TEST_DOFS);
+	RMLVelocityOutputParameters ReferenceOP(FIXED_PARAMETERS_TEST_DOFS);
+
+	ReflexxesAPI FixedRML(FIXED_PARAMETERS_TEST_DOFS, FIXED_PARAMETERS_TEST_CYCLE_TIME);
+	RMLVelocityInputParameters FixedIP(FIXED_PARAMETERS_TEST_DOFS);
+	RMLVelocityOutputParameters FixedOP(FIXED_PARAMETERS_TEST_DOFS);
+
+	RMLVelocityFlags Flags;
+	Input = RMLFixedVelocityInputParameters<FIXED_PARAMETERS_TEST_DOFS>();
+	Input.MaxAccelerationVector.Set(2.0);
+	Input.MaxJerkVector.Set(10.0);
+	Input.SelectionVector.Set(true);
+	Input.CopyTo(ReferenceIP);
+	Input.CopyTo(FixedIP);
+
+	int32 NumMismatches = 0;
+	for (int32 Cycle = 0; Cycle < FIXED_PARAMETERS_TEST_CYCLES && NumMismatches < 10; ++Cycle)
+	{
+		double Target[FIXED_PARAMETERS_TEST_DOFS];
+		GetFixedParametersTestTarget(Cycle, Target);
+
+		for (int32 i = 0; i < FIXED_PARAMETERS_TEST_DOFS; ++i)
+		{
+			ReferenceIP.TargetVelocityVector->VecData[i] = Target[i];
+		}
+		const int32 ReferenceResult = ReferenceRML.RMLVelocity(ReferenceIP, &ReferenceOP, Flags);
+		*ReferenceIP.CurrentPositionVector = *ReferenceOP.NewPositionVector;
+		*ReferenceIP.CurrentVelocityVector = *ReferenceOP.NewVelocityVector;
+		*ReferenceIP.CurrentAccelerationVector = *ReferenceOP.NewAccelerationVector;
+
+		for (int32 i = 0; i < FIXED_PARAMETERS_TEST_DOFS; ++i)
+		{
+			Input.TargetVelocityVector[i] = Target[i];
+		}
+		Input.CopyStateTo(FixedIP);
+		const int32 FixedResult = FixedRML.RMLVelocity(FixedIP, &FixedOP, Flags);
+		Output.CopyFrom(FixedOP);
+		Output.FeedBack(Input);
+
+		if (ReferenceResult != FixedResult
+			|| !IsSameVector(Input.CurrentPositionVector, *ReferenceIP.CurrentPositionVector)
+			|| !IsSameVector(Input.CurrentVelocityVector, *ReferenceIP.CurrentVelocityVector)
+			|| !IsSameVector(Input.CurrentAccelerationVector, *ReferenceIP.CurrentAccelerationVector)
+			|| Output.SynchronizationTime != ReferenceOP.SynchronizationTime)
+		{
+			++NumMismatches;
+			AddError(FString::Printf(TEXT("Cycle %d: the fixed parameters (result %d, velocity %f %f %f) differ from the library objects (result %d, velocity %f %f %f)."),
+				Cycle, FixedResult, Input.CurrentVelocityVector[0], Input.CurrentVelocityVector[1], Input.CurrentVelocityVector[2],
+				ReferenceResult, ReferenceIP.CurrentVelocityVector->VecData[0], ReferenceIP.CurrentVelocityVector->VecData[1], ReferenceIP.CurrentVelocityVector->VecData[2]));
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,197 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Interfaces/IPluginManager.h"
+#include "ReflexxesAPI.h"
+#include "RMLVelocityFlags.h"
+#include "RMLVelocityInputParameters.h"
+#include "RMLVelocityOutputParameters.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define TYPEIIRML_REGRESSION_DOFS (3)
+#define TYPEIIRML_REGRESSION_CYCLE_TIME (0.001)
+#define TYPEIIRML_REGRESSION_TOLERANCE (1e-9)
+#define TYPEIIRML_REGRESSION_FILE_NAME (TEXT("TypeIIRMLRegression.csv"))
+
+// Case, synchronization, time, result, synchronization time, then position, velocity and acceleration of every degree of freedom
+#define TYPEIIRML_REGRESSION_COLUMNS (5 + 3 * TYPEIIRML_REGRESSION_DOFS)
+
+/**
+ * Input of a reference trajectory of the regression test.
+ * The expected states are recorded from the prebuilt TypeIIRML.lib into Resources/TypeIIRMLRegression.csv of the plugin.
+ */
+struct FTypeIIRMLRegressionCase
+{
+	double Position[TYPEIIRML_REGRESSION_DOFS];
+	double Velocity[TYPEIIRML_REGRESSION_DOFS];
+	double Acceleration[TYPEIIRML_REGRESSION_DOFS];
+	double TargetVelocity[TYPEIIRML_REGRESSION_DOFS];
+	double MaxAcceleration[TYPEIIRML_REGRESSION_DOFS];
+};
+
+static const FTypeIIRMLRegressionCase TypeIIRMLRegressionCases[] =
+{
+	// Start from rest, as the MWController does.
+	{ { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, { 1.0, -0.5, 0.3 }, { 2.0, 2.0, 2.0 } },
+	// Braking to rest.
+	{ { 10.0, -4.0, 3.1 }, { 1.2, 0.4, -0.8 }, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, { 2.0, 2.0, 2.0 } },
+	// Reversing, different limits per degree of freedom.
+	{ { -1.0, 2.0, 0.5 }, { 0.5, -0.5, 1.0 }, { 0.0, 0.0, 0.0 }, { -0.5, 0.5, -1.0 }, { 1.0, 4.0, 0.5 } },
+	// One degree of freedom already at its target.
+	{ { 0.0, 0.0, 0.0 }, { 0.7, 0.0, 0.2 }, { 0.0, 0.0, 0.0 }, { 0.7, 1.5, 0.2 }, { 2.0, 3.0, 2.0 } },
+	// Target reached within the first cycle.
+	{ { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, { 0.0, 0.0, 0.0 }, { 0.0005, 0.0, -0.0005 }, { 2.0, 2.0, 2.0 } },
+	// Interrupted ramp, the current acceleration is not zero.
+	{ { 0.3, -0.2, 1.0 }, { 0.4, -0.1, 0.0 }, { 2.0, -1.0, 0.5 }, { -0.2, 0.6, 0.1 }, { 2.0, 2.0, 2.0 } },
+};
+
+// Times at which every profile is sampled after the first cycle
+static const double TypeIIRMLRegressionSampleTimes[] = { 0.01, 0.1, 0.25, 0.5, 1.0, 2.0 };
+
+// Fill the input of the library from a case
+static void SetRegressionInput(const FTypeIIRMLRegressionCase& Case, RMLVelocityInputParameters& IP)
+{
+	for (int32 i = 0; i < TYPEIIRML_REGRESSION_DOFS; ++i)
+	{
+		IP.CurrentPositionVector->VecData[i] = Case.Position[i];
+		IP.CurrentVelocityVector->VecData[i] = Case.Velocity[i];
+		IP.CurrentAccelerationVector->VecData[i] = Case.Acceleration[i];
+		IP.TargetVelocityVector->VecData[i] = Case.TargetVelocity[i];
+		IP.MaxAccelerationVector->VecData[i] = Case.MaxAcceleration[i];
+		IP.MaxJerkVector->VecData[i] = 10.0;
+		IP.SelectionVector->VecData[i] = true;
+	}
+}
+
+// One row of the reference file, full double precision
+static FString GetRegressionRow(const int32 CaseIndex, const int32 Behavior, const double Time, const int32 Result, const RMLVelocityOutputParameters& OP)
+{
+	FString Row = FString::Printf(TEXT("%d,%d,%.17g,%d,%.17g"), CaseIndex, Behavior, Time, Result, Result < 0 ? 0.0 : OP.SynchronizationTime);
+	for (int32 i = 0; i < TYPEIIRML_REGRESSION_DOFS; ++i)
+	{
+		Row += Result < 0 ? FString(TEXT(",0,0,0")) : FString::Printf(TEXT(",%.17g,%.17g,%.17g"),
+			OP.NewPositionVector->VecData[i], OP.NewVelocityVector->VecData[i], OP.NewAccelerationVector->VecData[i]);
+	}
+	return Row;
+}
+
+// Runs every case with the linked library and returns the rows of the reference file
+static void RecordRegressionRows(TArray<FString>& OutRows)
+{
+	ReflexxesAPI RML(TYPEIIRML_REGRESSION_DOFS, TYPEIIRML_REGRESSION_CYCLE_TIME);
+	RMLVelocityInputParameters IP(TYPEIIRML_REGRESSION_DOFS);
+	RMLVelocityOutputParameters OP(TYPEIIRML_REGRESSION_DOFS);
+
+	for (int32 CaseIndex = 0; CaseIndex < ARRAY_COUNT(TypeIIRMLRegressionCases); ++CaseIndex)
+	{
+		SetRegressionInput(TypeIIRMLRegressionCases[CaseIndex], IP);
+
+		for (const int32 Behavior : { (int32)RMLFlags::NO_SYNCHRONIZATION, (int32)RMLFlags::PHASE_SYNCHRONIZATION_IF_POSSIBLE })
+		{
+			RMLVelocityFlags Flags;
+			Flags.SynchronizationBehavior = Behavior;
+
+			// The first cycle and then samples along the whole profile.
+			const int32 Result = RML.RMLVelocity(IP, &OP, Flags);
+			OutRows.Add(GetRegressionRow(CaseIndex, Behavior, TYPEIIRML_REGRESSION_CYCLE_TIME, Result, OP));
+			if (Result < 0)
+			{
+				continue;
+			}
+			for (const double Time : TypeIIRMLRegressionSampleTimes)
+			{
+				const int32 SampleResult = RML.RMLVelocityAtAGivenSampleTime(Time, &OP);
+				OutRows.Add(GetRegressionRow(CaseIndex, Behavior, Time, SampleResult, OP));
+			}
+		}
+	}
+
+	// Invalid input values are reported, not calculated.
+	SetRegressionInput(TypeIIRMLRegressionCases[0], IP);
+	IP.MaxAccelerationVector->VecData[1] = -1.0;
+	RMLVelocityFlags Flags;
+	const int32 Result = RML.RMLVelocity(IP, &OP, Flags);
+	OutRows.Add(GetRegressionRow(INDEX_NONE, Flags.SynchronizationBehavior, TYPEIIRML_REGRESSION_CYCLE_TIME, Result, OP));
+}
+
+// Reads the rows of a reference file, without the comment lines
+static bool LoadRegressionRows(const FString& FileName, TArray<FString>& OutRows)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *FileName))
+	{
+		return false;
+	}
+	for (const FString& Line : Lines)
+	{
+		if (!Line.IsEmpty() && !Line.StartsWith(TEXT("#")))
+		{
+			OutRows.Add(Line);
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTypeIIRMLRegressionTest, "LibTypeIIRML.Regression", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Compare the linked library (prebuilt or built from source) with the trajectories recorded from TypeIIRML.lib
+bool FTypeIIRMLRegressionTest::RunTest(const FString& Parameters)
+{
+	TArray<FString> Rows;
+	RecordRegressionRows(Rows);
+
+	// Every run records, so the reference can be replaced with the output of a run with TypeIIRML.lib.
+	const FString RecordedFileName = FPaths::Combine(FPaths::AutomationDir(), TYPEIIRML_REGRESSION_FILE_NAME);
+	const FString Library = WITH_TYPEIIRML_SOURCES ? TEXT("the sources in Private/TypeIIRML") : PLATFORM_WINDOWS ? TEXT("TypeIIRML.lib") : TEXT("libTypeIIRML.a");
+	FFileHelper::SaveStringToFile(FString::Printf(TEXT("# Recorded from %s\n"), *Library) + FString::Join(Rows, TEXT("\n")) + TEXT("\n"), *RecordedFileName);
+
+	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("LibTypeIIRML"));
+	const FString ReferenceFileName = Plugin.IsValid() ? FPaths::Combine(Plugin->GetBaseDir(), TEXT("Resources"), TYPEIIRML_REGRESSION_FILE_NAME) : FString();
+	TArray<FString> ReferenceRows;
+	if (!Plugin.IsValid() || !LoadRegressionRows(ReferenceFileName, ReferenceRows))
+	{
+		AddWarning(FString::Printf(TEXT("No reference trajectories in %s. Run the test with TypeIIRML.lib (Win64, no sources) and copy %s there."),
+			*ReferenceFileName, *RecordedFileName));
+		return true;
+	}
+
+	if (!TestEqual(TEXT("Number of recorded states"), Rows.Num(), ReferenceRows.Num()))
+	{
+		return true;
+	}
+
+	for (int32 RowIndex = 0; RowIndex < Rows.Num(); ++RowIndex)
+	{
+		TArray<FString> Values;
+		TArray<FString> ReferenceValues;
+		Rows[RowIndex].ParseIntoArray(Values, TEXT(","));
+		ReferenceRows[RowIndex].ParseIntoArray(ReferenceValues, TEXT(","));
+		if (ReferenceValues.Num() != TYPEIIRML_REGRESSION_COLUMNS)
+		{
+			AddError(FString::Printf(TEXT("Line %d of the reference has %d values instead of %d."), RowIndex + 1, ReferenceValues.Num(), TYPEIIRML_REGRESSION_COLUMNS));
+			continue;
+		}
+
+		// Case, synchronization, time and result are the same, the states within the tolerance (compilers may round differently).
+		const FString What = FString::Printf(TEXT("Case %s, synchronization %s at %s s"), *ReferenceValues[0], *ReferenceValues[1], *ReferenceValues[2]);
+		for (int32 Column = 0; Column < TYPEIIRML_REGRESSION_COLUMNS; ++Column)
+		{
+			const double Value = FCString::Atod(*Values[Column]);
+			const double Expected = FCString::Atod(*ReferenceValues[Column]);
+			const double Tolerance = Column < 4 ? 0.0 : TYPEIIRML_REGRESSION_TOLERANCE;
+			if (FMath::Abs(Value - Expected) > Tolerance)
+			{
+				AddError(FString::Printf(TEXT("%s, value %d: expected %.17g, got %.17g."), *What, Column, Expected, Value));
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,133 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReflexxesAPI.h"
+#include "RMLVelocityFlags.h"
+#include "RMLFixedVelocityParameters.h"
+
+/**
+ * Closed-form velocity-based trajectory generation for N degrees of freedom without synchronization.
+ * Type II trajectories do not limit the jerk: every degree of freedom changes its velocity with the maximum acceleration
+ * until the target velocity is reached and then keeps it. Without synchronization the degrees of freedom are independent,
+ * so the next state of motion is a short piecewise polynomial and the decision trees of the library are not needed.
+ * CanEvaluate tells when the library is still needed (synchronization, invalid input values).
+ * Steady trajectories (no acceleration, target velocity reached) only move on with constant velocity (IsSteady, EvaluateSteady).
+ */
+template <uint32 N>
+struct RMLClosedFormVelocity
+{
+	/*
+	* Checks if the closed form gives the same trajectory as the library.
+	*
+	* @param Input Input of the trajectory.
+	* @param Flags Flags that would be used for the library.
+	* @return true if the closed form can be used.
+	*/
+	static FORCEINLINE bool CanEvaluate(const RMLFixedVelocityInputParameters<N>& Input, const RMLVelocityFlags& Flags)
+	{
+		if (Flags.SynchronizationBehavior != RMLFlags::NO_SYNCHRONIZATION)
+		{
+			return false;
+		}
+
+		bool bValid = true;
+		for (uint32 i = 0; i < N; ++i)
+		{
+			// Invalid values are left to the library, so the error values stay the same.
+			bValid = bValid
+				&& Input.SelectionVector[i]
+				&& Input.MaxAccelerationVector[i] > 0.0
+				&& FMath::IsFinite(Input.CurrentPositionVector[i])
+				&& FMath::IsFinite(Input.CurrentVelocityVector[i])
+				&& FMath::IsFinite(Input.TargetVelocityVector[i]);
+		}
+		return bValid;
+	}
+
+	/*
+	* Checks if a trajectory is steady: every degree of freedom is selected, does not accelerate and has its target velocity.
+	* The next state of motion is then only the movement with constant velocity.
+	*
+	* @param Input Input of the trajectory.
+	* @return true if the trajectory is steady.
+	*/
+	static FORCEINLINE bool IsSteady(const RMLFixedVelocityInputParameters<N>& Input)
+	{
+		bool bSteady = true;
+		for (uint32 i = 0; i < N; ++i)
+		{
+			bSteady = bSteady
+				&& Input.SelectionVector[i]
+				&& Input.CurrentAccelerationVector[i] == 0.0
+				&& Input.CurrentVelocityVector[i] == Input.TargetVelocityVector[i];
+		}
+		return bSteady;
+	}
+
+	/*
+	* Calculates the next state of motion of a steady trajectory. Same values as RMLVelocity returns for it.
+	*
+	* @param Input Input of the trajectory. Must pass IsSteady.
+	* @param Output Receives the next state of motion.
+	* @param TimeInSeconds Time to move on.
+	* @return ReflexxesAPI::RML_FINAL_STATE_REACHED
+	*/
+	static FORCEINLINE int32 EvaluateSteady(const RMLFixedVelocityInputParameters<N>& Input, RMLFixedVelocityOutputParameters<N>& Output, const double TimeInSeconds)
+	{
+		for (uint32 i = 0; i < N; ++i)
+		{
+			Output.NewPositionVector[i] = Input.CurrentPositionVector[i] + Input.CurrentVelocityVector[i] * TimeInSeconds;
+			Output.NewVelocityVector[i] = Input.CurrentVelocityVector[i];
+			Output.NewAccelerationVector[i] = 0.0;
+		}
+		Output.SynchronizationTime = 0.0;
+		Output.bANewCalculationWasPerformed = false;
+		return ReflexxesAPI::RML_FINAL_STATE_REACHED;
+	}
+
+	/*
+	* Calculates the next state of motion.
+	*
+	* @param Input Input of the trajectory. Must pass CanEvaluate.
+	* @param Output Receives the next state of motion.
+	* @param TimeInSeconds Time to move on.
+	* @return ReflexxesAPI::RML_WORKING or ReflexxesAPI::RML_FINAL_STATE_REACHED.
+	*/
+	static FORCEINLINE int32 Evaluate(const RMLFixedVelocityInputParameters<N>& Input, RMLFixedVelocityOutputParameters<N>& Output, const double TimeInSeconds)
+	{
+		double SynchronizationTime = 0.0;
+
+		for (uint32 i = 0; i < N; ++i)
+		{
+			const double P0 = Input.CurrentPositionVector[i];
+			const double V0 = Input.CurrentVelocityVector[i];
+			const double VT = Input.TargetVelocityVector[i];
+			const double DeltaV = VT - V0;
+			const double Acceleration = DeltaV >= 0.0 ? Input.MaxAccelerationVector[i] : -Input.MaxAccelerationVector[i];
+
+			// Time until the target velocity is reached.
+			const double RampTime = DeltaV / Acceleration;
+			SynchronizationTime = FMath::Max(SynchronizationTime, RampTime);
+
+			if (TimeInSeconds < RampTime)
+			{
+				Output.NewPositionVector[i] = P0 + V0 * TimeInSeconds + 0.5 * Acceleration * TimeInSeconds * TimeInSeconds;
+				Output.NewVelocityVector[i] = V0 + Acceleration * TimeInSeconds;
+				Output.NewAccelerationVector[i] = Acceleration;
+			}
+			else
+			{
+				Output.NewPositionVector[i] = P0 + V0 * RampTime + 0.5 * Acceleration * RampTime * RampTime + VT * (TimeInSeconds - RampTime);
+				Output.NewVelocityVector[i] = VT;
+				Output.NewAccelerationVector[i] = 0.0;
+			}
+		}
+
+		Output.SynchronizationTime = SynchronizationTime;
+		Output.bANewCalculationWasPerformed = true;
+		return TimeInSeconds < SynchronizationTime ? ReflexxesAPI::RML_WORKING : ReflexxesAPI::RML_FINAL_STATE_REACHED;
+	}
+};
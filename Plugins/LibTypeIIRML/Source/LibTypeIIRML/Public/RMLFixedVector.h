@@ -0,0 +1,132 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RMLVector.h"
+
+/**
+ * Vector with a dimension that is known at compile time. Same interface as RMLVector, but the data is stored inline,
+ * so constructing, copying and assigning never allocate and a set of vectors lies in one block of memory.
+ * RMLVector itself can not get a second template parameter, because the prebuilt TypeIIRML library is compiled against it.
+ * Use CopyTo and CopyFrom to exchange data with the RMLVectors the library works with.
+ */
+template <class T, uint32 N>
+class RMLFixedVector
+{
+public:
+
+	static_assert(N > 0, "RMLFixedVector needs at least one element.");
+
+	/*
+	* Constructor. All elements are zero.
+	*/
+	RMLFixedVector()
+	{
+		FMemory::Memzero(VecData, sizeof(VecData));
+	}
+
+	/*
+	* Constructor. All elements get the same value.
+	*
+	* @param Value Value of the elements.
+	*/
+	explicit RMLFixedVector(const T Value)
+	{
+		Set(Value);
+	}
+
+	/*
+	* Sets all elements to the same value.
+	*
+	* @param Value Value of the elements.
+	*/
+	FORCEINLINE void Set(const T Value)
+	{
+		for (uint32 i = 0; i < N; ++i)
+		{
+			VecData[i] = Value;
+		}
+	}
+
+	/*
+	* Getter for the dimension.
+	*
+	* @return Number of elements.
+	*/
+	static constexpr uint32 GetVecDim()
+	{
+		return N;
+	}
+
+	/*
+	* Access to a single element.
+	*/
+	FORCEINLINE T& operator[](const int32 Index)
+	{
+		return VecData[Index];
+	}
+
+	/*
+	* Access to a single element.
+	*/
+	FORCEINLINE const T& operator[](const int32 Index) const
+	{
+		return VecData[Index];
+	}
+
+	/*
+	* Compares all elements.
+	*/
+	FORCEINLINE bool operator==(const RMLFixedVector& Vector) const
+	{
+		for (uint32 i = 0; i < N; ++i)
+		{
+			if (VecData[i] != Vector.VecData[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/*
+	* Compares all elements.
+	*/
+	FORCEINLINE bool operator!=(const RMLFixedVector& Vector) const
+	{
+		return !(*this == Vector);
+	}
+
+	/*
+	* Copies the elements into a vector of the library. The dimension of the vector must be N.
+	*
+	* @param Vector Receives the elements.
+	*/
+	FORCEINLINE void CopyTo(RMLVector<T>& Vector) const
+	{
+		checkSlow(Vector.GetVecDim() == N);
+		FMemory::Memcpy(Vector.VecData, VecData, sizeof(VecData));
+	}
+
+	/*
+	* Copies the elements from a vector of the library. The dimension of the vector must be N.
+	*
+	* @param Vector Gives the elements.
+	*/
+	FORCEINLINE void CopyFrom(const RMLVector<T>& Vector)
+	{
+		checkSlow(Vector.GetVecDim() == N);
+		FMemory::Memcpy(VecData, Vector.VecData, sizeof(VecData));
+	}
+
+	// The elements of the vector. Public, same as in RMLVector.
+	T VecData[N];
+};
+
+template <uint32 N>
+using RMLFixedDoubleVector = RMLFixedVector<double, N>;
+
+template <uint32 N>
+using RMLFixedBoolVector = RMLFixedVector<bool, N>;
@@ -0,0 +1,93 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RMLFixedVector.h"
+#include "RMLVelocityInputParameters.h"
+#include "RMLVelocityOutputParameters.h"
+
+/**
+ * Input parameters of the velocity-based trajectory generation with N degrees of freedom.
+ * Holds the same values as RMLVelocityInputParameters in one block without heap allocations.
+ */
+template <uint32 N>
+struct RMLFixedVelocityInputParameters
+{
+	RMLFixedDoubleVector<N> CurrentPositionVector;
+	RMLFixedDoubleVector<N> CurrentVelocityVector;
+	RMLFixedDoubleVector<N> CurrentAccelerationVector;
+	RMLFixedDoubleVector<N> TargetVelocityVector;
+	RMLFixedDoubleVector<N> MaxAccelerationVector;
+	RMLFixedDoubleVector<N> MaxJerkVector;
+	RMLFixedBoolVector<N> SelectionVector;
+	double MinimumSynchronizationTime = 0.0;
+
+	/*
+	* Copies the state of motion and the target velocity (the values that change every cycle) to the input of the library.
+	*
+	* @param InputParameters Input of the library with N degrees of freedom.
+	*/
+	FORCEINLINE void CopyStateTo(RMLVelocityInputParameters& InputParameters) const
+	{
+		CurrentPositionVector.CopyTo(*InputParameters.CurrentPositionVector);
+		CurrentVelocityVector.CopyTo(*InputParameters.CurrentVelocityVector);
+		CurrentAccelerationVector.CopyTo(*InputParameters.CurrentAccelerationVector);
+		TargetVelocityVector.CopyTo(*InputParameters.TargetVelocityVector);
+	}
+
+	/*
+	* Copies all values to the input of the library.
+	*
+	* @param InputParameters Input of the library with N degrees of freedom.
+	*/
+	FORCEINLINE void CopyTo(RMLVelocityInputParameters& InputParameters) const
+	{
+		CopyStateTo(InputParameters);
+		MaxAccelerationVector.CopyTo(*InputParameters.MaxAccelerationVector);
+		MaxJerkVector.CopyTo(*InputParameters.MaxJerkVector);
+		SelectionVector.CopyTo(*InputParameters.SelectionVector);
+		InputParameters.MinimumSynchronizationTime = MinimumSynchronizationTime;
+	}
+};
+
+/**
+ * Output parameters of the velocity-based trajectory generation with N degrees of freedom.
+ * Only holds the values of the next state of motion, the extrema of the library are not copied.
+ */
+template <uint32 N>
+struct RMLFixedVelocityOutputParameters
+{
+	RMLFixedDoubleVector<N> NewPositionVector;
+	RMLFixedDoubleVector<N> NewVelocityVector;
+	RMLFixedDoubleVector<N> NewAccelerationVector;
+	double SynchronizationTime = 0.0;
+	bool bANewCalculationWasPerformed = false;
+
+	/*
+	* Copies the next state of motion from the output of the library.
+	*
+	* @param OutputParameters Output of the library with N degrees of freedom.
+	*/
+	FORCEINLINE void CopyFrom(const RMLVelocityOutputParameters& OutputParameters)
+	{
+		NewPositionVector.CopyFrom(*OutputParameters.NewPositionVector);
+		NewVelocityVector.CopyFrom(*OutputParameters.NewVelocityVector);
+		NewAccelerationVector.CopyFrom(*OutputParameters.NewAccelerationVector);
+		SynchronizationTime = OutputParameters.SynchronizationTime;
+		bANewCalculationWasPerformed = OutputParameters.ANewCalculationWasPerformed;
+	}
+
+	/*
+	* Feeds the next state of motion back as current state of the next cycle.
+	*
+	* @param InputParameters Input of the next cycle.
+	*/
+	FORCEINLINE void FeedBack(RMLFixedVelocityInputParameters<N>& InputParameters) const
+	{
+		InputParameters.CurrentPositionVector = NewPositionVector;
+		InputParameters.CurrentVelocityVector = NewVelocityVector;
+		InputParameters.CurrentAccelerationVector = NewAccelerationVector;
+	}
+};
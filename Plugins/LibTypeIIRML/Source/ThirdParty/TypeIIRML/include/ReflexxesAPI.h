@@ -51,6 +51,11 @@
 #include <RMLVelocityFlags.h>
 #include <RMLVector.h>
 
+// Export of the API class. LibTypeIIRML.Build.cs defines it when the sources are compiled into the module,
+// it stays empty for the prebuilt static libraries.
+#ifndef TYPEIIRML_API
+#define TYPEIIRML_API
+#endif
 
 //  ---------------------- Doxygen info ----------------------
 //! \class ReflexxesAPI
@@ -120,7 +125,7 @@
 //! \sa \ref page_TypeIIAndIVOverview
 //! \sa \ref page_ErrorHandling
 //  ----------------------------------------------------------
-class ReflexxesAPI
+class TYPEIIRML_API ReflexxesAPI
 {
 public:
 
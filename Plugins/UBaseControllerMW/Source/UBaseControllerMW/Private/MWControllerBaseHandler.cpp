@@ -14,11 +14,11 @@ MWControllerBaseHandler::~MWControllerBaseHandler()
 }
 
 // Sets the linear velocity of the base.
-bool MWControllerBaseHandler::SetBaseLinearVelocity(const FVector Velocity)
+bool MWControllerBaseHandler::SetBaseLinearVelocity(const FVector Velocity, const FQuat& BaseRotation)
 {
 	if (!CheckBase()) { return false; }
 
-	FVector CalcedVector = CalcLongitudinal(Velocity) + CalcTransversal(Velocity);
+	FVector CalcedVector = CalcLongitudinal(Velocity, BaseRotation) + CalcTransversal(Velocity, BaseRotation);
 
 	// meter to cm 
 	CalcedVector.X *= SCALE_FACTOR_M_TO_CM;
@@ -32,25 +32,39 @@ bool MWControllerBaseHandler::SetBaseLinearVelocity(const FVector Velocity)
 }
 
 // Calculates the velocity value based on the orientation.
-FVector MWControllerBaseHandler::CalcLongitudinal(const FVector LongitudinalVelocity)
+FVector MWControllerBaseHandler::CalcLongitudinal(const FVector LongitudinalVelocity, const FQuat& BaseRotation)
 {
-	const FRotator Rotation = MWConComp->Base->GetComponentRotation();
-	const FVector Direction = FRotationMatrix(Rotation).GetScaledAxis(EAxis::X);
+	const FVector Direction = BaseRotation.GetAxisX();
 
 	return FVector(Direction * LongitudinalVelocity.X);
 }
 
 // Calculates the velocity value based on the orientation.
-FVector MWControllerBaseHandler::CalcTransversal(const FVector TransversalVelocity)
+FVector MWControllerBaseHandler::CalcTransversal(const FVector TransversalVelocity, const FQuat& BaseRotation)
 {
-	const FRotator Rotation = MWConComp->Base->GetComponentRotation();
-	const FVector Direction = FRotationMatrix(Rotation).GetScaledAxis(EAxis::Y);
+	const FVector Direction = BaseRotation.GetAxisY();
 
 	return FVector(Direction * TransversalVelocity.Y);
 }
 
+// Sets the velocities on the body of the base.
+void MWControllerBaseHandler::SetBaseBodyVelocity(FBodyInstance& BaseBody, const FVector Twist, const FQuat& BaseRotation, const bool bCanRotate)
+{
+	FVector LinearVelocity = CalcLongitudinal(Twist, BaseRotation) + CalcTransversal(Twist, BaseRotation);
+
+	// meter to cm 
+	LinearVelocity.X *= SCALE_FACTOR_M_TO_CM;
+	LinearVelocity.Y *= SCALE_FACTOR_M_TO_CM;
+
+	// X_Type can not rotate by definition.
+	const FVector AngularVelocity = bCanRotate ? BaseRotation.GetAxisZ() * Twist.Z : FVector::ZeroVector;
+
+	BaseBody.SetLinearVelocity(LinearVelocity, false);
+	BaseBody.SetAngularVelocityInRadians(AngularVelocity, false);
+}
+
 // Sets the angular velocity of the base based on the orientation.
-bool MWControllerBaseHandler::SetBaseAngularVelocity(const FVector AngularVelocity)
+bool MWControllerBaseHandler::SetBaseAngularVelocity(const FVector AngularVelocity, const FQuat& BaseRotation)
 {
 	if (!CheckBase()) { return false; }
 
@@ -60,8 +74,7 @@ bool MWControllerBaseHandler::SetBaseAngularVelocity(const FVector AngularVeloci
 		MWConComp->Base->SetAllPhysicsAngularVelocityInRadians(FVector::ZeroVector, false);
 		return false;
 	}
-	const FRotator Rotation = MWConComp->Base->GetComponentRotation();
-	const FVector Direction = FRotationMatrix(Rotation).GetScaledAxis(EAxis::Z);
+	const FVector Direction = BaseRotation.GetAxisZ();
 	const FVector CalcedVector = Direction * AngularVelocity.Z;
 
 	MWConComp->Base->SetAllPhysicsAngularVelocityInRadians(CalcedVector, false);
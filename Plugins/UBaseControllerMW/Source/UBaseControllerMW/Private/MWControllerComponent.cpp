@@ -5,6 +5,9 @@
 #include "MWControllerWheelHandler.h"
 #include "MWControllerConstraintHandler.h"
 #include "MWControllerBaseHandler.h"
+#include "MWControllerFleetManager.h"
+#include "MWControllerRegistry.h"
+#include "Ids.h"
 
 
 #if WITH_EDITOR
@@ -108,48 +111,22 @@ bool UMWControllerComponent::AdjustMWControllerComponent()
 			}
 		}
 
-		// Get the actors who holds the wheels. 
-		TArray<AActor*> HelperActorList;
-		UGameplayStatics::GetAllActorsOfClass(this->GetWorld(), AActor::StaticClass(), HelperActorList);
+		// Get the actors who holds the wheels. The registry finds them by name, with several robots the closest ones are taken.
+		MWControllerRegistry* Registry = MWControllerRegistry::Get(this->GetWorld());
+		if (Registry)
+		{
+			ActorWheelLF = Registry->FindActorByName(MWActorWheelLFName, MWRobotBaseActor);
+			ActorWheelRF = Registry->FindActorByName(MWActorWheelRFName, MWRobotBaseActor);
+			ActorWheelLR = Registry->FindActorByName(MWActorWheelLRName, MWRobotBaseActor);
+			ActorWheelRR = Registry->FindActorByName(MWActorWheelRRName, MWRobotBaseActor);
+		}
 
-		for (auto WheelAct : HelperActorList)
+		for (AActor* WheelAct : { ActorWheelLF, ActorWheelRF, ActorWheelLR, ActorWheelRR })
 		{
-			// Look for the default names. "Contains" is used because Unreal changes the name in some cases.
-			if (WheelAct->GetName().Contains(MWActorWheelLFName))
+			if (WheelAct && WheelAct->IsValidLowLevel())
 			{
-				if (WheelAct && WheelAct->IsValidLowLevel())
-				{
-					ActorWheelLF = WheelAct;
-					ActorWheelLF->SetTickGroup(TG_PrePhysics);
-					WheelActorList.Add(WheelAct);
-				}
-			}
-			else if (WheelAct->GetName().Contains(MWActorWheelRFName))
-			{
-				if (WheelAct && WheelAct->IsValidLowLevel())
-				{
-					ActorWheelRF = WheelAct;
-					ActorWheelRF->SetTickGroup(TG_PrePhysics);
-					WheelActorList.Add(WheelAct);
-				}
-			}
-			else if (WheelAct->GetName().Contains(MWActorWheelLRName))
-			{
-				if (WheelAct && WheelAct->IsValidLowLevel())
-				{
-					ActorWheelLR = WheelAct;
-					ActorWheelLR->SetTickGroup(TG_PrePhysics);
-					WheelActorList.Add(WheelAct);
-				}
-			}
-			else if (WheelAct->GetName().Contains(MWActorWheelRRName))
-			{
-				if (WheelAct && WheelAct->IsValidLowLevel())
-				{
-					ActorWheelRR = WheelAct;
-					ActorWheelRR->SetTickGroup(TG_PrePhysics);
-					WheelActorList.Add(WheelAct);
-				}
+				WheelAct->SetTickGroup(TG_PrePhysics);
+				WheelActorList.Add(WheelAct);
 			}
 		}
 
@@ -244,6 +221,8 @@ bool UMWControllerComponent::AdjustMWControllerComponent()
 					FText::FromString("WheelDiameterInCentimeter was wrong. Please fix that."),
 					FText::FromString("MW Error Dialog"));
 			}
+
+			UpdateKinematics();
 		}
 		else
 		{
@@ -295,10 +274,11 @@ void UMWControllerComponent::PostEditChangeProperty(FPropertyChangedEvent & Prop
 	}
 	else if (PropertyName == FName("CyleTimeInSeconds"))
 	{
-		//For changes, the interpolator must be reset.
-		Interpolator->~MWControllerInterpolator();
-		Interpolator = nullptr;
-		Interpolator = new MWControllerInterpolator(CyleTimeInSeconds);
+		// The interpolator takes the time step of every cycle, so it is kept.
+		if (Interpolator)
+		{
+			Interpolator->set_time_step(CyleTimeInSeconds);
+		}
 	}
 	else if (PropertyName == FName("bUseWheelRotatio"))
 	{
@@ -350,6 +330,9 @@ void UMWControllerComponent::PostEditChangeProperty(FPropertyChangedEvent & Prop
 			}
 		}
 	}
+
+	// Every change of the geometry has to reach the kinematics.
+	UpdateKinematics();
 }
 #endif
 
@@ -368,6 +351,7 @@ void UMWControllerComponent::PostLoad()
 			ConstraintHandler = new MWControllerConstraintHandler(this);
 			Interpolator = new MWControllerInterpolator(CyleTimeInSeconds);
 		}
+		UpdateKinematics();
 	}
 }
 
@@ -375,6 +359,71 @@ void UMWControllerComponent::PostLoad()
 void UMWControllerComponent::BeginPlay()
 {
 	Super::BeginPlay();
+
+	UpdateKinematics();
+
+	// The results of the substeps reach the controller after the physics.
+	if (bUsePhysicsSubstepControl && GetWorld())
+	{
+		SubstepPublishTickFunction.TickGroup = TG_PostPhysics;
+		SubstepPublishTickFunction.bCanEverTick = true;
+		SubstepPublishTickFunction.bStartWithTickEnabled = true;
+		SubstepPublishTickFunction.Controller = this;
+		SubstepPublishTickFunction.RegisterTickFunction(GetWorld()->PersistentLevel);
+	}
+
+	// The fleet ticks the controller, the own tick is not needed anymore.
+	if (bUseFleetTick)
+	{
+		if (MWControllerFleetManager* Fleet = MWControllerFleetManager::Get(GetWorld()))
+		{
+			Fleet->AddController(this);
+			bRegisteredInFleet = true;
+			this->SetComponentTickEnabled(false);
+		}
+	}
+}
+
+// Called when the game ends.
+void UMWControllerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bRegisteredInFleet)
+	{
+		if (MWControllerFleetManager* Fleet = MWControllerFleetManager::Get(GetWorld(), false))
+		{
+			Fleet->RemoveController(this);
+		}
+		bRegisteredInFleet = false;
+	}
+
+	if (SubstepPublishTickFunction.IsTickFunctionRegistered())
+	{
+		SubstepPublishTickFunction.UnRegisterTickFunction();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+// Adds the controller to the registry.
+void UMWControllerComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	if (MWControllerRegistry* Registry = MWControllerRegistry::Get(GetWorld()))
+	{
+		Registry->RegisterController(this);
+	}
+}
+
+// Removes the controller from the registry.
+void UMWControllerComponent::OnUnregister()
+{
+	if (MWControllerRegistry* Registry = MWControllerRegistry::Get(GetWorld(), false))
+	{
+		Registry->UnregisterController(this);
+	}
+
+	Super::OnUnregister();
 }
 
 // Destroys MWController and cleans up.
@@ -399,6 +448,11 @@ void UMWControllerComponent::DestroyComponent(bool bPromoteChildren)
 	{
 		Interpolator->~MWControllerInterpolator();
 	}
+	if (SubstepState.Interpolator)
+	{
+		delete SubstepState.Interpolator;
+		SubstepState.Interpolator = nullptr;
+	}
 	if (PhysicsConstBaseWheelLF && PhysicsConstBaseWheelRF && PhysicsConstBaseWheelLR && PhysicsConstBaseWheelRR)
 	{
 		ConstraintHandler->DeletePhysicsConstraints();
@@ -410,39 +464,239 @@ void UMWControllerComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	if (CanRunControlCycle())
+	{
+		const FTransform BaseTransform = Base->GetComponentTransform();
+		if (bUsePhysicsSubstepControl)
+		{
+			QueueSubstepControlCycle(BaseTransform);
+			return;
+		}
+
+		const FVector NextTwist = ComputeControlCycle(BaseTransform, DeltaTime);
 
-	// Sees if distance has become faulty due to the deviations.
-	if (!WheelHandler->IsDistanceBetweenWheelsValid())
+		if (bUseWheelRotation)
+		{
+			WheelHandler->CalcWheelsAngularVelocity(NextTwist);
+		}
+
+		// Starts with the implementation of the simulation.
+		ApplyControlCycle(NextTwist, BaseTransform);
+	}
+}
+
+// Checks the simulation conditions.
+bool UMWControllerComponent::CanRunControlCycle(const bool bCheckWheelDistance)
+{
+	if (bControlCycleStopped)
 	{
-		this->SetComponentTickEnabled(false);
-		UE_LOG(LogTemp, Error,
-			TEXT("[%s][%d]Distance of the wheels has deviated too far (difference> 1.0). Tick of UMWControllerComponent will be turn off."),
-			TEXT(__FUNCTION__), __LINE__);
+		return false;
 	}
 
-	// Turns off the tick when problems occur, as this is safer than to destroy.
-	if (!MWRobotBaseActor || !MWRobotBaseActor->IsValidLowLevel() || !AllStaticMeshComponentsExist())
+	// Turns off the control cycle when problems occur, as this is safer than to destroy.
+	const bool bAllMeshesSet = Base && WheelLeftFront && WheelRightFront && WheelLeftRear && WheelRightRear;
+	if (!MWRobotBaseActor || !MWRobotBaseActor->IsValidLowLevel() || !bAllMeshesSet || !BaseHandler || !WheelHandler || !Interpolator)
 	{
+		// Only used to log which ones are missing.
+		if (!bAllMeshesSet)
+		{
+			AllStaticMeshComponentsExist();
+		}
 
-		this->SetComponentTickEnabled(false);
+		StopControlCycle();
 		UE_LOG(LogTemp, Error,
 			TEXT("[%s][%d]. Tick of UMWControllerComponent will be turned off."),
 			TEXT(__FUNCTION__), __LINE__);
+		return false;
+	}
+
+	// Sees if distance has become faulty due to the deviations. The current frame is still simulated.
+	if (bCheckWheelDistance && !WheelHandler->IsDistanceBetweenWheelsValid())
+	{
+		StopControlCycleForWheelDistance();
+	}
+	return true;
+}
+
+// Stops the control cycle because of the distance of the wheels.
+void UMWControllerComponent::StopControlCycleForWheelDistance()
+{
+	StopControlCycle();
+	UE_LOG(LogTemp, Error,
+		TEXT("[%s][%d]Distance of the wheels has deviated too far (difference> 1.0). Tick of UMWControllerComponent will be turn off."),
+		TEXT(__FUNCTION__), __LINE__);
+}
+
+// Gets the next twist from the interpolator.
+FVector UMWControllerComponent::ComputeControlCycle(const FTransform& BaseTransform, const float DeltaTime)
+{
+	return PrepareControlCycle(BaseTransform, DeltaTime)->get_next_twist();
+}
+
+// Gives the pose to the interpolator.
+MWControllerInterpolator* UMWControllerComponent::PrepareControlCycle(const FTransform& BaseTransform, const float DeltaTime)
+{
+	if (bUseVariableTimeStep)
+	{
+		Interpolator->set_time_step(DeltaTime, MaxSubStepInSeconds);
 	}
 	else
 	{
+		Interpolator->set_time_step(CyleTimeInSeconds);
+	}
 
-		// Gives the pose - Location X, Y - Orientation Yaw as double 
-		Interpolator->set_current_pose(double(Base->GetComponentLocation().X), double(Base->GetComponentLocation().Y), double(Base->GetComponentRotation().Yaw));
+	// Gives the pose - Location X, Y - Orientation Yaw as double
+	const FVector Location = BaseTransform.GetLocation();
+	Interpolator->set_current_pose(double(Location.X), double(Location.Y), double(BaseTransform.Rotator().Yaw));
 
-		FVector NextTwist = Interpolator->get_next_twist();
+	return Interpolator;
+}
 
-		// Starts with the implementation of the simulation.
-		ExecuteCommandMovement(FVector(NextTwist.X, NextTwist.Y, NextTwist.Z));
+// Does the work for the simulation.
+void UMWControllerComponent::ApplyControlCycle(const FVector Twist, const FTransform& BaseTransform)
+{
+	const FQuat BaseRotation = BaseTransform.GetRotation();
+
+	BaseHandler->SetBaseLinearVelocity(Twist, BaseRotation);
+	BaseHandler->SetBaseAngularVelocity(Twist, BaseRotation);
 
-		// Sets the actor to the same transform, so that he comes along.
-		MWRobotBaseActor->SetActorTransform(Base->GetComponentTransform());
+	if (bUseWheelRotation)
+	{
+		WheelHandler->RotateWheelsOnAxisY(BaseRotation);
 	}
+
+	// Sets the actor to the same transform, so that he comes along.
+	MWRobotBaseActor->SetActorTransform(BaseTransform);
+
+	// The velocities were just set, readers after the control cycle get a new snapshot.
+	StateSnapshot.FrameNumber = 0;
+}
+
+// Indicates whether the control cycle runs in the physics substeps.
+bool UMWControllerComponent::UsesPhysicsSubstepControl() const
+{
+	return bUsePhysicsSubstepControl;
+}
+
+// Registers the control cycle for the substeps of this frame.
+void UMWControllerComponent::QueueSubstepControlCycle(const FTransform& BaseTransform)
+{
+	// The physics of the last frame has ended, so the substep state can be written.
+	if (!SubstepState.Interpolator)
+	{
+		SubstepState.Interpolator = new MWControllerInterpolator(CyleTimeInSeconds);
+	}
+	if (bSubstepKinematicsDirty)
+	{
+		SubstepState.Kinematics = Kinematics;
+		bSubstepKinematicsDirty = false;
+	}
+	SubstepState.MaxSubStepInSeconds = MaxSubStepInSeconds;
+	SubstepState.bUseWheelRotation = bUseWheelRotation;
+	SubstepState.bCanRotate = MWType != EMWType::MW_X_Type;
+
+	if (bSubstepTargetPending)
+	{
+		SubstepState.Interpolator->set_target_twist(SubstepTargetTwist.X, SubstepTargetTwist.Y, SubstepTargetTwist.Z);
+		bSubstepTargetPending = false;
+	}
+
+	// The bodies are resolved here on the game thread, the substeps must not touch the components.
+	UStaticMeshComponent* const Wheels[] = { WheelLeftFront, WheelRightFront, WheelLeftRear, WheelRightRear };
+	for (int32 i = 0; i < ARRAY_COUNT(Wheels); ++i)
+	{
+		FBodyInstance* WheelBody = Wheels[i] ? Wheels[i]->GetBodyInstance() : nullptr;
+		SubstepState.WheelBodies[i] = WheelBody && WheelBody->IsValidBodyInstance() ? WheelBody : nullptr;
+	}
+
+	// Custom physics is only registered for the next physics step.
+	FBodyInstance* BodyInstance = Base->GetBodyInstance();
+	if (BodyInstance && BodyInstance->IsValidBodyInstance())
+	{
+		if (!OnCalculateCustomPhysics.IsBound())
+		{
+			OnCalculateCustomPhysics.BindUObject(this, &UMWControllerComponent::SubstepControlCycle);
+		}
+		BodyInstance->AddCustomPhysics(OnCalculateCustomPhysics);
+	}
+
+	// Sets the actor to the same transform, so that he comes along.
+	MWRobotBaseActor->SetActorTransform(BaseTransform);
+}
+
+// Runs one control cycle in a physics substep.
+void UMWControllerComponent::SubstepControlCycle(float DeltaTime, FBodyInstance* BodyInstance)
+{
+	// Runs on the physics thread, everything that changes lives in SubstepState.
+	FMWControllerSubstepState& State = SubstepState;
+	if (!BodyInstance || !State.Interpolator)
+	{
+		return;
+	}
+
+	const FTransform BaseTransform = BodyInstance->GetUnrealWorldTransform_AssumesLocked();
+	const FQuat BaseRotation = BaseTransform.GetRotation();
+	const FVector Location = BaseTransform.GetLocation();
+
+	State.Interpolator->set_time_step(DeltaTime, State.MaxSubStepInSeconds);
+	State.Interpolator->set_current_pose(double(Location.X), double(Location.Y), double(BaseTransform.Rotator().Yaw));
+	State.Twist = State.Interpolator->get_next_twist();
+
+	BaseHandler->SetBaseBodyVelocity(*BodyInstance, State.Twist, BaseRotation, State.bCanRotate);
+
+	if (State.bUseWheelRotation)
+	{
+		float* const Wheels = State.WheelAngularVelocities;
+		State.Kinematics.SolveInverse(0, 1, &State.Twist.X, &State.Twist.Y, &State.Twist.Z, &Wheels[0], &Wheels[1], &Wheels[2], &Wheels[3]);
+		MWControllerWheelHandler::RotateWheelBodiesOnAxisY(BaseRotation, State.WheelBodies, Wheels);
+	}
+	State.bHasResults = true;
+}
+
+// Copies the results of the substeps to the controller.
+void UMWControllerComponent::PublishSubstepResults()
+{
+	if (!SubstepState.bHasResults)
+	{
+		return;
+	}
+
+	WheelLeftFrontAngularVelocity = SubstepState.WheelAngularVelocities[0];
+	WheelRightFrontAngularVelocity = SubstepState.WheelAngularVelocities[1];
+	WheelLeftRearAngularVelocity = SubstepState.WheelAngularVelocities[2];
+	WheelRightRearAngularVelocity = SubstepState.WheelAngularVelocities[3];
+	SubstepState.bHasResults = false;
+
+	// The physics moved on, readers after the substeps get a new snapshot.
+	StateSnapshot.FrameNumber = 0;
+}
+
+// Publishes the results of the substeps.
+void FMWControllerSubstepPublishTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Controller)
+	{
+		Controller->PublishSubstepResults();
+	}
+}
+
+// Name for the tick debugger.
+FString FMWControllerSubstepPublishTickFunction::DiagnosticMessage()
+{
+	return TEXT("UMWControllerComponent::PublishSubstepResults");
+}
+
+// Indicates whether the control cycle was stopped.
+bool UMWControllerComponent::IsControlCycleStopped() const
+{
+	return bControlCycleStopped;
+}
+
+// Stops the tick. The fleet removes stopped controllers by itself.
+void UMWControllerComponent::StopControlCycle()
+{
+	bControlCycleStopped = true;
+	this->SetComponentTickEnabled(false);
 }
 
 
@@ -486,25 +740,22 @@ bool UMWControllerComponent::ReceiveROSMessage(FVector LinVel, FVector AngVel)
 				Theta = MaxThetaValue * -1.f;
 			}
 		}
-		Interpolator->set_target_twist(XVal, YVal, Theta);
+		// The substeps have their own interpolator, the target is passed on to it before the next physics step.
+		if (bUsePhysicsSubstepControl)
+		{
+			SubstepTargetTwist = FVector(XVal, YVal, Theta);
+			bSubstepTargetPending = true;
+		}
+		else
+		{
+			Interpolator->set_target_twist(XVal, YVal, Theta);
+		}
 
 		return true;
 	}
 	return false;
 }
 
-// Does the work for the simulation. 
-void UMWControllerComponent::ExecuteCommandMovement(FVector MoveCom)
-{
-	BaseHandler->SetBaseLinearVelocity(MoveCom);
-	BaseHandler->SetBaseAngularVelocity(MoveCom);
-
-	if (bUseWheelRotation)
-	{
-		WheelHandler->SetupWheelsMovement(MoveCom);
-	}
-}
-
 // Function looks if all elements are present and indicates which ones are missing.
 bool UMWControllerComponent::AllStaticMeshComponentsExist()
 {
@@ -539,64 +790,125 @@ bool UMWControllerComponent::AllStaticMeshComponentsExist()
 	return bMissingMeshComp ? false : true;
 }
 
+// Passes the geometry to the kinematics.
+void UMWControllerComponent::UpdateKinematics()
+{
+	if (Kinematics.Num() == 0)
+	{
+		Kinematics.AddRobot(WheelDiameterInCentimeter, CombinedDistanceValue, PolarityForAngularMovement, GetKinematicsType());
+	}
+	else
+	{
+		Kinematics.SetRobot(0, WheelDiameterInCentimeter, CombinedDistanceValue, PolarityForAngularMovement, GetKinematicsType());
+	}
+	bSubstepKinematicsDirty = true;
+
+	// The fleet has its own copy of the geometry.
+	if (bRegisteredInFleet)
+	{
+		if (MWControllerFleetManager* Fleet = MWControllerFleetManager::Get(GetWorld(), false))
+		{
+			Fleet->UpdateController(this);
+		}
+	}
+}
+
+// Gets the stable id of the robot.
+const FString& UMWControllerComponent::GetRobotId()
+{
+	if (RobotId.IsEmpty() && GetOwner())
+	{
+		// Without the prefix of the play in editor the id is the same in the editor and in a packaged game.
+		RobotId = FIds::NameToGuidInBase64Url(UWorld::RemovePIEPrefix(GetOwner()->GetPathName()));
+	}
+	return RobotId;
+}
+
+// Getter for the configuration.
+EMWKinematicsType UMWControllerComponent::GetKinematicsType() const
+{
+	return MWType == EMWType::MW_O_Type ? EMWKinematicsType::O_Type : EMWKinematicsType::X_Type;
+}
+
+// Gets the snapshot of this frame.
+const FMWControllerStateSnapshot& UMWControllerComponent::GetStateSnapshot()
+{
+	// Publishers in TG_PostPhysics must not get the state that a reader in TG_PrePhysics captured.
+	const UWorld* World = GetWorld();
+	const ETickingGroup TickGroup = World ? (ETickingGroup)World->TickGroup : TG_PostPhysics;
+	if (!StateSnapshot.IsCurrent(GFrameCounter, TickGroup))
+	{
+		CaptureStateSnapshot(TickGroup);
+	}
+	return StateSnapshot;
+}
+
+// Reads the physics state once for all getters.
+void UMWControllerComponent::CaptureStateSnapshot(const ETickingGroup TickGroup)
+{
+	StateSnapshot.SetCaptured(GFrameCounter, TickGroup);
+	StateSnapshot.TimeSeconds = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.f;
+
+	if (!Base || !WheelLeftFront || !WheelRightFront || !WheelLeftRear || !WheelRightRear)
+	{
+		return;
+	}
+
+	StateSnapshot.BaseTransform = Base->GetComponentTransform();
+	const FQuat BaseRotation = StateSnapshot.BaseTransform.GetRotation();
+	StateSnapshot.BaseLinearVelocity = BaseRotation.UnrotateVector(Base->GetPhysicsLinearVelocity());
+	StateSnapshot.BaseAngularVelocity = BaseRotation.UnrotateVector(Base->GetPhysicsAngularVelocityInRadians()).Z;
+
+	StateSnapshot.WheelLeftFront = WheelLeftFront->GetComponentQuat().UnrotateVector(WheelLeftFront->GetPhysicsLinearVelocity()).Y;
+	StateSnapshot.WheelRightFront = WheelRightFront->GetComponentQuat().UnrotateVector(WheelRightFront->GetPhysicsLinearVelocity()).Y;
+	StateSnapshot.WheelLeftRear = WheelLeftRear->GetComponentQuat().UnrotateVector(WheelLeftRear->GetPhysicsLinearVelocity()).Y;
+	StateSnapshot.WheelRightRear = WheelRightRear->GetComponentQuat().UnrotateVector(WheelRightRear->GetPhysicsLinearVelocity()).Y;
+}
+
 // Getter for base transform.
 const FTransform UMWControllerComponent::GetBaseTransform()
 {
-	return Base->GetComponentTransform();
+	return GetStateSnapshot().BaseTransform;
 }
 
 // Getter for Velocity.
 const float UMWControllerComponent::GetWheelLeftFrontAngularVelocity()
 {
-	FRotator Rot = WheelLeftFront->GetComponentRotation();
-	FVector Vel = Rot.UnrotateVector(WheelLeftFront->GetPhysicsLinearVelocity());
-	return Vel.Y;
+	return GetStateSnapshot().WheelLeftFront;
 }
 
 // Getter for Velocity.
 const float UMWControllerComponent::GetWheelRightFrontAngularVelocity()
 {
-	FRotator Rot = WheelRightFront->GetComponentRotation();
-	FVector Vel = Rot.UnrotateVector(WheelRightFront->GetPhysicsLinearVelocity());
-	return Vel.Y;
+	return GetStateSnapshot().WheelRightFront;
 }
 
 // Getter for Velocity.
 const float UMWControllerComponent::GetWheelLeftRearAngularVelocity()
 {
-	FRotator Rot = WheelLeftRear->GetComponentRotation();
-	FVector Vel = Rot.UnrotateVector(WheelLeftRear->GetPhysicsLinearVelocity());
-	return Vel.Y;
+	return GetStateSnapshot().WheelLeftRear;
 }
 
 // Getter for Velocity.
 const float UMWControllerComponent::GetWheelRightRearAngularVelocity()
 {
-	FRotator Rot = WheelRightRear->GetComponentRotation();
-	FVector Vel = Rot.UnrotateVector(WheelRightRear->GetPhysicsLinearVelocity());
-	return Vel.Y;
+	return GetStateSnapshot().WheelRightRear;
 }
 
 // Gets the LongitudinalVelocity of the Base. 
 const float UMWControllerComponent::GetBaseLongitudinalVelocity()
 {
-	FRotator Rot = Base->GetComponentRotation();
-	FVector Vel = Rot.UnrotateVector(Base->GetPhysicsLinearVelocity());
-	return Vel.X;
+	return GetStateSnapshot().BaseLinearVelocity.X;
 }
 
 // Gets the TransversalVelocity of the Base. 
 const float UMWControllerComponent::GetBaseTransversalVelocity()
 {
-	FRotator Rot = Base->GetComponentRotation();
-	FVector Vel = Rot.UnrotateVector(Base->GetPhysicsLinearVelocity());
-	return Vel.Y;
+	return GetStateSnapshot().BaseLinearVelocity.Y;
 }
 
 // Gets the AngularVelocity of the Base. 
 const float UMWControllerComponent::GetBaseAngularVelocity()
 {
-	FRotator Rot = Base->GetComponentRotation();
-	FVector Vel = Rot.UnrotateVector(Base->GetPhysicsAngularVelocityInRadians());
-	return Vel.Z;
+	return GetStateSnapshot().BaseAngularVelocity;
 }
@@ -0,0 +1,278 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "MWControllerFleetManager.h"
+#include "MWControllerComponent.h"
+#include "MWControllerInterpolator.h"
+#include "MWControllerWheelHandler.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarMWFleetParallel(
+	TEXT("mw.Fleet.Parallel"),
+	1,
+	TEXT("Interpolates the controllers of a fleet with ParallelFor.\n")
+	TEXT("0: one thread, 1: parallel if the fleet has enough controllers."));
+
+TMap<UWorld*, MWControllerFleetManager*> MWControllerFleetManager::Fleets;
+
+// Ticks the fleet.
+void FMWControllerFleetTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Fleet)
+	{
+		Fleet->Tick(DeltaTime);
+	}
+}
+
+// Name for the tick debugger.
+FString FMWControllerFleetTickFunction::DiagnosticMessage()
+{
+	return TEXT("MWControllerFleetManager::Tick");
+}
+
+// Gets or creates the fleet of a world.
+MWControllerFleetManager* MWControllerFleetManager::Get(UWorld* World, const bool bCreate)
+{
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	if (MWControllerFleetManager** Fleet = Fleets.Find(World))
+	{
+		return *Fleet;
+	}
+
+	if (!bCreate)
+	{
+		return nullptr;
+	}
+
+	static bool bCleanupBound = false;
+	if (!bCleanupBound)
+	{
+		FWorldDelegates::OnWorldCleanup.AddStatic(&MWControllerFleetManager::OnWorldCleanup);
+		bCleanupBound = true;
+	}
+
+	MWControllerFleetManager* NewFleet = new MWControllerFleetManager(World);
+	Fleets.Add(World, NewFleet);
+	return NewFleet;
+}
+
+// Constructor.
+MWControllerFleetManager::MWControllerFleetManager(UWorld* InWorld) : World(InWorld)
+{
+	// Same tick group as the single controllers had.
+	TickFunction.TickGroup = TG_PrePhysics;
+	TickFunction.bCanEverTick = true;
+	TickFunction.bStartWithTickEnabled = true;
+	TickFunction.bTickEvenWhenPaused = false;
+	TickFunction.Fleet = this;
+	TickFunction.RegisterTickFunction(World->PersistentLevel);
+}
+
+// Destructor.
+MWControllerFleetManager::~MWControllerFleetManager()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+	TickFunction.Fleet = nullptr;
+	World = nullptr;
+}
+
+// Deletes the fleet of the world.
+void MWControllerFleetManager::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	MWControllerFleetManager* Fleet = nullptr;
+	if (Fleets.RemoveAndCopyValue(World, Fleet))
+	{
+		delete Fleet;
+	}
+}
+
+// Adds a controller.
+void MWControllerFleetManager::AddController(UMWControllerComponent* Controller)
+{
+	if (!Controller || Controllers.Contains(Controller))
+	{
+		return;
+	}
+
+	Controllers.Add(Controller);
+	Kinematics.AddRobot(Controller->WheelDiameterInCentimeter, Controller->CombinedDistanceValue,
+		Controller->PolarityForAngularMovement, Controller->GetKinematicsType());
+	bOrderDirty = true;
+}
+
+// Removes a controller. The kinematics swap the same way as the list.
+void MWControllerFleetManager::RemoveController(UMWControllerComponent* Controller)
+{
+	const int32 Index = Controllers.Find(Controller);
+	if (Index != INDEX_NONE)
+	{
+		Controllers.RemoveAtSwap(Index, 1, false);
+		Kinematics.RemoveRobot(Index);
+		bOrderDirty = true;
+	}
+}
+
+// Updates the geometry of a controller.
+void MWControllerFleetManager::UpdateController(UMWControllerComponent* Controller)
+{
+	const int32 Index = Controllers.Find(Controller);
+	if (Index != INDEX_NONE)
+	{
+		Kinematics.SetRobot(Index, Controller->WheelDiameterInCentimeter, Controller->CombinedDistanceValue,
+			Controller->PolarityForAngularMovement, Controller->GetKinematicsType());
+	}
+}
+
+// Gets the number of controllers.
+int32 MWControllerFleetManager::Num() const
+{
+	return Controllers.Num();
+}
+
+// Runs the phases of the control cycle.
+void MWControllerFleetManager::Tick(float DeltaTime)
+{
+	if (Controllers.Num() == 0)
+	{
+		return;
+	}
+
+	if (bOrderDirty)
+	{
+		SortControllers();
+	}
+
+	const int32 NumControllers = Controllers.Num();
+	Active.SetNumUninitialized(NumControllers, false);
+	BaseTransforms.SetNumUninitialized(NumControllers, false);
+	TwistX.SetNumUninitialized(NumControllers, false);
+	TwistY.SetNumUninitialized(NumControllers, false);
+	TwistZ.SetNumUninitialized(NumControllers, false);
+	WheelLeftFront.SetNumUninitialized(NumControllers, false);
+	WheelRightFront.SetNumUninitialized(NumControllers, false);
+	WheelLeftRear.SetNumUninitialized(NumControllers, false);
+	WheelRightRear.SetNumUninitialized(NumControllers, false);
+
+	GatherControllers();
+	InterpolateControllers(DeltaTime);
+	SolveKinematics();
+	ApplyControllers();
+	RemoveStoppedControllers();
+}
+
+// Sorts the controllers, the kinematics are rebuilt in the same order.
+void MWControllerFleetManager::SortControllers()
+{
+	Controllers.Sort([](const UMWControllerComponent& A, const UMWControllerComponent& B)
+	{
+		return A.GetPathName() < B.GetPathName();
+	});
+
+	Kinematics.Reset();
+	for (UMWControllerComponent* Controller : Controllers)
+	{
+		Kinematics.AddRobot(Controller->WheelDiameterInCentimeter, Controller->CombinedDistanceValue,
+			Controller->PolarityForAngularMovement, Controller->GetKinematicsType());
+	}
+	bOrderDirty = false;
+}
+
+// Reads everything that is needed from the engine. Runs on the game thread.
+void MWControllerFleetManager::GatherControllers()
+{
+	for (int32 i = 0; i < Controllers.Num(); ++i)
+	{
+		UMWControllerComponent* Controller = Controllers[i];
+		Active[i] = Controller && !Controller->IsPendingKill() && Controller->CanRunControlCycle(false);
+
+		if (Active[i])
+		{
+			BaseTransforms[i] = Controller->Base->GetComponentTransform();
+
+			// Same check as in CanRunControlCycle, from the components that were just checked. The current frame is still simulated.
+			if (!MWControllerWheelHandler::IsDistanceBetweenWheelsValid(Controller->WheelLeftFront->RelativeLocation, Controller->WheelRightFront->RelativeLocation,
+				Controller->WheelLeftRear->RelativeLocation, Controller->WheelRightRear->RelativeLocation))
+			{
+				Controller->StopControlCycleForWheelDistance();
+			}
+
+			// These controllers run in the physics substeps, the fleet only registers them.
+			if (Controller->UsesPhysicsSubstepControl())
+			{
+				Controller->QueueSubstepControlCycle(BaseTransforms[i]);
+				Active[i] = false;
+			}
+		}
+	}
+}
+
+// Only touches the interpolators, so the batches can be split between threads.
+void MWControllerFleetManager::InterpolateControllers(const float DeltaTime)
+{
+	const int32 NumControllers = Controllers.Num();
+	const int32 NumBatches = FMath::DivideAndRoundUp(NumControllers, FLEET_INTERPOLATION_BATCH_SIZE);
+	const bool bSingleThread = CVarMWFleetParallel.GetValueOnGameThread() == 0 || NumControllers < FLEET_PARALLEL_MIN_CONTROLLERS;
+
+	ParallelFor(NumBatches, [this, NumControllers, DeltaTime](int32 BatchIndex)
+	{
+		const int32 First = BatchIndex * FLEET_INTERPOLATION_BATCH_SIZE;
+		const int32 Num = FMath::Min(FLEET_INTERPOLATION_BATCH_SIZE, NumControllers - First);
+
+		// Every slot is written, inactive controllers get the zero twist.
+		for (int32 Index = First; Index < First + Num; ++Index)
+		{
+			MWControllerInterpolator* Interpolator = Active[Index] ? Controllers[Index]->PrepareControlCycle(BaseTransforms[Index], DeltaTime) : nullptr;
+			const FVector Twist = Interpolator ? Interpolator->get_next_twist() : FVector::ZeroVector;
+			TwistX[Index] = Twist.X;
+			TwistY[Index] = Twist.Y;
+			TwistZ[Index] = Twist.Z;
+		}
+	}, bSingleThread);
+}
+
+// One batch for the whole fleet. InterpolateControllers has written the zero twist of the inactive controllers.
+void MWControllerFleetManager::SolveKinematics()
+{
+	Kinematics.SolveInverse(TwistX.GetData(), TwistY.GetData(), TwistZ.GetData(),
+		WheelLeftFront.GetData(), WheelRightFront.GetData(), WheelLeftRear.GetData(), WheelRightRear.GetData());
+}
+
+// All physics writes happen here, after every controller has been calculated.
+void MWControllerFleetManager::ApplyControllers()
+{
+	for (int32 i = 0; i < Controllers.Num(); ++i)
+	{
+		if (Active[i])
+		{
+			UMWControllerComponent* Controller = Controllers[i];
+			Controller->WheelLeftFrontAngularVelocity = WheelLeftFront[i];
+			Controller->WheelRightFrontAngularVelocity = WheelRightFront[i];
+			Controller->WheelLeftRearAngularVelocity = WheelLeftRear[i];
+			Controller->WheelRightRearAngularVelocity = WheelRightRear[i];
+			Controller->ApplyControlCycle(FVector(TwistX[i], TwistY[i], TwistZ[i]), BaseTransforms[i]);
+		}
+	}
+}
+
+// Controllers that failed their checks are not ticked again, same as the disabled TickComponent.
+void MWControllerFleetManager::RemoveStoppedControllers()
+{
+	for (int32 i = Controllers.Num() - 1; i >= 0; --i)
+	{
+		UMWControllerComponent* Controller = Controllers[i];
+		if (!Controller || Controller->IsPendingKill() || Controller->IsControlCycleStopped())
+		{
+			Controllers.RemoveAtSwap(i, 1, false);
+			Kinematics.RemoveRobot(i);
+			bOrderDirty = true;
+		}
+	}
+}
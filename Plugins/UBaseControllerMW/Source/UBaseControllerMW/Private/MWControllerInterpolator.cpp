@@ -2,42 +2,32 @@
 // Author: Patrick Kellmann
 
 #include "MWControllerInterpolator.h"
+#include "RMLClosedFormVelocity.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarMWInterpolatorClosedForm(
+	TEXT("mw.Interpolator.ClosedForm"),
+	1,
+	TEXT("Calculates the twist ramps of the interpolator in closed form instead of with the library.\n")
+	TEXT("0: always use the library, 1: closed form if possible.\n")
+	TEXT("The automation test LibTypeIIRML.ClosedFormVelocity compares both."));
 
 // Constructor.
-MWControllerInterpolator::MWControllerInterpolator(const float CycTimInSec) : RML(NULL), IP(NULL), OP(NULL)
+MWControllerInterpolator::MWControllerInterpolator(const float CycTimInSec) : result(0), CycleTime(CycTimInSec), MaxSubStepTime(0.0), LibraryCycleTime(CycTimInSec), RML(NULL), IP(NULL), OP(NULL),
+	bProfileValid(false), bProfileClosedForm(false), ProfileTime(0.0), ProfileHits(0), ProfileMisses(0)
 {
 
 	RML = new ReflexxesAPI(NUMBER_OF_DOFS, CycTimInSec);
 	IP = new RMLVelocityInputParameters(NUMBER_OF_DOFS);
 	OP = new RMLVelocityOutputParameters(NUMBER_OF_DOFS);
 
-	IP->CurrentPositionVector->VecData[0] = 0.0;
-	IP->CurrentPositionVector->VecData[1] = 0.0;
-	IP->CurrentPositionVector->VecData[2] = 0.0;
-
-	IP->CurrentVelocityVector->VecData[0] = 0.0;
-	IP->CurrentVelocityVector->VecData[1] = 0.0;
-	IP->CurrentVelocityVector->VecData[2] = 0.0;
-
-	IP->CurrentAccelerationVector->VecData[0] = 0.0;
-	IP->CurrentAccelerationVector->VecData[1] = 0.0;
-	IP->CurrentAccelerationVector->VecData[2] = 0.0;
-
-	IP->MaxAccelerationVector->VecData[0] = 2.0;
-	IP->MaxAccelerationVector->VecData[1] = 2.0;
-	IP->MaxAccelerationVector->VecData[2] = 2.0;
+	// Current state and target velocity start with zero.
+	Input.MaxAccelerationVector.Set(2.0);
+	Input.MaxJerkVector.Set(10.0);
+	Input.SelectionVector.Set(true);
 
-	IP->MaxJerkVector->VecData[0] = 10.0;
-	IP->MaxJerkVector->VecData[1] = 10.0;
-	IP->MaxJerkVector->VecData[2] = 10.0;
-
-	IP->TargetVelocityVector->VecData[0] = 0.0;
-	IP->TargetVelocityVector->VecData[1] = 0.0;
-	IP->TargetVelocityVector->VecData[2] = 0.0;
-
-	IP->SelectionVector->VecData[0] = true;
-	IP->SelectionVector->VecData[1] = true;
-	IP->SelectionVector->VecData[2] = true;
+	// The limits and the selection do not change, so they are only copied once.
+	Input.CopyTo(*IP);
 }
 
 // Destructor.
@@ -56,50 +46,159 @@ MWControllerInterpolator::~MWControllerInterpolator()
 // Sets the current transform.
 void MWControllerInterpolator::set_current_pose(double X, double Y, double Theta) 
 {
-	if (IP && RML && OP)
-	{
-		IP->CurrentPositionVector->VecData[0] = X;
-		IP->CurrentPositionVector->VecData[1] = Y;
-		IP->CurrentPositionVector->VecData[2] = Theta;
-	}
+	Input.CurrentPositionVector[0] = X;
+	Input.CurrentPositionVector[1] = Y;
+	Input.CurrentPositionVector[2] = Theta;
 }
 
 // Sets the desired twist.
 void MWControllerInterpolator::set_target_twist(double DX, double DY, double Dtheta) 
 {
-	if (IP && RML && OP)
+	// The same target is sent again with every message, the profile only changes with a new one.
+	if (Input.TargetVelocityVector[0] != DX || Input.TargetVelocityVector[1] != DY || Input.TargetVelocityVector[2] != Dtheta)
 	{
-		IP->TargetVelocityVector->VecData[0] = DX;
-		IP->TargetVelocityVector->VecData[1] = DY;
-		IP->TargetVelocityVector->VecData[2] = Dtheta;
+		Input.TargetVelocityVector[0] = DX;
+		Input.TargetVelocityVector[1] = DY;
+		Input.TargetVelocityVector[2] = Dtheta;
+		bProfileValid = false;
 	}
 }
 
+// Sets the time of the next cycle.
+void MWControllerInterpolator::set_time_step(const double TimeStepInSeconds, const double MaxSubStepInSeconds)
+{
+	CycleTime = TimeStepInSeconds;
+	MaxSubStepTime = MaxSubStepInSeconds;
+}
+
 // Gets the next twist. 
 FVector  MWControllerInterpolator::get_next_twist() 
 {
 	if (IP && RML && OP)
 	{
+		// Long frames are split, so a frame drop does not become one big step.
+		const int32 NumSubSteps = MaxSubStepTime > 0.0 ? FMath::Max(1, FMath::CeilToInt(CycleTime / MaxSubStepTime)) : 1;
+		const double StepTime = CycleTime / NumSubSteps;
+
+		FVector NextTwist = FVector::ZeroVector;
+		for (int32 SubStep = 0; SubStep < NumSubSteps; ++SubStep)
+		{
+			if (!next_state(StepTime))
+			{
+				UE_LOG(LogTemp, Error, TEXT("[%s][%d]. An error occurred (%d)."), TEXT(__FUNCTION__), __LINE__, result);
+				return FVector::ZeroVector;
+			}
+			NextTwist = finish_cycle();
+		}
+		return NextTwist;
+	}
+	return FVector::ZeroVector;
+}
+
+// Calculates the next state of motion.
+bool MWControllerInterpolator::next_state(const double StepTime)
+{
+	// The library is only needed while the twist changes.
+	if (RMLClosedFormVelocity<NUMBER_OF_DOFS>::IsSteady(Input))
+	{
+		bProfileValid = false;
+		result = RMLClosedFormVelocity<NUMBER_OF_DOFS>::EvaluateSteady(Input, Output, StepTime);
+		return true;
+	}
+
+	if (sample_profile(StepTime))
+	{
+		++ProfileHits;
+		return true;
+	}
+
+	++ProfileMisses;
+	return compute_profile(StepTime);
+}
+
+// Calculates the profile from the current state to the target twist.
+bool MWControllerInterpolator::compute_profile(const double StepTime)
+{
+	bProfileValid = false;
+	ProfileStart = Input;
+	ProfileTime = StepTime;
+
+	// Ramps without synchronization do not need the decision trees of the library.
+	bProfileClosedForm = CVarMWInterpolatorClosedForm.GetValueOnAnyThread() > 0 && RMLClosedFormVelocity<NUMBER_OF_DOFS>::CanEvaluate(Input, Flags);
+
+	if (bProfileClosedForm)
+	{
+		result = RMLClosedFormVelocity<NUMBER_OF_DOFS>::Evaluate(ProfileStart, Output, ProfileTime);
+	}
+	else
+	{
+		Input.CopyStateTo(*IP);
 		result = RML->RMLVelocity(*IP, OP, Flags);
 
+		// The library always steps by the cycle time it was created with.
+		if (result >= 0 && StepTime != LibraryCycleTime)
+		{
+			result = RML->RMLVelocityAtAGivenSampleTime(StepTime, OP);
+		}
 		if (result < 0)
 		{
-			UE_LOG(LogTemp, Error, TEXT("[%s][%d]. An error occurred (%d)."), TEXT(__FUNCTION__), __LINE__, result);
-			return FVector::ZeroVector;
+			return false;
 		}
+		Output.CopyFrom(*OP);
+	}
 
-		// Feeds the output values of the current control cycle back to
-		// input values of the next control cycle
-
-		*IP->CurrentPositionVector = *OP->NewPositionVector;
-		*IP->CurrentVelocityVector = *OP->NewVelocityVector;
-		*IP->CurrentAccelerationVector = *OP->NewAccelerationVector;
+	bProfileValid = true;
+	return true;
+}
 
-		double &DX = OP->NewVelocityVector->VecData[0];
-		double &DY = OP->NewVelocityVector->VecData[1];
-		double &Dtheta = OP->NewVelocityVector->VecData[2];
+// Samples the cached profile at the next cycle.
+bool MWControllerInterpolator::sample_profile(const double StepTime)
+{
+	if (!bProfileValid)
+	{
+		return false;
+	}
 
-		return FVector(float(DX), float(DY), float(Dtheta));
+	// Velocity-based profiles do not depend on the position. Only the velocities are used, so the positions of the
+	// profile stay those of its start pose and the measured pose (cm and degree, not the units of the twist) is not compared.
+	const double SampleTime = ProfileTime + StepTime;
+	if (bProfileClosedForm)
+	{
+		result = RMLClosedFormVelocity<NUMBER_OF_DOFS>::Evaluate(ProfileStart, Output, SampleTime);
 	}
-	return FVector::ZeroVector;
+	else
+	{
+		result = RML->RMLVelocityAtAGivenSampleTime(SampleTime, OP);
+		if (result < 0)
+		{
+			return false;
+		}
+		Output.CopyFrom(*OP);
+	}
+	Output.bANewCalculationWasPerformed = false;
+	ProfileTime = SampleTime;
+	return true;
+}
+
+// Gets the number of cycles that sampled the cached profile.
+uint64 MWControllerInterpolator::get_profile_hits() const
+{
+	return ProfileHits;
+}
+
+// Gets the number of cycles that calculated a new profile.
+uint64 MWControllerInterpolator::get_profile_misses() const
+{
+	return ProfileMisses;
+}
+
+// Feeds the output back and gives the new velocity.
+FVector MWControllerInterpolator::finish_cycle()
+{
+	// Feeds the output values of the current control cycle back to
+	// input values of the next control cycle
+	Output.FeedBack(Input);
+
+	const RMLFixedDoubleVector<NUMBER_OF_DOFS>& NewVelocity = Output.NewVelocityVector;
+	return FVector(float(NewVelocity[0]), float(NewVelocity[1]), float(NewVelocity[2]));
 }
@@ -0,0 +1,234 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "MWControllerRegistry.h"
+#include "MWControllerComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+TMap<UWorld*, MWControllerRegistry*> MWControllerRegistry::Registries;
+
+// Gets or creates the registry of a world.
+MWControllerRegistry* MWControllerRegistry::Get(UWorld* World, const bool bCreate)
+{
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	if (MWControllerRegistry** Registry = Registries.Find(World))
+	{
+		return *Registry;
+	}
+
+	if (!bCreate)
+	{
+		return nullptr;
+	}
+
+	static bool bCleanupBound = false;
+	if (!bCleanupBound)
+	{
+		FWorldDelegates::OnWorldCleanup.AddStatic(&MWControllerRegistry::OnWorldCleanup);
+		bCleanupBound = true;
+	}
+
+	MWControllerRegistry* NewRegistry = new MWControllerRegistry(World);
+	Registries.Add(World, NewRegistry);
+	return NewRegistry;
+}
+
+// Constructor.
+MWControllerRegistry::MWControllerRegistry(UWorld* InWorld) : World(InWorld)
+{
+}
+
+// Destructor.
+MWControllerRegistry::~MWControllerRegistry()
+{
+	if (World && ActorSpawnedHandle.IsValid())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+	World = nullptr;
+}
+
+// Deletes the registry of the world.
+void MWControllerRegistry::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	MWControllerRegistry* Registry = nullptr;
+	if (Registries.RemoveAndCopyValue(World, Registry))
+	{
+		delete Registry;
+	}
+}
+
+// Adds a controller.
+void MWControllerRegistry::RegisterController(UMWControllerComponent* Controller)
+{
+	if (!Controller || !Controller->GetOwner())
+	{
+		return;
+	}
+
+	ControllersById.Add(Controller->GetRobotId(), Controller);
+	ControllersByName.FindOrAdd(GetPlainName(Controller->GetOwner())).AddUnique(Controller);
+}
+
+// Removes a controller.
+void MWControllerRegistry::UnregisterController(UMWControllerComponent* Controller)
+{
+	if (!Controller)
+	{
+		return;
+	}
+
+	const TWeakObjectPtr<UMWControllerComponent>* Registered = ControllersById.Find(Controller->GetRobotId());
+	if (Registered && Registered->Get() == Controller)
+	{
+		ControllersById.Remove(Controller->GetRobotId());
+	}
+
+	// The actor can be renamed since the registration, so all names are checked.
+	for (auto It = ControllersByName.CreateIterator(); It; ++It)
+	{
+		It.Value().Remove(Controller);
+		if (It.Value().Num() == 0)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+// Finds a controller by robot id.
+UMWControllerComponent* MWControllerRegistry::FindController(const FString& RobotId) const
+{
+	const TWeakObjectPtr<UMWControllerComponent>* Controller = ControllersById.Find(RobotId);
+	return Controller ? Controller->Get() : nullptr;
+}
+
+// Finds a controller by the name of its actor.
+UMWControllerComponent* MWControllerRegistry::FindControllerByActorName(const FString& ActorName) const
+{
+	if (const TArray<TWeakObjectPtr<UMWControllerComponent>>* Controllers = ControllersByName.Find(ActorName))
+	{
+		for (const TWeakObjectPtr<UMWControllerComponent>& Controller : *Controllers)
+		{
+			if (Controller.IsValid() && Controller->GetOwner())
+			{
+				return Controller.Get();
+			}
+		}
+	}
+
+	// Same as the old search, but only over the robots. "Contains" is used because Unreal changes the name in some cases.
+	for (const TPair<FString, TWeakObjectPtr<UMWControllerComponent>>& Pair : ControllersById)
+	{
+		UMWControllerComponent* Controller = Pair.Value.Get();
+		if (Controller && Controller->GetOwner() && Controller->GetOwner()->GetName().Contains(ActorName))
+		{
+			return Controller;
+		}
+	}
+	return nullptr;
+}
+
+// Finds an actor by its name.
+AActor* MWControllerRegistry::FindActorByName(const FString& Name, const AActor* Near)
+{
+	if (!bActorIndexBuilt)
+	{
+		BuildActorIndex();
+	}
+
+	TArray<AActor*> Candidates;
+	if (const TArray<TWeakObjectPtr<AActor>>* Actors = ActorsByName.Find(Name))
+	{
+		for (const TWeakObjectPtr<AActor>& Actor : *Actors)
+		{
+			// Actors renamed since they were indexed do not count.
+			if (Actor.IsValid() && !Actor->IsPendingKill() && GetPlainName(Actor.Get()) == Name)
+			{
+				Candidates.Add(Actor.Get());
+			}
+		}
+	}
+
+	if (Candidates.Num() == 0)
+	{
+		// Not in the index. "Contains" is used because Unreal changes the name in some cases.
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			if (It->GetName().Contains(Name))
+			{
+				Candidates.Add(*It);
+			}
+		}
+	}
+
+	if (Candidates.Num() <= 1 || !Near)
+	{
+		return Candidates.Num() > 0 ? Candidates[0] : nullptr;
+	}
+
+	// Several robots have wheels with the same names, the ones of this robot are the closest.
+	AActor* Closest = nullptr;
+	float ClosestDistance = MAX_flt;
+	for (AActor* Actor : Candidates)
+	{
+		const float Distance = FVector::DistSquared(Actor->GetActorLocation(), Near->GetActorLocation());
+		if (Distance < ClosestDistance)
+		{
+			Closest = Actor;
+			ClosestDistance = Distance;
+		}
+	}
+	return Closest;
+}
+
+// Gets all controllers.
+void MWControllerRegistry::GetControllers(TArray<UMWControllerComponent*>& OutControllers) const
+{
+	OutControllers.Reset(ControllersById.Num());
+	for (const TPair<FString, TWeakObjectPtr<UMWControllerComponent>>& Pair : ControllersById)
+	{
+		if (UMWControllerComponent* Controller = Pair.Value.Get())
+		{
+			OutControllers.Add(Controller);
+		}
+	}
+}
+
+// Gets the number of controllers.
+int32 MWControllerRegistry::Num() const
+{
+	return ControllersById.Num();
+}
+
+// Indexes the actors of the world.
+void MWControllerRegistry::BuildActorIndex()
+{
+	ActorsByName.Reset();
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		IndexActor(*It);
+	}
+
+	ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateRaw(this, &MWControllerRegistry::IndexActor));
+	bActorIndexBuilt = true;
+}
+
+// Adds an actor to the index.
+void MWControllerRegistry::IndexActor(AActor* Actor)
+{
+	if (Actor)
+	{
+		ActorsByName.FindOrAdd(GetPlainName(Actor)).Add(Actor);
+	}
+}
+
+// Gets the name without number suffix.
+FString MWControllerRegistry::GetPlainName(const AActor* Actor)
+{
+	return Actor->GetFName().GetPlainNameString();
+}
@@ -18,20 +18,22 @@ bool MWControllerWheelHandler::IsDistanceBetweenWheelsValid()
 {
 	if (CheckAllWheels())
 	{
-		const FVector WheelLeftReraPostion = MWConComp->WheelLeftRear->RelativeLocation;
-		const FVector WheelLeftFrontPostion = MWConComp->WheelLeftFront->RelativeLocation;
-		const FVector WheelRightReraPostion = MWConComp->WheelRightRear->RelativeLocation;
-		const FVector WheelRightFrontPostion = MWConComp->WheelRightFront->RelativeLocation;
-
-		const float DistanceBetweenFrontWheels = FVector::Distance(WheelLeftFrontPostion, WheelRightFrontPostion);
-		const float DistanceBetweenReraWheels = FVector::Distance(WheelLeftReraPostion, WheelRightReraPostion);
-
-		// Deviations are tolerated to some degree. 
-		return FMath::IsNearlyEqual(DistanceBetweenFrontWheels, DistanceBetweenReraWheels, DEVIATION_VALUE) ? true : false;
+		return IsDistanceBetweenWheelsValid(MWConComp->WheelLeftFront->RelativeLocation, MWConComp->WheelRightFront->RelativeLocation,
+			MWConComp->WheelLeftRear->RelativeLocation, MWConComp->WheelRightRear->RelativeLocation);
 	}
 	return false;
 }
 
+// Compares the distances of the wheel pairs.
+bool MWControllerWheelHandler::IsDistanceBetweenWheelsValid(const FVector& LeftFront, const FVector& RightFront, const FVector& LeftRear, const FVector& RightRear)
+{
+	const float DistanceBetweenFrontWheels = FVector::Distance(LeftFront, RightFront);
+	const float DistanceBetweenReraWheels = FVector::Distance(LeftRear, RightRear);
+
+	// Deviations are tolerated to some degree. 
+	return FMath::IsNearlyEqual(DistanceBetweenFrontWheels, DistanceBetweenReraWheels, DEVIATION_VALUE);
+}
+
 // Determines the (half) distance between the wheels.  
 TPair<float, float> MWControllerWheelHandler::CalcDistanceBetweenWheels()
 {
@@ -95,7 +97,7 @@ void MWControllerWheelHandler::SetupWheelsMovement(const FVector Velocity)
 	{
 		// For the angular velocity of the wheels.
 		CalcWheelsAngularVelocity(Velocity);
-		RotateWheelsOnAxisY();
+		RotateWheelsOnAxisY(MWConComp->Base->GetComponentQuat());
 	}
 	else
 	{
@@ -108,51 +110,36 @@ void MWControllerWheelHandler::SetupWheelsMovement(const FVector Velocity)
 // Calculates the angular wheel velocity. 
 void MWControllerWheelHandler::CalcWheelsAngularVelocity(const FVector Velocity)
 {
-	// The formula works with meters.
-	float WheelRadius = MWConComp->WheelDiameterInCentimeter / DIAMETER_TO_RADIUS;
-	float CombinedDis = MWConComp->CombinedDistanceValue / SCALE_FACTOR_CM_TO_M;
-
-	// The wheels must be oriented the same way. In addition, they must be turned correctly (drive forward, turn forward, etc.). 
+	// The wheels must be oriented the same way. In addition, they must be turned correctly (drive forward, turn forward, etc.).
 	// Therefore, it may happen that the anular velocity of the wheels requires a polarity (adjustable in the editor).
-	if (MWConComp->MWType == EMWType::MW_O_Type)
-	{
-		MWConComp->WheelLeftFrontAngularVelocity = 1.f / WheelRadius *
-			((Velocity.X + Velocity.Y - (CombinedDis * Velocity.Z * MWConComp->PolarityForAngularMovement))
-				* SCALE_FACTOR_M_TO_CM);
-		MWConComp->WheelLeftRearAngularVelocity = 1.f / WheelRadius *
-			((Velocity.X - Velocity.Y - (CombinedDis * Velocity.Z * MWConComp->PolarityForAngularMovement))
-				* SCALE_FACTOR_M_TO_CM);
-		MWConComp->WheelRightFrontAngularVelocity = 1.f / WheelRadius *
-			((Velocity.X - Velocity.Y + (CombinedDis * Velocity.Z * MWConComp->PolarityForAngularMovement))
-				* SCALE_FACTOR_M_TO_CM);
-		MWConComp->WheelRightRearAngularVelocity = 1.f / WheelRadius *
-			((Velocity.X + Velocity.Y + (CombinedDis * Velocity.Z * MWConComp->PolarityForAngularMovement))
-				* SCALE_FACTOR_M_TO_CM);
-	}
-	else
-	{
-		// X_Type has no angular movement so the formular does not need that part. 
-		MWConComp->WheelLeftFrontAngularVelocity = 1.f / WheelRadius * ((Velocity.X - Velocity.Y)
-			* SCALE_FACTOR_M_TO_CM);
-		MWConComp->WheelLeftRearAngularVelocity = 1.f / WheelRadius * ((Velocity.X + Velocity.Y)
-			* SCALE_FACTOR_M_TO_CM);
-		MWConComp->WheelRightFrontAngularVelocity = 1.f / WheelRadius * ((Velocity.X + Velocity.Y)
-			* SCALE_FACTOR_M_TO_CM);
-		MWConComp->WheelRightRearAngularVelocity = 1.f / WheelRadius * ((Velocity.X - Velocity.Y)
-			* SCALE_FACTOR_M_TO_CM);
-	}
+	// Type, polarity and the distances are already part of the kinematics (see UpdateKinematics).
+	MWConComp->Kinematics.SolveInverse(0, 1, &Velocity.X, &Velocity.Y, &Velocity.Z,
+		&MWConComp->WheelLeftFrontAngularVelocity, &MWConComp->WheelRightFrontAngularVelocity,
+		&MWConComp->WheelLeftRearAngularVelocity, &MWConComp->WheelRightRearAngularVelocity);
 }
 
 // Turn the wheels.
-void MWControllerWheelHandler::RotateWheelsOnAxisY()
+void MWControllerWheelHandler::RotateWheelsOnAxisY(const FQuat& BaseRotation)
 {
 	// The wheels can only rotate freely in one axis.
-	const FRotator Rotation = MWConComp->Base->GetComponentRotation();
-	FVector Direction = FRotationMatrix(Rotation).GetScaledAxis(EAxis::Y);
-
+	const FVector Direction = BaseRotation.GetAxisY();
 
 	MWConComp->WheelLeftFront->SetAllPhysicsAngularVelocityInRadians(Direction * MWConComp->WheelLeftFrontAngularVelocity);
 	MWConComp->WheelRightFront->SetAllPhysicsAngularVelocityInRadians(Direction * MWConComp->WheelRightFrontAngularVelocity);
 	MWConComp->WheelLeftRear->SetAllPhysicsAngularVelocityInRadians(Direction * MWConComp->WheelLeftRearAngularVelocity);
 	MWConComp->WheelRightRear->SetAllPhysicsAngularVelocityInRadians(Direction * MWConComp->WheelRightRearAngularVelocity);
 }
+
+// Turns the wheel bodies.
+void MWControllerWheelHandler::RotateWheelBodiesOnAxisY(const FQuat& BaseRotation, FBodyInstance* const* Bodies, const float* AngularVelocities)
+{
+	const FVector Direction = BaseRotation.GetAxisY();
+
+	for (int32 i = 0; i < 4; ++i)
+	{
+		if (Bodies[i])
+		{
+			Bodies[i]->SetAngularVelocityInRadians(Direction * AngularVelocities[i], false);
+		}
+	}
+}
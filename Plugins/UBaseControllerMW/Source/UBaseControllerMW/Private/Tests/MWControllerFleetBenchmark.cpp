@@ -0,0 +1,218 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/EngineBaseTypes.h"
+#include "MWControllerInterpolator.h"
+#include "MWControllerKinematics.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define FLEET_BENCHMARK_DELTA_TIME (1.f / 60.f)
+#define FLEET_BENCHMARK_TICKS (600)
+#define FLEET_BENCHMARK_TARGET_PERIOD (120)
+
+/*
+* What the control cycle of the robots touches without the physics: one interpolator per robot, the kinematics
+* of every robot on its own (as MWControllerComponent has it) and of all robots together (as the fleet has it).
+*/
+struct FMWFleetBenchmarkRobots
+{
+	TArray<MWControllerInterpolator*> Interpolators;
+	TArray<MWControllerKinematics> RobotKinematics;
+	MWControllerKinematics FleetKinematics;
+	TArray<float> TwistX, TwistY, TwistZ;
+	TArray<float> WheelLeftFront, WheelRightFront, WheelLeftRear, WheelRightRear;
+	int32 NumTicks = 0;
+
+	FMWFleetBenchmarkRobots(const int32 NumRobots)
+	{
+		RobotKinematics.SetNum(NumRobots);
+		for (int32 i = 0; i < NumRobots; ++i)
+		{
+			const EMWKinematicsType Type = i % 2 == 0 ? EMWKinematicsType::O_Type : EMWKinematicsType::X_Type;
+			Interpolators.Add(new MWControllerInterpolator(FLEET_BENCHMARK_DELTA_TIME));
+			RobotKinematics[i].AddRobot(10.f, 40.f, -1.f, Type);
+			FleetKinematics.AddRobot(10.f, 40.f, -1.f, Type);
+		}
+		for (TArray<float>* Values : { &TwistX, &TwistY, &TwistZ, &WheelLeftFront, &WheelRightFront, &WheelLeftRear, &WheelRightRear })
+		{
+			Values->SetNumZeroed(NumRobots);
+		}
+	}
+
+	~FMWFleetBenchmarkRobots()
+	{
+		for (MWControllerInterpolator* Interpolator : Interpolators)
+		{
+			delete Interpolator;
+		}
+	}
+
+	// Interpolator of a robot, with a new target now and then as with ROS commands
+	MWControllerInterpolator* Prepare(const int32 Robot, const float DeltaTime)
+	{
+		const int32 Tick = NumTicks / Interpolators.Num();
+		MWControllerInterpolator* Interpolator = Interpolators[Robot];
+		if (Tick % FLEET_BENCHMARK_TARGET_PERIOD == 0)
+		{
+			const double Direction = (Tick / FLEET_BENCHMARK_TARGET_PERIOD) % 2 == 0 ? 1.0 : -1.0;
+			Interpolator->set_target_twist(Direction * 0.5, Direction * 0.2, Direction * 0.3);
+		}
+		Interpolator->set_time_step(DeltaTime);
+		Interpolator->set_current_pose(0.0, 0.0, 0.0);
+		++NumTicks;
+		return Interpolator;
+	}
+
+	// Control cycle of one robot in its own tick, as UMWControllerComponent::TickComponent
+	void TickRobot(const int32 Robot, const float DeltaTime)
+	{
+		const FVector Twist = Prepare(Robot, DeltaTime)->get_next_twist();
+		RobotKinematics[Robot].SolveInverse(0, 1, &Twist.X, &Twist.Y, &Twist.Z,
+			&WheelLeftFront[Robot], &WheelRightFront[Robot], &WheelLeftRear[Robot], &WheelRightRear[Robot]);
+	}
+
+	// Control cycle of all robots in one tick, as MWControllerFleetManager::Tick
+	void TickFleet(const float DeltaTime)
+	{
+		for (int32 Robot = 0; Robot < Interpolators.Num(); ++Robot)
+		{
+			const FVector Twist = Prepare(Robot, DeltaTime)->get_next_twist();
+			TwistX[Robot] = Twist.X;
+			TwistY[Robot] = Twist.Y;
+			TwistZ[Robot] = Twist.Z;
+		}
+		FleetKinematics.SolveInverse(TwistX.GetData(), TwistY.GetData(), TwistZ.GetData(),
+			WheelLeftFront.GetData(), WheelRightFront.GetData(), WheelLeftRear.GetData(), WheelRightRear.GetData());
+	}
+
+	// Sum of the wheel velocities, so both paths can be compared
+	double GetChecksum() const
+	{
+		double Checksum = 0.0;
+		for (int32 Robot = 0; Robot < Interpolators.Num(); ++Robot)
+		{
+			Checksum += WheelLeftFront[Robot] + WheelRightFront[Robot] + WheelLeftRear[Robot] + WheelRightRear[Robot];
+		}
+		return Checksum;
+	}
+};
+
+/*
+* Tick function of the benchmark. With a robot index it stands for the TickComponent of one controller,
+* with INDEX_NONE for the tick function of the fleet.
+*/
+struct FMWFleetBenchmarkTickFunction : public FTickFunction
+{
+	FMWFleetBenchmarkRobots* Robots = nullptr;
+	int32 Robot = INDEX_NONE;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override
+	{
+		if (Robot == INDEX_NONE)
+		{
+			Robots->TickFleet(DeltaTime);
+		}
+		else
+		{
+			Robots->TickRobot(Robot, DeltaTime);
+		}
+	}
+
+	virtual FString DiagnosticMessage() override
+	{
+		return TEXT("FMWFleetBenchmarkTickFunction");
+	}
+};
+
+// Ticks a world with one tick function per robot or with one for the fleet, returns the seconds per world tick
+static double RunFleetBenchmarkWorld(const int32 NumRobots, const bool bFleet, double& OutChecksum)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	FURL URL;
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	FMWFleetBenchmarkRobots Robots(NumRobots);
+	TArray<FMWFleetBenchmarkTickFunction> TickFunctions;
+	TickFunctions.SetNum(bFleet ? 1 : NumRobots);
+	for (int32 i = 0; i < TickFunctions.Num(); ++i)
+	{
+		FMWFleetBenchmarkTickFunction& TickFunction = TickFunctions[i];
+		TickFunction.TickGroup = TG_PrePhysics;
+		TickFunction.bCanEverTick = true;
+		TickFunction.bStartWithTickEnabled = true;
+		TickFunction.Robots = &Robots;
+		TickFunction.Robot = bFleet ? INDEX_NONE : i;
+		TickFunction.RegisterTickFunction(World->PersistentLevel);
+	}
+
+	const double Start = FPlatformTime::Seconds();
+	for (int32 Tick = 0; Tick < FLEET_BENCHMARK_TICKS; ++Tick)
+	{
+		World->Tick(LEVELTICK_All, FLEET_BENCHMARK_DELTA_TIME);
+	}
+	const double Seconds = FPlatformTime::Seconds() - Start;
+	OutChecksum = Robots.GetChecksum();
+
+	for (FMWFleetBenchmarkTickFunction& TickFunction : TickFunctions)
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return Seconds / FLEET_BENCHMARK_TICKS;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMWControllerFleetBenchmark, "UBaseControllerMW.Benchmark.FleetTick", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Control cycle of many robots in one tick function per controller against the one tick function of the fleet, without the physics.
+// First the control cycle alone, then in world ticks, where the task graph runs every tick function.
+bool FMWControllerFleetBenchmark::RunTest(const FString& Parameters)
+{
+	for (const int32 NumRobots : { 10, 100, 1000 })
+	{
+		double Checksums[2] = { 0.0, 0.0 };
+		double SecondsPerTick[2] = { 0.0, 0.0 };
+		for (const bool bFleet : { false, true })
+		{
+			FMWFleetBenchmarkRobots Robots(NumRobots);
+			const double Start = FPlatformTime::Seconds();
+			for (int32 Tick = 0; Tick < FLEET_BENCHMARK_TICKS; ++Tick)
+			{
+				if (bFleet)
+				{
+					Robots.TickFleet(FLEET_BENCHMARK_DELTA_TIME);
+				}
+				else
+				{
+					for (int32 Robot = 0; Robot < NumRobots; ++Robot)
+					{
+						Robots.TickRobot(Robot, FLEET_BENCHMARK_DELTA_TIME);
+					}
+				}
+			}
+			SecondsPerTick[bFleet] = (FPlatformTime::Seconds() - Start) / FLEET_BENCHMARK_TICKS;
+			Checksums[bFleet] = Robots.GetChecksum();
+		}
+		TestTrue(FString::Printf(TEXT("%d robots: same wheel velocities in both paths"), NumRobots), FMath::IsNearlyEqual(Checksums[0], Checksums[1], 1e-3));
+		AddInfo(FString::Printf(TEXT("%d robots, control cycle only: per component %.1f us, fleet %.1f us per tick (%.2fx)."),
+			NumRobots, SecondsPerTick[0] * 1e6, SecondsPerTick[1] * 1e6, SecondsPerTick[0] / FMath::Max(SecondsPerTick[1], 1e-12)));
+
+		SecondsPerTick[0] = RunFleetBenchmarkWorld(NumRobots, false, Checksums[0]);
+		SecondsPerTick[1] = RunFleetBenchmarkWorld(NumRobots, true, Checksums[1]);
+		TestTrue(FString::Printf(TEXT("%d robots: same wheel velocities in both worlds"), NumRobots), FMath::IsNearlyEqual(Checksums[0], Checksums[1], 1e-3));
+		AddInfo(FString::Printf(TEXT("%d robots, world tick: %d tick functions %.1f us, fleet %.1f us per tick (%.2fx)."),
+			NumRobots, NumRobots, SecondsPerTick[0] * 1e6, SecondsPerTick[1] * 1e6, SecondsPerTick[0] / FMath::Max(SecondsPerTick[1], 1e-12)));
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
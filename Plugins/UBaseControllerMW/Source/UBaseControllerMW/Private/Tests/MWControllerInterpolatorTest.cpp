@@ -0,0 +1,72 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "MWControllerInterpolator.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define INTERPOLATOR_TEST_CYCLE_TIME (0.01)
+#define INTERPOLATOR_TEST_MAX_ACCELERATION (2.0)
+#define INTERPOLATOR_TEST_TOLERANCE (1e-4f)
+
+// Velocity of a ramp from rest with the acceleration limit of the interpolator
+static float GetRampVelocity(const double Target, const double Time)
+{
+	const double Reached = FMath::Min(FMath::Abs(Target), INTERPOLATOR_TEST_MAX_ACCELERATION * Time);
+	return float(Target < 0.0 ? -Reached : Reached);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMWControllerInterpolatorLongFrameTest, "UBaseControllerMW.Interpolator.LongFrame", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// A long frame (frame drop) with MaxSubStepInSeconds must end in the same twist as many short frames of the same time,
+// split into sub-steps of at most MaxSubStepInSeconds, and move on by the real time and not by one cycle.
+bool FMWControllerInterpolatorLongFrameTest::RunTest(const FString& Parameters)
+{
+	// The targets are reached at different times: X not within the frame, Y and Theta in it.
+	const double Target[3] = { 1.5, -0.5, 0.8 };
+
+	for (const double FrameTime : { 0.5, 0.123, 0.005 })
+	{
+		const FString What = FString::Printf(TEXT("Frame of %.3f s"), FrameTime);
+
+		// One long frame, split by the interpolator.
+		MWControllerInterpolator LongFrame(INTERPOLATOR_TEST_CYCLE_TIME);
+		LongFrame.set_target_twist(Target[0], Target[1], Target[2]);
+		LongFrame.set_time_step(FrameTime, INTERPOLATOR_TEST_CYCLE_TIME);
+		const FVector LongFrameTwist = LongFrame.get_next_twist();
+
+		// The same time in frames of the sub-step length.
+		const int32 NumSubSteps = FMath::Max(1, FMath::CeilToInt(FrameTime / INTERPOLATOR_TEST_CYCLE_TIME));
+		MWControllerInterpolator ShortFrames(INTERPOLATOR_TEST_CYCLE_TIME);
+		ShortFrames.set_target_twist(Target[0], Target[1], Target[2]);
+		ShortFrames.set_time_step(FrameTime / NumSubSteps);
+		FVector ShortFramesTwist = FVector::ZeroVector;
+		for (int32 Frame = 0; Frame < NumSubSteps; ++Frame)
+		{
+			ShortFramesTwist = ShortFrames.get_next_twist();
+		}
+
+		const FVector Expected(GetRampVelocity(Target[0], FrameTime), GetRampVelocity(Target[1], FrameTime), GetRampVelocity(Target[2], FrameTime));
+		TestEqual(What + TEXT(": twist after the long frame"), LongFrameTwist, Expected, INTERPOLATOR_TEST_TOLERANCE);
+		TestEqual(What + TEXT(": twist after the short frames"), ShortFramesTwist, Expected, INTERPOLATOR_TEST_TOLERANCE);
+		TestEqual(What + TEXT(": long frame and short frames"), LongFrameTwist, ShortFramesTwist, INTERPOLATOR_TEST_TOLERANCE);
+
+		// One profile for the target, every further sub-step samples it.
+		TestEqual(What + TEXT(": sub-steps of the long frame"), int64(LongFrame.get_profile_hits() + LongFrame.get_profile_misses()), int64(NumSubSteps));
+		TestEqual(What + TEXT(": profiles of the long frame"), int64(LongFrame.get_profile_misses()), int64(1));
+	}
+
+	// Without MaxSubStepInSeconds a long frame is one step, it still moves on by the whole frame.
+	MWControllerInterpolator Unsplit(INTERPOLATOR_TEST_CYCLE_TIME);
+	Unsplit.set_target_twist(Target[0], Target[1], Target[2]);
+	Unsplit.set_time_step(0.5);
+	const FVector UnsplitTwist = Unsplit.get_next_twist();
+	TestEqual(TEXT("Unsplit long frame"), UnsplitTwist, FVector(GetRampVelocity(Target[0], 0.5), GetRampVelocity(Target[1], 0.5), GetRampVelocity(Target[2], 0.5)), INTERPOLATOR_TEST_TOLERANCE);
+	TestEqual(TEXT("Steps of the unsplit long frame"), int64(Unsplit.get_profile_hits() + Unsplit.get_profile_misses()), int64(1));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
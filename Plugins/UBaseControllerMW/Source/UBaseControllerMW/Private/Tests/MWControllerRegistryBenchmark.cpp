@@ -0,0 +1,114 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/TargetPoint.h"
+#include "Kismet/GameplayStatics.h"
+#include "MWControllerRegistry.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define REGISTRY_BENCHMARK_ACTORS (100000)
+#define REGISTRY_BENCHMARK_ROBOTS (100)
+#define REGISTRY_BENCHMARK_ROBOT_DISTANCE (500.f)
+
+// Default names of the wheel actors of UMWControllerComponent.
+static const TCHAR* RegistryBenchmarkWheelNames[] = { TEXT("MWRobotWheelLF"), TEXT("MWRobotWheelRF"), TEXT("MWRobotWheelLR"), TEXT("MWRobotWheelRR") };
+
+// Spawns an actor with a location, named like the actors of a level with several copies of a robot.
+static AActor* SpawnRegistryBenchmarkActor(UWorld* World, const FName Name, const FVector& Location)
+{
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.Name = Name;
+	return World->SpawnActor<ATargetPoint>(ATargetPoint::StaticClass(), Location, FRotator::ZeroRotator, SpawnParameters);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMWControllerRegistryBenchmark, "UBaseControllerMW.Benchmark.Registry", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Startup search of the wheels of all robots in a level with 100k actors: the scan over all actors per robot
+// that AdjustMWControllerComponent did before, against the registry. Checks that the registry finds the wheels of each robot.
+bool FMWControllerRegistryBenchmark::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	// The robots stand in a row, each with its four wheels. FName numbers give the names Unreal gives to copies (MWRobotWheelLF_3).
+	TArray<AActor*> Robots;
+	TArray<AActor*> Wheels;
+	for (int32 Robot = 0; Robot < REGISTRY_BENCHMARK_ROBOTS; ++Robot)
+	{
+		const FVector Location(Robot * REGISTRY_BENCHMARK_ROBOT_DISTANCE, 0.f, 0.f);
+		Robots.Add(SpawnRegistryBenchmarkActor(World, FName(TEXT("MWRobotBase"), Robot + 1), Location));
+		for (const TCHAR* WheelName : RegistryBenchmarkWheelNames)
+		{
+			Wheels.Add(SpawnRegistryBenchmarkActor(World, FName(WheelName, Robot + 1), Location + FVector(30.f, 30.f, 0.f)));
+		}
+	}
+
+	// The rest of the level.
+	for (int32 i = Robots.Num() + Wheels.Num(); i < REGISTRY_BENCHMARK_ACTORS; ++i)
+	{
+		World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+	}
+
+	// Before: every robot scanned all actors for each wheel name.
+	double Start = FPlatformTime::Seconds();
+	int32 ScanFound = 0;
+	for (int32 Robot = 0; Robot < REGISTRY_BENCHMARK_ROBOTS; ++Robot)
+	{
+		TArray<AActor*> HelperActorList;
+		UGameplayStatics::GetAllActorsOfClass(World, AActor::StaticClass(), HelperActorList);
+		for (AActor* Actor : HelperActorList)
+		{
+			for (const TCHAR* WheelName : RegistryBenchmarkWheelNames)
+			{
+				if (Actor->GetName().Contains(WheelName))
+				{
+					++ScanFound;
+					break;
+				}
+			}
+		}
+	}
+	const double ScanSeconds = FPlatformTime::Seconds() - Start;
+
+	// After: the index is built on the first search, then every wheel is one lookup.
+	Start = FPlatformTime::Seconds();
+	MWControllerRegistry* Registry = MWControllerRegistry::Get(World);
+	const int32 NumWheels = (int32)ARRAY_COUNT(RegistryBenchmarkWheelNames);
+	int32 RegistryFound = 0;
+	double IndexSeconds = 0.0;
+	for (int32 Robot = 0; Robot < REGISTRY_BENCHMARK_ROBOTS; ++Robot)
+	{
+		for (int32 Wheel = 0; Wheel < NumWheels; ++Wheel)
+		{
+			if (Registry->FindActorByName(RegistryBenchmarkWheelNames[Wheel], Robots[Robot]) == Wheels[Robot * NumWheels + Wheel])
+			{
+				++RegistryFound;
+			}
+			if (Robot == 0 && Wheel == 0)
+			{
+				IndexSeconds = FPlatformTime::Seconds() - Start;
+			}
+		}
+	}
+	const double RegistrySeconds = FPlatformTime::Seconds() - Start;
+
+	TestEqual(TEXT("Wheels found by the scan"), ScanFound, Wheels.Num() * REGISTRY_BENCHMARK_ROBOTS);
+	TestEqual(TEXT("Wheels of the own robot found by the registry"), RegistryFound, Wheels.Num());
+
+	AddInfo(FString::Printf(TEXT("%d actors, %d robots: scan over all actors %.1f ms, registry %.1f ms (%.1f ms of it to build the index, %.2f us per lookup after)."),
+		World->GetActorCount(), REGISTRY_BENCHMARK_ROBOTS, ScanSeconds * 1e3, RegistrySeconds * 1e3, IndexSeconds * 1e3,
+		(RegistrySeconds - IndexSeconds) / FMath::Max(Wheels.Num() - 1, 1) * 1e6));
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
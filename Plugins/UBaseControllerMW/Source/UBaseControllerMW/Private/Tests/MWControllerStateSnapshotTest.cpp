@@ -0,0 +1,66 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "MWControllerComponent.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Stand-in for the physics: the velocity of the base grows with every physics step
+static float GetStateSnapshotTestVelocity(const uint64 Frame, const ETickingGroup TickGroup)
+{
+	return float(Frame) * 2.f + (FMWControllerStateSnapshot::IsAfterPhysics(TickGroup) ? 1.f : 0.f);
+}
+
+// Same steps as UMWControllerComponent::GetStateSnapshot, the capture reads the stand-in
+static float ReadStateSnapshotTestVelocity(FMWControllerStateSnapshot& Snapshot, const uint64 Frame, const ETickingGroup TickGroup, int32& NumCaptures)
+{
+	if (!Snapshot.IsCurrent(Frame, TickGroup))
+	{
+		Snapshot.SetCaptured(Frame, TickGroup);
+		Snapshot.BaseLinearVelocity.X = GetStateSnapshotTestVelocity(Frame, TickGroup);
+		++NumCaptures;
+	}
+	return Snapshot.BaseLinearVelocity.X;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMWControllerStateSnapshotTest, "UBaseControllerMW.StateSnapshot", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Readers before the physics (controller, fleet) and after it (ROS publishers, data collector) in the same frames
+bool FMWControllerStateSnapshotTest::RunTest(const FString& Parameters)
+{
+	TestFalse(TEXT("TG_PrePhysics is after the physics"), FMWControllerStateSnapshot::IsAfterPhysics(TG_PrePhysics));
+	TestFalse(TEXT("TG_DuringPhysics is after the physics"), FMWControllerStateSnapshot::IsAfterPhysics(TG_DuringPhysics));
+	TestFalse(TEXT("TG_EndPhysics is after the physics"), FMWControllerStateSnapshot::IsAfterPhysics(TG_EndPhysics));
+	TestTrue(TEXT("TG_PostPhysics is after the physics"), FMWControllerStateSnapshot::IsAfterPhysics(TG_PostPhysics));
+	TestTrue(TEXT("TG_PostUpdateWork is after the physics"), FMWControllerStateSnapshot::IsAfterPhysics(TG_PostUpdateWork));
+
+	FMWControllerStateSnapshot Snapshot;
+	TestFalse(TEXT("A new snapshot is current"), Snapshot.IsCurrent(1, TG_PrePhysics));
+
+	int32 NumCaptures = 0;
+	for (uint64 Frame = 1; Frame <= 3; ++Frame)
+	{
+		const float Before = GetStateSnapshotTestVelocity(Frame, TG_PrePhysics);
+		const float After = GetStateSnapshotTestVelocity(Frame, TG_PostPhysics);
+
+		// Two readers before the physics share one capture.
+		TestEqual(FString::Printf(TEXT("Frame %llu, first reader in TG_PrePhysics"), Frame), ReadStateSnapshotTestVelocity(Snapshot, Frame, TG_PrePhysics, NumCaptures), Before);
+		TestEqual(FString::Printf(TEXT("Frame %llu, second reader in TG_PrePhysics"), Frame), ReadStateSnapshotTestVelocity(Snapshot, Frame, TG_PrePhysics, NumCaptures), Before);
+
+		// The publishers after the physics get the new state, not the one captured before the physics.
+		TestEqual(FString::Printf(TEXT("Frame %llu, publisher in TG_PostPhysics"), Frame), ReadStateSnapshotTestVelocity(Snapshot, Frame, TG_PostPhysics, NumCaptures), After);
+		TestEqual(FString::Printf(TEXT("Frame %llu, reader in TG_PostUpdateWork"), Frame), ReadStateSnapshotTestVelocity(Snapshot, Frame, TG_PostUpdateWork, NumCaptures), After);
+	}
+	TestEqual(TEXT("Captures, one before and one after the physics of every frame"), NumCaptures, 6);
+
+	// A frame with only readers after the physics captures once.
+	NumCaptures = 0;
+	TestEqual(TEXT("Frame 4, only a publisher in TG_PostPhysics"), ReadStateSnapshotTestVelocity(Snapshot, 4, TG_PostPhysics, NumCaptures), GetStateSnapshotTestVelocity(4, TG_PostPhysics));
+	TestEqual(TEXT("Frame 4, captures"), NumCaptures, 1);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
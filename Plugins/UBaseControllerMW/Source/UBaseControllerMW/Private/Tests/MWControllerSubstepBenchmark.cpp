@@ -0,0 +1,72 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "MWControllerInterpolator.h"
+#include "MWControllerKinematics.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define SUBSTEP_BENCHMARK_TIME_STEP (0.001)
+#define SUBSTEP_BENCHMARK_STEPS (2000)
+#define SUBSTEP_BENCHMARK_TARGET_PERIOD (500)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMWControllerSubstepBenchmark, "UBaseControllerMW.Benchmark.SubstepControlCycle", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Measures the control cycle of the physics substeps (interpolator and wheel kinematics) without the physics itself.
+// The result is the highest substep rate the control cycle alone allows for a number of robots on one thread.
+bool FMWControllerSubstepBenchmark::RunTest(const FString& Parameters)
+{
+	for (const int32 NumRobots : { 1, 10, 100 })
+	{
+		// Every robot has its own interpolator and kinematics, as in FMWControllerSubstepState.
+		TArray<MWControllerInterpolator*> Interpolators;
+		TArray<MWControllerKinematics> Kinematics;
+		Kinematics.SetNum(NumRobots);
+		for (int32 i = 0; i < NumRobots; ++i)
+		{
+			Interpolators.Add(new MWControllerInterpolator(SUBSTEP_BENCHMARK_TIME_STEP));
+			Kinematics[i].AddRobot(10.f, 40.f, -1.f, i % 2 == 0 ? EMWKinematicsType::O_Type : EMWKinematicsType::X_Type);
+		}
+
+		float Wheels[4] = { 0.f, 0.f, 0.f, 0.f };
+		double Checksum = 0.0;
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Step = 0; Step < SUBSTEP_BENCHMARK_STEPS; ++Step)
+		{
+			// New targets now and then, so the profiles are calculated and sampled like with ROS commands.
+			const bool bNewTarget = Step % SUBSTEP_BENCHMARK_TARGET_PERIOD == 0;
+			const double Direction = (Step / SUBSTEP_BENCHMARK_TARGET_PERIOD) % 2 == 0 ? 1.0 : -1.0;
+
+			for (int32 i = 0; i < NumRobots; ++i)
+			{
+				MWControllerInterpolator* Interpolator = Interpolators[i];
+				if (bNewTarget)
+				{
+					Interpolator->set_target_twist(Direction * 0.5, Direction * 0.2, Direction * 0.3);
+				}
+				Interpolator->set_time_step(SUBSTEP_BENCHMARK_TIME_STEP);
+				Interpolator->set_current_pose(0.0, 0.0, 0.0);
+				const FVector Twist = Interpolator->get_next_twist();
+				Kinematics[i].SolveInverse(0, 1, &Twist.X, &Twist.Y, &Twist.Z, &Wheels[0], &Wheels[1], &Wheels[2], &Wheels[3]);
+				Checksum += Wheels[0];
+			}
+		}
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		const double SecondsPerSubstep = Seconds / SUBSTEP_BENCHMARK_STEPS;
+		AddInfo(FString::Printf(TEXT("%d robots: %.3f us per substep, at most %.0f substeps/s for the control cycle (checksum %f)."),
+			NumRobots, SecondsPerSubstep * 1e6, SecondsPerSubstep > 0.0 ? 1.0 / SecondsPerSubstep : 0.0, Checksum));
+
+		for (MWControllerInterpolator* Interpolator : Interpolators)
+		{
+			delete Interpolator;
+		}
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -29,28 +29,42 @@ public:
 	* Sets the transversal and longitudinal linear velocities as physic velocities.
 	*
 	* @ param DiagonalVelocity Velocity to be set.
+	* @ param BaseRotation Rotation of the base.
 	*/
-	bool SetBaseLinearVelocity(const FVector Velocity);
+	bool SetBaseLinearVelocity(const FVector Velocity, const FQuat& BaseRotation);
 
 	/*
 	* Function sets the Angular Velocity of the RobotBase. This is only possible for O_Type configurations.
 	*
 	* @ param AngularVelocity Velocity to be set.
+	* @ param BaseRotation Rotation of the base.
 	*/
-	bool SetBaseAngularVelocity(const FVector AngularVelocity);
+	bool SetBaseAngularVelocity(const FVector AngularVelocity, const FQuat& BaseRotation);
+
+	/*
+	* Sets the linear and angular velocity directly on the body of the base. Used in the physics substeps, so the component is not touched.
+	*
+	* @ param BaseBody Body of the base.
+	* @ param Twist Linear (x, y) and angular (z) velocity to be set.
+	* @ param BaseRotation Rotation of the base.
+	* @ param bCanRotate false for X_Type robots, they can not rotate.
+	*/
+	void SetBaseBodyVelocity(FBodyInstance& BaseBody, const FVector Twist, const FQuat& BaseRotation, const bool bCanRotate);
 
 private:
 	/*
 	* Function calculates the linear velocity for longitudinal (forward, backward) driving.
 	*
 	* @ param LongitudinalVelocity Velocity to be set.
+	* @ param BaseRotation Rotation of the base.
 	*/
-	FVector CalcLongitudinal(const FVector LongitudinalVelocity);
+	FVector CalcLongitudinal(const FVector LongitudinalVelocity, const FQuat& BaseRotation);
 
 	/*
 	* Function calculates the linear velocity for transverse (lateral) driving.
 	*
 	* @ param TransversalVelocity Velocity to be set.
+	* @ param BaseRotation Rotation of the base.
 	*/
-	FVector CalcTransversal(const FVector TransversalVelocity);
+	FVector CalcTransversal(const FVector TransversalVelocity, const FQuat& BaseRotation);
 };
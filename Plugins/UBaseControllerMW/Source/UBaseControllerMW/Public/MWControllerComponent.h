@@ -8,21 +8,19 @@
 #include "Editor.h"
 #include "Components/ActorComponent.h"
 #include "MWControllerInterpolator.h"
+#include "MWControllerKinematics.h"
 #include "Runtime/Engine/Classes/PhysicsEngine/PhysicsConstraintComponent.h"
 #include "MWControllerComponent.generated.h"
 
 class MWControllerBaseHandler;
 class MWControllerWheelHandler;
 class MWControllerConstraintHandler;
+class UMWControllerComponent;
 
 #define DEVIATION_VALUE			(1.00f)
 #define HALF_DISTANCE_DIVIDER	(2.f)
 #define SCALE_FACTOR_COLLCOMP	(1.05f)
 #define RADIUS_TO_DIAMETER		(2.f)
-#define DIAMETER_TO_RADIUS		(2.f)
-#define WHEEL_NUMBER_DIVIDER	(4.f)
-#define SCALE_FACTOR_M_TO_CM	(100.f)
-#define SCALE_FACTOR_CM_TO_M	(100.f)
 
 
 /*
@@ -35,6 +33,120 @@ enum class EMWType : uint8
 	MW_X_Type	UMETA(DisplayName = "MW_X_Type")
 };
 
+/*
+* State of the robot in one frame. Plain data, so readers can copy it and pass it to other threads.
+*/
+struct FMWControllerStateSnapshot
+{
+	// Frame of the capture (GFrameCounter), 0 if never captured.
+	uint64 FrameNumber = 0;
+
+	// Captured after the physics of the frame, see IsAfterPhysics.
+	bool bAfterPhysics = false;
+
+	// World time of the capture.
+	float TimeSeconds = 0.f;
+
+	// Pose of the base.
+	FTransform BaseTransform = FTransform::Identity;
+
+	// Linear velocity of the base in its own frame (cm/s).
+	FVector BaseLinearVelocity = FVector::ZeroVector;
+
+	// Angular velocity of the base around its Z axis (rad/s).
+	float BaseAngularVelocity = 0.f;
+
+	// Velocities of the wheels along their Y axis.
+	float WheelLeftFront = 0.f;
+	float WheelRightFront = 0.f;
+	float WheelLeftRear = 0.f;
+	float WheelRightRear = 0.f;
+
+	/*
+	* Indicates whether the snapshot was captured in the given frame, on the same side of its physics as the reader.
+	*
+	* @param Frame Current frame (GFrameCounter).
+	* @param TickGroup Tick group of the reader.
+	* @return true if current.
+	*/
+	bool IsCurrent(const uint64 Frame, const ETickingGroup TickGroup) const
+	{
+		return FrameNumber != 0 && FrameNumber == Frame && bAfterPhysics == IsAfterPhysics(TickGroup);
+	}
+
+	/*
+	* Marks the snapshot as captured.
+	*
+	* @param Frame Current frame (GFrameCounter).
+	* @param TickGroup Tick group of the reader.
+	*/
+	void SetCaptured(const uint64 Frame, const ETickingGroup TickGroup)
+	{
+		FrameNumber = Frame;
+		bAfterPhysics = IsAfterPhysics(TickGroup);
+	}
+
+	/*
+	* Indicates whether the physics of the frame has ended in a tick group. The results of the physics are fetched in TG_EndPhysics,
+	* so readers up to TG_EndPhysics get the state before the physics and readers from TG_PostPhysics on the state after it.
+	*
+	* @param TickGroup Tick group of the world that is running.
+	* @return true from TG_PostPhysics on.
+	*/
+	static bool IsAfterPhysics(const ETickingGroup TickGroup)
+	{
+		return TickGroup >= TG_PostPhysics;
+	}
+};
+
+/*
+* State of the control cycle in the physics substeps. Only the physics thread uses it while the physics runs.
+* The game thread writes the inputs before the physics (QueueSubstepControlCycle) and reads the results after it (PublishSubstepResults),
+* so the substeps never share the interpolator, the kinematics or the wheel velocities of the game thread.
+*/
+struct FMWControllerSubstepState
+{
+	// Own interpolator of the substeps.
+	MWControllerInterpolator* Interpolator = nullptr;
+
+	// Copy of the kinematics of the controller.
+	MWControllerKinematics Kinematics;
+
+	// Bodies of the wheels in the order LF, RF, LR, RR. Resolved on the game thread before every physics step,
+	// nullptr for wheels without a valid body. The substeps only use these, never the wheel components.
+	FBodyInstance* WheelBodies[4] = { nullptr, nullptr, nullptr, nullptr };
+
+	// Settings of the controller, copied before every physics step.
+	double MaxSubStepInSeconds = 0.0;
+	bool bUseWheelRotation = true;
+	bool bCanRotate = true;
+
+	// Results of the last substep. The velocities of the wheels in the order LF, RF, LR, RR.
+	FVector Twist = FVector::ZeroVector;
+	float WheelAngularVelocities[4] = { 0.f, 0.f, 0.f, 0.f };
+	bool bHasResults = false;
+};
+
+/*
+* Tick function that publishes the results of the physics substeps to the game thread. Runs in TG_PostPhysics,
+* the first tick group after the physics of the frame ended.
+*/
+struct FMWControllerSubstepPublishTickFunction : public FTickFunction
+{
+	// The controller that is published.
+	UMWControllerComponent* Controller = nullptr;
+
+	/*
+	* Publishes the results of the controller.
+	*/
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	/*
+	* Name of the tick function for the tick debugger.
+	*/
+	virtual FString DiagnosticMessage() override;
+};
+
 // Structur for the constraints (base to wheel).
 USTRUCT()
 struct FConstraintStruct
@@ -110,6 +222,23 @@ protected:
 	*/
 	virtual void DestroyComponent(bool bPromoteChildren) override;
 
+	/*
+	* Called when the game ends. Removes the controller from the fleet.
+	*
+	* @param EndPlayReason Why the game ends.
+	*/
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/*
+	* Adds the controller to the registry of its world, so it can be found before BeginPlay.
+	*/
+	virtual void OnRegister() override;
+
+	/*
+	* Removes the controller from the registry of its world.
+	*/
+	virtual void OnUnregister() override;
+
 
 #if WITH_EDITORONLY_DATA
 
@@ -151,6 +280,96 @@ public:
 	*/
 	bool ReceiveROSMessage(FVector LinVel, FVector AngVel);
 
+	/*
+	* Checks if the simulation conditions are met. If not, the control cycle is stopped (tick or fleet).
+	*
+	* @param bCheckWheelDistance Checks the distance of the wheels. The fleet checks it for all controllers in its gather phase.
+	* @return true if the control cycle can run this frame, otherwise false.
+	*/
+	bool CanRunControlCycle(const bool bCheckWheelDistance = true);
+
+	/*
+	* Stops the control cycle because the distance of the wheels has deviated too far. The current frame is still simulated.
+	*/
+	void StopControlCycleForWheelDistance();
+
+	/*
+	* Gives the pose of the base to the interpolator and gets the next twist.
+	* Only uses the interpolator, so different controllers can be calculated on different threads.
+	*
+	* @param BaseTransform Transform of the base.
+	* @param DeltaTime Time since the last control cycle.
+	* @return Next twist (x, y linear, z angular).
+	*/
+	FVector ComputeControlCycle(const FTransform& BaseTransform, const float DeltaTime);
+
+	/*
+	* Gives the pose of the base to the interpolator. The next twist is then calculated by the caller,
+	* e.g. by the fleet for many controllers.
+	*
+	* @param BaseTransform Transform of the base.
+	* @param DeltaTime Time since the last control cycle. Only used with bUseVariableTimeStep.
+	* @return Interpolator of the controller.
+	*/
+	MWControllerInterpolator* PrepareControlCycle(const FTransform& BaseTransform, const float DeltaTime);
+
+	/*
+	* Writes the twist and the stored angular velocities of the wheels to the physics and moves the actor along.
+	*
+	* @param Twist Twist from ComputeControlCycle.
+	* @param BaseTransform Transform of the base that was used for ComputeControlCycle.
+	*/
+	void ApplyControlCycle(const FVector Twist, const FTransform& BaseTransform);
+
+	/*
+	* Indicates whether the control cycle runs in the physics substeps (bUsePhysicsSubstepControl).
+	*
+	* @return true if the control cycle runs in the physics substeps.
+	*/
+	bool UsesPhysicsSubstepControl() const;
+
+	/*
+	* Registers the control cycle for the physics substeps of this frame. Must be called every frame before the physics.
+	*
+	* @param BaseTransform Transform of the base at the start of the frame.
+	*/
+	void QueueSubstepControlCycle(const FTransform& BaseTransform);
+
+	/*
+	* Copies the results of the physics substeps (wheel velocities) to the controller. Called after the physics of the frame.
+	*/
+	void PublishSubstepResults();
+
+	/*
+	* Indicates whether the control cycle was stopped because of a problem.
+	*
+	* @return true if stopped.
+	*/
+	bool IsControlCycleStopped() const;
+
+	/*
+	* Gets the stable id of the robot. It is made from the path of the owner (without the prefix of play in editor),
+	* so it stays the same between runs of the level.
+	*
+	* @return Id in Base64Url.
+	*/
+	const FString& GetRobotId();
+
+	/*
+	* Getter for the configuration as kinematics type.
+	*
+	* @return O_Type or X_Type.
+	*/
+	EMWKinematicsType GetKinematicsType() const;
+
+	/*
+	* Gets the state of the robot in this frame. The physics is read by the first call before the physics of a frame
+	* (e.g. TG_PrePhysics) and again by the first call after it (TG_PostPhysics and later), all getters below use the snapshot.
+	*
+	* @return Snapshot of the current frame.
+	*/
+	const FMWControllerStateSnapshot& GetStateSnapshot();
+
 	/*
 	* Getter for the Transform of the base.
 	*
@@ -209,11 +428,16 @@ public:
 
 private:
 	/*
-	* Uses the new twist values. Starts turning the wheels and moving the base.
+	* Stops the control cycle. Turns off the tick, the fleet removes the controller after its tick.
+	*/
+	void StopControlCycle();
+
+	/*
+	* Reads the pose and velocities of the base and the wheels from the physics into the snapshot.
 	*
-	* @param MoveCom Vector with the new twist.
+	* @param TickGroup Tick group of the reader.
 	*/
-	void ExecuteCommandMovement(FVector MoveCom);
+	void CaptureStateSnapshot(const ETickingGroup TickGroup);
 
 	/*
 	* Checks the presence of all StaticMeshComponents (base, wheels).
@@ -222,6 +446,20 @@ private:
 	*/
 	bool AllStaticMeshComponentsExist();
 
+	/*
+	* Passes the current geometry (wheel diameter, distances, type, polarity) to the kinematics.
+	* Must be called whenever one of these values changes.
+	*/
+	void UpdateKinematics();
+
+	/*
+	* Runs one control cycle in a physics substep. Only uses SubstepState and the bodies resolved in QueueSubstepControlCycle, not the components.
+	*
+	* @param DeltaTime Time of the substep.
+	* @param BodyInstance Body of the base.
+	*/
+	void SubstepControlCycle(float DeltaTime, FBodyInstance* BodyInstance);
+
 public:
 	// Wheel diameter is calculated.
 	UPROPERTY(EditAnywhere, Category = "MW Details|Data", meta = (ToolTip = "Specification of the diameter of the wheels (average of the four). Can be calculated."))
@@ -310,6 +548,9 @@ public:
 	float WheelLeftRearAngularVelocity = 0.f;
 	float WheelRightRearAngularVelocity = 0.f;
 
+	// Solves the mecanum wheel formulas. Holds only this robot (index 0).
+	MWControllerKinematics Kinematics;
+
 	// Indicates what type the robot is. Standard is O Type
 	UPROPERTY(EditAnywhere, Category = "MW Details", meta = (ToolTip = "Indicates what type the robot is. Standard is O_Type. X_Type can not rotate."))
 		EMWType MWType = EMWType::MW_O_Type;
@@ -323,9 +564,28 @@ public:
 	UPROPERTY(EditAnywhere, Category = "MW Details")
 		float CyleTimeInSeconds = 0.01666f;
 
+	// Moves the interpolator on by the real frame time instead of CyleTimeInSeconds.
+	UPROPERTY(EditAnywhere, Category = "MW Details",
+		meta = (ToolTip = "Moves the interpolation on by the real frame time. The robot keeps its speed in wall time when the fps drop."))
+		bool bUseVariableTimeStep = false;
+
+	// Longest step of the interpolator with bUseVariableTimeStep. Longer frames are split.
+	UPROPERTY(EditAnywhere, Category = "MW Details", meta = (EditCondition = "bUseVariableTimeStep", ClampMin = "0.001"))
+		float MaxSubStepInSeconds = 0.03333f;
+
 	// List for the constraints (base to wheel). 
 	TArray<FConstraintStruct> ConstraintList;
 
+	// Runs the control cycle in the fleet of the world instead of the own tick.
+	UPROPERTY(EditAnywhere, Category = "MW Details",
+		meta = (ToolTip = "Ticks all controllers of the level together (batched interpolation and kinematics). Recommended for many robots."))
+		bool bUseFleetTick = false;
+
+	// Runs the interpolator and the wheel kinematics in every physics substep instead of once per frame.
+	UPROPERTY(EditAnywhere, Category = "MW Details",
+		meta = (ToolTip = "Runs the control cycle in every physics substep (Project Settings > Physics > Substepping). The frame rate can then be lower than the control rate."))
+		bool bUsePhysicsSubstepControl = false;
+
 	// Bool for testing. 
 	UPROPERTY(EditAnywhere, Category = "MW Details",
 		meta = (ToolTip = "For testing. Should be On"))
@@ -347,6 +607,34 @@ private:
 		meta = (ToolTip = "TODO"))
 		bool bUsePhysicsConstrains = true;
 
+	// Indicates whether the control cycle was stopped because of a problem.
+	bool bControlCycleStopped = false;
+
+	// State of the last frame that was read.
+	FMWControllerStateSnapshot StateSnapshot;
+
+	// Id of the robot, made on the first request.
+	FString RobotId;
+
+	// Indicates whether the controller is ticked by the fleet.
+	bool bRegisteredInFleet = false;
+
+	// Calls SubstepControlCycle in the physics substeps.
+	FCalculateCustomPhysics OnCalculateCustomPhysics;
+
+	// Target twist received during the frame. Passed to the interpolator of the substeps before the physics.
+	FVector SubstepTargetTwist = FVector::ZeroVector;
+	bool bSubstepTargetPending = false;
+
+	// State of the physics substeps, see FMWControllerSubstepState.
+	FMWControllerSubstepState SubstepState;
+
+	// The kinematics changed since it was copied to SubstepState.
+	bool bSubstepKinematicsDirty = true;
+
+	// Publishes the results of the substeps after the physics.
+	FMWControllerSubstepPublishTickFunction SubstepPublishTickFunction;
+
 	// Stores the handler for tasks affecting the base.
 	MWControllerBaseHandler* BaseHandler = nullptr;
 
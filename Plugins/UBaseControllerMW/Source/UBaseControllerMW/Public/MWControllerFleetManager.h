@@ -0,0 +1,169 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "MWControllerKinematics.h"
+
+#define FLEET_PARALLEL_MIN_CONTROLLERS	(8)
+#define FLEET_INTERPOLATION_BATCH_SIZE	(16)
+
+class UMWControllerComponent;
+class MWControllerFleetManager;
+
+/*
+* Tick function of the fleet. Runs once per frame in TG_PrePhysics for all registered controllers.
+*/
+struct FMWControllerFleetTickFunction : public FTickFunction
+{
+	// The fleet that is ticked.
+	MWControllerFleetManager* Fleet = nullptr;
+
+	/*
+	* Ticks the fleet.
+	*/
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	/*
+	* Name of the tick function for the tick debugger.
+	*/
+	virtual FString DiagnosticMessage() override;
+};
+
+/**
+ * Runs the control cycle of all MWControllerComponents of a world in one tick instead of one TickComponent per robot.
+ * A tick is split in phases: gather the transforms of the bases, interpolate (can run with ParallelFor across robots),
+ * solve the kinematics of all robots in one batch and finally write all physics velocities in one pass.
+ * There is one fleet per world. It is created when the first controller registers and deleted on world cleanup.
+ * The controllers are always ticked in the order of their paths, so the order does not depend on BeginPlay or removals.
+ */
+class UBASECONTROLLERMW_API MWControllerFleetManager
+{
+public:
+
+	/*
+	* Gets the fleet of a world.
+	*
+	* @param World World of the controllers.
+	* @param bCreate Creates the fleet if the world does not have one yet.
+	* @return The fleet or nullptr.
+	*/
+	static MWControllerFleetManager* Get(UWorld* World, const bool bCreate = true);
+
+	/*
+	* Adds a controller to the fleet. The controller is ticked by the fleet from now on.
+	*
+	* @param Controller Controller to add.
+	*/
+	void AddController(UMWControllerComponent* Controller);
+
+	/*
+	* Removes a controller from the fleet.
+	*
+	* @param Controller Controller to remove.
+	*/
+	void RemoveController(UMWControllerComponent* Controller);
+
+	/*
+	* Passes the changed geometry of a controller to the kinematics of the fleet.
+	*
+	* @param Controller Controller that changed.
+	*/
+	void UpdateController(UMWControllerComponent* Controller);
+
+	/*
+	* Gets the number of controllers in the fleet.
+	*
+	* @return Number of controllers.
+	*/
+	int32 Num() const;
+
+	/*
+	* Runs the control cycle of all controllers.
+	*
+	* @param DeltaTime Time since the last tick.
+	*/
+	void Tick(float DeltaTime);
+
+private:
+
+	/*
+	* Constructor of the fleet. Registers the tick function.
+	*
+	* @param InWorld World of the fleet.
+	*/
+	MWControllerFleetManager(UWorld* InWorld);
+
+	/*
+	* Destructor of the fleet. Unregisters the tick function.
+	*/
+	~MWControllerFleetManager();
+
+	/*
+	* Deletes the fleet of a world that is cleaned up.
+	*/
+	static void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	/*
+	* Sorts the controllers by their path and rebuilds the kinematics in the same order.
+	*/
+	void SortControllers();
+
+	/*
+	* Checks the controllers and reads the transforms of the bases.
+	*/
+	void GatherControllers();
+
+	/*
+	* Gets the next twist of all active controllers. The controllers are split in batches for the interpolator.
+	*
+	* @param DeltaTime Time since the last tick.
+	*/
+	void InterpolateControllers(const float DeltaTime);
+
+	/*
+	* Solves the wheel velocities of all controllers in one batch.
+	*/
+	void SolveKinematics();
+
+	/*
+	* Writes the velocities of the bases and wheels.
+	*/
+	void ApplyControllers();
+
+	/*
+	* Removes the controllers that stopped their control cycle.
+	*/
+	void RemoveStoppedControllers();
+
+	// The fleets of all worlds.
+	static TMap<UWorld*, MWControllerFleetManager*> Fleets;
+
+	// World of the fleet.
+	UWorld* World = nullptr;
+
+	// Ticks the fleet.
+	FMWControllerFleetTickFunction TickFunction;
+
+	// Registered controllers. Same index as in the kinematics.
+	TArray<UMWControllerComponent*> Controllers;
+
+	// Kinematics of all controllers.
+	MWControllerKinematics Kinematics;
+
+	// Controllers were added or removed since the last sort.
+	bool bOrderDirty = false;
+
+	// Data of the current tick. Stays allocated between the ticks.
+	TArray<bool> Active;
+	TArray<FTransform> BaseTransforms;
+	TArray<float> TwistX;
+	TArray<float> TwistY;
+	TArray<float> TwistZ;
+	TArray<float> WheelLeftFront;
+	TArray<float> WheelRightFront;
+	TArray<float> WheelLeftRear;
+	TArray<float> WheelRightRear;
+};
@@ -8,13 +8,17 @@
 #include "RMLVelocityFlags.h"
 #include "RMLVelocityInputParameters.h"
 #include "RMLVelocityOutputParameters.h"
+#include "RMLFixedVelocityParameters.h"
 
 
 #define CYCLE_TIME_IN_SECONDS            0.001
 #define NUMBER_OF_DOFS					 3
 
 /**
- * Defines a class that uses Reflexxes to interpolate in Twist-Space
+ * Defines a class that uses Reflexxes to interpolate in Twist-Space.
+ * Ramps without synchronization are calculated in closed form, the library is only used for the other cases.
+ * A profile is calculated once per target twist and then only sampled every cycle, until the target changes.
+ * Velocity-based profiles do not depend on the position, so the measured pose does not invalidate it.
  */
 class UBASECONTROLLERMW_API MWControllerInterpolator
 {
@@ -52,18 +56,93 @@ public:
 	void set_target_twist(double DX, double DY, double Dtheta);
 
 	/*
-	* Gets the next twist.
+	* Sets the time the next calls of get_next_twist move on. Can change every frame, e.g. to the real DeltaTime.
+	*
+	* @param TimeStepInSeconds Time to move on.
+	* @param MaxSubStepInSeconds Longer time steps are split in sub-steps of at most this length. 0 does not split.
+	*/
+	void set_time_step(const double TimeStepInSeconds, const double MaxSubStepInSeconds = 0.0);
+
+	/*
+	* Gets the next twist. Moves on by the time step of set_time_step (the cycle time of the constructor by default).
 	*
 	* @return FVector with new twist values.
 	*/
 	FVector get_next_twist();
 
+	/*
+	* Gets the number of cycles that only sampled the cached profile.
+	*
+	* @return Number of hits.
+	*/
+	uint64 get_profile_hits() const;
+
+	/*
+	* Gets the number of cycles that had to calculate a new profile.
+	*
+	* @return Number of misses.
+	*/
+	uint64 get_profile_misses() const;
+
 
 private:
 
+	/*
+	* Feeds the output back as next input and converts the new velocity.
+	*
+	* @return FVector with new twist values.
+	*/
+	FVector finish_cycle();
+
+	/*
+	* Calculates the next state of motion into the output.
+	*
+	* @param StepTime Time to move on.
+	* @return false if the library failed.
+	*/
+	bool next_state(const double StepTime);
+
+	/*
+	* Calculates a new profile from the current state and gives its first step.
+	*
+	* @param StepTime Time to move on.
+	* @return false if the library failed.
+	*/
+	bool compute_profile(const double StepTime);
+
+	/*
+	* Samples the cached profile one step further.
+	*
+	* @param StepTime Time to move on.
+	* @return false if there is no valid profile for the current state.
+	*/
+	bool sample_profile(const double StepTime);
+
 	int32 result;
+
+	// Time of the next call of get_next_twist and the longest sub-step.
+	double CycleTime;
+	double MaxSubStepTime;
+
+	// Cycle time the library was created with. Other times are sampled from its profile.
+	const double LibraryCycleTime;
+
 	ReflexxesAPI *RML;
+
+	// Parameters in the layout of the library. Only filled directly before and read directly after RMLVelocity.
 	RMLVelocityInputParameters *IP;
 	RMLVelocityOutputParameters *OP;
 	RMLVelocityFlags Flags;
+
+	// State of the interpolator. Fixed size, so a cycle does not allocate and the state lies in one block.
+	RMLFixedVelocityInputParameters<NUMBER_OF_DOFS> Input;
+	RMLFixedVelocityOutputParameters<NUMBER_OF_DOFS> Output;
+
+	// Cached profile. Closed form profiles are sampled from their start state, the others from the library.
+	bool bProfileValid;
+	bool bProfileClosedForm;
+	double ProfileTime;
+	RMLFixedVelocityInputParameters<NUMBER_OF_DOFS> ProfileStart;
+	uint64 ProfileHits;
+	uint64 ProfileMisses;
 };
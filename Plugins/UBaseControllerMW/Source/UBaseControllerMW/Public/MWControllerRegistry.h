@@ -0,0 +1,141 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class AActor;
+class UWorld;
+class UMWControllerComponent;
+
+/**
+ * Finds the mecanum robots of a world and the actors of their wheels without a search over all actors.
+ * Controllers register themselves when their component is registered, so they can be found before their BeginPlay,
+ * by the stable robot id (UMWControllerComponent::GetRobotId) or by the name of their actor.
+ * Other actors (e.g. the wheels) are indexed by their name without number suffix, once per world and then on spawn.
+ * A name that is not in the index (renamed in the editor, loaded by a streaming level, changed by Unreal) is searched
+ * once with the old "Contains" scan.
+ * There is one registry per world. It is created on first use and deleted on world cleanup.
+ */
+class UBASECONTROLLERMW_API MWControllerRegistry
+{
+public:
+
+	/*
+	* Gets the registry of a world.
+	*
+	* @param World World of the robots.
+	* @param bCreate Creates the registry if the world does not have one yet.
+	* @return The registry or nullptr.
+	*/
+	static MWControllerRegistry* Get(UWorld* World, const bool bCreate = true);
+
+	/*
+	* Adds a controller.
+	*
+	* @param Controller Controller to add.
+	*/
+	void RegisterController(UMWControllerComponent* Controller);
+
+	/*
+	* Removes a controller.
+	*
+	* @param Controller Controller to remove.
+	*/
+	void UnregisterController(UMWControllerComponent* Controller);
+
+	/*
+	* Finds a controller by the id of its robot.
+	*
+	* @param RobotId Id of the robot.
+	* @return The controller or nullptr.
+	*/
+	UMWControllerComponent* FindController(const FString& RobotId) const;
+
+	/*
+	* Finds a controller by the name of its actor. Names with a number suffix (MWRobotBaseActor_2) are found by the plain name.
+	*
+	* @param ActorName Name of the actor of the robot.
+	* @return The controller or nullptr.
+	*/
+	UMWControllerComponent* FindControllerByActorName(const FString& ActorName) const;
+
+	/*
+	* Finds an actor by its name. Names with a number suffix are found by the plain name.
+	*
+	* @param Name Name of the actor.
+	* @param Near If several actors have the name, the one closest to this actor is taken.
+	* @return The actor or nullptr.
+	*/
+	AActor* FindActorByName(const FString& Name, const AActor* Near = nullptr);
+
+	/*
+	* Gets all registered controllers.
+	*
+	* @param OutControllers Receives the controllers.
+	*/
+	void GetControllers(TArray<UMWControllerComponent*>& OutControllers) const;
+
+	/*
+	* Gets the number of registered controllers.
+	*
+	* @return Number of controllers.
+	*/
+	int32 Num() const;
+
+private:
+
+	/*
+	* Constructor of the registry.
+	*
+	* @param InWorld World of the registry.
+	*/
+	MWControllerRegistry(UWorld* InWorld);
+
+	/*
+	* Destructor of the registry. Removes the spawn handler.
+	*/
+	~MWControllerRegistry();
+
+	/*
+	* Deletes the registry of a world that is cleaned up.
+	*/
+	static void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	/*
+	* Indexes all actors of the world and starts to index the spawned ones.
+	*/
+	void BuildActorIndex();
+
+	/*
+	* Adds an actor to the index.
+	*
+	* @param Actor Actor to add.
+	*/
+	void IndexActor(AActor* Actor);
+
+	/*
+	* Gets the name of an actor without number suffix, the key of the indices.
+	*
+	* @param Actor Actor.
+	* @return Plain name.
+	*/
+	static FString GetPlainName(const AActor* Actor);
+
+	// The registries of all worlds.
+	static TMap<UWorld*, MWControllerRegistry*> Registries;
+
+	// World of the registry.
+	UWorld* World = nullptr;
+
+	// Controllers by robot id and by the plain name of their actor.
+	TMap<FString, TWeakObjectPtr<UMWControllerComponent>> ControllersById;
+	TMap<FString, TArray<TWeakObjectPtr<UMWControllerComponent>>> ControllersByName;
+
+	// Actors by their plain name. Built on the first search.
+	TMap<FString, TArray<TWeakObjectPtr<AActor>>> ActorsByName;
+	bool bActorIndexBuilt = false;
+	FDelegateHandle ActorSpawnedHandle;
+};
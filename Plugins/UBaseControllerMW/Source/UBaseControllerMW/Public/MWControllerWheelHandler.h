@@ -33,6 +33,17 @@ public:
 	*/
 	bool IsDistanceBetweenWheelsValid();
 
+	/*
+	* Compares the distance of the front wheels with the distance of the rear wheels. This must not deviate too far due to the mathematical formulas.
+	*
+	* @param LeftFront Relative location of the wheel.
+	* @param RightFront Relative location of the wheel.
+	* @param LeftRear Relative location of the wheel.
+	* @param RightRear Relative location of the wheel.
+	* @return true if distance is correct, otherwise false.
+	*/
+	static bool IsDistanceBetweenWheelsValid(const FVector& LeftFront, const FVector& RightFront, const FVector& LeftRear, const FVector& RightRear);
+
 	/*
 	* Calculates the distance between the wheels.
 	*
@@ -54,10 +65,6 @@ public:
 	*/
 	void SetupWheelsMovement(const FVector Velocity);
 
-	
-
-private:
-
 	/*
 	* Calculates the angular speed of the wheels.
 	*
@@ -66,9 +73,19 @@ private:
 	void CalcWheelsAngularVelocity(const FVector Velocity);
 
 	/*
-	* Calculates the turning of the wheels.
+	* Turns the wheels with the stored angular velocities.
+	*
+	* @param BaseRotation Rotation of the base.
+	*/
+	void RotateWheelsOnAxisY(const FQuat& BaseRotation);
+
+	/*
+	* Turns the wheels directly on their bodies. Used in the physics substeps, so neither the components nor the stored angular velocities are touched.
 	*
+	* @param BaseRotation Rotation of the base.
+	* @param Bodies Bodies of the wheels in the order LF, RF, LR, RR. Entries can be nullptr, they are skipped.
+	* @param AngularVelocities Angular velocities of the wheels in the same order.
 	*/
-	void RotateWheelsOnAxisY();
+	static void RotateWheelBodiesOnAxisY(const FQuat& BaseRotation, FBodyInstance* const* Bodies, const float* AngularVelocities);
 
 };
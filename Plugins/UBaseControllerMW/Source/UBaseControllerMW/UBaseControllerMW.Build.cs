@@ -34,6 +34,7 @@ public class UBaseControllerMW : ModuleRules
             {
                 "Core",
                 "LibTypeIIRML",
+                "UBaseControllerMWKinematics",
 				// ... add other public dependencies that you statically link with here ...
 			}
             );
@@ -47,7 +48,8 @@ public class UBaseControllerMW : ModuleRules
                 "Engine",
                 "UnrealEd",
                 "Slate",
-                "SlateCore",              
+                "SlateCore",
+                "UIds",
 				// ... add private dependencies that you statically link with here ...	
 			}
             );
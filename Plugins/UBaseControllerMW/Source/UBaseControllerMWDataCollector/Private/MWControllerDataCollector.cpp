@@ -2,7 +2,6 @@
 // Author: Patrick Kellmann
 
 #include "MWControllerDataCollector.h"
-#include "Misc/DateTime.h"
 
 // Sets default values for this component's properties
 UMWControllerDataCollector::UMWControllerDataCollector()
@@ -27,9 +26,16 @@ void UMWControllerDataCollector::DestroyComponent(bool bPromoteChildren)
 	MWConComp = nullptr;
 	PlatformFile = nullptr;
 
-	if (FileHandle)
+	if (Writer)
+	{
+		delete Writer;
+		Writer = nullptr;
+		FileHandle = nullptr;
+	}
+	else if (FileHandle)
 	{
 		delete FileHandle;
+		FileHandle = nullptr;
 	}
 }
 
@@ -90,110 +96,251 @@ void UMWControllerDataCollector::TickComponent(float DeltaTime, ELevelTick TickT
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	// If MWController no longer ticks or has been destroyed in any way, data should no longer be written to the file.
-	if (!MWConComp || !MWConComp->IsValidLowLevel() || !MWConComp->IsComponentTickEnabled() || MWConComp->IsBeingDestroyed())
+	// If MWController no longer runs or has been destroyed in any way, data should no longer be written to the file.
+	// The own tick of the controller is off when the fleet ticks it, so the control cycle is checked.
+	if (!MWConComp || !MWConComp->IsValidLowLevel() || MWConComp->IsControlCycleStopped() || MWConComp->IsBeingDestroyed())
 	{
+		// The samples before the stop are the interesting ones.
+		if (Writer)
+		{
+			TriggerCapture(TEXT("MWController stopped"));
+		}
+
 		this->SetComponentTickEnabled(false);
 		UE_LOG(LogTemp, Error,
 			TEXT("[%s][%d] No MWController was found or it is turn off. Tick of UMWControllerDataCollector will be turn off."),
 			TEXT(__FUNCTION__), __LINE__);
 
 	}
-	else
+	else if (!Writer)
 	{
-		if (!WriteInLine())
-		{
-			UE_LOG(LogTemp, Error,
-				TEXT("[%s][%d] File %s do not exists. Tick of UMWControllerDataCollector will be turn off."),
-				TEXT(__FUNCTION__), __LINE__, *FilePath);
-
-			this->SetComponentTickEnabled(false);
-		}
+		UE_LOG(LogTemp, Error,
+			TEXT("[%s][%d] File %s was not created. Tick of UMWControllerDataCollector will be turn off."),
+			TEXT(__FUNCTION__), __LINE__, *FilePath);
 
+		this->SetComponentTickEnabled(false);
+	}
+	else
+	{
+		// A full buffer only drops this sample, the writer catches up on its own.
+		WriteInLine();
 	}
 }
 
 //Creates a folder structure for files /Project/DataCollection/DAY
 bool UMWControllerDataCollector::CreateDataDir()
 {
-	const FDateTime Date = FDateTime::Now();
+	return MWControllerDataLog::CreateDataDir(DataDir);
+}
+
+//Creates .csv or .mwlog file and defines the data fields. 
+bool UMWControllerDataCollector::CreateFile()
+{
+	const bool bBinary = DataFormat == EMWDataFormat::Binary;
 
-	DataDir = FPaths::ProjectDir()
-		+ "DataCollection/"
-		+ FString::FromInt(Date.GetYear())
-		+ "." + FString::FromInt(Date.GetMonth())
-		+ "." + FString::FromInt(Date.GetDay());
+	// Robots that start in the same second still get their own files.
+	FilePath = MWControllerDataLog::GetUniqueFilePath(DataDir, TEXT("MW_Data_") + MWRobotBaseActor->GetName(), bBinary ? TEXT("mwlog") : TEXT("csv"));
 
-	//Creates DataCollection folder if missing.
-	if (!PlatformFile->DirectoryExists(*FString(FPaths::ProjectDir() + "DataCollection/")))
+	TArray<uint8> Header;
+	if (bBinary)
+	{
+		TArray<FString> ChannelNames = MWControllerDataLog::GetBaseChannelNames();
+		ChannelNames.Append(ExtraChannelNames);
+		MWControllerDataLog::WriteHeader(ChannelNames, Header);
+	}
+	else
 	{
-		PlatformFile->CreateDirectory(*FString(FPaths::ProjectDir() + "DataCollection/"));
+		const FString FirstLine = MWControllerDataLog::GetCsvHeader(ExtraChannelNames);
+		Header.Append((const uint8*)TCHAR_TO_ANSI(*FirstLine), FirstLine.Len());
 	}
 
-	//Creates folder for .csv files with date reference.
-	if (!PlatformFile->DirectoryExists(*DataDir))
+	FileHandle = FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*FilePath, true);
+
+	if (!FileHandle || !FileHandle->Write(Header.GetData(), Header.Num()))
 	{
-		PlatformFile->CreateDirectory(*DataDir);
+		return false;
 	}
 
-	return PlatformFile->DirectoryExists(*DataDir);
+	InitChannelSettings();
+
+	// The writer owns the file from now on.
+	Writer = new MWControllerDataWriter(FileHandle, BufferCapacity, EMWDataChannel::Num + ExtraChannelNames.Num(), bBinary);
+
+	FMWDataLogStream StreamInfo;
+	StreamInfo.Id = MWConComp->GetRobotId();
+	StreamInfo.Name = MWRobotBaseActor->GetName();
+	Stream = Writer->AddStream(StreamInfo);
+	return true;
 }
 
-//Creates .csv file and defines the data fields. 
-bool UMWControllerDataCollector::CreateFile()
+// Passes a new line to the writer.
+bool UMWControllerDataCollector::WriteInLine()
 {
-	const FDateTime Time = FDateTime::Now();
-	FilePath = DataDir + "/"
-		+ "MW_Data_" + FString::FromInt(Time.GetHour())
-		+ "_" + FString::FromInt(Time.GetMinute())
-		+ TEXT(".csv");
+	FMWControllerDataSample Sample;
+	ReadSample(Sample);
 
-		FString FirstLine = (FString("Time(BeginPlay); MW_Longitudinal_Velocity; MW_Transversal_Velocity; MW_Angular_Velocity; MW_Wheel_Left_Front(rad/s); MW_Wheel_Right_Front(rad/s); MW_Wheel_Left_Rear(rad/s); MW_Wheel_RightRear(rad/s); \n"));
-		FileHandle = FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*FilePath, true);
+	const bool bTrigger = RecordingMode == EMWRecordingMode::Trigger && CheckTrigger(Sample);
+	const bool bRecorded = Recorder.Add(Sample, [this](const FMWControllerDataSample& Recorded) { return Writer->Push(Recorded); });
 
-		return FileHandle->Write((const uint8*)TCHAR_TO_ANSI(*FirstLine), FirstLine.Len());
+	if (bTrigger)
+	{
+		TriggerCapture(TEXT("wheel speed divergence"));
+	}
+	return bRecorded;
 }
 
-// Writes a new line.
-bool UMWControllerDataCollector::WriteInLine()
+// Reads the current values.
+void UMWControllerDataCollector::ReadSample(FMWControllerDataSample& Sample)
 {
-	if (PlatformFile->FileExists(*FilePath))
-	{
-		//FJsonSerializableArray NextLine;
-		FString NextLine;
+	//Uses time format to synchronize with data.
+	ReadBaseChannels(MWConComp, this->GetWorld()->GetTimeSeconds(), Sample);
+	Sample.Stream = Stream;
 
-		//Uses time format to synchronize with data.
-		float BeginTime = this->GetWorld()->GetTimeSeconds();
-		FString TimeStamp = FString::SanitizeFloat(BeginTime);
+	FMemory::Memcpy(&Sample.Values[EMWDataChannel::Num], ExtraChannelValues, ExtraChannelNames.Num() * sizeof(float));
+}
 
-		const FString Wheel1 = FString::SanitizeFloat(MWConComp->GetWheelLeftFrontAngularVelocity());
-		const FString Wheel2 = FString::SanitizeFloat(MWConComp->GetWheelRightFrontAngularVelocity());
-		const FString Wheel3 = FString::SanitizeFloat(MWConComp->GetWheelLeftRearAngularVelocity());
-		const FString Wheel4 = FString::SanitizeFloat(MWConComp->GetWheelRightRearAngularVelocity());
+// Reads the base channels.
+void UMWControllerDataCollector::ReadBaseChannels(UMWControllerComponent* Controller, const float Time, FMWControllerDataSample& Sample)
+{
+	// One read of the physics for all channels.
+	const FMWControllerStateSnapshot& State = Controller->GetStateSnapshot();
 
-		// Conversion from cm to meter
-		const FString MWLongVel = FString::SanitizeFloat(MWConComp->GetBaseLongitudinalVelocity() / SCALE_FACTOR_CM_TO_M);
-		const FString MWTransVel = FString::SanitizeFloat(MWConComp->GetBaseTransversalVelocity() / SCALE_FACTOR_CM_TO_M);
+	float* const Values = Sample.Values;
+	Values[EMWDataChannel::Time] = Time;
 
-		// rad/s
-		const FString MWAngVel = FString::SanitizeFloat(MWConComp->GetBaseAngularVelocity());
+	Values[EMWDataChannel::WheelLeftFront] = State.WheelLeftFront;
+	Values[EMWDataChannel::WheelRightFront] = State.WheelRightFront;
+	Values[EMWDataChannel::WheelLeftRear] = State.WheelLeftRear;
+	Values[EMWDataChannel::WheelRightRear] = State.WheelRightRear;
 
-		NextLine = (FString(TimeStamp + ";" + MWLongVel + ";" + MWTransVel + ";" + MWAngVel + ";" + Wheel1 + ";"
-			+ Wheel2 + ";" + Wheel3 + ";" + Wheel4 + "\n").Replace(TEXT("."), TEXT(","), ESearchCase::IgnoreCase));
+	// Conversion from cm to meter
+	Values[EMWDataChannel::LongitudinalVelocity] = State.BaseLinearVelocity.X / SCALE_FACTOR_CM_TO_M;
+	Values[EMWDataChannel::TransversalVelocity] = State.BaseLinearVelocity.Y / SCALE_FACTOR_CM_TO_M;
 
-		// Writes in file.
-		return FileHandle->Write((const uint8*)TCHAR_TO_ANSI(*NextLine), NextLine.Len());
+	// rad/s
+	Values[EMWDataChannel::AngularVelocity] = State.BaseAngularVelocity;
+}
+
+// Resolves the channel settings.
+void UMWControllerDataCollector::InitChannelSettings()
+{
+	TArray<FString> ChannelNames = MWControllerDataLog::GetBaseChannelNames();
+	ChannelNames.Append(ExtraChannelNames);
+
+	float Intervals[EMWDataChannel::Num + DATA_MAX_EXTRA_CHANNELS];
+	float Deadbands[EMWDataChannel::Num + DATA_MAX_EXTRA_CHANNELS];
+	for (int32 i = 0; i < ChannelNames.Num(); ++i)
+	{
+		const FMWDataChannelSettings* Settings = ChannelSettings.Find(ChannelNames[i]);
+		Intervals[i] = Settings && Settings->SampleRateInHz > 0.f ? 1.f / Settings->SampleRateInHz : 0.f;
+		Deadbands[i] = Settings ? Settings->Deadband : 0.f;
+	}
+
+	for (const TPair<FString, FMWDataChannelSettings>& Pair : ChannelSettings)
+	{
+		if (!ChannelNames.Contains(Pair.Key))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[%s][%d] Channel %s of the settings does not exist."), TEXT(__FUNCTION__), __LINE__, *Pair.Key);
+		}
+	}
+
+	Recorder.Init(ChannelNames.Num(), Intervals, Deadbands, bRecordOnlyChanges,
+		RecordingMode == EMWRecordingMode::Trigger, PreTriggerSamples, PostTriggerSamples);
+}
+
+// Checks the trigger conditions.
+bool UMWControllerDataCollector::CheckTrigger(const FMWControllerDataSample& Sample) const
+{
+	if (WheelDivergenceThreshold <= 0.f)
+	{
+		return false;
+	}
+
+	const float* const Wheels = &Sample.Values[EMWDataChannel::WheelLeftFront];
+	const float Mean = 0.25f * (Wheels[0] + Wheels[1] + Wheels[2] + Wheels[3]);
+
+	for (int32 i = 0; i < 4; ++i)
+	{
+		if (FMath::Abs(Wheels[i] - Mean) > WheelDivergenceThreshold)
+		{
+			return true;
+		}
 	}
 	return false;
 }
 
+// Starts a capture.
+void UMWControllerDataCollector::TriggerCapture(const TCHAR* Reason)
+{
+	if (!Writer || RecordingMode != EMWRecordingMode::Trigger)
+	{
+		return;
+	}
+
+	// A trigger during a capture only extends it.
+	const int32 NumSamples = Recorder.GetNumPreTriggerSamples() + PostTriggerSamples;
+	if (Recorder.Trigger([this](const FMWControllerDataSample& Recorded) { return Writer->Push(Recorded); }))
+	{
+		UE_LOG(LogTemp, Log, TEXT("[%s][%d] Trigger (%s), %d samples are written to %s."),
+			TEXT(__FUNCTION__), __LINE__, Reason, NumSamples, *FilePath);
+	}
+}
+
+// Gets the number of triggers.
+int32 UMWControllerDataCollector::GetNumTriggers() const
+{
+	return Recorder.GetNumTriggers();
+}
+
+// Adds an extra channel.
+int32 UMWControllerDataCollector::RegisterChannel(const FString& Name)
+{
+	if (Writer || ExtraChannelNames.Num() >= DATA_MAX_EXTRA_CHANNELS)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[%s][%d] Channel %s can not be added (file already created or more than %d channels)."),
+			TEXT(__FUNCTION__), __LINE__, *Name, DATA_MAX_EXTRA_CHANNELS);
+		return INDEX_NONE;
+	}
+
+	ExtraChannelValues[ExtraChannelNames.Num()] = 0.f;
+	return ExtraChannelNames.Add(Name);
+}
+
+// Sets the value of an extra channel.
+void UMWControllerDataCollector::SetChannelValue(const int32 Channel, const float Value)
+{
+	if (ExtraChannelNames.IsValidIndex(Channel))
+	{
+		ExtraChannelValues[Channel] = Value;
+	}
+}
+
+// Gets the dropped samples.
+int64 UMWControllerDataCollector::GetDroppedSamples() const
+{
+	return Writer ? Writer->GetDroppedSamples() : 0;
+}
+
 // Deletes FileHandle so that the file is released.
 void UMWControllerDataCollector::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
 
-	if (FileHandle)
+	// Writes the remaining samples and closes the file.
+	if (Writer)
+	{
+		if (Writer->GetDroppedSamples() > 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[%s][%d] %lld samples were dropped for %s, the writer could not keep up."),
+				TEXT(__FUNCTION__), __LINE__, Writer->GetDroppedSamples(), *FilePath);
+		}
+		delete Writer;
+		Writer = nullptr;
+		FileHandle = nullptr;
+	}
+	else if (FileHandle)
 	{
 		delete FileHandle;
+		FileHandle = nullptr;
 	}
 }
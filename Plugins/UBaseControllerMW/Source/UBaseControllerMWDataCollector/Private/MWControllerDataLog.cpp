@@ -0,0 +1,475 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "MWControllerDataLog.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+// Appends a value in little endian.
+template <typename T>
+static void AppendRaw(TArray<uint8>& Out, const T Value)
+{
+	const int32 Offset = Out.AddUninitialized(sizeof(T));
+	FMemory::Memcpy(Out.GetData() + Offset, &Value, sizeof(T));
+}
+
+// Reads a value in little endian, moves the offset on.
+template <typename T>
+static bool ReadRaw(const uint8* Data, const int64 Size, int64& Offset, T& Value)
+{
+	if (Offset < 0 || Offset + int64(sizeof(T)) > Size)
+	{
+		return false;
+	}
+	FMemory::Memcpy(&Value, Data + Offset, sizeof(T));
+	Offset += sizeof(T);
+	return true;
+}
+
+// Appends a string with uint16 length in UTF-8.
+static void AppendString(TArray<uint8>& Out, const FString& Text)
+{
+	const FTCHARToUTF8 Utf8Text(*Text);
+	AppendRaw<uint16>(Out, uint16(Utf8Text.Length()));
+	Out.Append((const uint8*)Utf8Text.Get(), Utf8Text.Length());
+}
+
+// Reads a string with uint16 length in UTF-8, moves the offset on.
+static bool ReadString(const uint8* Data, const int64 Size, int64& Offset, FString& Text)
+{
+	uint16 Length = 0;
+	if (!ReadRaw(Data, Size, Offset, Length) || Offset + Length > Size)
+	{
+		return false;
+	}
+	const FUTF8ToTCHAR Converted((const ANSICHAR*)Data + Offset, Length);
+	Text = FString(Converted.Length(), Converted.Get());
+	Offset += Length;
+	return true;
+}
+
+// Gets the names of the base channels.
+const TArray<FString>& MWControllerDataLog::GetBaseChannelNames()
+{
+	static const TArray<FString> Names = {
+		TEXT("Time"),
+		TEXT("LongitudinalVelocity"),
+		TEXT("TransversalVelocity"),
+		TEXT("AngularVelocity"),
+		TEXT("WheelLeftFront"),
+		TEXT("WheelRightFront"),
+		TEXT("WheelLeftRear"),
+		TEXT("WheelRightRear")
+	};
+	return Names;
+}
+
+// Creates the folder of today.
+bool MWControllerDataLog::CreateDataDir(FString& OutDataDir)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FDateTime Date = FDateTime::Now();
+
+	OutDataDir = FPaths::ProjectDir()
+		+ "DataCollection/"
+		+ FString::FromInt(Date.GetYear())
+		+ "." + FString::FromInt(Date.GetMonth())
+		+ "." + FString::FromInt(Date.GetDay());
+
+	return PlatformFile.CreateDirectoryTree(*OutDataDir);
+}
+
+// Gets a path that no file has yet.
+FString MWControllerDataLog::GetUniqueFilePath(const FString& DataDir, const FString& BaseName, const FString& Extension)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString Stem = DataDir + TEXT("/") + BaseName + TEXT("_") + FDateTime::Now().ToString(TEXT("%H_%M_%S"));
+
+	FString FilePath = Stem + TEXT(".") + Extension;
+	for (int32 Suffix = 1; PlatformFile.FileExists(*FilePath); ++Suffix)
+	{
+		FilePath = FString::Printf(TEXT("%s_%d.%s"), *Stem, Suffix, *Extension);
+	}
+	return FilePath;
+}
+
+// Writes the header.
+void MWControllerDataLog::WriteHeader(const TArray<FString>& ChannelNames, TArray<uint8>& Out)
+{
+	AppendRaw<uint32>(Out, DATA_LOG_MAGIC);
+	AppendRaw<uint16>(Out, DATA_LOG_VERSION);
+	AppendRaw<uint16>(Out, uint16(ChannelNames.Num()));
+
+	for (const FString& Name : ChannelNames)
+	{
+		AppendString(Out, Name);
+	}
+}
+
+// Compresses a column.
+void MWControllerDataLog::EncodeColumn(const float* Values, const int32 Num, TArray<uint8>& Out)
+{
+	uint32 Previous = 0;
+	for (int32 i = 0; i < Num; ++i)
+	{
+		uint32 Bits;
+		FMemory::Memcpy(&Bits, &Values[i], sizeof(Bits));
+		const uint32 Xor = Bits ^ Previous;
+		Previous = Bits;
+
+		if (Xor == 0)
+		{
+			Out.Add(4 << 4);
+			continue;
+		}
+
+		const uint32 Leading = FMath::CountLeadingZeros(Xor) / 8;
+		const uint32 Trailing = FMath::CountTrailingZeros(Xor) / 8;
+		Out.Add(uint8((Leading << 4) | Trailing));
+
+		for (uint32 Byte = Trailing; Byte < 4 - Leading; ++Byte)
+		{
+			Out.Add(uint8(Xor >> (Byte * 8)));
+		}
+	}
+}
+
+// Decompresses a column.
+bool MWControllerDataLog::DecodeColumn(const uint8* Data, const int32 Size, const int32 Num, float* Values)
+{
+	uint32 Previous = 0;
+	int32 Offset = 0;
+
+	for (int32 i = 0; i < Num; ++i)
+	{
+		if (Offset >= Size)
+		{
+			return false;
+		}
+
+		const uint32 Leading = Data[Offset] >> 4;
+		const uint32 Trailing = Data[Offset] & 0x0F;
+		++Offset;
+
+		if (Leading + Trailing > 4 || Offset + int32(4 - Leading - Trailing) > Size)
+		{
+			return false;
+		}
+
+		uint32 Xor = 0;
+		for (uint32 Byte = Trailing; Byte < 4 - Leading; ++Byte)
+		{
+			Xor |= uint32(Data[Offset++]) << (Byte * 8);
+		}
+
+		Previous ^= Xor;
+		FMemory::Memcpy(&Values[i], &Previous, sizeof(Previous));
+	}
+	return Offset == Size;
+}
+
+// Writes the record of a stream.
+void MWControllerDataLog::WriteStream(const int32 Stream, const FMWDataLogStream& StreamInfo, TArray<uint8>& Out)
+{
+	AppendRaw<uint32>(Out, DATA_LOG_STREAM_MAGIC);
+	AppendRaw<uint32>(Out, uint32(Stream));
+	AppendString(Out, StreamInfo.Id);
+	AppendString(Out, StreamInfo.Name);
+}
+
+// Reads the record of a stream.
+bool MWControllerDataLog::ReadStream(const uint8* Data, const int64 Size, const int64 Offset, int32& OutStream, FMWDataLogStream& OutStreamInfo, int64& OutNextOffset)
+{
+	int64 Position = Offset;
+	uint32 Magic = 0;
+	uint32 Stream = 0;
+	if (!ReadRaw(Data, Size, Position, Magic) || Magic != DATA_LOG_STREAM_MAGIC
+		|| !ReadRaw(Data, Size, Position, Stream) || Stream >= DATA_LOG_MAX_STREAMS
+		|| !ReadString(Data, Size, Position, OutStreamInfo.Id) || !ReadString(Data, Size, Position, OutStreamInfo.Name))
+	{
+		return false;
+	}
+
+	OutStream = int32(Stream);
+	OutNextOffset = Position;
+	return true;
+}
+
+// Writes the index.
+void MWControllerDataLog::WriteIndex(const TArray<FMWDataLogChunk>& Chunks, const TArray<FMWDataLogStream>& Streams, const int64 IndexOffset, TArray<uint8>& Out)
+{
+	AppendRaw<uint32>(Out, DATA_LOG_INDEX_MAGIC);
+	AppendRaw<uint32>(Out, uint32(Chunks.Num()));
+
+	for (const FMWDataLogChunk& Chunk : Chunks)
+	{
+		AppendRaw<uint64>(Out, uint64(Chunk.Offset));
+		AppendRaw<uint32>(Out, uint32(Chunk.Stream));
+		AppendRaw<uint32>(Out, uint32(Chunk.NumSamples));
+		AppendRaw<float>(Out, Chunk.FirstTime);
+		AppendRaw<float>(Out, Chunk.LastTime);
+	}
+
+	AppendRaw<uint32>(Out, uint32(Streams.Num()));
+	for (const FMWDataLogStream& Stream : Streams)
+	{
+		AppendString(Out, Stream.Id);
+		AppendString(Out, Stream.Name);
+	}
+
+	AppendRaw<uint64>(Out, uint64(IndexOffset));
+	AppendRaw<uint32>(Out, DATA_LOG_END_MAGIC);
+}
+
+// Reads the header.
+bool MWControllerDataLog::ReadHeader(const uint8* Data, const int64 Size, TArray<FString>& OutChannelNames, int64& OutOffset)
+{
+	OutChannelNames.Reset();
+
+	int64 Offset = 0;
+	uint32 Magic = 0;
+	uint16 Version = 0;
+	uint16 NumChannels = 0;
+	if (!ReadRaw(Data, Size, Offset, Magic) || Magic != DATA_LOG_MAGIC
+		|| !ReadRaw(Data, Size, Offset, Version) || Version != DATA_LOG_VERSION
+		|| !ReadRaw(Data, Size, Offset, NumChannels))
+	{
+		return false;
+	}
+
+	OutChannelNames.SetNum(NumChannels);
+	for (FString& Name : OutChannelNames)
+	{
+		if (!ReadString(Data, Size, Offset, Name))
+		{
+			return false;
+		}
+	}
+
+	OutOffset = Offset;
+	return true;
+}
+
+// Checks that a chunk starts at the offset.
+static bool IsChunkAt(const uint8* Data, const int64 Size, int64 Offset)
+{
+	uint32 Magic = 0;
+	return ReadRaw(Data, Size, Offset, Magic) && Magic == DATA_LOG_CHUNK_MAGIC;
+}
+
+// Reads the index at the end.
+bool MWControllerDataLog::ReadIndex(const uint8* Data, const int64 Size, TArray<FMWDataLogChunk>& OutChunks, TArray<FMWDataLogStream>& OutStreams)
+{
+	OutChunks.Reset();
+	OutStreams.Reset();
+
+	int64 Offset = Size - int64(sizeof(uint64) + sizeof(uint32));
+	uint64 IndexOffset = 0;
+	uint32 EndMagic = 0;
+	if (!ReadRaw(Data, Size, Offset, IndexOffset) || !ReadRaw(Data, Size, Offset, EndMagic) || EndMagic != DATA_LOG_END_MAGIC)
+	{
+		return false;
+	}
+
+	Offset = int64(IndexOffset);
+	uint32 Magic = 0;
+	uint32 NumChunks = 0;
+	if (!ReadRaw(Data, Size, Offset, Magic) || Magic != DATA_LOG_INDEX_MAGIC || !ReadRaw(Data, Size, Offset, NumChunks))
+	{
+		return false;
+	}
+
+	// Offset, stream, number of samples, first and last time per chunk. The number comes from the file, so it is bounded by the bytes left.
+	const int64 ChunkEntrySize = sizeof(uint64) + 2 * sizeof(uint32) + 2 * sizeof(float);
+	if (int64(NumChunks) > (Size - Offset) / ChunkEntrySize)
+	{
+		return false;
+	}
+
+	OutChunks.SetNum(NumChunks);
+	for (FMWDataLogChunk& Chunk : OutChunks)
+	{
+		uint64 ChunkOffset = 0;
+		uint32 Stream = 0;
+		uint32 NumSamples = 0;
+		if (!ReadRaw(Data, Size, Offset, ChunkOffset) || !ReadRaw(Data, Size, Offset, Stream) || Stream >= DATA_LOG_MAX_STREAMS
+			|| !ReadRaw(Data, Size, Offset, NumSamples) || NumSamples > DATA_LOG_CHUNK_SAMPLES
+			|| !ReadRaw(Data, Size, Offset, Chunk.FirstTime) || !ReadRaw(Data, Size, Offset, Chunk.LastTime)
+			|| ChunkOffset >= IndexOffset || !IsChunkAt(Data, int64(IndexOffset), int64(ChunkOffset)))
+		{
+			// A damaged index, the reader scans the chunks instead.
+			OutChunks.Reset();
+			return false;
+		}
+		Chunk.Offset = int64(ChunkOffset);
+		Chunk.Stream = int32(Stream);
+		Chunk.NumSamples = int32(NumSamples);
+	}
+
+	uint32 NumStreams = 0;
+	if (!ReadRaw(Data, Size, Offset, NumStreams) || NumStreams > DATA_LOG_MAX_STREAMS)
+	{
+		OutChunks.Reset();
+		return false;
+	}
+
+	OutStreams.SetNum(NumStreams);
+	for (FMWDataLogStream& Stream : OutStreams)
+	{
+		if (!ReadString(Data, Size, Offset, Stream.Id) || !ReadString(Data, Size, Offset, Stream.Name))
+		{
+			OutChunks.Reset();
+			OutStreams.Reset();
+			return false;
+		}
+	}
+	return true;
+}
+
+// Reads the header of a chunk.
+bool MWControllerDataLog::ReadChunkHeader(const uint8* Data, const int64 Size, const int64 Offset, const int32 NumChannels, FMWDataLogChunk& OutChunk, int64& OutNextOffset)
+{
+	int64 Position = Offset;
+	uint32 Magic = 0;
+	uint32 Stream = 0;
+	uint32 NumSamples = 0;
+	if (!ReadRaw(Data, Size, Position, Magic) || Magic != DATA_LOG_CHUNK_MAGIC
+		|| !ReadRaw(Data, Size, Position, Stream) || Stream >= DATA_LOG_MAX_STREAMS
+		|| !ReadRaw(Data, Size, Position, NumSamples) || NumSamples > DATA_LOG_CHUNK_SAMPLES
+		|| !ReadRaw(Data, Size, Position, OutChunk.FirstTime) || !ReadRaw(Data, Size, Position, OutChunk.LastTime))
+	{
+		return false;
+	}
+
+	// Only the sizes are read, the columns are skipped.
+	for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+	{
+		uint32 ColumnSize = 0;
+		if (!ReadRaw(Data, Size, Position, ColumnSize) || Position + ColumnSize > Size)
+		{
+			return false;
+		}
+		Position += ColumnSize;
+	}
+
+	OutChunk.Offset = Offset;
+	OutChunk.Stream = int32(Stream);
+	OutChunk.NumSamples = int32(NumSamples);
+	OutNextOffset = Position;
+	return true;
+}
+
+// Decompresses a chunk.
+bool MWControllerDataLog::DecodeChunk(const uint8* Data, const int64 Size, const FMWDataLogChunk& Chunk, const int32 NumChannels, TArray<TArray<float>>& OutColumns)
+{
+	OutColumns.SetNum(NumChannels);
+	if (Chunk.NumSamples < 0 || Chunk.NumSamples > DATA_LOG_CHUNK_SAMPLES || !IsChunkAt(Data, Size, Chunk.Offset))
+	{
+		return false;
+	}
+
+	// Magic, stream, number of samples, first and last time.
+	int64 Offset = Chunk.Offset + 3 * sizeof(uint32) + 2 * sizeof(float);
+	for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+	{
+		uint32 ColumnSize = 0;
+		if (!ReadRaw(Data, Size, Offset, ColumnSize) || Offset + ColumnSize > Size)
+		{
+			return false;
+		}
+
+		TArray<float>& Column = OutColumns[Channel];
+		Column.SetNumUninitialized(Chunk.NumSamples, false);
+		if (!DecodeColumn(Data + Offset, ColumnSize, Chunk.NumSamples, Column.GetData()))
+		{
+			return false;
+		}
+		Offset += ColumnSize;
+	}
+	return true;
+}
+
+// Gets the first line of the csv files.
+FString MWControllerDataLog::GetCsvHeader(const TArray<FString>& ExtraChannelNames)
+{
+	FString FirstLine = TEXT("Time(BeginPlay); MW_Longitudinal_Velocity; MW_Transversal_Velocity; MW_Angular_Velocity; MW_Wheel_Left_Front(rad/s); MW_Wheel_Right_Front(rad/s); MW_Wheel_Left_Rear(rad/s); MW_Wheel_RightRear(rad/s); ");
+	for (const FString& Name : ExtraChannelNames)
+	{
+		FirstLine += Name + TEXT("; ");
+	}
+	return FirstLine + TEXT("\n");
+}
+
+// Appends a csv line.
+void MWControllerDataLog::AppendCsvLine(const float* Values, const int32 NumChannels, TArray<uint8>& Out)
+{
+	for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+	{
+		const FString Text = FString::SanitizeFloat(Values[Channel]);
+		for (const TCHAR Character : Text)
+		{
+			Out.Add(Character == TEXT('.') ? ',' : uint8(Character));
+		}
+		Out.Add(Channel + 1 < NumChannels ? ';' : '\n');
+	}
+}
+
+// Constructor.
+MWControllerDataLogEncoder::MWControllerDataLogEncoder(const int32 InNumChannels, const int32 InStream) : NumChannels(InNumChannels), Stream(InStream)
+{
+	Columns.SetNumUninitialized(NumChannels * DATA_LOG_CHUNK_SAMPLES);
+}
+
+// Adds a sample.
+void MWControllerDataLogEncoder::Add(const float* Values)
+{
+	check(NumSamples < DATA_LOG_CHUNK_SAMPLES);
+
+	for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+	{
+		Columns[Channel * DATA_LOG_CHUNK_SAMPLES + NumSamples] = Values[Channel];
+	}
+	++NumSamples;
+}
+
+// Indicates whether the chunk is full.
+bool MWControllerDataLogEncoder::IsFull() const
+{
+	return NumSamples >= DATA_LOG_CHUNK_SAMPLES;
+}
+
+// Gets the number of samples.
+int32 MWControllerDataLogEncoder::Num() const
+{
+	return NumSamples;
+}
+
+// Compresses the chunk.
+void MWControllerDataLogEncoder::Encode(TArray<uint8>& Out, const int64 ChunkOffset, TArray<FMWDataLogChunk>& OutChunks)
+{
+	FMWDataLogChunk& Chunk = OutChunks[OutChunks.AddDefaulted()];
+	Chunk.Offset = ChunkOffset;
+	Chunk.Stream = Stream;
+	Chunk.NumSamples = NumSamples;
+	Chunk.FirstTime = NumSamples > 0 ? Columns[EMWDataChannel::Time * DATA_LOG_CHUNK_SAMPLES] : 0.f;
+	Chunk.LastTime = NumSamples > 0 ? Columns[EMWDataChannel::Time * DATA_LOG_CHUNK_SAMPLES + NumSamples - 1] : 0.f;
+
+	AppendRaw<uint32>(Out, DATA_LOG_CHUNK_MAGIC);
+	AppendRaw<uint32>(Out, uint32(Stream));
+	AppendRaw<uint32>(Out, uint32(NumSamples));
+	AppendRaw<float>(Out, Chunk.FirstTime);
+	AppendRaw<float>(Out, Chunk.LastTime);
+
+	for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+	{
+		// The size is written in front of the column once it is known.
+		const int32 SizeOffset = Out.AddUninitialized(sizeof(uint32));
+		const int32 Start = Out.Num();
+		MWControllerDataLog::EncodeColumn(&Columns[Channel * DATA_LOG_CHUNK_SAMPLES], NumSamples, Out);
+
+		const uint32 Size = uint32(Out.Num() - Start);
+		FMemory::Memcpy(Out.GetData() + SizeOffset, &Size, sizeof(Size));
+	}
+	NumSamples = 0;
+}
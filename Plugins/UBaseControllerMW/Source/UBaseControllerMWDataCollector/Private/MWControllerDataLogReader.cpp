@@ -0,0 +1,320 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "MWControllerDataLogReader.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+
+// Constructor.
+MWControllerDataLogReader::MWControllerDataLogReader()
+{
+}
+
+// Destructor.
+MWControllerDataLogReader::~MWControllerDataLogReader()
+{
+	Close();
+}
+
+// Opens a log.
+bool MWControllerDataLogReader::Open(const FString& FilePath)
+{
+	Close();
+
+	MappedHandle = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath);
+	if (MappedHandle && MappedHandle->GetFileSize() > 0)
+	{
+		MappedRegion = MappedHandle->MapRegion(0, MappedHandle->GetFileSize());
+	}
+
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(LoadedData, *FilePath))
+	{
+		// Platforms without memory mapping read the whole file.
+		Data = LoadedData.GetData();
+		Size = LoadedData.Num();
+	}
+	else
+	{
+		Close();
+		return false;
+	}
+
+	int64 FirstChunkOffset = 0;
+	if (!MWControllerDataLog::ReadHeader(Data, Size, ChannelNames, FirstChunkOffset) || ChannelNames.Num() == 0)
+	{
+		Close();
+		return false;
+	}
+
+	if (!MWControllerDataLog::ReadIndex(Data, Size, Chunks, Streams))
+	{
+		ScanChunks(FirstChunkOffset);
+	}
+
+	IndexStreams();
+	return true;
+}
+
+// Closes the log.
+void MWControllerDataLogReader::Close()
+{
+	delete MappedRegion;
+	MappedRegion = nullptr;
+
+	delete MappedHandle;
+	MappedHandle = nullptr;
+
+	LoadedData.Empty();
+	Data = nullptr;
+	Size = 0;
+
+	ChannelNames.Reset();
+	Chunks.Reset();
+	Streams.Reset();
+	StreamChunks.Reset();
+	StreamSamples.Reset();
+}
+
+// Getter for the names of the channels.
+const TArray<FString>& MWControllerDataLogReader::GetChannelNames() const
+{
+	return ChannelNames;
+}
+
+// Getter for the chunks.
+const TArray<FMWDataLogChunk>& MWControllerDataLogReader::GetChunks() const
+{
+	return Chunks;
+}
+
+// Getter for the streams.
+const TArray<FMWDataLogStream>& MWControllerDataLogReader::GetStreams() const
+{
+	return Streams;
+}
+
+// Finds a stream.
+int32 MWControllerDataLogReader::FindStream(const FString& IdOrName) const
+{
+	return Streams.IndexOfByPredicate([&IdOrName](const FMWDataLogStream& Stream)
+	{
+		return Stream.Id == IdOrName || Stream.Name == IdOrName;
+	});
+}
+
+// Gets the number of samples of a stream.
+int64 MWControllerDataLogReader::GetNumSamples(const int32 Stream) const
+{
+	return StreamSamples.IsValidIndex(Stream) ? StreamSamples[Stream] : 0;
+}
+
+// Reads all samples of a stream.
+bool MWControllerDataLogReader::ReadAll(const int32 Stream, TArray<TArray<float>>& OutColumns) const
+{
+	OutColumns.Reset();
+	OutColumns.SetNum(ChannelNames.Num());
+
+	if (!StreamChunks.IsValidIndex(Stream))
+	{
+		return true;
+	}
+
+	for (const int32 ChunkIndex : StreamChunks[Stream])
+	{
+		const FMWDataLogChunk& Chunk = Chunks[ChunkIndex];
+		if (!AppendChunk(Chunk, 0, Chunk.NumSamples - 1, 1, OutColumns))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Reads a time range.
+bool MWControllerDataLogReader::ReadRange(const int32 Stream, const float StartTime, const float EndTime, TArray<TArray<float>>& OutColumns) const
+{
+	OutColumns.Reset();
+	OutColumns.SetNum(ChannelNames.Num());
+
+	if (!StreamChunks.IsValidIndex(Stream))
+	{
+		return true;
+	}
+	const TArray<int32>& ChunkIndices = StreamChunks[Stream];
+
+	// First chunk that ends in the range.
+	int32 Low = 0;
+	int32 High = ChunkIndices.Num();
+	while (Low < High)
+	{
+		const int32 Middle = (Low + High) / 2;
+		if (Chunks[ChunkIndices[Middle]].LastTime < StartTime)
+		{
+			Low = Middle + 1;
+		}
+		else
+		{
+			High = Middle;
+		}
+	}
+
+	for (int32 Index = Low; Index < ChunkIndices.Num() && Chunks[ChunkIndices[Index]].FirstTime <= EndTime; ++Index)
+	{
+		const FMWDataLogChunk& Chunk = Chunks[ChunkIndices[Index]];
+		if (!MWControllerDataLog::DecodeChunk(Data, Size, Chunk, ChannelNames.Num(), ChunkColumns))
+		{
+			return false;
+		}
+
+		// The borders of the range are found in the decoded time column.
+		const TArray<float>& Times = ChunkColumns[EMWDataChannel::Time];
+		int32 First = 0;
+		while (First < Chunk.NumSamples && Times[First] < StartTime)
+		{
+			++First;
+		}
+		int32 Last = Chunk.NumSamples - 1;
+		while (Last >= First && Times[Last] > EndTime)
+		{
+			--Last;
+		}
+
+		for (int32 Channel = 0; Channel < ChannelNames.Num() && First <= Last; ++Channel)
+		{
+			OutColumns[Channel].Append(ChunkColumns[Channel].GetData() + First, Last - First + 1);
+		}
+	}
+	return true;
+}
+
+// Reads evenly spaced samples.
+bool MWControllerDataLogReader::ReadOverview(const int32 Stream, const int32 MaxSamples, TArray<TArray<float>>& OutColumns) const
+{
+	const int64 NumSamples = GetNumSamples(Stream);
+	if (MaxSamples <= 0 || NumSamples <= MaxSamples)
+	{
+		return ReadAll(Stream, OutColumns);
+	}
+
+	OutColumns.Reset();
+	OutColumns.SetNum(ChannelNames.Num());
+	const TArray<int32>& ChunkIndices = StreamChunks[Stream];
+
+	const int64 Stride = (NumSamples + MaxSamples - 1) / MaxSamples;
+
+	// Only the chunks with a sample of the overview are decoded. With a spacing of more than a chunk the others are not touched.
+	int64 NextSample = 0;
+	int64 ChunkStart = 0;
+	for (const int32 ChunkIndex : ChunkIndices)
+	{
+		const FMWDataLogChunk& Chunk = Chunks[ChunkIndex];
+		const int64 ChunkEnd = ChunkStart + Chunk.NumSamples;
+		if (NextSample < ChunkEnd)
+		{
+			const int32 First = int32(NextSample - ChunkStart);
+			if (!AppendChunk(Chunk, First, Chunk.NumSamples - 1, int32(Stride), OutColumns))
+			{
+				return false;
+			}
+			NextSample += ((ChunkEnd - 1 - NextSample) / Stride + 1) * Stride;
+		}
+		ChunkStart = ChunkEnd;
+	}
+	return true;
+}
+
+// Finds the streams and chunks by their headers.
+void MWControllerDataLogReader::ScanChunks(const int64 FirstChunkOffset)
+{
+	Chunks.Reset();
+	Streams.Reset();
+
+	int64 Offset = FirstChunkOffset;
+	FMWDataLogChunk Chunk;
+	int32 Stream = 0;
+	FMWDataLogStream StreamInfo;
+	int64 NextOffset = 0;
+
+	// A crashed run ends in the middle of a record, the complete records before are used.
+	while (true)
+	{
+		if (MWControllerDataLog::ReadChunkHeader(Data, Size, Offset, ChannelNames.Num(), Chunk, NextOffset))
+		{
+			Chunks.Add(Chunk);
+		}
+		else if (MWControllerDataLog::ReadStream(Data, Size, Offset, Stream, StreamInfo, NextOffset) && Stream >= 0)
+		{
+			if (Stream >= Streams.Num())
+			{
+				Streams.SetNum(Stream + 1);
+			}
+			Streams[Stream] = StreamInfo;
+		}
+		else
+		{
+			break;
+		}
+		Offset = NextOffset;
+	}
+}
+
+// Sorts the chunks by stream.
+void MWControllerDataLogReader::IndexStreams()
+{
+	for (const FMWDataLogChunk& Chunk : Chunks)
+	{
+		// A chunk without stream record still gets an (unnamed) stream.
+		if (Chunk.Stream >= Streams.Num())
+		{
+			Streams.SetNum(Chunk.Stream + 1);
+		}
+	}
+
+	StreamChunks.SetNum(Streams.Num());
+	StreamSamples.SetNumZeroed(Streams.Num());
+	for (int32 ChunkIndex = 0; ChunkIndex < Chunks.Num(); ++ChunkIndex)
+	{
+		const FMWDataLogChunk& Chunk = Chunks[ChunkIndex];
+		StreamChunks[Chunk.Stream].Add(ChunkIndex);
+		StreamSamples[Chunk.Stream] += Chunk.NumSamples;
+	}
+}
+
+// Decodes a chunk and appends samples of it.
+bool MWControllerDataLogReader::AppendChunk(const FMWDataLogChunk& Chunk, const int32 First, const int32 Last, const int32 Stride, TArray<TArray<float>>& OutColumns) const
+{
+	if (Chunk.NumSamples <= 0)
+	{
+		return true;
+	}
+
+	if (!MWControllerDataLog::DecodeChunk(Data, Size, Chunk, ChannelNames.Num(), ChunkColumns))
+	{
+		return false;
+	}
+
+	for (int32 Channel = 0; Channel < ChannelNames.Num(); ++Channel)
+	{
+		const TArray<float>& Column = ChunkColumns[Channel];
+		TArray<float>& OutColumn = OutColumns[Channel];
+
+		if (Stride == 1)
+		{
+			OutColumn.Append(Column.GetData() + First, Last - First + 1);
+		}
+		else
+		{
+			for (int32 Sample = First; Sample <= Last; Sample += Stride)
+			{
+				OutColumn.Add(Column[Sample]);
+			}
+		}
+	}
+	return true;
+}
@@ -0,0 +1,125 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "MWControllerDataLogToCsvCommandlet.h"
+#include "MWControllerDataLogReader.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// Sets default values.
+UMWControllerDataLogToCsvCommandlet::UMWControllerDataLogToCsvCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+// Converts the log.
+int32 UMWControllerDataLogToCsvCommandlet::Main(const FString& Params)
+{
+	FString InPath;
+	if (!FParse::Value(*Params, TEXT("In="), InPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[%s][%d] Usage: -run=MWControllerDataLogToCsv -In=File.mwlog [-Out=File.csv] [-Robot=Name] [-Start=0 -End=10] [-MaxSamples=10000]"), TEXT(__FUNCTION__), __LINE__);
+		return 1;
+	}
+
+	FString OutPath = FPaths::ChangeExtension(InPath, TEXT("csv"));
+	FParse::Value(*Params, TEXT("Out="), OutPath);
+
+	float StartTime = -MAX_flt;
+	float EndTime = MAX_flt;
+	int32 MaxSamples = 0;
+	const bool bRange = FParse::Value(*Params, TEXT("Start="), StartTime) | FParse::Value(*Params, TEXT("End="), EndTime);
+	FParse::Value(*Params, TEXT("MaxSamples="), MaxSamples);
+
+	MWControllerDataLogReader Reader;
+	if (!Reader.Open(InPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[%s][%d] Could not read %s."), TEXT(__FUNCTION__), __LINE__, *InPath);
+		return 1;
+	}
+
+	const TArray<FString>& ChannelNames = Reader.GetChannelNames();
+	const int32 NumBaseChannels = MWControllerDataLog::GetBaseChannelNames().Num();
+	if (ChannelNames.Num() < NumBaseChannels)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[%s][%d] %s is no data collection."), TEXT(__FUNCTION__), __LINE__, *InPath);
+		return 1;
+	}
+
+	TArray<int32> Streams;
+	FString Robot;
+	if (FParse::Value(*Params, TEXT("Robot="), Robot))
+	{
+		const int32 Stream = Reader.FindStream(Robot);
+		if (Stream == INDEX_NONE)
+		{
+			UE_LOG(LogTemp, Error, TEXT("[%s][%d] %s has no robot %s."), TEXT(__FUNCTION__), __LINE__, *InPath, *Robot);
+			return 1;
+		}
+		Streams.Add(Stream);
+	}
+	else
+	{
+		for (int32 Stream = 0; Stream < Reader.GetStreams().Num(); ++Stream)
+		{
+			Streams.Add(Stream);
+		}
+	}
+
+	const TArray<FString> ExtraChannelNames(ChannelNames.GetData() + NumBaseChannels, ChannelNames.Num() - NumBaseChannels);
+	const FString FirstLine = MWControllerDataLog::GetCsvHeader(ExtraChannelNames);
+
+	for (const int32 Stream : Streams)
+	{
+		TArray<TArray<float>> Columns;
+		const bool bRead = bRange ? Reader.ReadRange(Stream, StartTime, EndTime, Columns) : Reader.ReadOverview(Stream, MaxSamples, Columns);
+		if (!bRead)
+		{
+			// The samples before the damaged chunk are still converted.
+			UE_LOG(LogTemp, Warning, TEXT("[%s][%d] %s is damaged, only the readable part is converted."),
+				TEXT(__FUNCTION__), __LINE__, *InPath);
+		}
+
+		TArray<uint8> Csv;
+		Csv.Append((const uint8*)TCHAR_TO_ANSI(*FirstLine), FirstLine.Len());
+
+		int32 NumSamples = Columns.Num() > 0 ? MAX_int32 : 0;
+		for (const TArray<float>& Column : Columns)
+		{
+			NumSamples = FMath::Min(NumSamples, Column.Num());
+		}
+
+		TArray<float> Values;
+		Values.SetNumUninitialized(Columns.Num());
+		for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+		{
+			for (int32 Channel = 0; Channel < Columns.Num(); ++Channel)
+			{
+				Values[Channel] = Columns[Channel][Sample];
+			}
+			MWControllerDataLog::AppendCsvLine(Values.GetData(), Values.Num(), Csv);
+		}
+
+		// A log of several robots gets one file per robot.
+		FString StreamPath = OutPath;
+		if (Reader.GetStreams().Num() > 1)
+		{
+			// The name is the object name of the robot, which is a valid file name.
+			const FMWDataLogStream& StreamInfo = Reader.GetStreams()[Stream];
+			const FString Suffix = StreamInfo.Name.IsEmpty() ? FString::FromInt(Stream) : StreamInfo.Name;
+			StreamPath = FPaths::GetPath(OutPath) / FPaths::GetBaseFilename(OutPath) + TEXT("_") + Suffix + TEXT(".") + FPaths::GetExtension(OutPath);
+		}
+
+		if (!FFileHelper::SaveArrayToFile(Csv, *StreamPath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("[%s][%d] Could not write %s."), TEXT(__FUNCTION__), __LINE__, *StreamPath);
+			return 1;
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("[%s][%d] Wrote %d samples to %s."), TEXT(__FUNCTION__), __LINE__, NumSamples, *StreamPath);
+	}
+	return 0;
+}
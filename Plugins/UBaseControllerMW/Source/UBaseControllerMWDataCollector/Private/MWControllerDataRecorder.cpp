@@ -0,0 +1,147 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "MWControllerDataRecorder.h"
+
+// Starts a recording.
+void MWControllerDataRecorder::Init(const int32 InNumChannels, const float* Intervals, const float* Deadbands, const bool bInRecordOnlyChanges,
+	const bool bInTriggerMode, const int32 PreTriggerSamples, const int32 InPostTriggerSamples)
+{
+	NumChannels = InNumChannels;
+	for (int32 i = 0; i < NumChannels; ++i)
+	{
+		ChannelInterval[i] = Intervals[i];
+		ChannelDeadband[i] = Deadbands[i];
+		ChannelNextTime[i] = 0.f;
+	}
+
+	// The time is the key of every sample.
+	ChannelInterval[EMWDataChannel::Time] = 0.f;
+	ChannelDeadband[EMWDataChannel::Time] = 0.f;
+
+	bRecordOnlyChanges = bInRecordOnlyChanges;
+	bTriggerMode = bInTriggerMode;
+	PostTriggerSamples = InPostTriggerSamples;
+
+	if (bTriggerMode)
+	{
+		PreTrigger.SetNumUninitialized(FMath::Max(PreTriggerSamples, 1));
+	}
+	PreTriggerHead = 0;
+	PreTriggerNum = 0;
+	PostTriggerRemaining = 0;
+	NumTriggers = 0;
+	bHasRecorded = false;
+}
+
+// Records a sample.
+bool MWControllerDataRecorder::Add(FMWControllerDataSample& Sample, TFunctionRef<bool(const FMWControllerDataSample&)> Push)
+{
+	const bool bChanged = FilterSample(Sample);
+
+	bool bRecorded = true;
+	if (bChanged || !bRecordOnlyChanges || !bHasRecorded)
+	{
+		bRecorded = RecordSample(Sample, Push);
+		LastRecorded = Sample;
+		bHasRecorded = true;
+	}
+	return bRecorded;
+}
+
+// Applies rates and deadbands.
+bool MWControllerDataRecorder::FilterSample(FMWControllerDataSample& Sample)
+{
+	const float Time = Sample.Values[EMWDataChannel::Time];
+
+	// The first sample is always recorded and starts the rates.
+	if (!bHasRecorded)
+	{
+		for (int32 i = 0; i < NumChannels; ++i)
+		{
+			ChannelNextTime[i] = Time + ChannelInterval[i];
+		}
+		return true;
+	}
+	bool bChanged = false;
+
+	for (int32 i = EMWDataChannel::Time + 1; i < NumChannels; ++i)
+	{
+		float& Value = Sample.Values[i];
+		const float Last = LastRecorded.Values[i];
+
+		if (ChannelInterval[i] > 0.f)
+		{
+			if (Time < ChannelNextTime[i])
+			{
+				Value = Last;
+				continue;
+			}
+			// Stays on the grid of the rate unless the collector fell behind by more than one interval.
+			ChannelNextTime[i] = FMath::Max(ChannelNextTime[i] + ChannelInterval[i], Time);
+		}
+
+		if (FMath::Abs(Value - Last) <= ChannelDeadband[i])
+		{
+			Value = Last;
+		}
+		else
+		{
+			bChanged = true;
+		}
+	}
+	return bChanged;
+}
+
+// Passes the sample on or keeps it for the next trigger.
+bool MWControllerDataRecorder::RecordSample(const FMWControllerDataSample& Sample, TFunctionRef<bool(const FMWControllerDataSample&)> Push)
+{
+	if (!bTriggerMode || PostTriggerRemaining > 0)
+	{
+		PostTriggerRemaining = FMath::Max(PostTriggerRemaining - 1, 0);
+		return Push(Sample);
+	}
+
+	// The oldest sample is overwritten when the ring is full.
+	PreTrigger[PreTriggerHead] = Sample;
+	PreTriggerHead = (PreTriggerHead + 1) % PreTrigger.Num();
+	PreTriggerNum = FMath::Min(PreTriggerNum + 1, PreTrigger.Num());
+	return true;
+}
+
+// Starts or extends a capture.
+bool MWControllerDataRecorder::Trigger(TFunctionRef<bool(const FMWControllerDataSample&)> Push)
+{
+	if (!bTriggerMode)
+	{
+		return false;
+	}
+
+	// A trigger during a capture only extends it.
+	const bool bNewCapture = PostTriggerRemaining == 0;
+	if (bNewCapture)
+	{
+		++NumTriggers;
+	}
+
+	const int32 Size = PreTrigger.Num();
+	for (int32 i = 0; i < PreTriggerNum; ++i)
+	{
+		Push(PreTrigger[(PreTriggerHead - PreTriggerNum + i + Size) % Size]);
+	}
+	PreTriggerNum = 0;
+	PostTriggerRemaining = PostTriggerSamples;
+	return bNewCapture;
+}
+
+// Gets the samples in the ring.
+int32 MWControllerDataRecorder::GetNumPreTriggerSamples() const
+{
+	return PreTriggerNum;
+}
+
+// Gets the number of triggers.
+int32 MWControllerDataRecorder::GetNumTriggers() const
+{
+	return NumTriggers;
+}
@@ -0,0 +1,193 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "MWControllerDataWriter.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+
+// Constructor.
+MWControllerDataWriter::MWControllerDataWriter(IFileHandle* InFileHandle, const int32 Capacity, const int32 InNumChannels, const bool bInBinary)
+	: Head(0), Tail(0), DroppedSamples(0), NumChannels(InNumChannels), bBinary(bInBinary), FileHandle(InFileHandle), bStopping(false)
+{
+	FileOffset = FileHandle ? FileHandle->Tell() : 0;
+
+	const uint32 RingSize = FMath::RoundUpToPowerOfTwo(uint32(FMath::Max(Capacity, 2)));
+	Samples.SetNumUninitialized(RingSize);
+	Mask = RingSize - 1;
+	Block.Reserve(DATA_WRITER_BLOCK_SIZE + 256);
+
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("MWControllerDataWriter"), 0, TPri_BelowNormal);
+}
+
+// Destructor.
+MWControllerDataWriter::~MWControllerDataWriter()
+{
+	if (Thread)
+	{
+		Stop();
+		Thread->WaitForCompletion();
+		delete Thread;
+		Thread = nullptr;
+	}
+	else
+	{
+		// Without a thread the samples are written here.
+		Drain(true);
+		Flush();
+	}
+
+	for (MWControllerDataLogEncoder* Encoder : Encoders)
+	{
+		delete Encoder;
+	}
+	Encoders.Empty();
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+
+	delete FileHandle;
+	FileHandle = nullptr;
+}
+
+// Adds a sample (game thread).
+bool MWControllerDataWriter::Push(const FMWControllerDataSample& Sample)
+{
+	const uint32 CurrentHead = Head.Load(EMemoryOrder::Relaxed);
+	if (CurrentHead - Tail.Load() > Mask)
+	{
+		DroppedSamples.Store(DroppedSamples.Load(EMemoryOrder::Relaxed) + 1, EMemoryOrder::Relaxed);
+		return false;
+	}
+
+	Samples[CurrentHead & Mask] = Sample;
+	Head.Store(CurrentHead + 1);
+	return true;
+}
+
+// Adds a stream (game thread).
+int32 MWControllerDataWriter::AddStream(const FMWDataLogStream& Stream)
+{
+	FScopeLock Lock(&NewStreamsLock);
+	NewStreams.Add(Stream);
+	return NumStreams++;
+}
+
+// Writes the new streams (writer thread).
+void MWControllerDataWriter::BeginNewStreams()
+{
+	TArray<FMWDataLogStream> Added;
+	{
+		FScopeLock Lock(&NewStreamsLock);
+		Added = MoveTemp(NewStreams);
+		NewStreams.Reset();
+	}
+
+	for (const FMWDataLogStream& Stream : Added)
+	{
+		if (bBinary)
+		{
+			MWControllerDataLog::WriteStream(Streams.Num(), Stream, Block);
+		}
+		Encoders.Add(bBinary ? new MWControllerDataLogEncoder(NumChannels, Streams.Num()) : nullptr);
+		Streams.Add(Stream);
+	}
+}
+
+// Gets the dropped samples.
+int64 MWControllerDataWriter::GetDroppedSamples() const
+{
+	return DroppedSamples.Load(EMemoryOrder::Relaxed);
+}
+
+// Writer thread.
+uint32 MWControllerDataWriter::Run()
+{
+	while (!bStopping.Load())
+	{
+		WakeEvent->Wait(DATA_WRITER_WAIT_MS);
+		Drain(false);
+	}
+
+	// Everything pushed before the stop is written.
+	Drain(true);
+	Flush();
+	return 0;
+}
+
+// Stops the writer thread.
+void MWControllerDataWriter::Stop()
+{
+	bStopping.Store(true);
+	WakeEvent->Trigger();
+}
+
+// Formats the samples of the ring.
+void MWControllerDataWriter::Drain(const bool bFinal)
+{
+	const uint32 CurrentHead = Head.Load();
+	uint32 CurrentTail = Tail.Load(EMemoryOrder::Relaxed);
+
+	// Streams are added before their first sample, so every stream up to the head is known after this.
+	BeginNewStreams();
+
+	for (; CurrentTail != CurrentHead; ++CurrentTail)
+	{
+		const FMWControllerDataSample& Sample = Samples[CurrentTail & Mask];
+
+		if (bBinary)
+		{
+			if (!Encoders.IsValidIndex(Sample.Stream))
+			{
+				continue;
+			}
+
+			MWControllerDataLogEncoder* Encoder = Encoders[Sample.Stream];
+			Encoder->Add(Sample.Values);
+			if (Encoder->IsFull())
+			{
+				Encoder->Encode(Block, FileOffset + Block.Num(), Chunks);
+			}
+		}
+		else
+		{
+			MWControllerDataLog::AppendCsvLine(Sample.Values, NumChannels, Block);
+		}
+
+		if (Block.Num() >= DATA_WRITER_BLOCK_SIZE)
+		{
+			// Frees the ring before the write, the game thread can go on pushing.
+			Tail.Store(CurrentTail + 1);
+			Flush();
+		}
+	}
+	Tail.Store(CurrentTail);
+
+	if (bFinal && bBinary)
+	{
+		for (MWControllerDataLogEncoder* Encoder : Encoders)
+		{
+			if (Encoder->Num() > 0)
+			{
+				Encoder->Encode(Block, FileOffset + Block.Num(), Chunks);
+			}
+		}
+		MWControllerDataLog::WriteIndex(Chunks, Streams, FileOffset + Block.Num(), Block);
+	}
+
+	// The rest is written on every wake, so the csv file lags at most DATA_WRITER_WAIT_MS behind.
+	Flush();
+}
+
+// Writes the block.
+void MWControllerDataWriter::Flush()
+{
+	if (Block.Num() > 0 && FileHandle)
+	{
+		FileHandle->Write((const uint8*)Block.GetData(), Block.Num());
+		FileOffset += Block.Num();
+	}
+	Block.Reset();
+}
@@ -0,0 +1,166 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "MWControllerFleetDataCollector.h"
+#include "MWControllerDataCollector.h"
+#include "MWControllerComponent.h"
+#include "MWControllerRegistry.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Engine/World.h"
+
+// Sets default values.
+AMWControllerFleetDataCollector::AMWControllerFleetDataCollector()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	// The velocities of the physics step of this frame are recorded.
+	PrimaryActorTick.TickGroup = TG_PostPhysics;
+}
+
+// Creates the log and finds the controllers.
+void AMWControllerFleetDataCollector::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!CreateFile())
+	{
+		UE_LOG(LogTemp, Error,
+			TEXT("[%s][%d] Could not create the data collection %s. Tick of AMWControllerFleetDataCollector will be turn off."),
+			TEXT(__FUNCTION__), __LINE__, *FilePath);
+
+		SetActorTickEnabled(false);
+		return;
+	}
+
+	DiscoverControllers();
+	TimeToDiscovery = DiscoveryIntervalInSeconds;
+}
+
+// Creates the log and the writer.
+bool AMWControllerFleetDataCollector::CreateFile()
+{
+	FString DataDir;
+	if (!MWControllerDataLog::CreateDataDir(DataDir))
+	{
+		return false;
+	}
+	FilePath = MWControllerDataLog::GetUniqueFilePath(DataDir, TEXT("MW_Fleet"), TEXT("mwlog"));
+
+	TArray<uint8> Header;
+	MWControllerDataLog::WriteHeader(MWControllerDataLog::GetBaseChannelNames(), Header);
+
+	IFileHandle* FileHandle = FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*FilePath, true);
+	if (!FileHandle || !FileHandle->Write(Header.GetData(), Header.Num()))
+	{
+		delete FileHandle;
+		return false;
+	}
+
+	// The writer owns the file from now on.
+	Writer = new MWControllerDataWriter(FileHandle, BufferCapacity, EMWDataChannel::Num, true);
+	return true;
+}
+
+// Adds the new controllers.
+void AMWControllerFleetDataCollector::DiscoverControllers()
+{
+	MWControllerRegistry* Registry = MWControllerRegistry::Get(GetWorld());
+	if (!Registry)
+	{
+		return;
+	}
+
+	TArray<UMWControllerComponent*> NewControllers;
+	Registry->GetControllers(NewControllers);
+	NewControllers.RemoveAllSwap([this](const UMWControllerComponent* Controller)
+	{
+		return !Controller->GetOwner() || Controller->IsPendingKill() || KnownControllers.Contains(Controller);
+	});
+
+	// Robots that exist at BeginPlay always get the same streams.
+	NewControllers.Sort([](const UMWControllerComponent& A, const UMWControllerComponent& B)
+	{
+		return A.GetPathName() < B.GetPathName();
+	});
+
+	for (UMWControllerComponent* Controller : NewControllers)
+	{
+		FMWDataLogStream StreamInfo;
+		StreamInfo.Id = Controller->GetRobotId();
+		StreamInfo.Name = Controller->GetOwner()->GetName();
+
+		FMWFleetDataRobot& Robot = Robots[Robots.AddDefaulted()];
+		Robot.Controller = Controller;
+		Robot.Stream = Writer->AddStream(StreamInfo);
+		KnownControllers.Add(Controller);
+	}
+}
+
+// Records all robots.
+void AMWControllerFleetDataCollector::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!Writer)
+	{
+		return;
+	}
+
+	TimeToDiscovery -= DeltaTime;
+	if (TimeToDiscovery <= 0.f)
+	{
+		DiscoverControllers();
+		TimeToDiscovery = DiscoveryIntervalInSeconds;
+	}
+
+	const float Time = GetWorld()->GetTimeSeconds();
+	FMWControllerDataSample Sample;
+
+	for (const FMWFleetDataRobot& Robot : Robots)
+	{
+		// Robots that stopped or were destroyed keep their stream, it only ends.
+		UMWControllerComponent* Controller = Robot.Controller.Get();
+		if (!Controller || Controller->IsControlCycleStopped() || Controller->IsBeingDestroyed())
+		{
+			continue;
+		}
+
+		UMWControllerDataCollector::ReadBaseChannels(Controller, Time, Sample);
+		Sample.Stream = Robot.Stream;
+
+		// A full buffer only drops this sample, the writer catches up on its own.
+		Writer->Push(Sample);
+	}
+}
+
+// Gets the dropped samples.
+int64 AMWControllerFleetDataCollector::GetDroppedSamples() const
+{
+	return Writer ? Writer->GetDroppedSamples() : 0;
+}
+
+// Gets the number of robots.
+int32 AMWControllerFleetDataCollector::GetNumRobots() const
+{
+	return Robots.Num();
+}
+
+// Closes the log.
+void AMWControllerFleetDataCollector::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+
+	// Writes the remaining samples and closes the file.
+	if (Writer)
+	{
+		if (Writer->GetDroppedSamples() > 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[%s][%d] %lld samples were dropped for %s, the writer could not keep up."),
+				TEXT(__FUNCTION__), __LINE__, Writer->GetDroppedSamples(), *FilePath);
+		}
+		delete Writer;
+		Writer = nullptr;
+	}
+	Robots.Reset();
+	KnownControllers.Reset();
+}
@@ -0,0 +1,234 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformFilemanager.h"
+#include "MWControllerDataLog.h"
+#include "MWControllerDataLogReader.h"
+#include "MWControllerDataWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define DATA_LOG_READER_TEST_CHANNELS (EMWDataChannel::Num + 1)
+#define DATA_LOG_READER_TEST_SAMPLES (1300)
+#define DATA_LOG_READER_TEST_OTHER_SAMPLES (100)
+#define DATA_LOG_READER_TEST_TIME_STEP (0.01f)
+
+// Time of a sample of the test log.
+static float GetReaderTestTime(const int32 Index)
+{
+	return Index * DATA_LOG_READER_TEST_TIME_STEP;
+}
+
+// Value of a channel of a sample of the test log, every value tells its sample and channel.
+static float GetReaderTestValue(const int32 Stream, const int32 Index, const int32 Channel)
+{
+	return Channel == EMWDataChannel::Time ? GetReaderTestTime(Index) : float(Stream * 100000 + Index * 10 + Channel);
+}
+
+// Writes the test log with MWControllerDataWriter: a long stream over three chunks (the last not full) and a short one.
+static bool WriteReaderTestLog(const FString& FilePath)
+{
+	TArray<FString> ChannelNames = MWControllerDataLog::GetBaseChannelNames();
+	ChannelNames.Add(TEXT("Extra"));
+
+	TArray<uint8> Header;
+	MWControllerDataLog::WriteHeader(ChannelNames, Header);
+
+	IFileHandle* FileHandle = FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*FilePath);
+	if (!FileHandle || !FileHandle->Write(Header.GetData(), Header.Num()))
+	{
+		delete FileHandle;
+		return false;
+	}
+
+	// The ring holds every sample, so none is dropped however late the writer thread runs.
+	MWControllerDataWriter* Writer = new MWControllerDataWriter(FileHandle, DATA_LOG_READER_TEST_SAMPLES + DATA_LOG_READER_TEST_OTHER_SAMPLES, DATA_LOG_READER_TEST_CHANNELS, true);
+
+	FMWDataLogStream StreamInfo;
+	StreamInfo.Id = TEXT("LongId");
+	StreamInfo.Name = TEXT("Long");
+	const int32 LongStream = Writer->AddStream(StreamInfo);
+	StreamInfo.Id = TEXT("ShortId");
+	StreamInfo.Name = TEXT("Short");
+	const int32 ShortStream = Writer->AddStream(StreamInfo);
+
+	bool bPushed = true;
+	FMWControllerDataSample Sample;
+	for (int32 Index = 0; Index < DATA_LOG_READER_TEST_SAMPLES; ++Index)
+	{
+		for (const int32 Stream : { LongStream, ShortStream })
+		{
+			if (Stream == ShortStream && Index >= DATA_LOG_READER_TEST_OTHER_SAMPLES)
+			{
+				continue;
+			}
+			for (int32 Channel = 0; Channel < DATA_LOG_READER_TEST_CHANNELS; ++Channel)
+			{
+				Sample.Values[Channel] = GetReaderTestValue(Stream, Index, Channel);
+			}
+			Sample.Stream = Stream;
+			bPushed &= Writer->Push(Sample);
+		}
+	}
+
+	// Writes the rest and the index.
+	delete Writer;
+	return bPushed;
+}
+
+// Compares the columns of a read with the given samples of a stream.
+static void TestReaderSamples(FAutomationTestBase& Test, const FString& What, const TArray<TArray<float>>& Columns, const int32 Stream, const TArray<int32>& Indices)
+{
+	if (!Test.TestEqual(What + TEXT(": number of channels"), Columns.Num(), DATA_LOG_READER_TEST_CHANNELS))
+	{
+		return;
+	}
+	for (int32 Channel = 0; Channel < DATA_LOG_READER_TEST_CHANNELS; ++Channel)
+	{
+		if (!Test.TestEqual(FString::Printf(TEXT("%s: number of samples of channel %d"), *What, Channel), Columns[Channel].Num(), Indices.Num()))
+		{
+			return;
+		}
+		for (int32 i = 0; i < Indices.Num(); ++i)
+		{
+			if (Columns[Channel][i] != GetReaderTestValue(Stream, Indices[i], Channel))
+			{
+				Test.AddError(FString::Printf(TEXT("%s: channel %d of sample %d is %f instead of %f."), *What, Channel, Indices[i], Columns[Channel][i], GetReaderTestValue(Stream, Indices[i], Channel)));
+				return;
+			}
+		}
+	}
+}
+
+// Samples of a stream whose time is in a range, found without the reader.
+static TArray<int32> GetReaderTestRange(const int32 NumSamples, const float StartTime, const float EndTime)
+{
+	TArray<int32> Indices;
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		if (GetReaderTestTime(Index) >= StartTime && GetReaderTestTime(Index) <= EndTime)
+		{
+			Indices.Add(Index);
+		}
+	}
+	return Indices;
+}
+
+// Checks the time ranges and overviews of one stream.
+static void TestReaderStream(FAutomationTestBase& Test, const FString& What, const MWControllerDataLogReader& Reader, const int32 Stream, const int32 NumSamples)
+{
+	Test.TestEqual(What + TEXT(": number of samples"), Reader.GetNumSamples(Stream), int64(NumSamples));
+
+	TArray<TArray<float>> Columns;
+	TArray<int32> All;
+	for (int32 Index = 0; Index < NumSamples; ++Index)
+	{
+		All.Add(Index);
+	}
+	Test.TestTrue(What + TEXT(": all samples are read"), Reader.ReadAll(Stream, Columns));
+	TestReaderSamples(Test, What + TEXT(", all samples"), Columns, Stream, All);
+
+	// Inside one chunk, across chunks, starting on the first sample of a chunk, around and outside the recording.
+	const float LastTime = GetReaderTestTime(NumSamples - 1);
+	const float Ranges[][2] = {
+		{ GetReaderTestTime(100), GetReaderTestTime(200) },
+		{ 0.015f, 0.055f },
+		{ GetReaderTestTime(400), GetReaderTestTime(1100) },
+		{ GetReaderTestTime(DATA_LOG_CHUNK_SAMPLES), GetReaderTestTime(DATA_LOG_CHUNK_SAMPLES) },
+		{ GetReaderTestTime(DATA_LOG_CHUNK_SAMPLES - 1), GetReaderTestTime(DATA_LOG_CHUNK_SAMPLES) },
+		{ -10.f, 1000.f },
+		{ -10.f, -1.f },
+		{ LastTime + 1.f, LastTime + 2.f },
+		{ 2.f, 1.f }
+	};
+	for (const auto& Range : Ranges)
+	{
+		const FString RangeWhat = FString::Printf(TEXT("%s, range %f to %f"), *What, Range[0], Range[1]);
+		Test.TestTrue(RangeWhat + TEXT(" is read"), Reader.ReadRange(Stream, Range[0], Range[1], Columns));
+		TestReaderSamples(Test, RangeWhat, Columns, Stream, GetReaderTestRange(NumSamples, Range[0], Range[1]));
+	}
+
+	// Spacing within a chunk, of more than a chunk, and more samples than the stream has.
+	for (const int32 MaxSamples : { 100, 7, 2, 1, NumSamples, NumSamples * 2 })
+	{
+		const int32 Stride = NumSamples <= MaxSamples ? 1 : (NumSamples + MaxSamples - 1) / MaxSamples;
+		TArray<int32> Indices;
+		for (int32 Index = 0; Index < NumSamples; Index += Stride)
+		{
+			Indices.Add(Index);
+		}
+
+		const FString OverviewWhat = FString::Printf(TEXT("%s, overview of %d samples"), *What, MaxSamples);
+		Test.TestTrue(OverviewWhat + TEXT(" is read"), Reader.ReadOverview(Stream, MaxSamples, Columns));
+		Test.TestTrue(OverviewWhat + TEXT(" has at most the samples asked for"), Columns.Num() > 0 && Columns[0].Num() <= MaxSamples);
+		TestReaderSamples(Test, OverviewWhat, Columns, Stream, Indices);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMWControllerDataLogReaderTest, "UBaseControllerMWDataCollector.DataLog.Reader", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Writes a log of two robots and checks the time ranges and overviews of the reader, with and without index.
+bool FMWControllerDataLogReaderTest::RunTest(const FString& Parameters)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::AutomationTransientDir());
+	const FString FilePath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("MWControllerDataLogReaderTest.mwlog"));
+	const FString CrashedFilePath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("MWControllerDataLogReaderTest_Crashed.mwlog"));
+
+	if (!TestTrue(TEXT("Log is written"), WriteReaderTestLog(FilePath)))
+	{
+		return false;
+	}
+
+	MWControllerDataLogReader Reader;
+	if (!TestTrue(TEXT("Log is opened"), Reader.Open(FilePath)))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Number of channels"), Reader.GetChannelNames().Num(), DATA_LOG_READER_TEST_CHANNELS);
+	TestEqual(TEXT("Number of chunks"), Reader.GetChunks().Num(), 4);
+
+	const int32 LongStream = Reader.FindStream(TEXT("LongId"));
+	const int32 ShortStream = Reader.FindStream(TEXT("Short"));
+	if (!TestTrue(TEXT("Streams are found by id and name"), LongStream != INDEX_NONE && ShortStream != INDEX_NONE))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Unknown stream"), Reader.FindStream(TEXT("Nobody")), int32(INDEX_NONE));
+
+	TestReaderStream(*this, TEXT("Long stream"), Reader, LongStream, DATA_LOG_READER_TEST_SAMPLES);
+	TestReaderStream(*this, TEXT("Short stream"), Reader, ShortStream, DATA_LOG_READER_TEST_OTHER_SAMPLES);
+
+	TArray<TArray<float>> Columns;
+	TestTrue(TEXT("Stream that is not in the log"), Reader.ReadRange(Reader.GetStreams().Num(), 0.f, 1000.f, Columns) && Columns.Num() > 0 && Columns[0].Num() == 0);
+
+	// A crashed run: no index and the last chunk cut off. The complete chunks are found by their headers.
+	TArray<uint8> Content;
+	FFileHelper::LoadFileToArray(Content, *FilePath);
+	const FMWDataLogChunk LastChunk = Reader.GetChunks().Last();
+	Reader.Close();
+
+	Content.SetNum(int32(LastChunk.Offset) + 20);
+	if (TestTrue(TEXT("Crashed log is written"), FFileHelper::SaveArrayToFile(Content, *CrashedFilePath))
+		&& TestTrue(TEXT("Crashed log is opened"), Reader.Open(CrashedFilePath)))
+	{
+		TestEqual(TEXT("Complete chunks of the crashed log"), Reader.GetChunks().Num(), 3);
+		TestEqual(TEXT("Streams of the crashed log"), Reader.GetStreams().Num(), 2);
+
+		// The chunks that were not full are written last, the short stream was only in the lost one.
+		const int32 CrashedLongStream = Reader.FindStream(TEXT("LongId"));
+		TestEqual(TEXT("Samples of the short stream of the crashed log"), Reader.GetNumSamples(Reader.FindStream(TEXT("ShortId"))), int64(0));
+		TestReaderStream(*this, TEXT("Long stream of the crashed log"), Reader, CrashedLongStream, DATA_LOG_READER_TEST_SAMPLES);
+		Reader.Close();
+	}
+
+	PlatformFile.DeleteFile(*FilePath);
+	PlatformFile.DeleteFile(*CrashedFilePath);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,260 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "MWControllerDataLog.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define DATA_LOG_TEST_STREAMS (3)
+#define DATA_LOG_TEST_SAMPLES (2000)
+#define DATA_LOG_TEST_EXTRA_CHANNELS (2)
+#define DATA_LOG_TEST_CHANNELS (EMWDataChannel::Num + DATA_LOG_TEST_EXTRA_CHANNELS)
+#define DATA_LOG_TEST_TIME_STEP (1.f / 60.f)
+
+// Sample of a robot as the data collector records it: time, twist, wheels and extra channels.
+// The twist ramps and then holds, as with ROS commands, the last extra channel is noise that does not compress.
+static void GetDataLogTestSample(const int32 Stream, const int32 Index, float* Values)
+{
+	const float Time = Index * DATA_LOG_TEST_TIME_STEP;
+	const float Ramp = FMath::Min(Time, 1.f) * (Stream + 1) * 0.25f;
+	const bool bTurning = (Index / 300) % 2 == 1;
+
+	Values[EMWDataChannel::Time] = Time;
+	Values[EMWDataChannel::LongitudinalVelocity] = Ramp;
+	Values[EMWDataChannel::TransversalVelocity] = Stream == 1 ? Ramp * 0.5f : 0.f;
+	Values[EMWDataChannel::AngularVelocity] = bTurning ? 0.3f : 0.f;
+	Values[EMWDataChannel::WheelLeftFront] = (Ramp - Values[EMWDataChannel::AngularVelocity]) * 20.f;
+	Values[EMWDataChannel::WheelRightFront] = (Ramp + Values[EMWDataChannel::AngularVelocity]) * 20.f;
+	Values[EMWDataChannel::WheelLeftRear] = Values[EMWDataChannel::WheelLeftFront];
+	Values[EMWDataChannel::WheelRightRear] = Values[EMWDataChannel::WheelRightFront];
+	Values[EMWDataChannel::Num] = Stream;
+	Values[EMWDataChannel::Num + 1] = FMath::Sin(Index * 12.9898f + Stream) * 43758.5453f;
+
+	// Values that a text format would not keep: the format must give back the same bits.
+	if (Index == 1000)
+	{
+		uint32 Bits[] = { 0x80000000u, 0x7FC00123u, 0x7F800000u, 0xFF800000u, 0x00000001u, 0x007FFFFFu, 0x7F7FFFFFu, 0x3DCCCCCDu };
+		FMemory::Memcpy(&Values[EMWDataChannel::LongitudinalVelocity], Bits, sizeof(Bits));
+	}
+}
+
+// Compares two values bit by bit, NaN and -0 included.
+static bool IsSameFloat(const float A, const float B)
+{
+	return FMemory::Memcmp(&A, &B, sizeof(float)) == 0;
+}
+
+// Copy of the log with a value of the index overwritten, Position counts from the start of the index.
+template <typename T>
+static TArray<uint8> GetDamagedDataLog(const TArray<uint8>& Log, const int64 IndexOffset, const int64 Position, const T Value)
+{
+	TArray<uint8> Damaged = Log;
+	FMemory::Memcpy(Damaged.GetData() + IndexOffset + Position, &Value, sizeof(T));
+	return Damaged;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMWControllerDataLogRoundTripTest, "UBaseControllerMWDataCollector.DataLog.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Writes a log of several streams the way MWControllerDataWriter does, reads it back with DecodeChunk
+// and compares every value bit by bit. Also compares the size with the csv lines of the same samples.
+bool FMWControllerDataLogRoundTripTest::RunTest(const FString& Parameters)
+{
+	TArray<FString> ChannelNames = MWControllerDataLog::GetBaseChannelNames();
+	ChannelNames.Add(TEXT("Stream"));
+	ChannelNames.Add(TEXT("Noise"));
+
+	TArray<uint8> Log;
+	MWControllerDataLog::WriteHeader(ChannelNames, Log);
+
+	TArray<FMWDataLogStream> Streams;
+	TArray<MWControllerDataLogEncoder*> Encoders;
+	for (int32 Stream = 0; Stream < DATA_LOG_TEST_STREAMS; ++Stream)
+	{
+		FMWDataLogStream& StreamInfo = Streams[Streams.AddDefaulted()];
+		StreamInfo.Id = FString::Printf(TEXT("Robot%d"), Stream);
+		StreamInfo.Name = FString::Printf(TEXT("Robot %d \u00E4"), Stream);
+		MWControllerDataLog::WriteStream(Stream, StreamInfo, Log);
+		Encoders.Add(new MWControllerDataLogEncoder(DATA_LOG_TEST_CHANNELS, Stream));
+	}
+
+	// The streams are recorded together, so their chunks are interleaved in the file.
+	TArray<FMWDataLogChunk> Chunks;
+	TArray<uint8> Csv;
+	float Values[DATA_LOG_TEST_CHANNELS];
+	for (int32 Index = 0; Index < DATA_LOG_TEST_SAMPLES; ++Index)
+	{
+		for (int32 Stream = 0; Stream < DATA_LOG_TEST_STREAMS; ++Stream)
+		{
+			GetDataLogTestSample(Stream, Index, Values);
+			Encoders[Stream]->Add(Values);
+			if (Encoders[Stream]->IsFull())
+			{
+				Encoders[Stream]->Encode(Log, Log.Num(), Chunks);
+			}
+			MWControllerDataLog::AppendCsvLine(Values, DATA_LOG_TEST_CHANNELS, Csv);
+		}
+	}
+	for (MWControllerDataLogEncoder* Encoder : Encoders)
+	{
+		if (Encoder->Num() > 0)
+		{
+			Encoder->Encode(Log, Log.Num(), Chunks);
+		}
+		delete Encoder;
+	}
+	const int64 IndexOffset = Log.Num();
+	MWControllerDataLog::WriteIndex(Chunks, Streams, IndexOffset, Log);
+
+	// Header and index.
+	TArray<FString> ReadChannelNames;
+	int64 FirstRecordOffset = 0;
+	if (!TestTrue(TEXT("Header is read"), MWControllerDataLog::ReadHeader(Log.GetData(), Log.Num(), ReadChannelNames, FirstRecordOffset)))
+	{
+		return false;
+	}
+	TestTrue(TEXT("Channel names are kept"), ReadChannelNames == ChannelNames);
+
+	TArray<FMWDataLogChunk> ReadChunks;
+	TArray<FMWDataLogStream> ReadStreams;
+	if (!TestTrue(TEXT("Index is read"), MWControllerDataLog::ReadIndex(Log.GetData(), Log.Num(), ReadChunks, ReadStreams)))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Number of chunks"), ReadChunks.Num(), Chunks.Num());
+	TestEqual(TEXT("Number of streams"), ReadStreams.Num(), Streams.Num());
+	for (int32 Stream = 0; Stream < ReadStreams.Num() && Stream < Streams.Num(); ++Stream)
+	{
+		TestEqual(TEXT("Stream id"), ReadStreams[Stream].Id, Streams[Stream].Id);
+		TestEqual(TEXT("Stream name"), ReadStreams[Stream].Name, Streams[Stream].Name);
+	}
+
+	// Every value of every chunk, bit by bit.
+	int32 NextSample[DATA_LOG_TEST_STREAMS] = { 0 };
+	int32 NumMismatches = 0;
+	TArray<TArray<float>> Columns;
+	for (const FMWDataLogChunk& Chunk : ReadChunks)
+	{
+		if (!TestTrue(TEXT("Chunk has a stream of the log"), Chunk.Stream >= 0 && Chunk.Stream < DATA_LOG_TEST_STREAMS)
+			|| !TestTrue(FString::Printf(TEXT("Chunk at %lld is decoded"), Chunk.Offset), MWControllerDataLog::DecodeChunk(Log.GetData(), Log.Num(), Chunk, DATA_LOG_TEST_CHANNELS, Columns)))
+		{
+			return false;
+		}
+
+		for (int32 Sample = 0; Sample < Chunk.NumSamples; ++Sample)
+		{
+			GetDataLogTestSample(Chunk.Stream, NextSample[Chunk.Stream]++, Values);
+			for (int32 Channel = 0; Channel < DATA_LOG_TEST_CHANNELS; ++Channel)
+			{
+				if (!IsSameFloat(Columns[Channel][Sample], Values[Channel]) && ++NumMismatches <= 10)
+				{
+					AddError(FString::Printf(TEXT("Stream %d, sample %d, channel %d: got %f instead of %f."),
+						Chunk.Stream, NextSample[Chunk.Stream] - 1, Channel, Columns[Channel][Sample], Values[Channel]));
+				}
+			}
+		}
+		TestTrue(TEXT("First time of the chunk"), Chunk.NumSamples == 0 || IsSameFloat(Chunk.FirstTime, Columns[EMWDataChannel::Time][0]));
+		TestTrue(TEXT("Last time of the chunk"), Chunk.NumSamples == 0 || IsSameFloat(Chunk.LastTime, Columns[EMWDataChannel::Time][Chunk.NumSamples - 1]));
+	}
+	for (int32 Stream = 0; Stream < DATA_LOG_TEST_STREAMS; ++Stream)
+	{
+		TestEqual(FString::Printf(TEXT("Samples of stream %d"), Stream), NextSample[Stream], DATA_LOG_TEST_SAMPLES);
+	}
+
+	// A crashed run has no index, the records are found by their headers then.
+	int64 Offset = FirstRecordOffset;
+	int32 NumScannedChunks = 0;
+	int32 NumScannedStreams = 0;
+	while (Offset < IndexOffset)
+	{
+		FMWDataLogChunk Chunk;
+		int32 Stream = 0;
+		FMWDataLogStream StreamInfo;
+		int64 NextOffset = 0;
+		if (MWControllerDataLog::ReadChunkHeader(Log.GetData(), IndexOffset, Offset, DATA_LOG_TEST_CHANNELS, Chunk, NextOffset))
+		{
+			TestTrue(TEXT("Scanned chunk matches the index"), Chunks.IsValidIndex(NumScannedChunks) && Chunks[NumScannedChunks].Offset == Chunk.Offset && Chunks[NumScannedChunks].NumSamples == Chunk.NumSamples);
+			++NumScannedChunks;
+		}
+		else if (MWControllerDataLog::ReadStream(Log.GetData(), IndexOffset, Offset, Stream, StreamInfo, NextOffset))
+		{
+			TestEqual(TEXT("Scanned stream"), Stream, NumScannedStreams++);
+		}
+		else
+		{
+			AddError(FString::Printf(TEXT("No record at %lld."), Offset));
+			break;
+		}
+		Offset = NextOffset;
+	}
+	TestEqual(TEXT("Scanned chunks"), NumScannedChunks, Chunks.Num());
+	TestEqual(TEXT("Scanned streams"), NumScannedStreams, DATA_LOG_TEST_STREAMS);
+	TestFalse(TEXT("Log without index has no index"), MWControllerDataLog::ReadIndex(Log.GetData(), IndexOffset, ReadChunks, ReadStreams));
+
+	// A damaged index is not used, the reader scans the chunks then. After the magic and the number of chunks
+	// every entry has the offset, the stream and the number of samples of a chunk.
+	const int64 FirstEntry = 2 * sizeof(uint32);
+	const TArray<uint8> ManyChunks = GetDamagedDataLog<uint32>(Log, IndexOffset, sizeof(uint32), 0xFFFFFFFFu);
+	TestFalse(TEXT("Index with more chunks than the file has bytes"), MWControllerDataLog::ReadIndex(ManyChunks.GetData(), ManyChunks.Num(), ReadChunks, ReadStreams));
+	TestEqual(TEXT("No chunks of an index with too many chunks"), ReadChunks.Num(), 0);
+	const TArray<uint8> OutsideChunk = GetDamagedDataLog<uint64>(Log, IndexOffset, FirstEntry, uint64(Log.Num()) + 1000);
+	TestFalse(TEXT("Index with a chunk outside of the file"), MWControllerDataLog::ReadIndex(OutsideChunk.GetData(), OutsideChunk.Num(), ReadChunks, ReadStreams));
+	const TArray<uint8> MovedChunk = GetDamagedDataLog<uint64>(Log, IndexOffset, FirstEntry, uint64(Chunks[0].Offset) + 4);
+	TestFalse(TEXT("Index with a chunk that does not start with the magic"), MWControllerDataLog::ReadIndex(MovedChunk.GetData(), MovedChunk.Num(), ReadChunks, ReadStreams));
+	const TArray<uint8> LargeChunk = GetDamagedDataLog<uint32>(Log, IndexOffset, FirstEntry + sizeof(uint64) + sizeof(uint32), uint32(DATA_LOG_CHUNK_SAMPLES + 1));
+	TestFalse(TEXT("Index with a chunk of too many samples"), MWControllerDataLog::ReadIndex(LargeChunk.GetData(), LargeChunk.Num(), ReadChunks, ReadStreams));
+
+	// The chunks of an index are checked again when they are decoded.
+	FMWDataLogChunk DamagedChunk = Chunks[0];
+	DamagedChunk.NumSamples = DATA_LOG_CHUNK_SAMPLES + 1;
+	TestFalse(TEXT("Chunk of too many samples is not decoded"), MWControllerDataLog::DecodeChunk(Log.GetData(), Log.Num(), DamagedChunk, DATA_LOG_TEST_CHANNELS, Columns));
+	DamagedChunk = Chunks[0];
+	DamagedChunk.Offset += 4;
+	TestFalse(TEXT("Chunk without the magic is not decoded"), MWControllerDataLog::DecodeChunk(Log.GetData(), Log.Num(), DamagedChunk, DATA_LOG_TEST_CHANNELS, Columns));
+
+	// Size against the csv files of the same samples (one file per robot, so one header per stream).
+	const int64 CsvHeaderSize = FTCHARToUTF8(*MWControllerDataLog::GetCsvHeader({ TEXT("Stream"), TEXT("Noise") })).Length();
+	const int64 CsvSize = Csv.Num() + DATA_LOG_TEST_STREAMS * CsvHeaderSize;
+	AddInfo(FString::Printf(TEXT("%d samples of %d channels: binary %lld bytes (%.2f per sample), csv %lld bytes (%.2f per sample), %.1f%% of the csv size."),
+		DATA_LOG_TEST_STREAMS * DATA_LOG_TEST_SAMPLES, DATA_LOG_TEST_CHANNELS,
+		int64(Log.Num()), double(Log.Num()) / (DATA_LOG_TEST_STREAMS * DATA_LOG_TEST_SAMPLES),
+		CsvSize, double(CsvSize) / (DATA_LOG_TEST_STREAMS * DATA_LOG_TEST_SAMPLES), 100.0 * Log.Num() / CsvSize));
+	TestTrue(TEXT("Binary log is smaller than the csv files"), Log.Num() < CsvSize);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMWControllerDataLogColumnTest, "UBaseControllerMWDataCollector.DataLog.Column", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Checks the sizes of the column encoding and that damaged columns are found.
+bool FMWControllerDataLogColumnTest::RunTest(const FString& Parameters)
+{
+	// Values that do not change take one byte, the first zero too.
+	const float Constant[] = { 0.f, 0.f, 0.f, 0.f };
+	TArray<uint8> Encoded;
+	MWControllerDataLog::EncodeColumn(Constant, ARRAY_COUNT(Constant), Encoded);
+	TestEqual(TEXT("Constant column"), Encoded.Num(), int32(ARRAY_COUNT(Constant)));
+
+	// A change of one byte takes two.
+	uint32 Bits[] = { 0x3F800000u, 0x3F800001u };
+	float Changed[2];
+	FMemory::Memcpy(Changed, Bits, sizeof(Bits));
+	Encoded.Reset();
+	MWControllerDataLog::EncodeColumn(Changed, 2, Encoded);
+	TestEqual(TEXT("Column with a small change"), Encoded.Num(), 1 + 2 + 2);
+
+	float Decoded[2];
+	TestTrue(TEXT("Column is decoded"), MWControllerDataLog::DecodeColumn(Encoded.GetData(), Encoded.Num(), 2, Decoded));
+	TestTrue(TEXT("Decoded column is the same"), FMemory::Memcmp(Decoded, Changed, sizeof(Changed)) == 0);
+
+	// Too short, too long and a control byte with more than four zero bytes.
+	TestFalse(TEXT("Truncated column"), MWControllerDataLog::DecodeColumn(Encoded.GetData(), Encoded.Num() - 1, 2, Decoded));
+	TestFalse(TEXT("Column with bytes left"), MWControllerDataLog::DecodeColumn(Encoded.GetData(), Encoded.Num(), 1, Decoded));
+	const uint8 Invalid[] = { 0x41 };
+	TestFalse(TEXT("Invalid control byte"), MWControllerDataLog::DecodeColumn(Invalid, 1, 1, Decoded));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
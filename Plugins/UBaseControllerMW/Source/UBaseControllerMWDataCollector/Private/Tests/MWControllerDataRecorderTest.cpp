@@ -0,0 +1,170 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "MWControllerDataRecorder.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Binary fractions, so the times of the samples hit the grid of the rates exactly.
+#define DATA_RECORDER_TEST_TIME_STEP (1.f / 64.f)
+#define DATA_RECORDER_TEST_INTERVAL (1.f / 8.f)
+
+// Starts a recorder with the base channels, the settings only apply to one channel
+static void InitDataRecorderTest(MWControllerDataRecorder& Recorder, const int32 Channel, const float Interval, const float Deadband,
+	const bool bRecordOnlyChanges, const bool bTriggerMode = false, const int32 PreTriggerSamples = 1, const int32 PostTriggerSamples = 0)
+{
+	float Intervals[EMWDataChannel::Num] = {};
+	float Deadbands[EMWDataChannel::Num] = {};
+	Intervals[Channel] = Interval;
+	Deadbands[Channel] = Deadband;
+	Recorder.Init(EMWDataChannel::Num, Intervals, Deadbands, bRecordOnlyChanges, bTriggerMode, PreTriggerSamples, PostTriggerSamples);
+}
+
+// Sample at a step, one channel has a value, the others are 0
+static FMWControllerDataSample GetDataRecorderTestSample(const int32 Step, const int32 Channel, const float Value)
+{
+	FMWControllerDataSample Sample;
+	FMemory::Memzero(Sample.Values, sizeof(Sample.Values));
+	Sample.Values[EMWDataChannel::Time] = Step * DATA_RECORDER_TEST_TIME_STEP;
+	Sample.Values[Channel] = Value;
+	return Sample;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMWControllerDataRecorderRateTest, "UBaseControllerMWDataCollector.Recorder.Rate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// A channel with a rate is recorded on its grid and keeps its value in between, the other channels with every sample.
+bool FMWControllerDataRecorderRateTest::RunTest(const FString& Parameters)
+{
+	MWControllerDataRecorder Recorder;
+	InitDataRecorderTest(Recorder, EMWDataChannel::LongitudinalVelocity, DATA_RECORDER_TEST_INTERVAL, 0.f, false);
+
+	TArray<FMWControllerDataSample> Written;
+	const auto Push = [&Written](const FMWControllerDataSample& Sample) { Written.Add(Sample); return true; };
+
+	const int32 StepsPerInterval = FMath::RoundToInt(DATA_RECORDER_TEST_INTERVAL / DATA_RECORDER_TEST_TIME_STEP);
+	for (int32 Step = 0; Step < 8 * StepsPerInterval; ++Step)
+	{
+		// The rated channel changes with every sample, the angular velocity too.
+		FMWControllerDataSample Sample = GetDataRecorderTestSample(Step, EMWDataChannel::LongitudinalVelocity, float(Step));
+		Sample.Values[EMWDataChannel::AngularVelocity] = float(Step);
+		Recorder.Add(Sample, Push);
+	}
+
+	if (!TestEqual(TEXT("Every sample is written"), Written.Num(), 8 * StepsPerInterval))
+	{
+		return true;
+	}
+	for (int32 Step = 0; Step < Written.Num(); ++Step)
+	{
+		const float* Values = Written[Step].Values;
+		const float Expected = float(Step - Step % StepsPerInterval);
+		if (Values[EMWDataChannel::LongitudinalVelocity] != Expected)
+		{
+			AddError(FString::Printf(TEXT("Step %d: rated channel is %f instead of %f."), Step, Values[EMWDataChannel::LongitudinalVelocity], Expected));
+		}
+		TestEqual(TEXT("Time of the sample"), Values[EMWDataChannel::Time], Step * DATA_RECORDER_TEST_TIME_STEP);
+		TestEqual(TEXT("Channel without a rate"), Values[EMWDataChannel::AngularVelocity], float(Step));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMWControllerDataRecorderDeadbandTest, "UBaseControllerMWDataCollector.Recorder.Deadband", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Changes within the deadband keep the last recorded value, with bRecordOnlyChanges such samples are not written.
+bool FMWControllerDataRecorderDeadbandTest::RunTest(const FString& Parameters)
+{
+	const float Inputs[] = { 0.f, 0.25f, 0.5f, 0.75f, 1.f, 1.5f, 1.5f, 0.75f };
+	const float Recorded[] = { 0.f, 0.f, 0.f, 0.75f, 0.75f, 1.5f, 1.5f, 0.75f };
+
+	for (const bool bRecordOnlyChanges : { false, true })
+	{
+		MWControllerDataRecorder Recorder;
+		InitDataRecorderTest(Recorder, EMWDataChannel::WheelLeftFront, 0.f, 0.5f, bRecordOnlyChanges);
+
+		TArray<FMWControllerDataSample> Written;
+		for (int32 Step = 0; Step < ARRAY_COUNT(Inputs); ++Step)
+		{
+			FMWControllerDataSample Sample = GetDataRecorderTestSample(Step, EMWDataChannel::WheelLeftFront, Inputs[Step]);
+			Recorder.Add(Sample, [&Written](const FMWControllerDataSample& WrittenSample) { Written.Add(WrittenSample); return true; });
+			TestEqual(FString::Printf(TEXT("Step %d: recorded value"), Step), Sample.Values[EMWDataChannel::WheelLeftFront], Recorded[Step]);
+		}
+
+		// Only the first sample and the changes beyond the deadband.
+		TArray<float> Expected;
+		for (int32 Step = 0; Step < ARRAY_COUNT(Recorded); ++Step)
+		{
+			if (!bRecordOnlyChanges || Step == 0 || Recorded[Step] != Recorded[Step - 1])
+			{
+				Expected.Add(Recorded[Step]);
+			}
+		}
+		TArray<float> Values;
+		for (const FMWControllerDataSample& Sample : Written)
+		{
+			Values.Add(Sample.Values[EMWDataChannel::WheelLeftFront]);
+		}
+		TestTrue(bRecordOnlyChanges ? TEXT("Only changed samples are written") : TEXT("Every sample is written"), Values == Expected);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMWControllerDataRecorderTriggerTest, "UBaseControllerMWDataCollector.Recorder.Trigger", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// The pre-trigger ring is written with a trigger, oldest first, followed by the samples after it. A trigger during a capture extends it.
+bool FMWControllerDataRecorderTriggerTest::RunTest(const FString& Parameters)
+{
+	MWControllerDataRecorder Recorder;
+	InitDataRecorderTest(Recorder, EMWDataChannel::LongitudinalVelocity, 0.f, 0.f, false, true, 4, 3);
+
+	TArray<int32> Written;
+	const auto Push = [&Written](const FMWControllerDataSample& Sample) { Written.Add(FMath::RoundToInt(Sample.Values[EMWDataChannel::LongitudinalVelocity])); return true; };
+	int32 Step = 0;
+	const auto AddSamples = [&Recorder, &Push, &Step](const int32 Num)
+	{
+		for (int32 i = 0; i < Num; ++i, ++Step)
+		{
+			FMWControllerDataSample Sample = GetDataRecorderTestSample(Step, EMWDataChannel::LongitudinalVelocity, float(Step));
+			Recorder.Add(Sample, Push);
+		}
+	};
+
+	AddSamples(10);
+	TestEqual(TEXT("Nothing is written before a trigger"), Written.Num(), 0);
+	TestEqual(TEXT("The ring keeps the last samples"), Recorder.GetNumPreTriggerSamples(), 4);
+
+	TestTrue(TEXT("First trigger starts a capture"), Recorder.Trigger(Push));
+	TestTrue(TEXT("Pre-trigger samples, oldest first"), Written == TArray<int32>({ 6, 7, 8, 9 }));
+
+	// Three samples after the trigger, the fourth goes into the ring again.
+	AddSamples(4);
+	TestTrue(TEXT("Post-trigger samples"), Written == TArray<int32>({ 6, 7, 8, 9, 10, 11, 12 }));
+	TestEqual(TEXT("Sample after the capture is in the ring"), Recorder.GetNumPreTriggerSamples(), 1);
+
+	// A new capture, then a trigger during it only extends it.
+	AddSamples(1);
+	TestTrue(TEXT("Trigger after the capture starts a new one"), Recorder.Trigger(Push));
+	AddSamples(1);
+	TestFalse(TEXT("Trigger during a capture does not start a new one"), Recorder.Trigger(Push));
+	AddSamples(4);
+	TestTrue(TEXT("Extended capture, no sample lost or repeated"), Written == TArray<int32>({ 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18 }));
+	TestEqual(TEXT("Number of captures"), Recorder.GetNumTriggers(), 2);
+
+	// In the continuous mode every sample is written and triggers do nothing.
+	MWControllerDataRecorder Continuous;
+	InitDataRecorderTest(Continuous, EMWDataChannel::LongitudinalVelocity, 0.f, 0.f, false);
+	Written.Reset();
+	for (Step = 0; Step < 3; ++Step)
+	{
+		FMWControllerDataSample Sample = GetDataRecorderTestSample(Step, EMWDataChannel::LongitudinalVelocity, float(Step));
+		Continuous.Add(Sample, Push);
+	}
+	TestFalse(TEXT("No capture in the continuous mode"), Continuous.Trigger(Push));
+	TestTrue(TEXT("Continuous mode writes every sample once"), Written == TArray<int32>({ 0, 1, 2 }));
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
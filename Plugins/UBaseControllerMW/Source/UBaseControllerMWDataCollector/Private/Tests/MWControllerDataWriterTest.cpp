@@ -0,0 +1,134 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "MWControllerDataLog.h"
+#include "MWControllerDataWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define DATA_WRITER_TEST_CAPACITY (1024)
+// Several wakes of the writer thread, see DATA_WRITER_WAIT_MS.
+#define DATA_WRITER_TEST_SECONDS (0.5)
+
+// Value of a channel of a sample. The number of the sample is split over two channels, so every value is exact as a float.
+static float GetWriterTestValue(const uint32 Index, const int32 Channel)
+{
+	switch (Channel)
+	{
+	case EMWDataChannel::Time:
+		return float(Index % 65536);
+	case EMWDataChannel::LongitudinalVelocity:
+		return float(Index / 65536);
+	default:
+		return float(Channel);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMWControllerDataWriterFullRingTest, "UBaseControllerMWDataCollector.DataWriter.FullRing", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// The producer pushes as fast as it can, so the ring is full most of the time and the writer thread drains it on every wake.
+// The writer is deleted while the ring is full. Every sample the ring took is in the log, in the order of the pushes,
+// and every other one is counted as dropped.
+bool FMWControllerDataWriterFullRingTest::RunTest(const FString& Parameters)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::AutomationTransientDir());
+	const FString FilePath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("MWControllerDataWriterTest.mwlog"));
+
+	TArray<uint8> Header;
+	MWControllerDataLog::WriteHeader(MWControllerDataLog::GetBaseChannelNames(), Header);
+	IFileHandle* FileHandle = PlatformFile.OpenWrite(*FilePath);
+	if (!TestTrue(TEXT("Log is created"), FileHandle && FileHandle->Write(Header.GetData(), Header.Num())))
+	{
+		delete FileHandle;
+		return false;
+	}
+
+	MWControllerDataWriter* Writer = new MWControllerDataWriter(FileHandle, DATA_WRITER_TEST_CAPACITY, EMWDataChannel::Num, true);
+	FMWDataLogStream StreamInfo;
+	StreamInfo.Id = TEXT("Robot");
+	StreamInfo.Name = TEXT("Robot");
+	const int32 Stream = Writer->AddStream(StreamInfo);
+
+	TArray<uint32> Accepted;
+	int64 NumPushes = 0;
+	bool bLastPushAccepted = false;
+	FMWControllerDataSample Sample;
+	Sample.Stream = Stream;
+	const double Start = FPlatformTime::Seconds();
+	for (uint32 Index = 0; FPlatformTime::Seconds() - Start < DATA_WRITER_TEST_SECONDS || bLastPushAccepted; ++Index)
+	{
+		for (int32 Channel = 0; Channel < EMWDataChannel::Num; ++Channel)
+		{
+			Sample.Values[Channel] = GetWriterTestValue(Index, Channel);
+		}
+		++NumPushes;
+		bLastPushAccepted = Writer->Push(Sample);
+		if (bLastPushAccepted)
+		{
+			Accepted.Add(Index);
+		}
+		else
+		{
+			FPlatformProcess::Sleep(0.f);
+		}
+	}
+
+	// The last push found the ring full, the destructor writes what is left.
+	const int64 NumDropped = Writer->GetDroppedSamples();
+	delete Writer;
+
+	TestTrue(TEXT("The ring was full"), NumDropped > 0);
+	TestTrue(TEXT("The writer drained the ring while the producer pushed"), Accepted.Num() > DATA_WRITER_TEST_CAPACITY);
+	TestEqual(TEXT("Every push is either in the ring or dropped"), int64(Accepted.Num()) + NumDropped, NumPushes);
+
+	TArray<uint8> Log;
+	TArray<FString> ChannelNames;
+	TArray<FMWDataLogChunk> Chunks;
+	TArray<FMWDataLogStream> Streams;
+	int64 Offset = 0;
+	if (!TestTrue(TEXT("Log is read"), FFileHelper::LoadFileToArray(Log, *FilePath))
+		|| !TestTrue(TEXT("Header is read"), MWControllerDataLog::ReadHeader(Log.GetData(), Log.Num(), ChannelNames, Offset))
+		|| !TestTrue(TEXT("The index is written on shutdown"), MWControllerDataLog::ReadIndex(Log.GetData(), Log.Num(), Chunks, Streams)))
+	{
+		return false;
+	}
+
+	// One stream, so the chunks of the file are in the order of the samples.
+	TArray<uint32> Written;
+	TArray<TArray<float>> Columns;
+	for (const FMWDataLogChunk& Chunk : Chunks)
+	{
+		if (!TestTrue(TEXT("Chunk is decoded"), MWControllerDataLog::DecodeChunk(Log.GetData(), Log.Num(), Chunk, EMWDataChannel::Num, Columns)))
+		{
+			return false;
+		}
+		for (int32 i = 0; i < Chunk.NumSamples; ++i)
+		{
+			Written.Add(uint32(Columns[EMWDataChannel::LongitudinalVelocity][i]) * 65536 + uint32(Columns[EMWDataChannel::Time][i]));
+		}
+	}
+
+	TestEqual(TEXT("Samples in the log"), Written.Num(), Accepted.Num());
+	int32 NumMismatches = 0;
+	for (int32 i = 0; i < FMath::Min(Written.Num(), Accepted.Num()); ++i)
+	{
+		if (Written[i] != Accepted[i] && ++NumMismatches <= 5)
+		{
+			AddError(FString::Printf(TEXT("Sample %d of the log is push %u instead of push %u."), i, Written[i], Accepted[i]));
+		}
+	}
+	TestEqual(TEXT("Samples out of order or lost"), NumMismatches, 0);
+
+	PlatformFile.DeleteFile(*FilePath);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
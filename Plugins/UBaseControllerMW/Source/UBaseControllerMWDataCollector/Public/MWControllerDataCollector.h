@@ -6,11 +6,56 @@
 #include "Engine.h"
 #include "Components/ActorComponent.h"
 #include "MWControllerComponent.h"
+#include "MWControllerDataWriter.h"
+#include "MWControllerDataRecorder.h"
 #include "MWControllerDataCollector.generated.h"
 
+/*
+* Format of the data collection files.
+*/
+UENUM()
+enum class EMWDataFormat : uint8
+{
+	Binary	UMETA(DisplayName = "Binary (.mwlog)"),
+	Csv		UMETA(DisplayName = "Csv")
+};
+
+/*
+* When the samples are passed to the file.
+*/
+UENUM()
+enum class EMWRecordingMode : uint8
+{
+	// Every sample is written.
+	Continuous	UMETA(DisplayName = "Continuous"),
+	// The samples are kept in the pre-trigger ring and only written around a trigger.
+	Trigger		UMETA(DisplayName = "Trigger")
+};
+
+// Recording settings of one channel.
+USTRUCT()
+struct FMWDataChannelSettings
+{
+	GENERATED_BODY()
+
+	// Samples per second of the channel. 0 records the channel with every sample.
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0"))
+		float SampleRateInHz = 0.f;
+
+	// Changes up to this value are not recorded, the channel keeps its last recorded value.
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0"))
+		float Deadband = 0.f;
+};
+
 /*
 * This class stores data from a MWController which is searched in the owner.
 * The stored data are obtained via getter. The data itself is recorded in a csv file, which stores either in each tick (high-performance) or every second.
+* The tick only collects a sample, the file is written by a MWControllerDataWriter on its own thread.
+* The default format is the compressed binary log (MWControllerDataLog), -run=MWControllerDataLogToCsv converts it to the csv layout.
+* Channels can be recorded with a lower rate or a deadband. Between two recordings a channel keeps its last value,
+* which the binary format stores in one byte. With bRecordOnlyChanges samples without a change are not written at all.
+* In the trigger mode the samples stay in a ring and the ring is only written when a trigger fires (wheel speed divergence,
+* stopped controller or TriggerCapture), followed by the samples after the trigger.
 */
 UCLASS(EditInlineNew, ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class UBASECONTROLLERMWDATACOLLECTOR_API UMWControllerDataCollector : public UActorComponent
@@ -67,12 +112,82 @@ private:
 	bool CreateFile();
 
 	/*
-	* Writes the corresponding data into the created csv file. Here the getters are called.
+	* Passes the corresponding data to the writer of the csv file. Here the getters are called.
 	*
-	* @return returns true if it could be written to the file. Otherwise false.
+	* @return returns true if the writer could take the sample. Otherwise false (sample dropped).
 	*/
 	bool WriteInLine();
 
+	/*
+	* Reads the current values of all channels.
+	*
+	* @param Sample Receives the values.
+	*/
+	void ReadSample(FMWControllerDataSample& Sample);
+
+	/*
+	* Resolves the channel settings by name and starts the recorder. Called when the file is created.
+	*/
+	void InitChannelSettings();
+
+	/*
+	* Checks the trigger conditions on the current values.
+	*
+	* @param Sample Sample with the current values.
+	* @return true if a trigger condition is met.
+	*/
+	bool CheckTrigger(const FMWControllerDataSample& Sample) const;
+
+public:
+
+	/*
+	* Gets the number of samples that were dropped because the writer could not keep up.
+	*
+	* @return Number of dropped samples.
+	*/
+	int64 GetDroppedSamples() const;
+
+	/*
+	* Adds an extra channel to the data collection. Only possible before BeginPlay, as the file header lists all channels.
+	*
+	* @param Name Name of the channel.
+	* @return Index of the channel for SetChannelValue, INDEX_NONE if not possible.
+	*/
+	int32 RegisterChannel(const FString& Name);
+
+	/*
+	* Sets the value of an extra channel. The value is stored with every sample until it is set again.
+	*
+	* @param Channel Index from RegisterChannel.
+	* @param Value New value.
+	*/
+	void SetChannelValue(const int32 Channel, const float Value);
+
+	/*
+	* Writes the pre-trigger ring and the next PostTriggerSamples samples. Only used in the trigger mode.
+	*
+	* @param Reason Reason for the log.
+	*/
+	void TriggerCapture(const TCHAR* Reason);
+
+	/*
+	* Gets the number of triggers since BeginPlay.
+	*
+	* @return Number of triggers.
+	*/
+	int32 GetNumTriggers() const;
+
+	/*
+	* Reads the channels every sample has.
+	*
+	* @param Controller Controller of the robot.
+	* @param Time Time of the sample.
+	* @param Sample Receives the values of the base channels.
+	*/
+	static void ReadBaseChannels(UMWControllerComponent* Controller, const float Time, FMWControllerDataSample& Sample);
+
+private:
+
 
 	/*
 	* Called after the end of the game and releases the file.
@@ -95,5 +210,50 @@ private:
 	FString FilePath;
 
 	// File handle to process the raw data
-	IFileHandle* FileHandle;
+	IFileHandle* FileHandle = nullptr;
+
+	// Writes the samples on its own thread. Owns the file handle once it is created.
+	MWControllerDataWriter* Writer = nullptr;
+
+	// Stream of the robot in the file.
+	int32 Stream = 0;
+
+	// Format of the file.
+	UPROPERTY(EditAnywhere, Category = "MW Details")
+		EMWDataFormat DataFormat = EMWDataFormat::Binary;
+
+	// Names and current values of the extra channels.
+	TArray<FString> ExtraChannelNames;
+	float ExtraChannelValues[DATA_MAX_EXTRA_CHANNELS] = {};
+
+	// Samples the writer can hold. If the writer falls behind by more, new samples are dropped.
+	UPROPERTY(EditAnywhere, Category = "MW Details", meta = (ClampMin = "2"))
+		int32 BufferCapacity = 4096;
+
+	// Settings of the channels by name (Time, LongitudinalVelocity, ..., registered channels). Other channels are recorded with every sample.
+	UPROPERTY(EditAnywhere, Category = "MW Details|Recording")
+		TMap<FString, FMWDataChannelSettings> ChannelSettings;
+
+	// Samples without a changed channel are not written.
+	UPROPERTY(EditAnywhere, Category = "MW Details|Recording")
+		bool bRecordOnlyChanges = false;
+
+	// Writes every sample or only the samples around a trigger.
+	UPROPERTY(EditAnywhere, Category = "MW Details|Recording")
+		EMWRecordingMode RecordingMode = EMWRecordingMode::Continuous;
+
+	// Samples before a trigger that are written with it.
+	UPROPERTY(EditAnywhere, Category = "MW Details|Recording", meta = (ClampMin = "1"))
+		int32 PreTriggerSamples = 256;
+
+	// Samples after a trigger that are written.
+	UPROPERTY(EditAnywhere, Category = "MW Details|Recording", meta = (ClampMin = "0"))
+		int32 PostTriggerSamples = 256;
+
+	// Fires a trigger if a wheel differs by more than this from the mean speed of the wheels (cm/s). 0 turns it off.
+	UPROPERTY(EditAnywhere, Category = "MW Details|Recording", meta = (ClampMin = "0"))
+		float WheelDivergenceThreshold = 0.f;
+
+	// Applies the resolved ChannelSettings and the recording mode.
+	MWControllerDataRecorder Recorder;
 };
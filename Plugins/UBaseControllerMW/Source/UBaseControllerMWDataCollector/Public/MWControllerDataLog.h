@@ -0,0 +1,298 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#define DATA_LOG_MAGIC				(0x474C574Du)	// "MWLG"
+#define DATA_LOG_CHUNK_MAGIC		(0x4B4E4843u)	// "CHNK"
+#define DATA_LOG_STREAM_MAGIC		(0x4D525453u)	// "STRM"
+#define DATA_LOG_INDEX_MAGIC		(0x58444E49u)	// "INDX"
+#define DATA_LOG_END_MAGIC			(0x444E454Du)	// "MEND"
+#define DATA_LOG_VERSION			(3)
+#define DATA_LOG_CHUNK_SAMPLES		(512)
+#define DATA_MAX_EXTRA_CHANNELS		(8)
+#define DATA_LOG_MAX_STREAMS		(4096)
+
+/*
+* Channels every sample has. Registered extra channels follow after Num.
+*/
+namespace EMWDataChannel
+{
+	enum Type
+	{
+		Time,
+		LongitudinalVelocity,
+		TransversalVelocity,
+		AngularVelocity,
+		WheelLeftFront,
+		WheelRightFront,
+		WheelLeftRear,
+		WheelRightRear,
+		Num
+	};
+}
+
+/*
+* One sample of the data collection. Fixed size, so the game thread only copies it.
+*/
+struct FMWControllerDataSample
+{
+	float Values[EMWDataChannel::Num + DATA_MAX_EXTRA_CHANNELS];
+
+	// Stream (robot) of the sample.
+	int32 Stream = 0;
+};
+
+/*
+* Stream of a log, one per robot.
+*/
+struct FMWDataLogStream
+{
+	// Stable id of the robot.
+	FString Id;
+
+	// Readable name of the robot.
+	FString Name;
+};
+
+/*
+* Position, stream and time range of a chunk in a log.
+*/
+struct FMWDataLogChunk
+{
+	int64 Offset = 0;
+	int32 Stream = 0;
+	int32 NumSamples = 0;
+	float FirstTime = 0.f;
+	float LastTime = 0.f;
+};
+
+/**
+ * Binary format of the data collection (.mwlog). All values are little endian.
+ *
+ * Header: uint32 DATA_LOG_MAGIC, uint16 version, uint16 number of channels,
+ *         per channel uint16 length and the name in UTF-8.
+ * Streams: uint32 DATA_LOG_STREAM_MAGIC, uint32 stream, uint16 length and the id, uint16 length and the name in UTF-8.
+ *         Written before the first chunk of the stream, a log holds the samples of several robots.
+ * Chunks: uint32 DATA_LOG_CHUNK_MAGIC, uint32 stream, uint32 number of samples (at most DATA_LOG_CHUNK_SAMPLES),
+ *         float first and last time, per channel uint32 size and the compressed column.
+ *         The chunks of the streams are interleaved, the chunks of one stream are in the order of the time.
+ * Index:  uint32 DATA_LOG_INDEX_MAGIC, uint32 number of chunks, per chunk uint64 offset, uint32 stream,
+ *         uint32 number of samples, float first and last time. uint32 number of streams and the streams as above
+ *         without magic and stream. Ends with uint64 offset of the index and uint32 DATA_LOG_END_MAGIC.
+ *         Logs of crashed runs have no index, readers find the streams and chunks by their headers then.
+ *
+ * A column stores the float values XOR the previous value (the first with 0). Each value is a control byte
+ * (high nibble: leading zero bytes, low nibble: trailing zero bytes of the XOR) followed by the remaining bytes.
+ * Values that do not change take one byte, the format is lossless.
+ */
+class UBASECONTROLLERMWDATACOLLECTOR_API MWControllerDataLog
+{
+public:
+
+	/*
+	* Gets the names of the channels every sample has.
+	*
+	* @return Names of the channels, in the order of EMWDataChannel.
+	*/
+	static const TArray<FString>& GetBaseChannelNames();
+
+	/*
+	* Creates the folder of the data collection of today (Project/DataCollection/Year.Month.Day).
+	*
+	* @param OutDataDir Receives the path of the folder.
+	* @return false if the folder could not be created.
+	*/
+	static bool CreateDataDir(FString& OutDataDir);
+
+	/*
+	* Gets a path for a new file that no other file has, also not one of the same second.
+	*
+	* @param DataDir Folder of the file.
+	* @param BaseName Start of the file name.
+	* @param Extension Extension of the file without dot.
+	* @return Path of the file.
+	*/
+	static FString GetUniqueFilePath(const FString& DataDir, const FString& BaseName, const FString& Extension);
+
+	/*
+	* Writes the header of a log.
+	*
+	* @param ChannelNames Names of all channels.
+	* @param Out Receives the header.
+	*/
+	static void WriteHeader(const TArray<FString>& ChannelNames, TArray<uint8>& Out);
+
+	/*
+	* Compresses a column.
+	*
+	* @param Values Values of the column.
+	* @param Num Number of values.
+	* @param Out Receives the compressed column.
+	*/
+	static void EncodeColumn(const float* Values, const int32 Num, TArray<uint8>& Out);
+
+	/*
+	* Decompresses a column.
+	*
+	* @param Data Compressed column.
+	* @param Size Size of the compressed column.
+	* @param Num Number of values.
+	* @param Values Receives the values.
+	* @return false if the column is damaged.
+	*/
+	static bool DecodeColumn(const uint8* Data, const int32 Size, const int32 Num, float* Values);
+
+	/*
+	* Writes the record of a new stream.
+	*
+	* @param Stream Index of the stream.
+	* @param StreamInfo Id and name of the stream.
+	* @param Out Receives the record.
+	*/
+	static void WriteStream(const int32 Stream, const FMWDataLogStream& StreamInfo, TArray<uint8>& Out);
+
+	/*
+	* Reads the record of a stream.
+	*
+	* @param Data Content of the file.
+	* @param Size Size of the file.
+	* @param Offset Position of the record.
+	* @param OutStream Receives the index of the stream.
+	* @param OutStreamInfo Receives id and name of the stream.
+	* @param OutNextOffset Receives the position after the record.
+	* @return false if there is no complete stream record at the position.
+	*/
+	static bool ReadStream(const uint8* Data, const int64 Size, const int64 Offset, int32& OutStream, FMWDataLogStream& OutStreamInfo, int64& OutNextOffset);
+
+	/*
+	* Writes the index of the chunks at the end of a log.
+	*
+	* @param Chunks All chunks of the log.
+	* @param Streams All streams of the log.
+	* @param IndexOffset Position of the index in the file.
+	* @param Out Receives the index.
+	*/
+	static void WriteIndex(const TArray<FMWDataLogChunk>& Chunks, const TArray<FMWDataLogStream>& Streams, const int64 IndexOffset, TArray<uint8>& Out);
+
+	/*
+	* Reads the header of a log.
+	*
+	* @param Data Content of the file.
+	* @param Size Size of the file.
+	* @param OutChannelNames Receives the names of the channels.
+	* @param OutOffset Receives the position of the first chunk.
+	* @return false if the file is no log.
+	*/
+	static bool ReadHeader(const uint8* Data, const int64 Size, TArray<FString>& OutChannelNames, int64& OutOffset);
+
+	/*
+	* Reads the index at the end of a log. Besides the end of the file only the magic of every listed chunk is read.
+	*
+	* @param Data Content of the file.
+	* @param Size Size of the file.
+	* @param OutChunks Receives the chunks.
+	* @param OutStreams Receives the streams.
+	* @return false if the log has no (valid) index, also if an entry does not point to a chunk.
+	*/
+	static bool ReadIndex(const uint8* Data, const int64 Size, TArray<FMWDataLogChunk>& OutChunks, TArray<FMWDataLogStream>& OutStreams);
+
+	/*
+	* Reads the header of a chunk and skips its columns.
+	*
+	* @param Data Content of the file.
+	* @param Size Size of the file.
+	* @param Offset Position of the chunk.
+	* @param NumChannels Number of channels of the log.
+	* @param OutChunk Receives the chunk.
+	* @param OutNextOffset Receives the position after the chunk.
+	* @return false if there is no complete chunk at the position.
+	*/
+	static bool ReadChunkHeader(const uint8* Data, const int64 Size, const int64 Offset, const int32 NumChannels, FMWDataLogChunk& OutChunk, int64& OutNextOffset);
+
+	/*
+	* Decompresses all columns of a chunk.
+	*
+	* @param Data Content of the file.
+	* @param Size Size of the file.
+	* @param Chunk Chunk to decompress.
+	* @param NumChannels Number of channels of the log.
+	* @param OutColumns Receives the values per channel, replaces the old values.
+	* @return false if the chunk is damaged.
+	*/
+	static bool DecodeChunk(const uint8* Data, const int64 Size, const FMWDataLogChunk& Chunk, const int32 NumChannels, TArray<TArray<float>>& OutColumns);
+
+	/*
+	* Gets the first line of the csv files.
+	*
+	* @param ExtraChannelNames Names of the registered extra channels.
+	* @return First line with line break.
+	*/
+	static FString GetCsvHeader(const TArray<FString>& ExtraChannelNames);
+
+	/*
+	* Appends a line in the csv format (semicolons, comma as decimal separator).
+	*
+	* @param Values Values of the line.
+	* @param NumChannels Number of values.
+	* @param Out Receives the line.
+	*/
+	static void AppendCsvLine(const float* Values, const int32 NumChannels, TArray<uint8>& Out);
+};
+
+/**
+ * Collects samples column by column and compresses them into chunks of the binary format.
+ */
+class UBASECONTROLLERMWDATACOLLECTOR_API MWControllerDataLogEncoder
+{
+public:
+
+	/*
+	* Constructor of the encoder.
+	*
+	* @param InNumChannels Number of channels of every sample.
+	* @param InStream Stream of the samples.
+	*/
+	MWControllerDataLogEncoder(const int32 InNumChannels, const int32 InStream = 0);
+
+	/*
+	* Adds a sample to the current chunk.
+	*
+	* @param Values Values of the sample, one per channel.
+	*/
+	void Add(const float* Values);
+
+	/*
+	* Indicates whether the chunk has DATA_LOG_CHUNK_SAMPLES samples.
+	*
+	* @return true if full.
+	*/
+	bool IsFull() const;
+
+	/*
+	* Gets the number of samples in the current chunk.
+	*
+	* @return Number of samples.
+	*/
+	int32 Num() const;
+
+	/*
+	* Compresses the current chunk and starts a new one.
+	*
+	* @param Out Receives the chunk.
+	* @param ChunkOffset Position of the chunk in the file.
+	* @param OutChunks Receives the chunk for the index.
+	*/
+	void Encode(TArray<uint8>& Out, const int64 ChunkOffset, TArray<FMWDataLogChunk>& OutChunks);
+
+private:
+
+	int32 NumChannels;
+	int32 Stream;
+	int32 NumSamples = 0;
+
+	// Values of the chunk, column after column (channel * DATA_LOG_CHUNK_SAMPLES + sample).
+	TArray<float> Columns;
+};
@@ -0,0 +1,159 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MWControllerDataLog.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Reads binary data collections (.mwlog) without loading them. The file is memory-mapped, so only the pages of the
+ * index and of the decoded chunks are read from the disk. The chunks are found with the index at the end of the file,
+ * logs without index (crashed runs) are indexed once by skipping from chunk header to chunk header.
+ * Time ranges are found by a binary search over the chunk times, an overview of a long log decodes only every n-th chunk.
+ * Samples are read per stream (robot), the chunks of the other streams are not touched.
+ */
+class UBASECONTROLLERMWDATACOLLECTOR_API MWControllerDataLogReader
+{
+public:
+
+	/*
+	* Constructor of the reader.
+	*/
+	MWControllerDataLogReader();
+
+	/*
+	* Destructor of the reader. Closes the file.
+	*/
+	~MWControllerDataLogReader();
+
+	MWControllerDataLogReader(const MWControllerDataLogReader&) = delete;
+	MWControllerDataLogReader& operator=(const MWControllerDataLogReader&) = delete;
+
+	/*
+	* Opens a log and reads its header and index.
+	*
+	* @param FilePath Path of the log.
+	* @return false if the file could not be opened or is no log.
+	*/
+	bool Open(const FString& FilePath);
+
+	/*
+	* Closes the log.
+	*/
+	void Close();
+
+	/*
+	* Getter for the names of the channels.
+	*
+	* @return Names of the channels, in the order of the columns.
+	*/
+	const TArray<FString>& GetChannelNames() const;
+
+	/*
+	* Getter for the chunks of the log.
+	*
+	* @return Chunks of all streams in the order of the file.
+	*/
+	const TArray<FMWDataLogChunk>& GetChunks() const;
+
+	/*
+	* Getter for the streams of the log.
+	*
+	* @return Streams, the index is the stream of the chunks.
+	*/
+	const TArray<FMWDataLogStream>& GetStreams() const;
+
+	/*
+	* Finds a stream by the id or the name of its robot.
+	*
+	* @param IdOrName Id or name of the robot.
+	* @return Index of the stream or INDEX_NONE.
+	*/
+	int32 FindStream(const FString& IdOrName) const;
+
+	/*
+	* Gets the number of samples of a stream.
+	*
+	* @param Stream Index of the stream.
+	* @return Number of samples.
+	*/
+	int64 GetNumSamples(const int32 Stream) const;
+
+	/*
+	* Reads all samples of a stream.
+	*
+	* @param Stream Index of the stream.
+	* @param OutColumns Receives the values per channel.
+	* @return false if a chunk is damaged. The samples before are still given.
+	*/
+	bool ReadAll(const int32 Stream, TArray<TArray<float>>& OutColumns) const;
+
+	/*
+	* Reads the samples of a stream in a time range. Only the chunks that overlap the range are decoded.
+	*
+	* @param Stream Index of the stream.
+	* @param StartTime First time of the range.
+	* @param EndTime Last time of the range.
+	* @param OutColumns Receives the values per channel.
+	* @return false if a chunk is damaged. The samples before are still given.
+	*/
+	bool ReadRange(const int32 Stream, const float StartTime, const float EndTime, TArray<TArray<float>>& OutColumns) const;
+
+	/*
+	* Reads evenly spaced samples of a whole stream. If the spacing is larger than a chunk, only every n-th chunk is decoded.
+	*
+	* @param Stream Index of the stream.
+	* @param MaxSamples Most samples to give.
+	* @param OutColumns Receives the values per channel.
+	* @return false if a chunk is damaged. The samples before are still given.
+	*/
+	bool ReadOverview(const int32 Stream, const int32 MaxSamples, TArray<TArray<float>>& OutColumns) const;
+
+private:
+
+	/*
+	* Finds the streams and chunks by their headers, for logs without index.
+	*
+	* @param FirstChunkOffset Position of the first record after the header.
+	*/
+	void ScanChunks(const int64 FirstChunkOffset);
+
+	/*
+	* Sorts the chunks by stream and counts the samples of the streams.
+	*/
+	void IndexStreams();
+
+	/*
+	* Decodes a chunk and appends some of its samples.
+	*
+	* @param Chunk Chunk to decode.
+	* @param First First sample of the chunk to append.
+	* @param Last Last sample of the chunk to append.
+	* @param Stride Appends every Stride-th sample from First.
+	* @param OutColumns Receives the samples.
+	* @return false if the chunk is damaged.
+	*/
+	bool AppendChunk(const FMWDataLogChunk& Chunk, const int32 First, const int32 Last, const int32 Stride, TArray<TArray<float>>& OutColumns) const;
+
+	// Mapped file, or the loaded file on platforms without memory mapping.
+	IMappedFileHandle* MappedHandle = nullptr;
+	IMappedFileRegion* MappedRegion = nullptr;
+	TArray<uint8> LoadedData;
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+
+	TArray<FString> ChannelNames;
+	TArray<FMWDataLogChunk> Chunks;
+	TArray<FMWDataLogStream> Streams;
+
+	// Chunks of every stream (indices into Chunks) and the number of samples.
+	TArray<TArray<int32>> StreamChunks;
+	TArray<int64> StreamSamples;
+
+	// Decoded chunk, reused between the chunks.
+	mutable TArray<TArray<float>> ChunkColumns;
+};
@@ -0,0 +1,37 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MWControllerDataLogToCsvCommandlet.generated.h"
+
+/*
+* Converts a binary data collection (.mwlog) into the csv layout of the data collector.
+* -Start/-End export only a time range, -MaxSamples a downsampled overview. Both only read the needed chunks.
+* Every robot (stream) of the log gets its own csv file named after the robot, -Robot exports only one robot by id or name.
+*
+* UE4Editor-Cmd.exe Project.uproject -run=MWControllerDataLogToCsv -In=DataCollection/2019.5.3/MW_Fleet_14_02_10.mwlog [-Out=MW_Fleet.csv]
+*     [-Robot=MW_Robot_1] [-Start=10.0 -End=20.0] [-MaxSamples=10000]
+*/
+UCLASS()
+class UBASECONTROLLERMWDATACOLLECTOR_API UMWControllerDataLogToCsvCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	/*
+	* Sets default values for the commandlet.
+	*/
+	UMWControllerDataLogToCsvCommandlet();
+
+	/*
+	* Reads the log and writes the csv file.
+	*
+	* @param Params Command line of the commandlet.
+	* @return 0 on success, otherwise 1.
+	*/
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,111 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "MWControllerDataLog.h"
+
+/**
+ * Decides which samples of a data collector are passed to the writer.
+ * Every channel can have its own rate and deadband, between two recordings a channel keeps its last recorded value.
+ * Samples without a changed channel can be skipped. In the trigger mode the samples stay in the pre-trigger ring
+ * and are only passed on around a trigger, followed by the samples after the trigger.
+ * Runs on the game thread. Does not know the engine, the collector reads the samples and owns the writer.
+ */
+class UBASECONTROLLERMWDATACOLLECTOR_API MWControllerDataRecorder
+{
+public:
+
+	/*
+	* Starts a new recording. The time channel is recorded with every sample, whatever its settings are.
+	*
+	* @param InNumChannels Number of channels of the file.
+	* @param Intervals Seconds between two recordings, per channel. 0 records the channel with every sample.
+	* @param Deadbands Changes up to this value are not recorded, per channel.
+	* @param bInRecordOnlyChanges Samples without a changed channel are not passed on.
+	* @param bInTriggerMode Keeps the samples in the pre-trigger ring until a trigger.
+	* @param PreTriggerSamples Size of the pre-trigger ring.
+	* @param InPostTriggerSamples Samples after a trigger that are passed on.
+	*/
+	void Init(const int32 InNumChannels, const float* Intervals, const float* Deadbands, const bool bInRecordOnlyChanges,
+		const bool bInTriggerMode, const int32 PreTriggerSamples, const int32 InPostTriggerSamples);
+
+	/*
+	* Records a sample.
+	*
+	* @param Sample Sample with the current values. Receives the recorded values.
+	* @param Push Passes a sample to the writer. Returns false if the writer dropped it.
+	* @return false if the writer dropped the sample.
+	*/
+	bool Add(FMWControllerDataSample& Sample, TFunctionRef<bool(const FMWControllerDataSample&)> Push);
+
+	/*
+	* Passes the pre-trigger ring on, oldest sample first, and the next PostTriggerSamples samples. Only used in the trigger mode.
+	*
+	* @param Push Passes a sample to the writer.
+	* @return true if a new capture started, false if the trigger only extended the running capture.
+	*/
+	bool Trigger(TFunctionRef<bool(const FMWControllerDataSample&)> Push);
+
+	/*
+	* Gets the number of samples in the pre-trigger ring.
+	*
+	* @return Number of samples a trigger passes on from the ring.
+	*/
+	int32 GetNumPreTriggerSamples() const;
+
+	/*
+	* Gets the number of captures since Init.
+	*
+	* @return Number of triggers that started a capture.
+	*/
+	int32 GetNumTriggers() const;
+
+private:
+
+	/*
+	* Applies the rates and deadbands of the channels. Channels that are not recorded keep their last recorded value.
+	*
+	* @param Sample Sample with the current values. Receives the recorded values.
+	* @return true if a channel other than the time changed.
+	*/
+	bool FilterSample(FMWControllerDataSample& Sample);
+
+	/*
+	* Passes a recorded sample on or keeps it in the pre-trigger ring.
+	*
+	* @param Sample Recorded sample.
+	* @param Push Passes a sample to the writer.
+	* @return false if the writer dropped the sample.
+	*/
+	bool RecordSample(const FMWControllerDataSample& Sample, TFunctionRef<bool(const FMWControllerDataSample&)> Push);
+
+	// Number of channels of the file.
+	int32 NumChannels = 0;
+
+	// By channel index. An interval of 0 records the channel with every sample.
+	float ChannelInterval[EMWDataChannel::Num + DATA_MAX_EXTRA_CHANNELS] = {};
+	float ChannelDeadband[EMWDataChannel::Num + DATA_MAX_EXTRA_CHANNELS] = {};
+	float ChannelNextTime[EMWDataChannel::Num + DATA_MAX_EXTRA_CHANNELS] = {};
+
+	bool bRecordOnlyChanges = false;
+	bool bTriggerMode = false;
+	int32 PostTriggerSamples = 0;
+
+	// Last recorded values.
+	FMWControllerDataSample LastRecorded;
+	bool bHasRecorded = false;
+
+	// Samples before the next trigger. Head is the next slot, the oldest sample is Num slots before it.
+	TArray<FMWControllerDataSample> PreTrigger;
+	int32 PreTriggerHead = 0;
+	int32 PreTriggerNum = 0;
+
+	// Samples that are still passed on after the last trigger.
+	int32 PostTriggerRemaining = 0;
+
+	// Captures since Init.
+	int32 NumTriggers = 0;
+};
@@ -0,0 +1,135 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/Atomic.h"
+#include "MWControllerDataLog.h"
+
+class FRunnableThread;
+class FEvent;
+class IFileHandle;
+
+#define DATA_WRITER_BLOCK_SIZE		(64 * 1024)
+#define DATA_WRITER_WAIT_MS			(100)
+
+/**
+ * Writes the samples of a data collector on its own thread.
+ * The game thread pushes samples into a ring (single producer, single consumer, no locks).
+ * The writer thread formats them as csv lines or binary chunks (MWControllerDataLog) and writes them in blocks.
+ * Csv blocks are written at the latest every DATA_WRITER_WAIT_MS, binary chunks when they are full and at the end.
+ * If the ring is full, the new sample is dropped and counted, so the memory stays bounded and the game thread never waits.
+ * A binary log can hold several streams (robots): every stream has its own chunks, the full chunks are interleaved in the file.
+ */
+class UBASECONTROLLERMWDATACOLLECTOR_API MWControllerDataWriter : public FRunnable
+{
+public:
+
+	/*
+	* Constructor of the writer. Starts the thread.
+	*
+	* @param InFileHandle Opened file with the header. The writer deletes it.
+	* @param Capacity Number of samples in the ring. Rounded up to a power of two.
+	* @param InNumChannels Number of used values of every sample.
+	* @param bInBinary Writes the binary format instead of csv.
+	*/
+	MWControllerDataWriter(IFileHandle* InFileHandle, const int32 Capacity, const int32 InNumChannels, const bool bInBinary);
+
+	/*
+	* Destructor of the writer. Writes the remaining samples, stops the thread and closes the file.
+	*/
+	virtual ~MWControllerDataWriter();
+
+	/*
+	* Adds a sample. Only one thread may push.
+	*
+	* @param Sample Sample to write.
+	* @return false if the ring was full and the sample was dropped.
+	*/
+	bool Push(const FMWControllerDataSample& Sample);
+
+	/*
+	* Adds a stream. Called on the thread that pushes, before the first sample of the stream.
+	*
+	* @param Stream Id and name of the stream.
+	* @return Index of the stream for FMWControllerDataSample::Stream.
+	*/
+	int32 AddStream(const FMWDataLogStream& Stream);
+
+	/*
+	* Gets the number of samples that were dropped because the ring was full.
+	*
+	* @return Number of dropped samples.
+	*/
+	int64 GetDroppedSamples() const;
+
+	/*
+	* Writes the samples until the writer is stopped.
+	*/
+	virtual uint32 Run() override;
+
+	/*
+	* Asks the thread to write the remaining samples and to end.
+	*/
+	virtual void Stop() override;
+
+private:
+
+	/*
+	* Formats all samples of the ring into the block. Writes full blocks.
+	*
+	* @param bFinal Also writes the last, not full binary chunks and the index.
+	*/
+	void Drain(const bool bFinal);
+
+	/*
+	* Writes the records of the streams that were added since the last call and creates their encoders.
+	*/
+	void BeginNewStreams();
+
+	/*
+	* Writes the block into the file.
+	*/
+	void Flush();
+
+	// Ring of the samples. Head is only written by the game thread, Tail only by the writer thread.
+	TArray<FMWControllerDataSample> Samples;
+	uint32 Mask = 0;
+	TAtomic<uint32> Head;
+	TAtomic<uint32> Tail;
+
+	// Samples that did not fit into the ring.
+	TAtomic<int64> DroppedSamples;
+
+	// Number of used values of every sample.
+	int32 NumChannels;
+
+	// Writes the binary format.
+	bool bBinary;
+
+	// Compresses the binary chunks, one per stream. Only used by the writer thread.
+	TArray<MWControllerDataLogEncoder*> Encoders;
+	TArray<FMWDataLogStream> Streams;
+
+	// Written chunks for the index.
+	TArray<FMWDataLogChunk> Chunks;
+
+	// Streams that were added but not written yet.
+	TArray<FMWDataLogStream> NewStreams;
+	FCriticalSection NewStreamsLock;
+	int32 NumStreams = 0;
+
+	// Formatted data that was not written yet.
+	TArray<uint8> Block;
+
+	// Position in the file where the block is written, for the index of the binary chunks.
+	int64 FileOffset = 0;
+
+	IFileHandle* FileHandle = nullptr;
+	FEvent* WakeEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+	TAtomic<bool> bStopping;
+};
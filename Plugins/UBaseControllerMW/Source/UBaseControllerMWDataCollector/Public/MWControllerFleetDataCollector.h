@@ -0,0 +1,109 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "MWControllerDataWriter.h"
+#include "MWControllerFleetDataCollector.generated.h"
+
+class UMWControllerComponent;
+
+/*
+* Robot that is recorded by the fleet collector.
+*/
+struct FMWFleetDataRobot
+{
+	// Controller of the robot.
+	TWeakObjectPtr<UMWControllerComponent> Controller;
+
+	// Stream of the robot in the log.
+	int32 Stream = 0;
+};
+
+/**
+ * Records all MWControllerComponents of a level into one binary data collection (.mwlog).
+ * Place one in the level instead of a MWControllerDataCollector on every robot. Controllers are taken from the
+ * MWControllerRegistry, also the ones spawned later (every DiscoveryIntervalInSeconds). Every robot is a stream of the log with the stable id
+ * of UMWControllerComponent::GetRobotId, so the samples of all robots go through one MWControllerDataWriter and one thread.
+ * Only the base channels are recorded, -run=MWControllerDataLogToCsv writes one csv file per robot.
+ */
+UCLASS(ClassGroup = (Custom))
+class UBASECONTROLLERMWDATACOLLECTOR_API AMWControllerFleetDataCollector : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	/*
+	* Sets default values for this actor's properties.
+	*/
+	AMWControllerFleetDataCollector();
+
+	/*
+	* Finds new controllers and passes a sample of every robot to the writer.
+	*/
+	virtual void Tick(float DeltaTime) override;
+
+	/*
+	* Gets the number of samples that were dropped because the writer could not keep up.
+	*
+	* @return Number of dropped samples.
+	*/
+	int64 GetDroppedSamples() const;
+
+	/*
+	* Gets the number of robots that are recorded.
+	*
+	* @return Number of robots.
+	*/
+	int32 GetNumRobots() const;
+
+protected:
+
+	/*
+	* Creates the log and finds the controllers of the level.
+	*/
+	virtual void BeginPlay() override;
+
+	/*
+	* Writes the remaining samples and closes the log.
+	*/
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+
+	/*
+	* Creates the log file and the writer.
+	*
+	* @return false if the file could not be created.
+	*/
+	bool CreateFile();
+
+	/*
+	* Adds a stream for every controller of the level that is not recorded yet. New robots are added in the order of their paths.
+	*/
+	void DiscoverControllers();
+
+	// Samples the writer can hold for all robots together. If the writer falls behind by more, new samples are dropped.
+	UPROPERTY(EditAnywhere, Category = "MW Details", meta = (ClampMin = "2"))
+		int32 BufferCapacity = 16384;
+
+	// Time between two searches for new controllers.
+	UPROPERTY(EditAnywhere, Category = "MW Details", meta = (ClampMin = "0"))
+		float DiscoveryIntervalInSeconds = 1.f;
+
+	// Path of the log.
+	FString FilePath;
+
+	// Writes the samples of all robots on its own thread. Owns the file.
+	MWControllerDataWriter* Writer = nullptr;
+
+	// Recorded robots.
+	TArray<FMWFleetDataRobot> Robots;
+	TSet<TWeakObjectPtr<UMWControllerComponent>> KnownControllers;
+
+	// Time until the next search for controllers.
+	float TimeToDiscovery = 0.f;
+};
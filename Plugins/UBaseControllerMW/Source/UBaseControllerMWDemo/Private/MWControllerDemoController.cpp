@@ -2,7 +2,7 @@
 // Author: Patrick Kellmann
 
 #include "MWControllerDemoController.h"
-#include "Kismet/GameplayStatics.h"
+#include "MWControllerRegistry.h"
 
 // Constructor. 
 AMWControllerDemoController::AMWControllerDemoController()
@@ -29,34 +29,20 @@ void AMWControllerDemoController::BeginPlay()
 {
 	if (this && this->IsValidLowLevel())
 	{
-		// Get the Actor who holds the robot.
-		TArray<AActor*> HelperList;
-		UGameplayStatics::GetAllActorsOfClass(this->GetWorld(), AActor::StaticClass(), HelperList);
-
-		for (auto RobAct : HelperList)
+		// Get the Actor who holds the robot from the registry.
+		if (MWControllerRegistry* Registry = MWControllerRegistry::Get(this->GetWorld()))
 		{
-			// Looks for the default names. "Contains" is used because Unreal changes the name in some cases.
-			if (RobAct->GetName().Contains(MWRobotBaseActorName))
-			{
-				MWRobotBaseActor = RobAct;
-				break;
-			}
+			MWRobotBaseActor = Registry->FindActorByName(MWRobotBaseActorName);
+			MWConComp = Registry->FindControllerByActorName(MWRobotBaseActorName);
 		}
 	}
 
 	if (MWRobotBaseActor && MWRobotBaseActor->IsValidLowLevel())
 	{
-		TArray<UMWControllerComponent*> ActorComponentList;
-		MWRobotBaseActor->GetComponents<UMWControllerComponent>(ActorComponentList);
-
-		for (auto ActComp : ActorComponentList)
+		// The controller has to belong to the found actor.
+		if (MWConComp && MWConComp->GetOwner() != MWRobotBaseActor)
 		{
-			// The MWController is searched via the Tag.
-			if (ActComp->ComponentHasTag("MWControllerComponentTag"))
-			{
-				MWConComp = ActComp;
-				break;
-			}
+			MWConComp = nullptr;
 		}
 		if (!MWConComp)
 		{
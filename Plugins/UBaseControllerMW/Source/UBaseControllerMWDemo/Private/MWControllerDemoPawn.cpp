@@ -2,7 +2,7 @@
 // Author: Patrick Kellmann
 
 #include "MWControllerDemoPawn.h"
-#include "Kismet/GameplayStatics.h"
+#include "MWControllerRegistry.h"
 
 // Sets default values
 AMWControllerDemoPawn::AMWControllerDemoPawn()
@@ -39,25 +39,18 @@ void AMWControllerDemoPawn::BeginPlay()
 
 	if (this && this->IsValidLowLevel())
 	{
-		// Get the actor who holds the robot.
-		TArray<AActor*> HelperList;
-		UGameplayStatics::GetAllActorsOfClass(this->GetWorld(), AActor::StaticClass(), HelperList);
-		for (auto RobAct : HelperList)
+		// Get the actor who holds the robot from the registry.
+		MWControllerRegistry* Registry = MWControllerRegistry::Get(this->GetWorld());
+		AActor* RobAct = Registry ? Registry->FindActorByName(MWRobotBaseActorName) : nullptr;
+
+		if (RobAct && RobAct->IsValidLowLevel()) 
 		{
-			// Looks for the default names. "Contains" is used because Unreal changes the name in some cases.
-			if (RobAct->GetName().Contains(MWRobotBaseActorName))
-			{
-				if (RobAct && RobAct->IsValidLowLevel()) 
-				{
-					MWRobotBaseActor = RobAct;
-					this->SetActorLocation(MWRobotBaseActor->GetActorLocation());
-					this->SetActorRotation(MWRobotBaseActor->GetActorRotation());
-
-					// Attach to MWRobotBaseActor holding the robot. 
-					this->AttachToActor(MWRobotBaseActor, FAttachmentTransformRules::KeepWorldTransform);
-					break;
-				}
-			}
+			MWRobotBaseActor = RobAct;
+			this->SetActorLocation(MWRobotBaseActor->GetActorLocation());
+			this->SetActorRotation(MWRobotBaseActor->GetActorRotation());
+
+			// Attach to MWRobotBaseActor holding the robot. 
+			this->AttachToActor(MWRobotBaseActor, FAttachmentTransformRules::KeepWorldTransform);
 		}
 
 		if (!MWRobotBaseActor ||!MWRobotBaseActor->IsValidLowLevel()) 
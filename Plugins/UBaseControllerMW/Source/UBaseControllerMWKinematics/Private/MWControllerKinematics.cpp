@@ -0,0 +1,156 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "MWControllerKinematics.h"
+
+// Constructor of the kinematics.
+MWControllerKinematics::MWControllerKinematics()
+{
+}
+
+// Destructor of the kinematics.
+MWControllerKinematics::~MWControllerKinematics()
+{
+}
+
+// Adds a robot and calculates its factors.
+int32 MWControllerKinematics::AddRobot(const float WheelDiameterInCentimeter, const float CombinedDistanceValue, const float PolarityForAngularMovement, const EMWKinematicsType Type)
+{
+	const int32 RobotIndex = WheelFactor.AddUninitialized();
+	InverseWheelFactor.AddUninitialized();
+	TransversalSign.AddUninitialized();
+	AngularFactor.AddUninitialized();
+	InverseAngularFactor.AddUninitialized();
+
+	CalcFactors(RobotIndex, WheelDiameterInCentimeter, CombinedDistanceValue, PolarityForAngularMovement, Type);
+
+	return RobotIndex;
+}
+
+// Recalculates the factors of an existing robot.
+void MWControllerKinematics::SetRobot(const int32 RobotIndex, const float WheelDiameterInCentimeter, const float CombinedDistanceValue, const float PolarityForAngularMovement, const EMWKinematicsType Type)
+{
+	if (!WheelFactor.IsValidIndex(RobotIndex))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[%s][%d] Robot index %d is not valid."), TEXT(__FUNCTION__), __LINE__, RobotIndex);
+		return;
+	}
+
+	CalcFactors(RobotIndex, WheelDiameterInCentimeter, CombinedDistanceValue, PolarityForAngularMovement, Type);
+}
+
+// Removes a robot. The last robot takes its index.
+void MWControllerKinematics::RemoveRobot(const int32 RobotIndex)
+{
+	if (!WheelFactor.IsValidIndex(RobotIndex))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[%s][%d] Robot index %d is not valid."), TEXT(__FUNCTION__), __LINE__, RobotIndex);
+		return;
+	}
+
+	WheelFactor.RemoveAtSwap(RobotIndex, 1, false);
+	InverseWheelFactor.RemoveAtSwap(RobotIndex, 1, false);
+	TransversalSign.RemoveAtSwap(RobotIndex, 1, false);
+	AngularFactor.RemoveAtSwap(RobotIndex, 1, false);
+	InverseAngularFactor.RemoveAtSwap(RobotIndex, 1, false);
+}
+
+// Removes all robots.
+void MWControllerKinematics::Reset()
+{
+	WheelFactor.Reset();
+	InverseWheelFactor.Reset();
+	TransversalSign.Reset();
+	AngularFactor.Reset();
+	InverseAngularFactor.Reset();
+}
+
+// Gets the number of robots.
+int32 MWControllerKinematics::Num() const
+{
+	return WheelFactor.Num();
+}
+
+// Inverse kinematics for all robots.
+void MWControllerKinematics::SolveInverse(const float* LongitudinalVelocity, const float* TransversalVelocity, const float* AngularVelocity,
+	float* WheelLeftFront, float* WheelRightFront, float* WheelLeftRear, float* WheelRightRear) const
+{
+	SolveInverse(0, Num(), LongitudinalVelocity, TransversalVelocity, AngularVelocity, WheelLeftFront, WheelRightFront, WheelLeftRear, WheelRightRear);
+}
+
+// Inverse kinematics for a range of robots.
+void MWControllerKinematics::SolveInverse(const int32 FirstRobot, const int32 NumRobots,
+	const float* LongitudinalVelocity, const float* TransversalVelocity, const float* AngularVelocity,
+	float* WheelLeftFront, float* WheelRightFront, float* WheelLeftRear, float* WheelRightRear) const
+{
+	check(FirstRobot >= 0 && NumRobots >= 0 && FirstRobot + NumRobots <= Num());
+
+	const float* RESTRICT F = WheelFactor.GetData() + FirstRobot;
+	const float* RESTRICT S = TransversalSign.GetData() + FirstRobot;
+	const float* RESTRICT A = AngularFactor.GetData() + FirstRobot;
+	const float* RESTRICT X = LongitudinalVelocity + FirstRobot;
+	const float* RESTRICT Y = TransversalVelocity + FirstRobot;
+	const float* RESTRICT Z = AngularVelocity + FirstRobot;
+	float* RESTRICT LF = WheelLeftFront + FirstRobot;
+	float* RESTRICT RF = WheelRightFront + FirstRobot;
+	float* RESTRICT LR = WheelLeftRear + FirstRobot;
+	float* RESTRICT RR = WheelRightRear + FirstRobot;
+
+	for (int32 i = 0; i < NumRobots; ++i)
+	{
+		const float SY = S[i] * Y[i];
+		const float AZ = A[i] * Z[i];
+
+		LF[i] = F[i] * (X[i] + SY - AZ);
+		LR[i] = F[i] * (X[i] - SY - AZ);
+		RF[i] = F[i] * (X[i] - SY + AZ);
+		RR[i] = F[i] * (X[i] + SY + AZ);
+	}
+}
+
+// Forward kinematics for all robots.
+void MWControllerKinematics::SolveForward(const float* WheelLeftFront, const float* WheelRightFront, const float* WheelLeftRear, const float* WheelRightRear,
+	float* LongitudinalVelocity, float* TransversalVelocity, float* AngularVelocity) const
+{
+	SolveForward(0, Num(), WheelLeftFront, WheelRightFront, WheelLeftRear, WheelRightRear, LongitudinalVelocity, TransversalVelocity, AngularVelocity);
+}
+
+// Forward kinematics for a range of robots.
+void MWControllerKinematics::SolveForward(const int32 FirstRobot, const int32 NumRobots,
+	const float* WheelLeftFront, const float* WheelRightFront, const float* WheelLeftRear, const float* WheelRightRear,
+	float* LongitudinalVelocity, float* TransversalVelocity, float* AngularVelocity) const
+{
+	check(FirstRobot >= 0 && NumRobots >= 0 && FirstRobot + NumRobots <= Num());
+
+	const float* RESTRICT G = InverseWheelFactor.GetData() + FirstRobot;
+	const float* RESTRICT S = TransversalSign.GetData() + FirstRobot;
+	const float* RESTRICT IA = InverseAngularFactor.GetData() + FirstRobot;
+	const float* RESTRICT LF = WheelLeftFront + FirstRobot;
+	const float* RESTRICT RF = WheelRightFront + FirstRobot;
+	const float* RESTRICT LR = WheelLeftRear + FirstRobot;
+	const float* RESTRICT RR = WheelRightRear + FirstRobot;
+	float* RESTRICT X = LongitudinalVelocity + FirstRobot;
+	float* RESTRICT Y = TransversalVelocity + FirstRobot;
+	float* RESTRICT Z = AngularVelocity + FirstRobot;
+
+	for (int32 i = 0; i < NumRobots; ++i)
+	{
+		X[i] = (LF[i] + LR[i] + RF[i] + RR[i]) * G[i];
+		Y[i] = (LF[i] - LR[i] - RF[i] + RR[i]) * G[i] * S[i];
+		Z[i] = (RF[i] + RR[i] - LF[i] - LR[i]) * G[i] * IA[i];
+	}
+}
+
+// Calculates the factors of a robot.
+void MWControllerKinematics::CalcFactors(const int32 RobotIndex, const float WheelDiameterInCentimeter, const float CombinedDistanceValue, const float PolarityForAngularMovement, const EMWKinematicsType Type)
+{
+	const float WheelRadius = WheelDiameterInCentimeter / DIAMETER_TO_RADIUS;
+	const bool bIsOType = Type == EMWKinematicsType::O_Type;
+
+	// A robot without wheels does not move. Keeps the solver free of divisions by zero.
+	WheelFactor[RobotIndex] = WheelRadius > 0.f ? SCALE_FACTOR_M_TO_CM / WheelRadius : 0.f;
+	InverseWheelFactor[RobotIndex] = WheelRadius > 0.f ? WheelRadius / (SCALE_FACTOR_M_TO_CM * WHEEL_NUMBER_DIVIDER) : 0.f;
+	TransversalSign[RobotIndex] = bIsOType ? 1.f : -1.f;
+	AngularFactor[RobotIndex] = bIsOType ? (CombinedDistanceValue / SCALE_FACTOR_CM_TO_M) * PolarityForAngularMovement : 0.f;
+	InverseAngularFactor[RobotIndex] = AngularFactor[RobotIndex] != 0.f ? 1.f / AngularFactor[RobotIndex] : 0.f;
+}
@@ -0,0 +1,117 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "MWControllerKinematics.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Wheel velocities solved per size, so every size takes about the same time.
+#define KINEMATICS_BENCHMARK_SOLVES (4 * 1000 * 1000)
+
+/**
+ * Robot as the wheel handler solved it before the kinematics had their own module: the geometry and the wheels
+ * are fields of the controller, the factors are calculated again with every call.
+ */
+struct FMWKinematicsBenchmarkRobot
+{
+	float WheelDiameterInCentimeter;
+	float CombinedDistanceValue;
+	float PolarityForAngularMovement;
+	EMWKinematicsType Type;
+	float WheelLeftFront, WheelRightFront, WheelLeftRear, WheelRightRear;
+};
+
+// Inverse kinematics of one robot with the formulas of MWControllerWheelHandler::CalcWheelsAngularVelocity
+static FORCENOINLINE void SolveBenchmarkRobot(FMWKinematicsBenchmarkRobot& Robot, const float X, const float Y, const float Z)
+{
+	const float WheelRadius = Robot.WheelDiameterInCentimeter / DIAMETER_TO_RADIUS;
+	const float CombinedDis = Robot.CombinedDistanceValue / SCALE_FACTOR_CM_TO_M;
+
+	if (Robot.Type == EMWKinematicsType::O_Type)
+	{
+		const float Angular = CombinedDis * Z * Robot.PolarityForAngularMovement;
+		Robot.WheelLeftFront = 1.f / WheelRadius * ((X + Y - Angular) * SCALE_FACTOR_M_TO_CM);
+		Robot.WheelRightFront = 1.f / WheelRadius * ((X - Y + Angular) * SCALE_FACTOR_M_TO_CM);
+		Robot.WheelLeftRear = 1.f / WheelRadius * ((X - Y - Angular) * SCALE_FACTOR_M_TO_CM);
+		Robot.WheelRightRear = 1.f / WheelRadius * ((X + Y + Angular) * SCALE_FACTOR_M_TO_CM);
+	}
+	else
+	{
+		Robot.WheelLeftFront = 1.f / WheelRadius * ((X - Y) * SCALE_FACTOR_M_TO_CM);
+		Robot.WheelRightFront = 1.f / WheelRadius * ((X + Y) * SCALE_FACTOR_M_TO_CM);
+		Robot.WheelLeftRear = 1.f / WheelRadius * ((X + Y) * SCALE_FACTOR_M_TO_CM);
+		Robot.WheelRightRear = 1.f / WheelRadius * ((X - Y) * SCALE_FACTOR_M_TO_CM);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMWControllerKinematicsBenchmark, "UBaseControllerMWKinematics.Benchmark.BatchSolve", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Inverse kinematics of many robots: one call per robot with the factors calculated in every call, as the wheel handler did,
+// against one SolveInverse for all robots. Both give the same wheels, reports the ns per robot.
+bool FMWControllerKinematicsBenchmark::RunTest(const FString& Parameters)
+{
+	for (const int32 NumRobots : { 1, 10, 100, 1000, 10000 })
+	{
+		MWControllerKinematics Kinematics;
+		TArray<FMWKinematicsBenchmarkRobot> Robots;
+		TArray<float> X, Y, Z, LF, RF, LR, RR;
+		for (TArray<float>* Values : { &X, &Y, &Z, &LF, &RF, &LR, &RR })
+		{
+			Values->SetNumZeroed(NumRobots);
+		}
+		for (int32 i = 0; i < NumRobots; ++i)
+		{
+			FMWKinematicsBenchmarkRobot& Robot = Robots[Robots.AddZeroed()];
+			Robot.WheelDiameterInCentimeter = 10.f + (i % 3) * 5.f;
+			Robot.CombinedDistanceValue = 40.f + (i % 5) * 10.f;
+			Robot.PolarityForAngularMovement = i % 2 == 0 ? 1.f : -1.f;
+			Robot.Type = i % 4 == 3 ? EMWKinematicsType::X_Type : EMWKinematicsType::O_Type;
+			Kinematics.AddRobot(Robot.WheelDiameterInCentimeter, Robot.CombinedDistanceValue, Robot.PolarityForAngularMovement, Robot.Type);
+
+			X[i] = 0.1f * (i % 7);
+			Y[i] = -0.05f * (i % 11);
+			Z[i] = 0.2f * (i % 3) - 0.2f;
+		}
+
+		const int32 NumRounds = FMath::Max(KINEMATICS_BENCHMARK_SOLVES / NumRobots, 1);
+
+		double Start = FPlatformTime::Seconds();
+		for (int32 Round = 0; Round < NumRounds; ++Round)
+		{
+			for (int32 i = 0; i < NumRobots; ++i)
+			{
+				SolveBenchmarkRobot(Robots[i], X[i], Y[i], Z[i]);
+			}
+		}
+		const double PerRobotSeconds = FPlatformTime::Seconds() - Start;
+
+		Start = FPlatformTime::Seconds();
+		for (int32 Round = 0; Round < NumRounds; ++Round)
+		{
+			Kinematics.SolveInverse(X.GetData(), Y.GetData(), Z.GetData(), LF.GetData(), RF.GetData(), LR.GetData(), RR.GetData());
+		}
+		const double BatchSeconds = FPlatformTime::Seconds() - Start;
+
+		int32 NumMismatches = 0;
+		for (int32 i = 0; i < NumRobots; ++i)
+		{
+			const FMWKinematicsBenchmarkRobot& Robot = Robots[i];
+			if (!FMath::IsNearlyEqual(LF[i], Robot.WheelLeftFront, 1e-3f) || !FMath::IsNearlyEqual(RF[i], Robot.WheelRightFront, 1e-3f)
+				|| !FMath::IsNearlyEqual(LR[i], Robot.WheelLeftRear, 1e-3f) || !FMath::IsNearlyEqual(RR[i], Robot.WheelRightRear, 1e-3f))
+			{
+				++NumMismatches;
+			}
+		}
+		TestEqual(FString::Printf(TEXT("%d robots: robots with other wheels in the batch"), NumRobots), NumMismatches, 0);
+
+		const double Solves = double(NumRounds) * NumRobots;
+		AddInfo(FString::Printf(TEXT("%d robots: per robot %.2f ns, batch %.2f ns per robot (%.2fx)."), NumRobots,
+			PerRobotSeconds / Solves * 1e9, BatchSeconds / Solves * 1e9, PerRobotSeconds / FMath::Max(BatchSeconds, 1e-12)));
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,161 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "MWControllerKinematics.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define KINEMATICS_TEST_TOLERANCE (1e-4f)
+
+/**
+ * Geometry of a robot of the kinematics test.
+ */
+struct FMWKinematicsTestRobot
+{
+	float WheelDiameterInCentimeter;
+	float CombinedDistanceValue;
+	float PolarityForAngularMovement;
+	EMWKinematicsType Type;
+};
+
+static const FMWKinematicsTestRobot KinematicsTestRobots[] =
+{
+	{ 10.f, 40.f, 1.f, EMWKinematicsType::O_Type },
+	{ 10.f, 40.f, -1.f, EMWKinematicsType::O_Type },
+	{ 25.4f, 63.5f, 1.f, EMWKinematicsType::O_Type },
+	{ 10.f, 40.f, 1.f, EMWKinematicsType::X_Type },
+	{ 7.5f, 30.f, -1.f, EMWKinematicsType::X_Type },
+};
+
+// Angular velocity of the wheels with the formulas of the wheel handler before the kinematics had their own module.
+static void GetReferenceWheels(const FMWKinematicsTestRobot& Robot, const float X, const float Y, const float Z, float* Wheels)
+{
+	const float WheelRadius = Robot.WheelDiameterInCentimeter / DIAMETER_TO_RADIUS;
+	const float CombinedDis = Robot.CombinedDistanceValue / SCALE_FACTOR_CM_TO_M;
+
+	if (Robot.Type == EMWKinematicsType::O_Type)
+	{
+		const float Angular = CombinedDis * Z * Robot.PolarityForAngularMovement;
+		Wheels[0] = 1.f / WheelRadius * ((X + Y - Angular) * SCALE_FACTOR_M_TO_CM);
+		Wheels[1] = 1.f / WheelRadius * ((X - Y + Angular) * SCALE_FACTOR_M_TO_CM);
+		Wheels[2] = 1.f / WheelRadius * ((X - Y - Angular) * SCALE_FACTOR_M_TO_CM);
+		Wheels[3] = 1.f / WheelRadius * ((X + Y + Angular) * SCALE_FACTOR_M_TO_CM);
+	}
+	else
+	{
+		Wheels[0] = 1.f / WheelRadius * ((X - Y) * SCALE_FACTOR_M_TO_CM);
+		Wheels[1] = 1.f / WheelRadius * ((X + Y) * SCALE_FACTOR_M_TO_CM);
+		Wheels[2] = 1.f / WheelRadius * ((X + Y) * SCALE_FACTOR_M_TO_CM);
+		Wheels[3] = 1.f / WheelRadius * ((X - Y) * SCALE_FACTOR_M_TO_CM);
+	}
+}
+
+// Compares two values relative to their size, the wheels turn with up to some hundred rad/s.
+static bool IsNearlyEqualRelative(const float A, const float B)
+{
+	return FMath::Abs(A - B) <= KINEMATICS_TEST_TOLERANCE * FMath::Max(1.f, FMath::Abs(B));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMWControllerKinematicsTest, "UBaseControllerMWKinematics.RoundTrip", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Solves the inverse kinematics for O_Type and X_Type robots, compares the wheels with the formulas of the wheel handler
+// and checks that the forward kinematics give back the twist (X_Type without the angular velocity, it can not rotate).
+bool FMWControllerKinematicsTest::RunTest(const FString& Parameters)
+{
+	const float Twists[][3] = {
+		{ 0.f, 0.f, 0.f },
+		{ 1.f, 0.f, 0.f },
+		{ 0.f, -0.5f, 0.f },
+		{ 0.f, 0.f, 0.8f },
+		{ 0.4f, 0.3f, -0.6f },
+		{ -1.2f, 0.7f, 1.5f },
+	};
+
+	MWControllerKinematics Kinematics;
+	for (const FMWKinematicsTestRobot& Robot : KinematicsTestRobots)
+	{
+		Kinematics.AddRobot(Robot.WheelDiameterInCentimeter, Robot.CombinedDistanceValue, Robot.PolarityForAngularMovement, Robot.Type);
+	}
+	const int32 NumRobots = Kinematics.Num();
+	TestEqual(TEXT("Number of robots"), NumRobots, int32(ARRAY_COUNT(KinematicsTestRobots)));
+
+	TArray<float> X, Y, Z, LF, RF, LR, RR, ForwardX, ForwardY, ForwardZ;
+	for (TArray<float>* Values : { &X, &Y, &Z, &LF, &RF, &LR, &RR, &ForwardX, &ForwardY, &ForwardZ })
+	{
+		Values->SetNumZeroed(NumRobots);
+	}
+
+	for (const auto& Twist : Twists)
+	{
+		// Every robot gets the twist, so all robots are solved in one call.
+		for (int32 i = 0; i < NumRobots; ++i)
+		{
+			X[i] = Twist[0];
+			Y[i] = Twist[1];
+			Z[i] = Twist[2];
+		}
+		Kinematics.SolveInverse(X.GetData(), Y.GetData(), Z.GetData(), LF.GetData(), RF.GetData(), LR.GetData(), RR.GetData());
+		Kinematics.SolveForward(LF.GetData(), RF.GetData(), LR.GetData(), RR.GetData(), ForwardX.GetData(), ForwardY.GetData(), ForwardZ.GetData());
+
+		for (int32 i = 0; i < NumRobots; ++i)
+		{
+			const FMWKinematicsTestRobot& Robot = KinematicsTestRobots[i];
+			const FString What = FString::Printf(TEXT("Robot %d (%s), twist (%f, %f, %f)"), i,
+				Robot.Type == EMWKinematicsType::O_Type ? TEXT("O_Type") : TEXT("X_Type"), Twist[0], Twist[1], Twist[2]);
+
+			float Reference[4];
+			GetReferenceWheels(Robot, Twist[0], Twist[1], Twist[2], Reference);
+			const float Wheels[4] = { LF[i], RF[i], LR[i], RR[i] };
+			for (int32 Wheel = 0; Wheel < 4; ++Wheel)
+			{
+				if (!IsNearlyEqualRelative(Wheels[Wheel], Reference[Wheel]))
+				{
+					AddError(FString::Printf(TEXT("%s: wheel %d turns with %f rad/s instead of %f rad/s."), *What, Wheel, Wheels[Wheel], Reference[Wheel]));
+				}
+			}
+
+			const float ExpectedZ = Robot.Type == EMWKinematicsType::O_Type ? Twist[2] : 0.f;
+			if (!IsNearlyEqualRelative(ForwardX[i], Twist[0]) || !IsNearlyEqualRelative(ForwardY[i], Twist[1]) || !IsNearlyEqualRelative(ForwardZ[i], ExpectedZ))
+			{
+				AddError(FString::Printf(TEXT("%s: forward kinematics give (%f, %f, %f) instead of (%f, %f, %f)."),
+					*What, ForwardX[i], ForwardY[i], ForwardZ[i], Twist[0], Twist[1], ExpectedZ));
+			}
+		}
+	}
+
+	// A range only writes its own robots.
+	const TArray<float> AllLF = LF;
+	for (int32 i = 0; i < NumRobots; ++i)
+	{
+		X[i] = 2.f;
+	}
+	Kinematics.SolveInverse(1, 2, X.GetData(), Y.GetData(), Z.GetData(), LF.GetData(), RF.GetData(), LR.GetData(), RR.GetData());
+	for (int32 i = 0; i < NumRobots; ++i)
+	{
+		const bool bInRange = i >= 1 && i < 3;
+		TestTrue(FString::Printf(TEXT("Robot %d %s the range"), i, bInRange ? TEXT("in") : TEXT("outside")), (LF[i] != AllLF[i]) == bInRange);
+	}
+
+	// The last robot takes the index of a removed one.
+	Kinematics.RemoveRobot(0);
+	TestEqual(TEXT("Number of robots after removing one"), Kinematics.Num(), NumRobots - 1);
+	X[0] = 0.f;
+	Y[0] = 1.f;
+	Z[0] = 0.f;
+	Kinematics.SolveInverse(0, 1, X.GetData(), Y.GetData(), Z.GetData(), LF.GetData(), RF.GetData(), LR.GetData(), RR.GetData());
+	float Reference[4];
+	GetReferenceWheels(KinematicsTestRobots[NumRobots - 1], X[0], Y[0], Z[0], Reference);
+	TestTrue(TEXT("Last robot moved to the removed index"), IsNearlyEqualRelative(LF[0], Reference[0]) && IsNearlyEqualRelative(RF[0], Reference[1]));
+
+	// A robot without wheels does not move instead of dividing by zero.
+	Kinematics.SetRobot(0, 0.f, 0.f, 1.f, EMWKinematicsType::O_Type);
+	Kinematics.SolveInverse(0, 1, X.GetData(), Y.GetData(), Z.GetData(), LF.GetData(), RF.GetData(), LR.GetData(), RR.GetData());
+	Kinematics.SolveForward(0, 1, LF.GetData(), RF.GetData(), LR.GetData(), RR.GetData(), ForwardX.GetData(), ForwardY.GetData(), ForwardZ.GetData());
+	TestTrue(TEXT("Robot without wheels"), LF[0] == 0.f && RR[0] == 0.f && ForwardX[0] == 0.f && ForwardY[0] == 0.f && ForwardZ[0] == 0.f);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,21 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "UBaseControllerMWKinematics.h"
+
+#define LOCTEXT_NAMESPACE "FUBaseControllerMWKinematicsModule"
+
+void FUBaseControllerMWKinematicsModule::StartupModule()
+{
+	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+}
+
+void FUBaseControllerMWKinematicsModule::ShutdownModule()
+{
+	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
+	// we call this function before unloading the module.
+}
+
+#undef LOCTEXT_NAMESPACE
+
+IMPLEMENT_MODULE(FUBaseControllerMWKinematicsModule, UBaseControllerMWKinematics)
@@ -0,0 +1,157 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#define DIAMETER_TO_RADIUS		(2.f)
+#define WHEEL_NUMBER_DIVIDER	(4.f)
+#define SCALE_FACTOR_M_TO_CM	(100.f)
+#define SCALE_FACTOR_CM_TO_M	(100.f)
+
+/*
+* Configuration of a robot as seen by the kinematics. Same meaning as EMWType, but without the engine.
+*/
+enum class EMWKinematicsType : uint8
+{
+	O_Type,
+	X_Type
+};
+
+/**
+ * Solves the mecanum wheel kinematics for any number of robots at once.
+ * The geometry of the robots is stored as structure of arrays. All factors are calculated when the geometry is set,
+ * so solving only multiplies and adds contiguous floats without branches and can be vectorized by the compiler.
+ * The class does not use any UObjects and only depends on Core.
+ *
+ * Units: Longitudinal and transversal velocity in m/s, angular velocity of the base and the wheels in rad/s.
+ */
+class UBASECONTROLLERMWKINEMATICS_API MWControllerKinematics
+{
+public:
+
+	/*
+	* Constructor of the kinematics. Starts without robots.
+	*/
+	MWControllerKinematics();
+
+	/*
+	* Destructor of the kinematics.
+	*/
+	~MWControllerKinematics();
+
+	/*
+	* Adds a robot and calculates its factors.
+	*
+	* @param WheelDiameterInCentimeter Diameter of the wheels (1 cm = 1 uu).
+	* @param CombinedDistanceValue Half distance between the front wheels plus half distance between front and rear wheels in cm.
+	* @param PolarityForAngularMovement Polarity of the angular movement. Should only be 1.0 or -1.0.
+	* @param Type O_Type or X_Type configuration.
+	* @return Index of the robot.
+	*/
+	int32 AddRobot(const float WheelDiameterInCentimeter, const float CombinedDistanceValue, const float PolarityForAngularMovement, const EMWKinematicsType Type);
+
+	/*
+	* Recalculates the factors of an existing robot.
+	*
+	* @param RobotIndex Index of the robot.
+	* @param WheelDiameterInCentimeter Diameter of the wheels (1 cm = 1 uu).
+	* @param CombinedDistanceValue Half distance between the front wheels plus half distance between front and rear wheels in cm.
+	* @param PolarityForAngularMovement Polarity of the angular movement. Should only be 1.0 or -1.0.
+	* @param Type O_Type or X_Type configuration.
+	*/
+	void SetRobot(const int32 RobotIndex, const float WheelDiameterInCentimeter, const float CombinedDistanceValue, const float PolarityForAngularMovement, const EMWKinematicsType Type);
+
+	/*
+	* Removes a robot. The last robot takes its index.
+	*
+	* @param RobotIndex Index of the robot.
+	*/
+	void RemoveRobot(const int32 RobotIndex);
+
+	/*
+	* Removes all robots.
+	*/
+	void Reset();
+
+	/*
+	* Gets the number of robots.
+	*
+	* @return Number of robots.
+	*/
+	int32 Num() const;
+
+	/*
+	* Inverse kinematics. Calculates the angular velocity of the wheels from the twist of the base for all robots.
+	* All arrays must hold Num() values.
+	*
+	* @param LongitudinalVelocity Longitudinal velocity of the bases.
+	* @param TransversalVelocity Transversal velocity of the bases.
+	* @param AngularVelocity Angular velocity of the bases.
+	* @param WheelLeftFront Receives the angular velocity of the wheels.
+	* @param WheelRightFront Receives the angular velocity of the wheels.
+	* @param WheelLeftRear Receives the angular velocity of the wheels.
+	* @param WheelRightRear Receives the angular velocity of the wheels.
+	*/
+	void SolveInverse(const float* LongitudinalVelocity, const float* TransversalVelocity, const float* AngularVelocity,
+		float* WheelLeftFront, float* WheelRightFront, float* WheelLeftRear, float* WheelRightRear) const;
+
+	/*
+	* Inverse kinematics for the robots [FirstRobot, FirstRobot + NumRobots). The arrays are indexed with the robot index.
+	* Ranges that do not overlap can be solved from different threads.
+	*
+	* @param FirstRobot Index of the first robot.
+	* @param NumRobots Number of robots to solve.
+	*/
+	void SolveInverse(const int32 FirstRobot, const int32 NumRobots,
+		const float* LongitudinalVelocity, const float* TransversalVelocity, const float* AngularVelocity,
+		float* WheelLeftFront, float* WheelRightFront, float* WheelLeftRear, float* WheelRightRear) const;
+
+	/*
+	* Forward kinematics. Calculates the twist of the base from the angular velocity of the wheels for all robots.
+	* All arrays must hold Num() values. X_Type robots always get an angular velocity of 0.
+	*
+	* @param WheelLeftFront Angular velocity of the wheels.
+	* @param WheelRightFront Angular velocity of the wheels.
+	* @param WheelLeftRear Angular velocity of the wheels.
+	* @param WheelRightRear Angular velocity of the wheels.
+	* @param LongitudinalVelocity Receives the longitudinal velocity of the bases.
+	* @param TransversalVelocity Receives the transversal velocity of the bases.
+	* @param AngularVelocity Receives the angular velocity of the bases.
+	*/
+	void SolveForward(const float* WheelLeftFront, const float* WheelRightFront, const float* WheelLeftRear, const float* WheelRightRear,
+		float* LongitudinalVelocity, float* TransversalVelocity, float* AngularVelocity) const;
+
+	/*
+	* Forward kinematics for the robots [FirstRobot, FirstRobot + NumRobots). The arrays are indexed with the robot index.
+	*
+	* @param FirstRobot Index of the first robot.
+	* @param NumRobots Number of robots to solve.
+	*/
+	void SolveForward(const int32 FirstRobot, const int32 NumRobots,
+		const float* WheelLeftFront, const float* WheelRightFront, const float* WheelLeftRear, const float* WheelRightRear,
+		float* LongitudinalVelocity, float* TransversalVelocity, float* AngularVelocity) const;
+
+private:
+
+	/*
+	* Calculates the factors of a robot.
+	*/
+	void CalcFactors(const int32 RobotIndex, const float WheelDiameterInCentimeter, const float CombinedDistanceValue, const float PolarityForAngularMovement, const EMWKinematicsType Type);
+
+	// 1 / wheel radius, including the conversion of the velocity from m to cm.
+	TArray<float> WheelFactor;
+
+	// Inverse of 4 * WheelFactor. Used by the forward kinematics.
+	TArray<float> InverseWheelFactor;
+
+	// 1 for O_Type, -1 for X_Type (the rollers point the other way).
+	TArray<float> TransversalSign;
+
+	// Combined distance in m multiplied with the polarity. 0 for X_Type, because it can not rotate.
+	TArray<float> AngularFactor;
+
+	// Inverse of AngularFactor, 0 if the robot can not rotate.
+	TArray<float> InverseAngularFactor;
+};
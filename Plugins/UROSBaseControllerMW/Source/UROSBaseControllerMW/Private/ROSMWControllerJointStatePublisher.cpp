@@ -0,0 +1,188 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "ROSMWControllerJointStatePublisher.h"
+#include "MWControllerRegistry.h"
+
+// Sets default values
+AROSMWControllerJointStatePublisher::AROSMWControllerJointStatePublisher()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	// The joints are read after physics, so they show the result of the current frame.
+	PrimaryActorTick.TickGroup = TG_PostPhysics;
+
+	IPAddress = TEXT("127.0.0.1");
+
+	// Set Port to 9090
+	Port = 9090;
+
+	WheelJointNames.Add(TEXT("wheel_left_front_joint"));
+	WheelJointNames.Add(TEXT("wheel_right_front_joint"));
+	WheelJointNames.Add(TEXT("wheel_left_rear_joint"));
+	WheelJointNames.Add(TEXT("wheel_right_rear_joint"));
+}
+
+// Called when the game starts or when spawned
+void AROSMWControllerJointStatePublisher::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (WheelJointNames.Num() != JOINT_STATE_NUM_WHEELS)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[%s][%d] WheelJointNames needs %d names. No joint states will be published."),
+			TEXT(__FUNCTION__), __LINE__, JOINT_STATE_NUM_WHEELS);
+		return;
+	}
+
+	Handler = MakeShareable<FROSBridgeHandler>(new FROSBridgeHandler(IPAddress, Port));
+
+	MWControllerRegistry* Registry = MWControllerRegistry::Get(this->GetWorld());
+	if (Registry)
+	{
+		if (RobotNames.Num() > 0)
+		{
+			Robots.Reserve(RobotNames.Num());
+			for (const FString& RobotName : RobotNames)
+			{
+				if (UMWControllerComponent* Controller = Registry->FindControllerByActorName(RobotName))
+				{
+					AddRobot(RobotName, Controller);
+				}
+				else
+				{
+					UE_LOG(LogTemp, Log, TEXT("[%s] MWControllerComponent not found. No joint states will be published. %s"),
+						*FString(__FUNCTION__), *RobotName);
+				}
+			}
+		}
+		else
+		{
+			TArray<UMWControllerComponent*> Controllers;
+			Registry->GetControllers(Controllers);
+
+			// Same order in every run.
+			Controllers.Sort([](const UMWControllerComponent& A, const UMWControllerComponent& B)
+			{
+				return A.GetPathName() < B.GetPathName();
+			});
+
+			Robots.Reserve(Controllers.Num());
+			for (UMWControllerComponent* Controller : Controllers)
+			{
+				if (Controller->GetOwner())
+				{
+					AddRobot(Controller->GetOwner()->GetName(), Controller);
+				}
+			}
+		}
+	}
+
+	// Connect to rosbridge
+	Handler->Connect();
+}
+
+// Adds a robot.
+void AROSMWControllerJointStatePublisher::AddRobot(const FString& RobotName, UMWControllerComponent* Controller)
+{
+	FROSMWControllerJointStateRobot& Robot = Robots[Robots.AddDefaulted()];
+	Robot.Controller = Controller;
+	Robot.Topic = TopicTemplate.Replace(TEXT("{robot}"), *RobotName);
+
+	// The arrays keep their size, a cycle only writes the values. Effort is not known and stays empty.
+	Robot.Message.Names = WheelJointNames;
+	Robot.Message.Positions.SetNumZeroed(JOINT_STATE_NUM_WHEELS);
+	Robot.Message.Velocities.SetNumZeroed(JOINT_STATE_NUM_WHEELS);
+	Robot.Message.GetHeaderRef().SetFrameId(FString());
+
+	Handler->AddPublisher(MakeShareable<FROSBridgePublisher>(new FROSBridgePublisher(Robot.Topic, TEXT("sensor_msgs/JointState"))));
+}
+
+// Called when the game ends
+void AROSMWControllerJointStatePublisher::EndPlay(const EEndPlayReason::Type Reason)
+{
+	if (Handler.IsValid())
+	{
+		Handler->Disconnect();
+	}
+	Super::EndPlay(Reason);
+}
+
+// Called every frame
+void AROSMWControllerJointStatePublisher::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!Handler.IsValid())
+	{
+		return;
+	}
+
+	TimeToPublish -= DeltaTime;
+	if (TimeToPublish > 0.f || !Handler->IsConnected())
+	{
+		return;
+	}
+
+	// Do not fall behind by more than one cycle after a long frame.
+	TimeToPublish = FMath::Max(TimeToPublish + 1.f / PublishRateInHz, 0.f);
+
+	const FROSTime Stamp = FROSTime::Now();
+	const uint32 CycleSeq = Seq++;
+
+	for (FROSMWControllerJointStateRobot& Robot : Robots)
+	{
+		if (!UpdateJoints(Robot))
+		{
+			continue;
+		}
+
+		std_msgs::Header& Header = Robot.Message.GetHeaderRef();
+		Header.SetSeq(CycleSeq);
+		Header.SetStamp(Stamp);
+
+		FROSBridgeMsg::WritePublish(Robot.Topic, Robot.Message, PublishBuffer);
+		Handler->PublishSerializedMsg(PublishBuffer);
+	}
+}
+
+// Reads the wheels.
+bool AROSMWControllerJointStatePublisher::UpdateJoints(FROSMWControllerJointStateRobot& Robot) const
+{
+	UMWControllerComponent* Controller = Robot.Controller.Get();
+	if (!Controller || Controller->IsBeingDestroyed() || !Controller->Base)
+	{
+		return false;
+	}
+
+	UStaticMeshComponent* const Wheels[JOINT_STATE_NUM_WHEELS] = {
+		Controller->WheelLeftFront, Controller->WheelRightFront, Controller->WheelLeftRear, Controller->WheelRightRear };
+	for (UStaticMeshComponent* Wheel : Wheels)
+	{
+		if (!Wheel)
+		{
+			return false;
+		}
+	}
+
+	// The wheels turn around the Y axis of the base (see MWControllerWheelHandler::RotateWheelsOnAxisY).
+	const FQuat BaseRotation = Controller->Base->GetComponentQuat();
+	const FQuat InverseBaseRotation = BaseRotation.Inverse();
+
+	for (int32 i = 0; i < JOINT_STATE_NUM_WHEELS; ++i)
+	{
+		const FQuat Relative = InverseBaseRotation * Wheels[i]->GetComponentQuat();
+		if (!Robot.bRestRotationsSet)
+		{
+			Robot.RestRotations[i] = Relative;
+		}
+
+		// Twist of the rotation since the rest pose around Y. Y is the same in ROS, so no conversion is needed.
+		const FQuat Turn = Relative * Robot.RestRotations[i].Inverse();
+		Robot.Message.Positions[i] = FMath::UnwindRadians(2.f * FMath::Atan2(Turn.Y, Turn.W));
+		Robot.Message.Velocities[i] = BaseRotation.UnrotateVector(Wheels[i]->GetPhysicsAngularVelocityInRadians()).Y;
+	}
+	Robot.bRestRotationsSet = true;
+
+	return true;
+}
@@ -0,0 +1,176 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "ROSMWControllerSimulationCommandlet.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "EngineUtils.h"
+#include "Misc/App.h"
+#include "Containers/Ticker.h"
+#include "ROSTime.h"
+#include "MWControllerComponent.h"
+#include "MWControllerFleetManager.h"
+
+// Sets default values.
+UROSMWControllerSimulationCommandlet::UROSMWControllerSimulationCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = true;
+	LogToConsole = true;
+}
+
+// Steps the map with a fixed time step.
+int32 UROSMWControllerSimulationCommandlet::Main(const FString& Params)
+{
+	FString MapName;
+	float DeltaTime = 0.001f;
+	float Duration = 60.f;
+	float ReportInterval = 10.f;
+
+	if (!FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[%s][%d] Usage: -run=ROSMWControllerSimulation -Map=/Game/Maps/MyMap [-DeltaTime=0.001] [-Duration=60] [-ReportInterval=10]"),
+			TEXT(__FUNCTION__), __LINE__);
+		return 1;
+	}
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+	FParse::Value(*Params, TEXT("ReportInterval="), ReportInterval);
+
+	if (DeltaTime <= 0.f)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[%s][%d] DeltaTime must be greater than 0."), TEXT(__FUNCTION__), __LINE__);
+		return 1;
+	}
+
+	UWorld* World = LoadWorld(MapName);
+	if (!World)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[%s][%d] Could not load %s."), TEXT(__FUNCTION__), __LINE__, *MapName);
+		return 1;
+	}
+
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(DeltaTime);
+
+	// The simulated time is counted in steps, the float world time loses precision in long runs.
+	const int64 NumSteps = FMath::CeilToInt(Duration / DeltaTime);
+	const int64 StepsPerReport = FMath::Max(1, FMath::RoundToInt(ReportInterval / DeltaTime));
+	const double WallStart = FPlatformTime::Seconds();
+	int64 Step = 0;
+
+	for (; Step < NumSteps && !GIsRequestingExit; ++Step)
+	{
+		TickStep(World, DeltaTime, Step);
+
+		if ((Step + 1) % StepsPerReport == 0)
+		{
+			const double SimulatedSeconds = double(Step + 1) * DeltaTime;
+			const double WallSeconds = FPlatformTime::Seconds() - WallStart;
+			UE_LOG(LogTemp, Display, TEXT("[%s][%d] %.3f simulated s, %.2f simulated s per wall s."),
+				TEXT(__FUNCTION__), __LINE__, SimulatedSeconds, SimulatedSeconds / FMath::Max(WallSeconds, SMALL_NUMBER));
+		}
+	}
+
+	const double SimulatedSeconds = double(Step) * DeltaTime;
+	const double WallSeconds = FPlatformTime::Seconds() - WallStart;
+	UE_LOG(LogTemp, Display, TEXT("[%s][%d] Simulated %.3f s (%lld steps of %f s) in %.3f wall s: %.2f simulated s per wall s."),
+		TEXT(__FUNCTION__), __LINE__, SimulatedSeconds, Step, DeltaTime, WallSeconds, SimulatedSeconds / FMath::Max(WallSeconds, SMALL_NUMBER));
+
+	UnloadWorld(World);
+	FROSTime::ClearSimulatedTime();
+	return 0;
+}
+
+// Moves every controller into the fleet.
+int32 UROSMWControllerSimulationCommandlet::UseFleetTick(UWorld* World)
+{
+	int32 NumControllers = 0;
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		TInlineComponentArray<UMWControllerComponent*> Controllers(*It);
+		for (UMWControllerComponent* Controller : Controllers)
+		{
+			Controller->bUseFleetTick = true;
+			++NumControllers;
+		}
+	}
+	return NumControllers;
+}
+
+// Ticks one step.
+void UROSMWControllerSimulationCommandlet::TickStep(UWorld* World, const float DeltaTime, const int64 Step)
+{
+	// Messages stamped in this step get the time at its end, the world time after the tick.
+	FROSTime::SetSimulatedTime(double(Step + 1) * DeltaTime);
+	FApp::SetCurrentTime(FApp::GetCurrentTime() + DeltaTime);
+	FApp::SetDeltaTime(DeltaTime);
+
+	World->Tick(LEVELTICK_All, DeltaTime);
+	FTicker::GetCoreTicker().Tick(DeltaTime);
+	GFrameCounter++;
+}
+
+// Loads the map like a game would.
+UWorld* UROSMWControllerSimulationCommandlet::LoadWorld(const FString& MapName)
+{
+	UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	World->WorldType = EWorldType::Game;
+	World->AddToRoot();
+
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.AllowAudioPlayback(false)
+			.RequiresHitProxies(false)
+			.CreatePhysicsScene(true)
+			.ShouldSimulatePhysics(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.EnableTraceCollision(true));
+	}
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->UpdateWorldComponents(true, false);
+
+	FURL URL;
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+
+	// Otherwise two runs of the same map could tick the controllers in a different order.
+	const int32 NumControllers = UseFleetTick(World);
+	World->BeginPlay();
+
+	const MWControllerFleetManager* Fleet = MWControllerFleetManager::Get(World, false);
+	const int32 NumFleetControllers = Fleet ? Fleet->Num() : 0;
+	if (NumFleetControllers != NumControllers)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[%s][%d] Only %d of %d MW controllers tick in the fleet, the steps are not repeatable."),
+			TEXT(__FUNCTION__), __LINE__, NumFleetControllers, NumControllers);
+		UnloadWorld(World);
+		return nullptr;
+	}
+	UE_LOG(LogTemp, Display, TEXT("[%s][%d] %d MW controllers tick in the fleet."), TEXT(__FUNCTION__), __LINE__, NumControllers);
+	return World;
+}
+
+// Ends the play, the fleet of the world is deleted on cleanup.
+void UROSMWControllerSimulationCommandlet::UnloadWorld(UWorld* World)
+{
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		It->RouteEndPlay(EEndPlayReason::Quit);
+	}
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+}
@@ -0,0 +1,176 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "ROSMWControllerStatePublisher.h"
+#include "MWControllerRegistry.h"
+
+// Sets default values
+AROSMWControllerStatePublisher::AROSMWControllerStatePublisher()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	// The snapshots are taken after physics, so they show the result of the current frame.
+	PrimaryActorTick.TickGroup = TG_PostPhysics;
+
+	IPAddress = TEXT("127.0.0.1");
+
+	// Set Port to 9090
+	Port = 9090;
+}
+
+// Gets the number of skipped cycles.
+int32 AROSMWControllerStatePublisher::GetSkippedCycles() const
+{
+	return SkippedCycles;
+}
+
+// Called when the game starts or when spawned
+void AROSMWControllerStatePublisher::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Handler = MakeShareable<FROSBridgeHandler>(new FROSBridgeHandler(IPAddress, Port));
+	Robots = MakeShareable(new TArray<FROSMWControllerStateRobot>());
+	PublishOps = MakeShareable(new TArray<FString>());
+
+	MWControllerRegistry* Registry = MWControllerRegistry::Get(this->GetWorld());
+	if (Registry)
+	{
+		if (RobotNames.Num() > 0)
+		{
+			for (const FString& RobotName : RobotNames)
+			{
+				if (UMWControllerComponent* Controller = Registry->FindControllerByActorName(RobotName))
+				{
+					AddRobot(RobotName, Controller);
+				}
+				else
+				{
+					UE_LOG(LogTemp, Log, TEXT("[%s] MWControllerComponent not found. No state will be published. %s"),
+						*FString(__FUNCTION__), *RobotName);
+				}
+			}
+		}
+		else
+		{
+			TArray<UMWControllerComponent*> Controllers;
+			Registry->GetControllers(Controllers);
+
+			// Same order in every run, so the transforms have the same order in every TFMessage.
+			Controllers.Sort([](const UMWControllerComponent& A, const UMWControllerComponent& B)
+			{
+				return A.GetPathName() < B.GetPathName();
+			});
+
+			for (UMWControllerComponent* Controller : Controllers)
+			{
+				if (Controller->GetOwner())
+				{
+					AddRobot(Controller->GetOwner()->GetName(), Controller);
+				}
+			}
+		}
+	}
+
+	if (!TFTopic.IsEmpty())
+	{
+		Handler->AddPublisher(MakeShareable<FROSBridgePublisher>(new FROSBridgePublisher(TFTopic, TEXT("tf2_msgs/TFMessage"))));
+	}
+
+	// Connect to rosbridge
+	Handler->Connect();
+}
+
+// Adds a robot.
+void AROSMWControllerStatePublisher::AddRobot(const FString& RobotName, UMWControllerComponent* Controller)
+{
+	FROSMWControllerStateRobot& Robot = (*Robots)[Robots->AddDefaulted()];
+	Robot.Controller = Controller;
+	Robot.OdometryTopic = OdometryTopicTemplate.Replace(TEXT("{robot}"), *RobotName);
+	Robot.OdomFrame = OdomFrameTemplate.Replace(TEXT("{robot}"), *RobotName);
+	Robot.BaseFrame = BaseFrameTemplate.Replace(TEXT("{robot}"), *RobotName);
+
+	if (!Robot.OdometryTopic.IsEmpty())
+	{
+		Handler->AddPublisher(MakeShareable<FROSBridgePublisher>(new FROSBridgePublisher(Robot.OdometryTopic, TEXT("nav_msgs/Odometry"))));
+	}
+}
+
+// Called when the game ends
+void AROSMWControllerStatePublisher::EndPlay(const EEndPlayReason::Type Reason)
+{
+	// The task uses the handler.
+	if (PublishTask.IsValid() && !PublishTask->IsComplete())
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(PublishTask);
+	}
+	PublishTask = nullptr;
+
+	if (Handler.IsValid())
+	{
+		Handler->Disconnect();
+	}
+	Super::EndPlay(Reason);
+}
+
+// Called every frame
+void AROSMWControllerStatePublisher::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Tick handler
+	Handler->Process();
+
+	TimeToPublish -= DeltaTime;
+	if (TimeToPublish > 0.f || !Handler->IsConnected() || Robots->Num() == 0)
+	{
+		return;
+	}
+	TimeToPublish += 1.f / PublishRateInHz;
+
+	// Do not fall behind by more than one cycle after a long frame.
+	TimeToPublish = FMath::Max(TimeToPublish, 0.f);
+
+	if (PublishTask.IsValid() && !PublishTask->IsComplete())
+	{
+		SkippedCycles++;
+		return;
+	}
+
+	// Only the snapshots are taken here, the messages are built on the task.
+	TArray<FROSMWControllerStateSample> Samples;
+	Samples.Reserve(Robots->Num());
+	for (int32 i = 0; i < Robots->Num(); ++i)
+	{
+		UMWControllerComponent* Controller = (*Robots)[i].Controller.Get();
+		if (Controller && !Controller->IsBeingDestroyed())
+		{
+			FROSMWControllerStateSample& Sample = Samples[Samples.AddDefaulted()];
+			Sample.Robot = i;
+			Sample.Snapshot = Controller->GetStateSnapshot();
+		}
+	}
+
+	const FROSTime Stamp = FROSTime::Now();
+	const uint32 CycleSeq = Seq++;
+	TSharedPtr<FROSBridgeHandler> TaskHandler = Handler;
+	TSharedPtr<TArray<FROSMWControllerStateRobot>> TaskRobots = Robots;
+	TSharedPtr<TArray<FString>> TaskPublishOps = PublishOps;
+	const FString TaskTFTopic = TFTopic;
+
+	PublishTask = FFunctionGraphTask::CreateAndDispatchWhenReady([TaskHandler, TaskRobots, TaskPublishOps, Samples, Stamp, CycleSeq, TaskTFTopic]()
+	{
+		PublishSamples(*TaskHandler, *TaskRobots, Samples, Stamp, CycleSeq, TaskTFTopic, *TaskPublishOps);
+	}, TStatId(), nullptr, ENamedThreads::AnyBackgroundThreadNormalTask);
+}
+
+// Builds and publishes the messages of one cycle.
+void AROSMWControllerStatePublisher::PublishSamples(FROSBridgeHandler& Handler, const TArray<FROSMWControllerStateRobot>& Robots,
+	const TArray<FROSMWControllerStateSample>& Samples, const FROSTime& Stamp, const uint32 Seq, const FString& TFTopic, TArray<FString>& PublishOps)
+{
+	FROSMWControllerStateWriter::WritePublishOps(Robots, Samples, Stamp, Seq, TFTopic, PublishOps);
+	for (const FString& PublishOp : PublishOps)
+	{
+		Handler.PublishSerializedMsg(PublishOp);
+	}
+}
@@ -0,0 +1,62 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "ROSMWControllerStateWriter.h"
+#include "Conversions.h"
+#include "nav_msgs/Odometry.h"
+#include "tf2_msgs/TFMessage.h"
+
+// Writes the publish operations of one cycle.
+void FROSMWControllerStateWriter::WritePublishOps(const TArray<FROSMWControllerStateRobot>& Robots, const TArray<FROSMWControllerStateSample>& Samples,
+	const FROSTime& Stamp, const uint32 Seq, const FString& TFTopic, TArray<FString>& OutPublishOps)
+{
+	// One operation per odometry and one for the transforms, the strings of the last cycle are written again.
+	int32 NumOps = 0;
+	tf2_msgs::TFMessage TFMessage;
+
+	for (const FROSMWControllerStateSample& Sample : Samples)
+	{
+		const FROSMWControllerStateRobot& Robot = Robots[Sample.Robot];
+		const FMWControllerStateSnapshot& Snapshot = Sample.Snapshot;
+
+		// Convert unreal left-hand (cm) to ROS right-hand (m).
+		const FTransform Pose = FConversions::UToROS(Snapshot.BaseTransform);
+		const std_msgs::Header Header(Seq, Stamp, Robot.OdomFrame);
+
+		if (!TFTopic.IsEmpty())
+		{
+			TFMessage.AddTransform(geometry_msgs::TransformStamped(Header, Robot.BaseFrame,
+				geometry_msgs::Transform(geometry_msgs::Vector3(Pose.GetLocation()), geometry_msgs::Quaternion(Pose.GetRotation()))));
+		}
+
+		if (!Robot.OdometryTopic.IsEmpty())
+		{
+			geometry_msgs::PoseWithCovariance PoseWithCovariance;
+			PoseWithCovariance.SetPose(geometry_msgs::Pose(geometry_msgs::Point(Pose.GetLocation()), geometry_msgs::Quaternion(Pose.GetRotation())));
+
+			// The twist is given in the frame of the base. Same transformation as for the received messages, in reverse.
+			geometry_msgs::TwistWithCovariance TwistWithCovariance;
+			TwistWithCovariance.SetTwist(geometry_msgs::Twist(geometry_msgs::Vector3(FConversions::UToROS(Snapshot.BaseLinearVelocity)),
+				geometry_msgs::Vector3(FVector(0.f, 0.f, -Snapshot.BaseAngularVelocity))));
+
+			const nav_msgs::Odometry Odometry(Header, Robot.BaseFrame, PoseWithCovariance, TwistWithCovariance);
+			if (OutPublishOps.Num() <= NumOps)
+			{
+				OutPublishOps.AddDefaulted();
+			}
+			FROSBridgeMsg::WritePublish(Robot.OdometryTopic, Odometry, OutPublishOps[NumOps++]);
+		}
+	}
+
+	// The transforms of all robots go out in one message.
+	if (!TFTopic.IsEmpty() && Samples.Num() > 0)
+	{
+		if (OutPublishOps.Num() <= NumOps)
+		{
+			OutPublishOps.AddDefaulted();
+		}
+		FROSBridgeMsg::WritePublish(TFTopic, TFMessage, OutPublishOps[NumOps++]);
+	}
+
+	OutPublishOps.SetNum(NumOps, false);
+}
@@ -2,6 +2,7 @@
 // Author: Patrick Kellmann
 
 #include "ROSMWControllerSubscriber.h"
+#include "MWControllerRegistry.h"
 #include "std_msgs/String.h"
 
 // Sets default values
@@ -29,56 +30,138 @@ void AROSMWControllerSubscriber::BeginPlay()
 	// Set websocket server address to default
 	Handler = MakeShareable<FROSBridgeHandler>(new FROSBridgeHandler(IPAddress, Port));
 
+	// The subscribers are added before the handler thread starts, it takes them from the pending list once connected.
+	if (bSubscribeAllRobots)
+	{
+		AddRobotSubscribers();
+	}
+	else
+	{
+		AddRobotSubscriber();
+	}
+
 	// Connect to rosbridge
 	Handler->Connect();
+}
+
+// Adds the subscriber of the robot named MWRobotBaseActorName.
+void AROSMWControllerSubscriber::AddRobotSubscriber()
+{
+	// Get the controller of the actor who holds the robot. Controllers register themselves, so no actor has to be searched.
+	MWControllerRegistry* Registry = MWControllerRegistry::Get(this->GetWorld());
+	MWConComp = Registry ? Registry->FindControllerByActorName(MWRobotBaseActorName) : nullptr;
+
+	// MWController must be present at BeginPlay.
+	if (MWConComp && MWConComp->IsValidLowLevel())
+	{
+
+		// Create subscriber with callback class
+		MWSubscriber = MakeShareable<UROSMWControllerSubscriberCallback>(
+			new UROSMWControllerSubscriberCallback(Topic, TEXT("geometry_msgs/TwistStamped"), MWConComp));
+		if (bUseCbor)
+		{
+			MWSubscriber->SetCompression(TEXT("cbor"));
+		}
 
-	if (this && this->IsValidLowLevel())
+		// Add subscriber to ROS handler
+		Handler->AddSubscriber(MWSubscriber);
+	}
+	else
 	{
-		// Get the actor who holds the robot.
-		TArray<AActor*> HelperList;
-		UGameplayStatics::GetAllActorsOfClass(this->GetWorld(), AActor::StaticClass(), HelperList);
-		for (auto RobAct : HelperList)
+		UE_LOG(LogTemp, Log, 
+			TEXT("[%s] MWControllerComponent not found. No messages will be subscribed. %s"), 
+			*FString(__FUNCTION__), *MWRobotBaseActorName);
+	}
+}
+
+// Adds a subscriber for every robot.
+void AROSMWControllerSubscriber::AddRobotSubscribers()
+{
+	MWControllerRegistry* Registry = MWControllerRegistry::Get(this->GetWorld());
+	if (!Registry)
+	{
+		return;
+	}
+
+	RobotTopics.Reset();
+
+	if (RobotNames.Num() > 0)
+	{
+		for (const FString& RobotName : RobotNames)
 		{
-			// Look for the default names. "Contains" is used because Unreal changes the name in some cases.
-			if (RobAct->GetName().Contains(MWRobotBaseActorName))
+			UMWControllerComponent* Controller = Registry->FindControllerByActorName(RobotName);
+			if (Controller)
 			{
-				if (RobAct && RobAct->IsValidLowLevel())
-				{
-					TArray<UMWControllerComponent*> ActorComponentList;
-					RobAct->GetComponents<UMWControllerComponent>(ActorComponentList);
-
-					for (auto ActComp : ActorComponentList)
-					{
-						//Search for the controller per tag. 
-						if (ActComp->ComponentHasTag("MWControllerComponentTag"))
-						{
-							MWConComp = ActComp;
-
-							// MWController must be present at BeginPlay.
-							if (MWConComp && MWConComp->IsValidLowLevel())
-							{
-
-								// Create subscriber with callback class
-								MWSubscriber = MakeShareable<UROSMWControllerSubscriberCallback>(
-									new UROSMWControllerSubscriberCallback(Topic, TEXT("geometry_msgs/TwistStamped"), MWConComp));
-
-								// Add subscriber to ROS handler
-								Handler->AddSubscriber(MWSubscriber);
-							}
-							else
-							{
-								UE_LOG(LogTemp, Log, 
-									TEXT("[%s] MWControllerComponent not found. No messages will be subscribed. %s"), 
-									*FString(__FUNCTION__));
-							}
-
-							break;
-						}
-					}
-				}
+				AddRobotSubscriber(RobotName, Controller);
+			}
+			else
+			{
+				UE_LOG(LogTemp, Log,
+					TEXT("[%s] MWControllerComponent not found. No messages will be subscribed. %s"),
+					*FString(__FUNCTION__), *RobotName);
 			}
 		}
 	}
+	else
+	{
+		TArray<UMWControllerComponent*> Controllers;
+		Registry->GetControllers(Controllers);
+
+		// Same order in every run, so the log shows the topics in the same order.
+		Controllers.Sort([](const UMWControllerComponent& A, const UMWControllerComponent& B)
+		{
+			return A.GetPathName() < B.GetPathName();
+		});
+
+		for (UMWControllerComponent* Controller : Controllers)
+		{
+			if (Controller->GetOwner())
+			{
+				AddRobotSubscriber(Controller->GetOwner()->GetName(), Controller);
+			}
+		}
+	}
+
+	if (RobotSubscribers.Num() == 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("[%s] No MWControllerComponent found. No messages will be subscribed."), *FString(__FUNCTION__));
+	}
+}
+
+// Adds the subscriber of one robot.
+void AROSMWControllerSubscriber::AddRobotSubscriber(const FString& RobotName, UMWControllerComponent* Controller)
+{
+	FString RobotTopic;
+	if (!GetRobotTopic(RobotTopicTemplate, RobotName, RobotTopics, RobotTopic))
+	{
+		return;
+	}
+
+	// Each subscriber holds its controller, so a message needs no lookup.
+	TSharedPtr<UROSMWControllerSubscriberCallback> Subscriber = MakeShareable<UROSMWControllerSubscriberCallback>(
+		new UROSMWControllerSubscriberCallback(RobotTopic, TEXT("geometry_msgs/TwistStamped"), Controller));
+	if (bUseCbor)
+	{
+		Subscriber->SetCompression(TEXT("cbor"));
+	}
+	RobotSubscribers.Add(Subscriber);
+	Handler->AddSubscriber(Subscriber);
+}
+
+// Gets the topic of a robot.
+bool AROSMWControllerSubscriber::GetRobotTopic(const FString& TopicTemplate, const FString& RobotName, TSet<FString>& InOutTopics, FString& OutTopic)
+{
+	OutTopic = TopicTemplate.Replace(TEXT("{robot}"), *RobotName);
+
+	bool bTopicUsed = false;
+	InOutTopics.Add(OutTopic, &bTopicUsed);
+	if (bTopicUsed)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[%s][%d] Topic %s is used by several robots, only the first one is subscribed."),
+			TEXT(__FUNCTION__), __LINE__, *OutTopic);
+		return false;
+	}
+	return true;
 }
 
 // Called when the game starts or when spawned
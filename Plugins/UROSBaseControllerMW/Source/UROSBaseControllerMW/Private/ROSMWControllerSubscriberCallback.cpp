@@ -29,6 +29,45 @@ TSharedPtr<FROSBridgeMsg> UROSMWControllerSubscriberCallback::ParseMessage
 	return StaticCastSharedPtr<FROSBridgeMsg>(MWMessage);
 }
 
+// Reads TwistStamped from a json or CBOR view, both have the same accessors.
+template<typename ViewType>
+static TSharedPtr<FROSBridgeMsg> ParseTwistStamped(const ViewType& MsgView)
+{
+	const ViewType Twist = MsgView.GetField("twist");
+	const ViewType Linear = Twist.GetField("linear");
+	const ViewType Angular = Twist.GetField("angular");
+	if (!Linear.IsValid() || !Angular.IsValid())
+	{
+		// ParseMessage reports it.
+		return nullptr;
+	}
+
+	const ViewType Header = MsgView.GetField("header");
+	const ViewType Stamp = Header.GetField("stamp");
+
+	TSharedPtr<geometry_msgs::TwistStamped> MWMessage = MakeShareable<geometry_msgs::TwistStamped>(new geometry_msgs::TwistStamped(
+		std_msgs::Header((uint32)Header.GetField("seq").AsNumber(),
+			FROSTime((uint32)Stamp.GetField("secs").AsNumber(), (uint32)Stamp.GetField("nsecs").AsNumber()),
+			Header.GetField("frame_id").GetString().ToString()),
+		geometry_msgs::Twist(
+			geometry_msgs::Vector3(Linear.GetField("x").AsNumber(), Linear.GetField("y").AsNumber(), Linear.GetField("z").AsNumber()),
+			geometry_msgs::Vector3(Angular.GetField("x").AsNumber(), Angular.GetField("y").AsNumber(), Angular.GetField("z").AsNumber()))));
+
+	return StaticCastSharedPtr<FROSBridgeMsg>(MWMessage);
+}
+
+// Parse Message from the received bytes, cmd_vel comes at a high rate.
+TSharedPtr<FROSBridgeMsg> UROSMWControllerSubscriberCallback::ParseMessageFromView(const FROSBridgeJsonView& MsgView) const
+{
+	return ParseTwistStamped(MsgView);
+}
+
+// Parse Message from the received CBOR bytes.
+TSharedPtr<FROSBridgeMsg> UROSMWControllerSubscriberCallback::ParseMessageFromCbor(const FROSBridgeCborView& MsgView) const
+{
+	return ParseTwistStamped(MsgView);
+}
+
 // Sends Messages. 
 void UROSMWControllerSubscriberCallback::Callback(TSharedPtr<FROSBridgeMsg> Msg)
 {
@@ -42,13 +81,17 @@ void UROSMWControllerSubscriberCallback::Callback(TSharedPtr<FROSBridgeMsg> Msg)
 	// Transformation for the correct system in Unreal
 	AngularVelocity.Z *= -1;
 
+	// Copied, the task does not hold the callback.
+	TWeakObjectPtr<UMWControllerComponent> Controller = MWConComp;
+
 	// To use the same thread as MWController. 
-	FGraphEventRef Task = FFunctionGraphTask::CreateAndDispatchWhenReady([&, this, LinearVelocity, AngularVelocity]()
+	FGraphEventRef Task = FFunctionGraphTask::CreateAndDispatchWhenReady([Controller, LinearVelocity, AngularVelocity]()
 	{
-		if (MWConComp && MWConComp->IsValidLowLevel() && !MWConComp->IsBeingDestroyed())
+		if (Controller.IsValid() && !Controller->IsBeingDestroyed())
 		{
 			// Convert ROS right-hand to unreal left-hand. m/s is needed for most formulas and the interpolator, so it needs to be reverted. 
-			MWConComp->ReceiveROSMessage(FConversions::CmToM(FConversions::ROSToU(LinearVelocity)), AngularVelocity);
+			Controller->ReceiveROSMessage(FConversions::CmToM(FConversions::ROSToU(LinearVelocity)), AngularVelocity);
 		}
 	}, TStatId(), nullptr, ENamedThreads::GameThread);
-}
\ No newline at end of file
+}
+
@@ -0,0 +1,109 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "ROSMWControllerSimulationCommandlet.h"
+#include "MWControllerComponent.h"
+#include "MWControllerFleetManager.h"
+#include "ROSTime.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define SIMULATION_TEST_DELTA_TIME (1.f / 120.f)
+#define SIMULATION_TEST_STEPS (240)
+
+// Game world as the commandlet loads it: two MW controllers, spawned against the order of their names, and a tumbling cube
+static UWorld* CreateSimulationTestWorld(AStaticMeshActor*& OutCube)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	for (const TCHAR* Name : { TEXT("MWRobot_B"), TEXT("MWRobot_A") })
+	{
+		FActorSpawnParameters Parameters;
+		Parameters.Name = Name;
+		AActor* Robot = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, Parameters);
+		UMWControllerComponent* Controller = NewObject<UMWControllerComponent>(Robot, TEXT("MWController"));
+		Controller->RegisterComponent();
+	}
+
+	OutCube = World->SpawnActor<AStaticMeshActor>(FVector(0.f, 0.f, 500.f), FRotator(10.f, 20.f, 30.f));
+	UStaticMeshComponent* Mesh = OutCube->GetStaticMeshComponent();
+	Mesh->SetMobility(EComponentMobility::Movable);
+	Mesh->SetStaticMesh(LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube")));
+	Mesh->SetSimulatePhysics(true);
+
+	FURL URL;
+	World->InitializeActorsForPlay(URL);
+	UROSMWControllerSimulationCommandlet::UseFleetTick(World);
+	World->BeginPlay();
+
+	Mesh->SetPhysicsAngularVelocityInDegrees(FVector(90.f, 0.f, 45.f));
+	return World;
+}
+
+// Destroys the world of CreateSimulationTestWorld
+static void DestroySimulationTestWorld(UWorld* World)
+{
+	World->EndPlay(EEndPlayReason::Quit);
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSMWControllerSimulationTest, "UROSBaseControllerMW.Simulation", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Two headless runs of the same world give the same states, FROSTime follows the steps
+bool FROSMWControllerSimulationTest::RunTest(const FString& Parameters)
+{
+	TArray<FTransform> Runs[2];
+	for (TArray<FTransform>& Run : Runs)
+	{
+		AStaticMeshActor* Cube = nullptr;
+		UWorld* World = CreateSimulationTestWorld(Cube);
+
+		// The controllers do not tick on their own, whatever the default of bUseFleetTick is.
+		const MWControllerFleetManager* Fleet = MWControllerFleetManager::Get(World, false);
+		TestTrue(TEXT("Both controllers tick in the fleet"), Fleet && Fleet->Num() == 2);
+
+		int32 NumTimeMismatches = 0;
+		for (int64 Step = 0; Step < SIMULATION_TEST_STEPS; ++Step)
+		{
+			UROSMWControllerSimulationCommandlet::TickStep(World, SIMULATION_TEST_DELTA_TIME, Step);
+			Run.Add(Cube->GetActorTransform());
+
+			// Stamps of the step are the time at its end, counted in steps and not in float world time.
+			const FROSTime Now = FROSTime::Now();
+			const int64 Nanoseconds = int64(Now.Secs) * 1000000000 + Now.NSecs;
+			const int64 Expected = (int64)FMath::RoundToDouble(double(Step + 1) * SIMULATION_TEST_DELTA_TIME * 1e9);
+			if (Nanoseconds != Expected && ++NumTimeMismatches <= 5)
+			{
+				AddError(FString::Printf(TEXT("Step %lld: FROSTime is %lld ns instead of %lld ns."), Step, Nanoseconds, Expected));
+			}
+		}
+
+		DestroySimulationTestWorld(World);
+	}
+	FROSTime::ClearSimulatedTime();
+
+	TestFalse(TEXT("The cube moves"), Runs[0].Last().GetLocation().Equals(Runs[0][0].GetLocation()));
+	int32 NumMismatches = 0;
+	for (int32 Step = 0; Step < SIMULATION_TEST_STEPS; ++Step)
+	{
+		if (FMemory::Memcmp(&Runs[0][Step], &Runs[1][Step], sizeof(FTransform)) != 0 && ++NumMismatches <= 5)
+		{
+			AddError(FString::Printf(TEXT("Step %d: %s in the first run, %s in the second."), Step, *Runs[0][Step].ToString(), *Runs[1][Step].ToString()));
+		}
+	}
+	TestEqual(TEXT("Steps that differ between the runs"), NumMismatches, 0);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,172 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "ROSMWControllerStateWriter.h"
+#include "ROSBridgeJsonView.h"
+#include "Conversions.h"
+#include "nav_msgs/Odometry.h"
+#include "tf2_msgs/TFMessage.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define STATE_WRITER_BENCHMARK_ROBOTS (100)
+#define STATE_WRITER_BENCHMARK_RATE (50)
+#define STATE_WRITER_BENCHMARK_CYCLES (500)
+
+// Creates robots named like the ones of the publisher, with a pose and velocity per robot.
+static void CreateStateWriterRobots(const int32 NumRobots, TArray<FROSMWControllerStateRobot>& OutRobots, TArray<FROSMWControllerStateSample>& OutSamples)
+{
+	for (int32 i = 0; i < NumRobots; ++i)
+	{
+		const FString RobotName = FString::Printf(TEXT("MWRobot_%d"), i);
+		FROSMWControllerStateRobot& Robot = OutRobots[OutRobots.AddDefaulted()];
+		Robot.OdometryTopic = FString::Printf(TEXT("/%s/odom"), *RobotName);
+		Robot.OdomFrame = RobotName + TEXT("/odom");
+		Robot.BaseFrame = RobotName + TEXT("/base_footprint");
+
+		FROSMWControllerStateSample& Sample = OutSamples[OutSamples.AddDefaulted()];
+		Sample.Robot = i;
+		Sample.Snapshot.BaseTransform = FTransform(FQuat(0.f, 0.f, 0.38268343f, 0.92387953f), FVector(150.f * i, -200.f, 10.f));
+		Sample.Snapshot.BaseLinearVelocity = FVector(50.f, 25.f, 0.f);
+		Sample.Snapshot.BaseAngularVelocity = 0.5f;
+	}
+}
+
+// Publish operations as the publisher wrote them before: every message through a FJsonObject and the json writer of the engine.
+static void WriteStateOpsWithJsonObjects(const TArray<FROSMWControllerStateRobot>& Robots, const TArray<FROSMWControllerStateSample>& Samples,
+	const FROSTime& Stamp, const uint32 Seq, const FString& TFTopic, TArray<FString>& OutPublishOps)
+{
+	OutPublishOps.Reset();
+	TSharedPtr<tf2_msgs::TFMessage> TFMessage = MakeShareable(new tf2_msgs::TFMessage());
+	for (const FROSMWControllerStateSample& Sample : Samples)
+	{
+		const FROSMWControllerStateRobot& Robot = Robots[Sample.Robot];
+		const FTransform Pose = FConversions::UToROS(Sample.Snapshot.BaseTransform);
+		const std_msgs::Header Header(Seq, Stamp, Robot.OdomFrame);
+
+		TFMessage->AddTransform(geometry_msgs::TransformStamped(Header, Robot.BaseFrame,
+			geometry_msgs::Transform(geometry_msgs::Vector3(Pose.GetLocation()), geometry_msgs::Quaternion(Pose.GetRotation()))));
+
+		geometry_msgs::PoseWithCovariance PoseWithCovariance;
+		PoseWithCovariance.SetPose(geometry_msgs::Pose(geometry_msgs::Point(Pose.GetLocation()), geometry_msgs::Quaternion(Pose.GetRotation())));
+		geometry_msgs::TwistWithCovariance TwistWithCovariance;
+		TwistWithCovariance.SetTwist(geometry_msgs::Twist(geometry_msgs::Vector3(FConversions::UToROS(Sample.Snapshot.BaseLinearVelocity)),
+			geometry_msgs::Vector3(FVector(0.f, 0.f, -Sample.Snapshot.BaseAngularVelocity))));
+
+		TSharedPtr<nav_msgs::Odometry> Odometry = MakeShareable(new nav_msgs::Odometry(Header, Robot.BaseFrame, PoseWithCovariance, TwistWithCovariance));
+		OutPublishOps.Add(FROSBridgeMsg::Publish(Robot.OdometryTopic, Odometry));
+	}
+	OutPublishOps.Add(FROSBridgeMsg::Publish(TFTopic, TFMessage));
+}
+
+// Bytes of the operations as sent, the text is ASCII
+static int32 GetStatePublishOpsBytes(const TArray<FString>& PublishOps)
+{
+	int32 Bytes = 0;
+	for (const FString& PublishOp : PublishOps)
+	{
+		Bytes += PublishOp.Len();
+	}
+	return Bytes;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSMWControllerStateWriterTest, "UROSBaseControllerMW.StateWriter", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Reads the written operations back: one odometry per robot with the pose in ROS coordinates and one TFMessage with all robots.
+bool FROSMWControllerStateWriterTest::RunTest(const FString& Parameters)
+{
+	TArray<FROSMWControllerStateRobot> Robots;
+	TArray<FROSMWControllerStateSample> Samples;
+	CreateStateWriterRobots(3, Robots, Samples);
+
+	// The second robot publishes no odometry, the third has no state in this cycle.
+	Robots[1].OdometryTopic.Empty();
+	Samples.RemoveAt(2);
+
+	// A longer list from the last cycle is cut to the operations of this one.
+	TArray<FString> PublishOps;
+	PublishOps.SetNum(5);
+	FROSMWControllerStateWriter::WritePublishOps(Robots, Samples, FROSTime(12, 500), 7, TEXT("/tf"), PublishOps);
+	if (!TestEqual(TEXT("Operations"), PublishOps.Num(), 2))
+	{
+		return false;
+	}
+
+	const FTCHARToUTF8 Odometry(*PublishOps[0]);
+	const FROSBridgeJsonView OdometryOp(Odometry.Get(), Odometry.Get() + Odometry.Length());
+	const FROSBridgeJsonView OdometryMsg = OdometryOp.GetField("msg");
+	TestTrue(TEXT("Odometry op"), OdometryOp.GetField("op").GetString().Equals("publish"));
+	TestTrue(TEXT("Odometry topic"), OdometryOp.GetField("topic").GetString().Equals("/MWRobot_0/odom"));
+	TestTrue(TEXT("Odometry seq"), OdometryMsg.GetField("header").GetField("seq").AsNumber() == 7.0);
+	TestTrue(TEXT("Odometry nsecs"), OdometryMsg.GetField("header").GetField("stamp").GetField("nsecs").AsNumber() == 500.0);
+	TestTrue(TEXT("Odometry frame"), OdometryMsg.GetField("header").GetField("frame_id").GetString().Equals("MWRobot_0/odom"));
+	TestTrue(TEXT("Odometry child frame"), OdometryMsg.GetField("child_frame_id").GetString().Equals("MWRobot_0/base_footprint"));
+
+	// Unreal cm with Y right to ROS m with Y left, the rotation around Z is mirrored.
+	const FROSBridgeJsonView Pose = OdometryMsg.GetField("pose").GetField("pose");
+	TestTrue(TEXT("Odometry position"), FMath::IsNearlyEqual(Pose.GetField("position").GetField("y").AsNumber(), 2.0, 1e-6));
+	TestTrue(TEXT("Odometry orientation"), FMath::IsNearlyEqual(Pose.GetField("orientation").GetField("z").AsNumber(), -0.38268343, 1e-6));
+	TestTrue(TEXT("Odometry angular velocity"), OdometryMsg.GetField("twist").GetField("twist").GetField("angular").GetField("z").AsNumber() == -0.5);
+	TArray<FROSBridgeJsonView> Covariance;
+	TestTrue(TEXT("Odometry covariance"), OdometryMsg.GetField("pose").GetField("covariance").GetElements(Covariance) && Covariance.Num() == 36);
+
+	const FTCHARToUTF8 TF(*PublishOps[1]);
+	const FROSBridgeJsonView TFOp(TF.Get(), TF.Get() + TF.Length());
+	TArray<FROSBridgeJsonView> Transforms;
+	TestTrue(TEXT("TF topic"), TFOp.GetField("topic").GetString().Equals("/tf"));
+	if (TestTrue(TEXT("Transforms"), TFOp.GetField("msg").GetField("transforms").GetElements(Transforms) && Transforms.Num() == 2))
+	{
+		TestTrue(TEXT("Child frame of the second robot"), Transforms[1].GetField("child_frame_id").GetString().Equals("MWRobot_1/base_footprint"));
+		TestTrue(TEXT("Translation of the second robot"), FMath::IsNearlyEqual(Transforms[1].GetField("transform").GetField("translation").GetField("x").AsNumber(), 1.5, 1e-6));
+	}
+
+	// Without a TF topic only the odometry is written.
+	FROSMWControllerStateWriter::WritePublishOps(Robots, Samples, FROSTime(12, 500), 8, FString(), PublishOps);
+	TestEqual(TEXT("Operations without TF"), PublishOps.Num(), 1);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSMWControllerStateWriterBenchmark, "UROSBaseControllerMW.Benchmark.StatePublisher", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Bytes and CPU time of the messages of 100 robots at 50 Hz, written directly and as before through FJsonObjects
+bool FROSMWControllerStateWriterBenchmark::RunTest(const FString& Parameters)
+{
+	TArray<FROSMWControllerStateRobot> Robots;
+	TArray<FROSMWControllerStateSample> Samples;
+	CreateStateWriterRobots(STATE_WRITER_BENCHMARK_ROBOTS, Robots, Samples);
+	const FROSTime Stamp(1550000000, 123456789);
+
+	TArray<FString> PublishOps;
+	double Start = FPlatformTime::Seconds();
+	for (int32 Cycle = 0; Cycle < STATE_WRITER_BENCHMARK_CYCLES; ++Cycle)
+	{
+		FROSMWControllerStateWriter::WritePublishOps(Robots, Samples, Stamp, Cycle, TEXT("/tf"), PublishOps);
+	}
+	const double WriterSeconds = (FPlatformTime::Seconds() - Start) / STATE_WRITER_BENCHMARK_CYCLES;
+	const int32 WriterBytes = GetStatePublishOpsBytes(PublishOps);
+
+	TArray<FString> JsonObjectOps;
+	Start = FPlatformTime::Seconds();
+	for (int32 Cycle = 0; Cycle < STATE_WRITER_BENCHMARK_CYCLES; ++Cycle)
+	{
+		WriteStateOpsWithJsonObjects(Robots, Samples, Stamp, Cycle, TEXT("/tf"), JsonObjectOps);
+	}
+	const double JsonObjectSeconds = (FPlatformTime::Seconds() - Start) / STATE_WRITER_BENCHMARK_CYCLES;
+	const int32 JsonObjectBytes = GetStatePublishOpsBytes(JsonObjectOps);
+
+	TestEqual(TEXT("Operations"), PublishOps.Num(), JsonObjectOps.Num());
+
+	// Share of one core and bandwidth at the publish rate.
+	AddInfo(FString::Printf(TEXT("%d robots at %d Hz, written: %d bytes and %.3f ms per cycle, %.2f MB/s, %.1f %% of a core."),
+		STATE_WRITER_BENCHMARK_ROBOTS, STATE_WRITER_BENCHMARK_RATE, WriterBytes, WriterSeconds * 1e3,
+		WriterBytes * STATE_WRITER_BENCHMARK_RATE * 1e-6, WriterSeconds * STATE_WRITER_BENCHMARK_RATE * 100.0));
+	AddInfo(FString::Printf(TEXT("%d robots at %d Hz, FJsonObject: %d bytes and %.3f ms per cycle, %.2f MB/s, %.1f %% of a core."),
+		STATE_WRITER_BENCHMARK_ROBOTS, STATE_WRITER_BENCHMARK_RATE, JsonObjectBytes, JsonObjectSeconds * 1e3,
+		JsonObjectBytes * STATE_WRITER_BENCHMARK_RATE * 1e-6, JsonObjectSeconds * STATE_WRITER_BENCHMARK_RATE * 100.0));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,303 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "ROSBridgeHandler.h"
+#include "ROSBridgeJsonView.h"
+#include "ROSMWControllerSubscriber.h"
+#include "ROSMWControllerSubscriberCallback.h"
+#include "MWControllerComponent.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !PLATFORM_HTML5
+
+// Work around a conflict between a UI namespace defined by engine code and a typedef in OpenSSL
+#define UI UI_ST
+THIRD_PARTY_INCLUDES_START
+#include "libwebsockets.h"
+THIRD_PARTY_INCLUDES_END
+#undef UI
+
+#define SUBSCRIBER_TEST_PORT (9191)
+#define SUBSCRIBER_TEST_MESSAGES (100)
+#define SUBSCRIBER_TEST_TIMEOUT (5.0)
+
+static int ros_mw_subscriber_test_server(struct lws* Wsi, enum lws_callback_reasons Reason, void* User, void* In, size_t Len);
+
+// Stand-in for rosbridge on localhost: once every robot topic is subscribed, publishes cmd_vel on all of them in turns.
+// The twist of a message has the number of its topic in linear.x and its number in linear.y.
+class FROSMWControllerTopicServer : public FRunnable
+{
+public:
+	FROSMWControllerTopicServer(const int32 InNumTopics) : Context(nullptr), Thread(nullptr), bStop(false), NumTopics(InNumTopics), NumSent(0)
+	{
+		FMemory::Memzero(Protocols, sizeof(Protocols));
+	}
+
+	~FROSMWControllerTopicServer()
+	{
+		if (Thread)
+		{
+			Thread->Kill(true);
+			delete Thread;
+		}
+		if (Context)
+		{
+			lws_context_destroy(Context);
+		}
+	}
+
+	// Listen on the port and start the thread of the server
+	bool Start(const int32 Port)
+	{
+		Protocols[0].name = "binary";
+		Protocols[0].callback = ros_mw_subscriber_test_server;
+		Protocols[0].rx_buffer_size = 64 * 1024;
+
+		struct lws_context_creation_info Info;
+		FMemory::Memzero(&Info, sizeof(Info));
+		Info.port = Port;
+		Info.protocols = Protocols;
+		Info.gid = -1;
+		Info.uid = -1;
+		Info.user = this;
+		Context = lws_create_context(&Info);
+		if (!Context)
+		{
+			return false;
+		}
+		Thread = FRunnableThread::Create(this, TEXT("ROSMWControllerTopicServer"), 0, TPri_Normal);
+		return Thread != nullptr;
+	}
+
+	virtual uint32 Run() override
+	{
+		while (!bStop.Load())
+		{
+			lws_service(Context, 100);
+		}
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStop.Store(true);
+		lws_cancel_service(Context);
+	}
+
+	// Topics in the order the handler subscribed them, a topic subscribed twice is in it twice
+	TArray<FString> GetSubscribedTopics()
+	{
+		FScopeLock Lock(&TopicsCriticalSection);
+		return Topics;
+	}
+
+	// Note the subscribed topics, start publishing with the last one
+	void OnReceive(struct lws* Wsi, const ANSICHAR* Data, const int32 Length)
+	{
+		const FROSBridgeJsonView Message(Data, Data + Length);
+		if (!Message.GetField("op").GetString().Equals("subscribe"))
+		{
+			return;
+		}
+
+		int32 NumSubscribed = 0;
+		{
+			FScopeLock Lock(&TopicsCriticalSection);
+			NumSubscribed = Topics.Add(Message.GetField("topic").GetString().ToString()) + 1;
+		}
+		if (NumSubscribed != NumTopics)
+		{
+			return;
+		}
+
+		// One message per topic in turns, so the handler has to route every message on its own.
+		const TArray<FString> SubscribedTopics = GetSubscribedTopics();
+		for (int32 i = 0; i < SUBSCRIBER_TEST_MESSAGES; ++i)
+		{
+			for (int32 TopicIndex = 0; TopicIndex < SubscribedTopics.Num(); ++TopicIndex)
+			{
+				const FString Publish = FString::Printf(
+					TEXT("{\"op\":\"publish\",\"topic\":\"%s\",\"msg\":{\"header\":{\"seq\":%d,\"stamp\":{\"secs\":0,\"nsecs\":0},\"frame_id\":\"\"},")
+					TEXT("\"twist\":{\"linear\":{\"x\":%d,\"y\":%d,\"z\":0},\"angular\":{\"x\":0,\"y\":0,\"z\":0}}}}"),
+					*SubscribedTopics[TopicIndex], i, TopicIndex, i);
+				const FTCHARToUTF8 Utf8(*Publish);
+
+				TArray<uint8>& Frame = Pending[Pending.AddDefaulted()];
+				Frame.SetNumUninitialized(LWS_PRE + Utf8.Length());
+				FMemory::Memcpy(Frame.GetData() + LWS_PRE, Utf8.Get(), Utf8.Length());
+			}
+		}
+		lws_callback_on_writable(Wsi);
+	}
+
+	// Send one message per callback, libwebsockets keeps the rest of a frame that did not fit
+	void OnWritable(struct lws* Wsi)
+	{
+		if (NumSent == Pending.Num())
+		{
+			return;
+		}
+		TArray<uint8>& Frame = Pending[NumSent++];
+		lws_write(Wsi, Frame.GetData() + LWS_PRE, Frame.Num() - LWS_PRE, LWS_WRITE_TEXT);
+		lws_callback_on_writable(Wsi);
+	}
+
+private:
+	struct lws_context* Context;
+	struct lws_protocols Protocols[2];
+	FRunnableThread* Thread;
+	TAtomic<bool> bStop;
+
+	// Number of robot topics the handler subscribes.
+	const int32 NumTopics;
+
+	// Subscribed topics, read by the test.
+	TArray<FString> Topics;
+	FCriticalSection TopicsCriticalSection;
+
+	// Messages to send, with the headroom of libwebsockets in front. Only used by the thread of the server.
+	TArray<TArray<uint8>> Pending;
+	int32 NumSent;
+};
+
+static int ros_mw_subscriber_test_server(struct lws* Wsi, enum lws_callback_reasons Reason, void* User, void* In, size_t Len)
+{
+	FROSMWControllerTopicServer* Server = (FROSMWControllerTopicServer*)lws_context_user(lws_get_context(Wsi));
+	switch (Reason)
+	{
+	case LWS_CALLBACK_RECEIVE:
+		Server->OnReceive(Wsi, (const ANSICHAR*)In, (int32)Len);
+		break;
+	case LWS_CALLBACK_SERVER_WRITEABLE:
+		Server->OnWritable(Wsi);
+		break;
+	default:
+		break;
+	}
+	return 0;
+}
+
+// Subscriber of a robot that notes the messages it gets, then passes them on to the controller
+class FROSMWControllerTestSubscriber : public UROSMWControllerSubscriberCallback
+{
+public:
+	FROSMWControllerTestSubscriber(const FString& InTopic, UMWControllerComponent* Controller) :
+		UROSMWControllerSubscriberCallback(InTopic, TEXT("geometry_msgs/TwistStamped"), Controller)
+	{
+	}
+
+	virtual void Callback(TSharedPtr<FROSBridgeMsg> Msg) override
+	{
+		const TSharedPtr<geometry_msgs::TwistStamped> Twist = StaticCastSharedPtr<geometry_msgs::TwistStamped>(Msg);
+		Seqs.Add(Twist->GetHeader().GetSeq());
+		Linears.Add(Twist->GetTwist().GetLinear().GetVector());
+		UROSMWControllerSubscriberCallback::Callback(Msg);
+	}
+
+	TArray<uint32> Seqs;
+	TArray<FVector> Linears;
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSMWControllerSubscriberTopicsTest, "UROSBaseControllerMW.Subscriber.RobotTopics", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// The cmd_vel of two robots come over one connection and each robot gets only the messages of its topic, in order.
+// A topic is subscribed for one robot only.
+bool FROSMWControllerSubscriberTopicsTest::RunTest(const FString& Parameters)
+{
+	// A template without {robot} gives every robot the same topic, and a robot added twice has its topic twice.
+	AddExpectedError(TEXT("is used by several robots"), EAutomationExpectedErrorFlags::Contains, 2);
+	{
+		TSet<FString> Topics;
+		FString Topic;
+		TestTrue(TEXT("First robot gets the topic"), AROSMWControllerSubscriber::GetRobotTopic(TEXT("/base/cmd_vel"), TEXT("MWRobot_A"), Topics, Topic));
+		TestFalse(TEXT("Second robot with the same topic is rejected"), AROSMWControllerSubscriber::GetRobotTopic(TEXT("/base/cmd_vel"), TEXT("MWRobot_B"), Topics, Topic));
+		TestEqual(TEXT("Topic is subscribed once"), Topics.Num(), 1);
+	}
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	const FString RobotNames[] = { TEXT("MWRobot_A"), TEXT("MWRobot_B"), TEXT("MWRobot_A") };
+	TSet<FString> RobotTopics;
+	TArray<TSharedPtr<FROSMWControllerTestSubscriber>> Subscribers;
+	FROSBridgeHandler Handler(TEXT("127.0.0.1"), SUBSCRIBER_TEST_PORT);
+	for (int32 i = 0; i < ARRAY_COUNT(RobotNames); ++i)
+	{
+		FString RobotTopic;
+		if (!AROSMWControllerSubscriber::GetRobotTopic(TEXT("/{robot}/base/cmd_vel"), RobotNames[i], RobotTopics, RobotTopic))
+		{
+			continue;
+		}
+
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.Name = *RobotNames[i];
+		AActor* Robot = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParameters);
+		UMWControllerComponent* Controller = NewObject<UMWControllerComponent>(Robot, TEXT("MWController"));
+		Controller->RegisterComponent();
+
+		TSharedPtr<FROSMWControllerTestSubscriber> Subscriber = MakeShareable(new FROSMWControllerTestSubscriber(RobotTopic, Controller));
+		Subscribers.Add(Subscriber);
+		Handler.AddSubscriber(Subscriber);
+	}
+	TestEqual(TEXT("Robot added twice is subscribed once"), Subscribers.Num(), 2);
+
+	FROSMWControllerTopicServer Server(Subscribers.Num());
+	if (TestTrue(TEXT("Stand-in server listens"), Server.Start(SUBSCRIBER_TEST_PORT)))
+	{
+		Handler.Connect();
+		const double Start = FPlatformTime::Seconds();
+		bool bReceived = false;
+		while (!bReceived && FPlatformTime::Seconds() - Start < SUBSCRIBER_TEST_TIMEOUT)
+		{
+			Handler.Process();
+			bReceived = true;
+			for (const TSharedPtr<FROSMWControllerTestSubscriber>& Subscriber : Subscribers)
+			{
+				bReceived &= Subscriber->Seqs.Num() >= SUBSCRIBER_TEST_MESSAGES;
+			}
+			FPlatformProcess::Sleep(0.001f);
+		}
+		Handler.Disconnect();
+
+		// The controllers get the messages in tasks of the game thread.
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+
+		const TArray<FString> SubscribedTopics = Server.GetSubscribedTopics();
+		TestEqual(TEXT("Every topic is subscribed once over the connection"), SubscribedTopics.Num(), Subscribers.Num());
+		for (const TSharedPtr<FROSMWControllerTestSubscriber>& Subscriber : Subscribers)
+		{
+			const int32 TopicIndex = SubscribedTopics.IndexOfByKey(Subscriber->GetTopic());
+			if (!TestTrue(FString::Printf(TEXT("%s is subscribed"), *Subscriber->GetTopic()), TopicIndex != INDEX_NONE)
+				|| !TestEqual(FString::Printf(TEXT("%s: messages"), *Subscriber->GetTopic()), Subscriber->Seqs.Num(), SUBSCRIBER_TEST_MESSAGES))
+			{
+				continue;
+			}
+
+			int32 NumMismatches = 0;
+			for (int32 i = 0; i < SUBSCRIBER_TEST_MESSAGES; ++i)
+			{
+				const FVector Expected(float(TopicIndex), float(i), 0.f);
+				if ((Subscriber->Seqs[i] != uint32(i) || !Subscriber->Linears[i].Equals(Expected)) && ++NumMismatches <= 5)
+				{
+					AddError(FString::Printf(TEXT("%s: message %d is seq %u with %s instead of seq %d with %s."), *Subscriber->GetTopic(),
+						i, Subscriber->Seqs[i], *Subscriber->Linears[i].ToString(), i, *Expected.ToString()));
+				}
+			}
+			TestEqual(FString::Printf(TEXT("%s: messages of other topics or out of order"), *Subscriber->GetTopic()), NumMismatches, 0);
+		}
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && !PLATFORM_HTML5
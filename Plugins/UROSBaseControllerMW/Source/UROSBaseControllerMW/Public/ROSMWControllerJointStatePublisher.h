@@ -0,0 +1,129 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ROSBridgeHandler.h"
+#include "MWControllerComponent.h"
+#include "sensor_msgs/JointState.h"
+#include "ROSMWControllerJointStatePublisher.generated.h"
+
+#define JOINT_STATE_NUM_WHEELS	(4)
+
+/*
+* Robot whose wheel joints are published. The message is made once and only its values change.
+*/
+struct FROSMWControllerJointStateRobot
+{
+	// Controller of the robot.
+	TWeakObjectPtr<UMWControllerComponent> Controller;
+
+	// Topic of the joint states.
+	FString Topic;
+
+	// Message that is published again in every cycle.
+	sensor_msgs::JointState Message;
+
+	// Rotation of the wheels relative to the base at the first cycle, the positions start at 0.
+	FQuat RestRotations[JOINT_STATE_NUM_WHEELS];
+	bool bRestRotationsSet = false;
+};
+
+/*
+* Publishes the angles and velocities of the four wheels of MWControllers as sensor_msgs/JointState, one topic per robot.
+* The messages, their name arrays and the json buffer are made at BeginPlay and reused, a cycle only writes the values.
+*/
+UCLASS()
+class UROSBASECONTROLLERMW_API AROSMWControllerJointStatePublisher : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	/*
+	* Sets default values for this actor's properties.
+	*/
+	AROSMWControllerJointStatePublisher();
+
+protected:
+
+	/*
+	* Called when the game starts or when spawned. Finds the robots and advertises the topics.
+	*/
+	virtual void BeginPlay() override;
+
+	/*
+	* Called when game ends or actor deleted
+	*
+	* @param Reason reason for end play.
+	*/
+	virtual void EndPlay(const EEndPlayReason::Type Reason) override;
+
+	/*
+	* Called every frame. Publishes when a cycle is due.
+	*
+	* @param DeltaTime Holds current delta time in seconds.
+	*/
+	virtual void Tick(float DeltaTime) override;
+
+public:
+
+	// Address for communication.
+	UPROPERTY(EditAnywhere, Category = "ROS Publisher", meta = (ToolTip = "IP address of the ROS computer"))
+		FString IPAddress;
+
+	// Port for communication.
+	UPROPERTY(EditAnywhere, Category = "ROS Publisher", meta = (ToolTip = "Port to be used"))
+		uint32 Port;
+
+	// Rate of the messages.
+	UPROPERTY(EditAnywhere, Category = "ROS Publisher", meta = (ClampMin = "0.1"))
+		float PublishRateInHz = 50.f;
+
+	// Names of the robot actors to publish. Empty publishes every robot of the level.
+	UPROPERTY(EditAnywhere, Category = "ROS Publisher", meta = (ToolTip = "Names of the robot actors. Empty publishes every robot that is in the level at BeginPlay."))
+		TArray<FString> RobotNames;
+
+	// Topic of a robot, {robot} is replaced by the name of the robot.
+	UPROPERTY(EditAnywhere, Category = "ROS Publisher", meta = (ToolTip = "Joint state topic of a robot. {robot} is replaced by the name of the robot actor."))
+		FString TopicTemplate = TEXT("/{robot}/joint_states");
+
+	// Joint names of the wheels: left front, right front, left rear, right rear.
+	UPROPERTY(EditAnywhere, Category = "ROS Publisher", EditFixedSize, meta = (ToolTip = "Joint names of the wheels: left front, right front, left rear, right rear."))
+		TArray<FString> WheelJointNames;
+
+private:
+
+	/*
+	* Adds a robot and advertises its topic.
+	*
+	* @param RobotName Name of the robot, replaces {robot} in the topic.
+	* @param Controller Controller of the robot.
+	*/
+	void AddRobot(const FString& RobotName, UMWControllerComponent* Controller);
+
+	/*
+	* Writes the wheel angles and velocities into the message of the robot.
+	*
+	* @param Robot Robot to update.
+	* @return false if the robot is gone.
+	*/
+	bool UpdateJoints(FROSMWControllerJointStateRobot& Robot) const;
+
+	// Add a smart pointer to ROSBridgeHandler
+	TSharedPtr<FROSBridgeHandler> Handler;
+
+	// Published robots.
+	TArray<FROSMWControllerJointStateRobot> Robots;
+
+	// Json of the last message, the memory is reused.
+	FString PublishBuffer;
+
+	// Time until the next cycle.
+	float TimeToPublish = 0.f;
+
+	// Number of the next cycle.
+	uint32 Seq = 0;
+};
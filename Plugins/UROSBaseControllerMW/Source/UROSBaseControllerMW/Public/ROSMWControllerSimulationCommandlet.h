@@ -0,0 +1,72 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ROSMWControllerSimulationCommandlet.generated.h"
+
+/*
+* Runs a map headless with a fixed time step as fast as possible, e.g. for parameter sweeps.
+* Nothing is rendered. FROSTime and the world time both follow the simulated time, so ROS stamps and
+* the data collector match the steps. Reports the simulated seconds per wall second.
+* Every MW controller runs in the fleet of the world, whatever bUseFleetTick says in the map: the fleet ticks
+* the controllers sorted by path, the own component ticks would run in the order of the task graph.
+*
+* UE4Editor-Cmd.exe Project.uproject -run=ROSMWControllerSimulation -Map=/Game/Maps/MyMap [-DeltaTime=0.001] [-Duration=60] [-ReportInterval=10]
+*/
+UCLASS()
+class UROSBASECONTROLLERMW_API UROSMWControllerSimulationCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	/*
+	* Sets default values for the commandlet.
+	*/
+	UROSMWControllerSimulationCommandlet();
+
+	/*
+	* Loads the map and steps it.
+	*
+	* @param Params Command line of the commandlet.
+	* @return 0 on success, otherwise 1.
+	*/
+	virtual int32 Main(const FString& Params) override;
+
+	/*
+	* Lets the fleet of the world tick every MW controller. Must be called before BeginPlay.
+	*
+	* @param World World that has not begun play yet.
+	* @return Number of MW controllers in the world.
+	*/
+	static int32 UseFleetTick(UWorld* World);
+
+	/*
+	* Ticks the world by one fixed step. FROSTime is set to the end of the step before.
+	*
+	* @param World World of LoadWorld.
+	* @param DeltaTime Fixed time step in seconds.
+	* @param Step Number of the step, counted from 0.
+	*/
+	static void TickStep(UWorld* World, const float DeltaTime, const int64 Step);
+
+private:
+
+	/*
+	* Loads the map and starts the play in it.
+	*
+	* @param MapName Package name of the map.
+	* @return The world or nullptr.
+	*/
+	UWorld* LoadWorld(const FString& MapName);
+
+	/*
+	* Ends the play and destroys the world.
+	*
+	* @param World World of LoadWorld.
+	*/
+	void UnloadWorld(UWorld* World);
+};
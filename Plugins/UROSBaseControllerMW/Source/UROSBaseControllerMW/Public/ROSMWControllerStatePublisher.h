@@ -0,0 +1,137 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ROSBridgeHandler.h"
+#include "MWControllerComponent.h"
+#include "ROSMWControllerStateWriter.h"
+#include "ROSMWControllerStatePublisher.generated.h"
+
+/*
+* Publishes the odometry and the TF of MWControllers.
+* The state snapshots of all robots are taken on the game thread after physics, at PublishRateInHz. The messages are built
+* and serialized on a background task: one nav_msgs/Odometry per robot and one tf2_msgs/TFMessage with the transforms of all robots.
+* The pose is the ground truth of the simulation. If a cycle is due while the last one is still being serialized, it is skipped.
+*/
+UCLASS()
+class UROSBASECONTROLLERMW_API AROSMWControllerStatePublisher : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	/*
+	* Sets default values for this actor's properties.
+	*/
+	AROSMWControllerStatePublisher();
+
+	/*
+	* Gets the number of cycles that were skipped because the last one was not published yet.
+	*
+	* @return Number of skipped cycles.
+	*/
+	int32 GetSkippedCycles() const;
+
+protected:
+
+	/*
+	* Called when the game starts or when spawned. Finds the robots and advertises the topics.
+	*/
+	virtual void BeginPlay() override;
+
+	/*
+	* Called when game ends or actor deleted. Waits for the last cycle.
+	*
+	* @param Reason reason for end play.
+	*/
+	virtual void EndPlay(const EEndPlayReason::Type Reason) override;
+
+	/*
+	* Called every frame. Takes the snapshots when a cycle is due.
+	*
+	* @param DeltaTime Holds current delta time in seconds.
+	*/
+	virtual void Tick(float DeltaTime) override;
+
+public:
+
+	// Address for communication.
+	UPROPERTY(EditAnywhere, Category = "ROS Publisher", meta = (ToolTip = "IP address of the ROS computer"))
+		FString IPAddress;
+
+	// Port for communication.
+	UPROPERTY(EditAnywhere, Category = "ROS Publisher", meta = (ToolTip = "Port to be used"))
+		uint32 Port;
+
+	// Rate of the messages.
+	UPROPERTY(EditAnywhere, Category = "ROS Publisher", meta = (ClampMin = "0.1"))
+		float PublishRateInHz = 50.f;
+
+	// Names of the robot actors to publish. Empty publishes every robot of the level.
+	UPROPERTY(EditAnywhere, Category = "ROS Publisher", meta = (ToolTip = "Names of the robot actors. Empty publishes every robot that is in the level at BeginPlay."))
+		TArray<FString> RobotNames;
+
+	// Topic of the odometry of a robot, {robot} is replaced by the name of the robot. Empty does not publish odometry.
+	UPROPERTY(EditAnywhere, Category = "ROS Publisher", meta = (ToolTip = "Odometry topic of a robot. {robot} is replaced by the name of the robot actor."))
+		FString OdometryTopicTemplate = TEXT("/{robot}/odom");
+
+	// Topic of the transforms of all robots. Empty does not publish TF.
+	UPROPERTY(EditAnywhere, Category = "ROS Publisher", meta = (ToolTip = "TF topic, shared by all robots."))
+		FString TFTopic = TEXT("/tf");
+
+	// Frame the pose is given in, {robot} is replaced by the name of the robot.
+	UPROPERTY(EditAnywhere, Category = "ROS Publisher")
+		FString OdomFrameTemplate = TEXT("{robot}/odom");
+
+	// Frame of the base, {robot} is replaced by the name of the robot.
+	UPROPERTY(EditAnywhere, Category = "ROS Publisher")
+		FString BaseFrameTemplate = TEXT("{robot}/base_footprint");
+
+private:
+
+	/*
+	* Adds a robot and advertises its odometry.
+	*
+	* @param RobotName Name of the robot, replaces {robot} in the topic and frames.
+	* @param Controller Controller of the robot.
+	*/
+	void AddRobot(const FString& RobotName, UMWControllerComponent* Controller);
+
+	/*
+	* Builds and publishes the messages of one cycle. Runs on a background task.
+	*
+	* @param Handler Handler to publish with.
+	* @param Robots Published robots.
+	* @param Samples States of the robots.
+	* @param Stamp Time of the cycle.
+	* @param Seq Number of the cycle.
+	* @param TFTopic Topic of the transforms, empty if not published.
+	* @param PublishOps Strings of the publish operations, kept from cycle to cycle.
+	*/
+	static void PublishSamples(FROSBridgeHandler& Handler, const TArray<FROSMWControllerStateRobot>& Robots,
+		const TArray<FROSMWControllerStateSample>& Samples, const FROSTime& Stamp, const uint32 Seq, const FString& TFTopic, TArray<FString>& PublishOps);
+
+	// Add a smart pointer to ROSBridgeHandler
+	TSharedPtr<FROSBridgeHandler> Handler;
+
+	// Published robots. Not changed after BeginPlay, so the tasks can read them.
+	TSharedPtr<TArray<FROSMWControllerStateRobot>> Robots;
+
+	// Publish operations of the last cycle, only one task uses them at a time.
+	TSharedPtr<TArray<FString>> PublishOps;
+
+	// Task of the last cycle.
+	FGraphEventRef PublishTask;
+
+	// Time until the next cycle.
+	float TimeToPublish = 0.f;
+
+	// Number of the next cycle.
+	uint32 Seq = 0;
+
+	// Cycles skipped because the last task was still running.
+	int32 SkippedCycles = 0;
+};
@@ -0,0 +1,58 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+// Author: Patrick Kellmann
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ROSTime.h"
+#include "MWControllerComponent.h"
+
+/*
+* Robot whose state is published.
+*/
+struct FROSMWControllerStateRobot
+{
+	// Controller of the robot.
+	TWeakObjectPtr<UMWControllerComponent> Controller;
+
+	// Topic of the odometry, empty if not published.
+	FString OdometryTopic;
+
+	// Frame the pose is given in (frame_id).
+	FString OdomFrame;
+
+	// Frame of the base (child_frame_id).
+	FString BaseFrame;
+};
+
+/*
+* State of one robot in one publish cycle.
+*/
+struct FROSMWControllerStateSample
+{
+	// Index of the robot.
+	int32 Robot = 0;
+
+	// State of the robot.
+	FMWControllerStateSnapshot Snapshot;
+};
+
+/*
+* Writes the messages of one publish cycle of AROSMWControllerStatePublisher: one nav_msgs/Odometry per robot
+* and one tf2_msgs/TFMessage with the transforms of all robots. Plain data in and out, so it runs on any thread.
+*/
+struct UROSBASECONTROLLERMW_API FROSMWControllerStateWriter
+{
+	/*
+	* Writes the publish operations of one cycle.
+	*
+	* @param Robots Published robots.
+	* @param Samples States of the robots.
+	* @param Stamp Time of the cycle.
+	* @param Seq Number of the cycle.
+	* @param TFTopic Topic of the transforms, empty if not published.
+	* @param OutPublishOps Receives the serialized publish operations, the memory of the strings is reused.
+	*/
+	static void WritePublishOps(const TArray<FROSMWControllerStateRobot>& Robots, const TArray<FROSMWControllerStateSample>& Samples,
+		const FROSTime& Stamp, const uint32 Seq, const FString& TFTopic, TArray<FString>& OutPublishOps);
+};
@@ -12,6 +12,8 @@
 
 /*
 * Subscriber for MWController.
+* With bSubscribeAllRobots one subscriber serves many robots over one rosbridge connection: every robot gets its own topic
+* from RobotTopicTemplate (e.g. /MWRobotBaseActor_2/base/cmd_vel) and the messages are routed to its controller by topic.
 */
 UCLASS()
 class UROSBASECONTROLLERMW_API AROSMWControllerSubscriber : public AActor
@@ -45,6 +47,39 @@ protected:
 	*/
 	virtual void Tick(float DeltaTime) override;
 
+public:
+
+	/*
+	* Gets the topic of a robot. A topic is subscribed for one robot only, the topics of the other robots are rejected.
+	*
+	* @param TopicTemplate Topic with {robot} for the name of the robot.
+	* @param RobotName Name of the robot, replaces {robot} in the topic.
+	* @param InOutTopics Topics that are subscribed already. Receives the topic of the robot.
+	* @param OutTopic Topic of the robot.
+	* @return false if another robot has the topic already.
+	*/
+	static bool GetRobotTopic(const FString& TopicTemplate, const FString& RobotName, TSet<FString>& InOutTopics, FString& OutTopic);
+
+private:
+
+	/*
+	* Adds the subscriber of the robot named MWRobotBaseActorName.
+	*/
+	void AddRobotSubscriber();
+
+	/*
+	* Adds a subscriber with a templated topic for every robot of RobotNames, or for every robot of the level.
+	*/
+	void AddRobotSubscribers();
+
+	/*
+	* Adds the subscriber of one robot.
+	*
+	* @param RobotName Name of the robot, replaces {robot} in the topic.
+	* @param Controller Controller of the robot.
+	*/
+	void AddRobotSubscriber(const FString& RobotName, UMWControllerComponent* Controller);
+
 public:
 
 	// Address for communication.
@@ -59,6 +94,22 @@ public:
 	UPROPERTY(EditAnywhere, Category = "ROS Subscriber", meta = (ToolTip = "Topic that is used. Default setting is standard for MWController."))
 		FString Topic;
 
+	// Subscribes one topic per robot instead of Topic.
+	UPROPERTY(EditAnywhere, Category = "ROS Subscriber", meta = (ToolTip = "Subscribe one topic per robot over the same connection."))
+		bool bSubscribeAllRobots = false;
+
+	// Receives the messages as binary CBOR instead of json text.
+	UPROPERTY(EditAnywhere, Category = "ROS Subscriber", meta = (ToolTip = "Subscribe with rosbridge compression cbor, the messages come as binary frames."))
+		bool bUseCbor = false;
+
+	// Topic of a robot, {robot} is replaced by the name of the robot.
+	UPROPERTY(EditAnywhere, Category = "ROS Subscriber", meta = (EditCondition = "bSubscribeAllRobots", ToolTip = "Topic of a robot. {robot} is replaced by the name of the robot actor."))
+		FString RobotTopicTemplate = TEXT("/{robot}/base/cmd_vel");
+
+	// Names of the robot actors to subscribe. Empty subscribes every robot of the level.
+	UPROPERTY(EditAnywhere, Category = "ROS Subscriber", meta = (EditCondition = "bSubscribeAllRobots", ToolTip = "Names of the robot actors. Empty subscribes every robot that is in the level at BeginPlay."))
+		TArray<FString> RobotNames;
+
 private:
 	// Add a smart pointer to ROSBridgeHandler
 	TSharedPtr<FROSBridgeHandler> Handler;
@@ -66,6 +117,12 @@ private:
 	// Add a ROSBridgePublisher smart pointer
 	TSharedPtr<UROSMWControllerSubscriberCallback> MWSubscriber;
 
+	// Subscribers of the robots, all on Handler.
+	TArray<TSharedPtr<UROSMWControllerSubscriberCallback>> RobotSubscribers;
+
+	// Topics of RobotSubscribers, a topic is subscribed for one robot only.
+	TSet<FString> RobotTopics;
+
 	// MWController to which the messages should be routed.
 	UMWControllerComponent* MWConComp;
 
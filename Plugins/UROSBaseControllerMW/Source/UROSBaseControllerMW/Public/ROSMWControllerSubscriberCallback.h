@@ -40,6 +40,22 @@ public:
 	*/
 	TSharedPtr<FROSBridgeMsg> ParseMessage(TSharedPtr<FJsonObject> JsonObject) const override;
 
+	/*
+	* Converts messages straight from the received bytes.
+	*
+	* @param MsgView Bytes of the message.
+	* @return parsed geometry_msgs::TwistStamped message, nullptr if the message is incomplete.
+	*/
+	TSharedPtr<FROSBridgeMsg> ParseMessageFromView(const FROSBridgeJsonView& MsgView) const override;
+
+	/*
+	* Converts messages straight from the received CBOR bytes.
+	*
+	* @param MsgView Bytes of the message.
+	* @return parsed geometry_msgs::TwistStamped message, nullptr if the message is incomplete.
+	*/
+	TSharedPtr<FROSBridgeMsg> ParseMessageFromCbor(const FROSBridgeCborView& MsgView) const override;
+
 	/*
 	* Processes the messages and passes on specific data.
 	*
@@ -49,6 +65,6 @@ public:
 
 private:
 
-	// The MWController to which the messages are sent.
-	UMWControllerComponent* MWConComp = nullptr;
+	// The MWController to which the messages are sent, weak because the robot can be destroyed before the handler.
+	TWeakObjectPtr<UMWControllerComponent> MWConComp;
 };
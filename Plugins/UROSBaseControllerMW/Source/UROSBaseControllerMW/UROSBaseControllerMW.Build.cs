@@ -45,6 +45,9 @@ public class UROSBaseControllerMW : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore", 
+				// Stand-in rosbridge of the tests
+				"libWebSockets",
+				"OpenSSL",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -5,6 +5,9 @@
 #pragma  once
 #include "ROSBridgePrivate.h"
 #include "Core.h"
+#include "Templates/Atomic.h"
+#include "ROSWebSocketRing.h"
+#include "ROSWebSocketReceiveBuffer.h"
 #if !PLATFORM_HTML5
 #include "Runtime/Sockets/Private/BSDSockets/SocketSubsystemBSD.h"
 #define USE_LIBWEBSOCKET 1
@@ -39,6 +42,8 @@ public:
 	void SetConnectedCallBack(FROSWebsocketInfoSignature CallBack);
 	void SetErrorCallBack(FROSWebsocketInfoSignature CallBack);
 	void SetRecieveCallBack(FROSWebsocketPacketRecievedSignature CallBack);
+	/** binary frames are passed whole to this callback, if it is not set they are read as size prefixed messages */
+	void SetBinaryRecieveCallBack(FROSWebsocketPacketRecievedSignature CallBack);
 
 	/** Send raw data to remote end point. */
 	bool Send(uint8* Data, uint32 Size);  // Send Binary
@@ -47,6 +52,14 @@ public:
 
 	/** service libwebsocket.			   */
 	void Tick();
+	/** service libwebsocket, waits up to TimeoutInMs for the socket or for Wake */
+	void Service(int32 TimeoutInMs);
+	/** wake a thread that waits in Service, thread safe */
+	void Wake();
+	/** check if data is waiting to be sent, thread safe */
+	bool HasOutgoingData();
+	/** check if a committed frame is waiting to be sent, frames that are still written are not counted */
+	bool HasCommittedData();
 	/** service libwebsocket until outgoing buffer is empty */
 	void Flush();
 
@@ -58,25 +71,49 @@ public:
 // this was made public because of cross-platform build issues
 public:
 
-	void HandlePacket();
-	void OnRawRecieve(void* Data, uint32 Size, bool isBinary = true);
+	void HandlePacket(int32 TimeoutInMs = 0);
+	void OnRawRecieve(void* Data, uint32 Size, bool isBinary = true, bool bIsFinal = true);
 	void OnRawWebSocketWritable(WebSocketInternal* wsi);
 
+	/** reserve a frame in the ring, nullptr if it has to go to the overflow queue */
+	uint8* BeginFrame(uint32 Size, uint8 Type, uint64& OutPosition);
+	/** queue a frame that did not fit into the ring, Buffer has the headroom in front */
+	void AddOverflowFrame(TArray<uint8>&& Buffer, uint8 Type);
+	/** take the oldest frame of the overflow queue */
+	bool PopOverflowFrame(TArray<uint8>& OutBuffer, uint8& OutType);
+#if USE_LIBWEBSOCKET
+	/** write one frame, the payload has LWS_PRE bytes of headroom in front */
+	bool WriteFrame(uint8* Payload, uint32 Size, uint8 Type);
+#endif
+
 	/************************************************************************/
 	/*	Various Socket callbacks											*/
 	/************************************************************************/
 	FROSWebsocketPacketRecievedSignature  OnRecieved;
+	FROSWebsocketPacketRecievedSignature  OnRecievedBinary;
 	FROSWebsocketInfoSignature OnConnection;
 	FROSWebsocketInfoSignature OnError;
 
-	/**  Recv and Send Buffers, serviced during the Tick */
-	TArray<uint8> RecievedBuffer;
+	/**  Recv and Send Buffers, serviced during the Tick. RecievedBuffer only holds incomplete frames and keeps its memory */
+	FROSWebSocketReceiveBuffer RecievedBuffer;
+
+	/** Outgoing frames, written by any thread and sent from the ring without a copy (client side only) */
+	FROSWebSocketRing* OutgoingRing;
+
+	/** Frames that did not fit into the ring, guarded by the critical section */
 	TArray<TArray<uint8>> OutgoingBuffer;
 	TArray<uint8> OutgoingBufferType;
+	TAtomic<int32> NumOverflowFrames;
+
+	/** Number of frames written to the socket, only used by the servicing thread */
+	uint64 NumSentFrames;
 
 	/** Critical Section */
 	FCriticalSection CriticalSection;
 
+	/** Guards the context against Destroy while another thread wakes the servicing thread */
+	FCriticalSection ContextCriticalSection;
+
 #if USE_LIBWEBSOCKET
 	/** libwebsocket internal context*/
 	WebSocketInternalContext* Context;
@@ -101,8 +138,8 @@ public:
 	/** Server side socket or client side*/
 	bool IsServerSide;
 
-	/** Is the client destroyed? */ 
-	bool IsDestroyed; 
+	/** Is the client destroyed? Read by Wake on any thread */ 
+	TAtomic<bool> IsDestroyed; 
 
 	friend class FWebSocketServer;
 };
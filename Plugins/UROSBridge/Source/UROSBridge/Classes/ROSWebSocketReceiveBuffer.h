@@ -0,0 +1,29 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+/**
+* Puts received websocket data together, so the callbacks of the socket always get whole frames or messages.
+* Data that is complete when it arrives is handed over in place, only incomplete data is copied and the memory is kept.
+*/
+class FROSWebSocketReceiveBuffer
+{
+public:
+	// Add a piece of a frame, OnFrame gets the whole frame after the final piece
+	void ReceiveFrame(const uint8* Data, uint32 Size, bool bIsFinal, TFunctionRef<void(void*, uint32)> OnFrame);
+
+	// Add a piece of a stream of messages with their size in front, OnMessage gets every complete message
+	void ReceiveSizePrefixed(const uint8* Data, uint32 Size, TFunctionRef<void(void*, uint32)> OnMessage);
+
+	// Number of bytes kept of an incomplete frame or message
+	int32 Num() const
+	{
+		return Buffer.Num();
+	}
+
+private:
+	TArray<uint8> Buffer;
+};
@@ -0,0 +1,69 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Atomic.h"
+
+/**
+* Ring of the outgoing websocket frames, allocated once.
+* Any thread can write frames (the space is reserved with a compare exchange), only the websocket thread reads them.
+* Every frame has the headroom libwebsockets needs in front of the payload (LWS_PRE), so it is sent from the ring without a copy.
+* The bytes of sent frames are zeroed, so a frame that is reserved but not committed yet is never read.
+*/
+class FROSWebSocketRing
+{
+public:
+	// Allocate the ring, the capacity is rounded up to a power of two
+	FROSWebSocketRing(uint32 InCapacity, uint32 InHeadroom);
+
+	// Free the ring
+	~FROSWebSocketRing();
+
+	// Reserve a frame, returns its payload or nullptr if the ring is full. The frame must be committed with EndWrite
+	uint8* BeginWrite(uint32 Size, uint32 Type, uint64& OutPosition);
+
+	// Commit a reserved frame, it can be sent from now on
+	void EndWrite(uint64 Position);
+
+	// Get the payload of the oldest frame, nullptr if there is none or it is not committed yet
+	uint8* Peek(uint32& OutSize, uint32& OutType);
+
+	// Release the frame returned by Peek
+	void Pop();
+
+	// Check if no frame is reserved or committed
+	bool IsEmpty() const;
+
+	// Check if the oldest frame is committed, so Peek returns it. Only called by the websocket thread
+	bool HasCommittedFrame() const;
+
+private:
+	// Header in front of the headroom of every frame
+	struct FFrameHeader
+	{
+		// 0 reserved, 1 committed frame, 2 padding to the end of the ring
+		volatile int32 State;
+		uint32 Size;
+		uint32 Type;
+		uint32 Total;
+	};
+
+	// Header of the frame at the position
+	FFrameHeader* GetHeader(uint64 Position) const
+	{
+		return (FFrameHeader*)(Data + (Position & Mask));
+	}
+
+	// Zero the frame and give its space back to the writers
+	void Release(uint64 Position, uint32 Total);
+
+	uint8* Data;
+	uint32 Capacity;
+	uint32 Mask;
+	uint32 Headroom;
+
+	// Positions only grow, the offset in the ring is Position & Mask
+	TAtomic<uint64> WritePosition;
+	TAtomic<uint64> ReadPosition;
+};
@@ -0,0 +1,142 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#include "ROSBridgeBase64.h"
+
+static const ANSICHAR Base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Marks a character that is not Base64, above the 24 bits of a group
+#define ROS_BRIDGE_BASE64_INVALID (1u << 24)
+
+// Bits of every character at each of the 4 positions of a group, already shifted into place
+struct FROSBridgeBase64DecodeTable
+{
+	uint32 Bits[4][256];
+
+	FROSBridgeBase64DecodeTable()
+	{
+		for (int32 Position = 0; Position < 4; ++Position)
+		{
+			for (int32 i = 0; i < 256; ++i)
+			{
+				Bits[Position][i] = ROS_BRIDGE_BASE64_INVALID;
+			}
+			for (int32 i = 0; i < 64; ++i)
+			{
+				Bits[Position][(uint8)Base64Alphabet[i]] = (uint32)i << (18 - 6 * Position);
+			}
+		}
+	}
+};
+
+static const FROSBridgeBase64DecodeTable Base64DecodeTable;
+
+// Bits of a character at a position of the group
+template<typename CharType>
+static FORCEINLINE uint32 GetBase64Bits(int32 Position, CharType Char)
+{
+	// Wider characters are never Base64
+	return (uint32)Char < 256 ? Base64DecodeTable.Bits[Position][(uint32)Char] : ROS_BRIDGE_BASE64_INVALID;
+}
+
+// Decode, the same for the text of FStrings and of received frames
+template<typename CharType>
+static bool DecodeBase64(const CharType* Source, int32 Length, TArray<uint8>& Out)
+{
+	// The padding only fills the last group
+	while (Length > 0 && Source[Length - 1] == '=')
+	{
+		--Length;
+	}
+	const int32 Remainder = Length % 4;
+	if (Remainder == 1)
+	{
+		Out.Reset();
+		return false;
+	}
+
+	const int32 NumGroups = Length / 4;
+	const int32 DecodedLength = NumGroups * 3 + (Remainder > 0 ? Remainder - 1 : 0);
+
+	// Keeps the memory of Out if it is large enough
+	Out.SetNumUninitialized(DecodedLength, false);
+	uint8* Dest = Out.GetData();
+
+	// Invalid characters are collected and checked once at the end, the loop has no branch
+	uint32 Invalid = 0;
+	for (int32 Group = 0; Group < NumGroups; ++Group, Source += 4, Dest += 3)
+	{
+		const uint32 Bits = GetBase64Bits(0, Source[0]) | GetBase64Bits(1, Source[1]) | GetBase64Bits(2, Source[2]) | GetBase64Bits(3, Source[3]);
+		Invalid |= Bits;
+		Dest[0] = (uint8)(Bits >> 16);
+		Dest[1] = (uint8)(Bits >> 8);
+		Dest[2] = (uint8)Bits;
+	}
+
+	if (Remainder > 0)
+	{
+		const uint32 Bits = GetBase64Bits(0, Source[0]) | GetBase64Bits(1, Source[1]) | (Remainder == 3 ? GetBase64Bits(2, Source[2]) : 0);
+		Invalid |= Bits;
+		Dest[0] = (uint8)(Bits >> 16);
+		if (Remainder == 3)
+		{
+			Dest[1] = (uint8)(Bits >> 8);
+		}
+	}
+
+	if (Invalid & ROS_BRIDGE_BASE64_INVALID)
+	{
+		Out.Reset();
+		return false;
+	}
+	return true;
+}
+
+// Encode
+void FROSBridgeBase64::Encode(const uint8* Data, int32 Length, FString& Out)
+{
+	if (Length <= 0)
+	{
+		return;
+	}
+
+	// Written straight into the characters of Out, after what is already there
+	const int32 Start = Out.Len();
+	const int32 EncodedLength = GetEncodedLength(Length);
+	TArray<TCHAR>& Chars = Out.GetCharArray();
+	Chars.SetNumUninitialized(Start + EncodedLength + 1, false);
+	TCHAR* Dest = Chars.GetData() + Start;
+
+	const int32 NumGroups = Length / 3;
+	for (int32 Group = 0; Group < NumGroups; ++Group, Data += 3, Dest += 4)
+	{
+		const uint32 Bits = (Data[0] << 16) | (Data[1] << 8) | Data[2];
+		Dest[0] = Base64Alphabet[(Bits >> 18) & 0x3f];
+		Dest[1] = Base64Alphabet[(Bits >> 12) & 0x3f];
+		Dest[2] = Base64Alphabet[(Bits >> 6) & 0x3f];
+		Dest[3] = Base64Alphabet[Bits & 0x3f];
+	}
+
+	const int32 Remainder = Length - NumGroups * 3;
+	if (Remainder > 0)
+	{
+		const uint32 Bits = (Data[0] << 16) | (Remainder == 2 ? Data[1] << 8 : 0);
+		Dest[0] = Base64Alphabet[(Bits >> 18) & 0x3f];
+		Dest[1] = Base64Alphabet[(Bits >> 12) & 0x3f];
+		Dest[2] = Remainder == 2 ? Base64Alphabet[(Bits >> 6) & 0x3f] : TEXT('=');
+		Dest[3] = TEXT('=');
+	}
+
+	Chars[Start + EncodedLength] = 0;
+}
+
+// Decode TCHARs
+bool FROSBridgeBase64::Decode(const TCHAR* Source, int32 Length, TArray<uint8>& Out)
+{
+	return DecodeBase64(Source, Length, Out);
+}
+
+// Decode bytes
+bool FROSBridgeBase64::Decode(const ANSICHAR* Source, int32 Length, TArray<uint8>& Out)
+{
+	return DecodeBase64((const uint8*)Source, Length, Out);
+}
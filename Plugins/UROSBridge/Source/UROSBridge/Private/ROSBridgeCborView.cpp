@@ -0,0 +1,483 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#include "ROSBridgeCborView.h"
+#include "ROSBridgeBase64.h"
+#include <cmath>
+
+// Nesting limit, a broken frame must not overflow the stack
+#define ROS_BRIDGE_CBOR_MAX_DEPTH (64)
+
+// CBOR major types
+#define ROS_BRIDGE_CBOR_UNSIGNED (0)
+#define ROS_BRIDGE_CBOR_NEGATIVE (1)
+#define ROS_BRIDGE_CBOR_BYTES (2)
+#define ROS_BRIDGE_CBOR_TEXT (3)
+#define ROS_BRIDGE_CBOR_ARRAY (4)
+#define ROS_BRIDGE_CBOR_MAP (5)
+#define ROS_BRIDGE_CBOR_TAG (6)
+#define ROS_BRIDGE_CBOR_SIMPLE (7)
+
+// Tags of the typed arrays (RFC 8746)
+#define ROS_BRIDGE_CBOR_TYPED_ARRAY_FIRST (64)
+#define ROS_BRIDGE_CBOR_TYPED_ARRAY_LAST (87)
+
+// Half precision float to double
+static double HalfToDouble(uint16 Half)
+{
+	const int32 Exponent = (Half >> 10) & 0x1f;
+	const int32 Mantissa = Half & 0x3ff;
+	double Value;
+	if (Exponent == 0)
+	{
+		Value = ldexp((double)Mantissa, -24);
+	}
+	else if (Exponent != 31)
+	{
+		Value = ldexp((double)(Mantissa + 1024), Exponent - 25);
+	}
+	else
+	{
+		Value = Mantissa == 0 ? INFINITY : NAN;
+	}
+	return (Half & 0x8000) ? -Value : Value;
+}
+
+// Float of the given size from its bits
+static double BitsToDouble(uint64 Bits, int32 Size)
+{
+	if (Size == 2)
+	{
+		return HalfToDouble((uint16)Bits);
+	}
+	if (Size == 4)
+	{
+		const uint32 FloatBits = (uint32)Bits;
+		float Value;
+		FMemory::Memcpy(&Value, &FloatBits, sizeof(float));
+		return Value;
+	}
+	double Value;
+	FMemory::Memcpy(&Value, &Bits, sizeof(double));
+	return Value;
+}
+
+// Read the head of an item
+const uint8* FROSBridgeCborView::ReadHead(const uint8* Pos, uint8& OutMajor, uint8& OutInfo, uint64& OutArgument) const
+{
+	if (!Pos || Pos >= End)
+	{
+		return nullptr;
+	}
+
+	OutMajor = *Pos >> 5;
+	OutInfo = *Pos & 0x1f;
+	++Pos;
+
+	if (OutInfo < 24)
+	{
+		OutArgument = OutInfo;
+		return Pos;
+	}
+	if (OutInfo > 27)
+	{
+		// Indefinite length or reserved
+		return nullptr;
+	}
+
+	// Big endian argument of 1, 2, 4 or 8 bytes
+	const int32 Size = 1 << (OutInfo - 24);
+	if (End - Pos < Size)
+	{
+		return nullptr;
+	}
+	OutArgument = 0;
+	for (int32 i = 0; i < Size; ++i)
+	{
+		OutArgument = (OutArgument << 8) | Pos[i];
+	}
+	return Pos + Size;
+}
+
+// Skip an item
+const uint8* FROSBridgeCborView::SkipItem(const uint8* Pos, int32 Depth) const
+{
+	if (Depth > ROS_BRIDGE_CBOR_MAX_DEPTH)
+	{
+		return nullptr;
+	}
+
+	uint8 Major;
+	uint8 Info;
+	uint64 Argument;
+	Pos = ReadHead(Pos, Major, Info, Argument);
+	if (!Pos)
+	{
+		return nullptr;
+	}
+
+	switch (Major)
+	{
+	case ROS_BRIDGE_CBOR_BYTES:
+	case ROS_BRIDGE_CBOR_TEXT:
+		return Argument <= (uint64)(End - Pos) ? Pos + Argument : nullptr;
+
+	case ROS_BRIDGE_CBOR_ARRAY:
+	case ROS_BRIDGE_CBOR_MAP:
+	{
+		// Every item has at least one byte, larger counts are broken
+		if (Argument > (uint64)(End - Pos))
+		{
+			return nullptr;
+		}
+		const uint64 Count = Major == ROS_BRIDGE_CBOR_MAP ? Argument * 2 : Argument;
+		for (uint64 i = 0; i < Count && Pos; ++i)
+		{
+			Pos = SkipItem(Pos, Depth + 1);
+		}
+		return Pos;
+	}
+
+	case ROS_BRIDGE_CBOR_TAG:
+		return SkipItem(Pos, Depth + 1);
+
+	default:
+		return Pos;
+	}
+}
+
+// Find a field of the map
+FROSBridgeCborView FROSBridgeCborView::GetField(const ANSICHAR* Key) const
+{
+	uint8 Major;
+	uint8 Info;
+	uint64 Count;
+	const uint8* Pos = IsValid() ? ReadHead(Begin, Major, Info, Count) : nullptr;
+	if (!Pos || Major != ROS_BRIDGE_CBOR_MAP)
+	{
+		return FROSBridgeCborView();
+	}
+
+	const int32 KeyLength = FCStringAnsi::Strlen(Key);
+	for (uint64 i = 0; i < Count; ++i)
+	{
+		// Key, rosbridge only uses text keys
+		const FROSBridgeJsonView KeyView = FROSBridgeCborView(Pos, End).GetString();
+		Pos = SkipItem(Pos);
+		if (!Pos)
+		{
+			break;
+		}
+
+		// Value
+		const uint8* ValueEnd = SkipItem(Pos);
+		if (!ValueEnd)
+		{
+			break;
+		}
+		if (KeyView.Equals(Key, KeyLength))
+		{
+			return FROSBridgeCborView(Pos, ValueEnd);
+		}
+		Pos = ValueEnd;
+	}
+	return FROSBridgeCborView();
+}
+
+// Get the elements of the array
+bool FROSBridgeCborView::GetElements(TArray<FROSBridgeCborView>& OutElements) const
+{
+	uint8 Major;
+	uint8 Info;
+	uint64 Count;
+	const uint8* Pos = IsValid() ? ReadHead(Begin, Major, Info, Count) : nullptr;
+	if (!Pos || Major != ROS_BRIDGE_CBOR_ARRAY || Count > (uint64)(End - Pos))
+	{
+		return false;
+	}
+
+	OutElements.Reset((int32)Count);
+	for (uint64 i = 0; i < Count; ++i)
+	{
+		const uint8* ElementEnd = SkipItem(Pos);
+		if (!ElementEnd)
+		{
+			return false;
+		}
+		OutElements.Add(FROSBridgeCborView(Pos, ElementEnd));
+		Pos = ElementEnd;
+	}
+	return true;
+}
+
+// Get the content of a text string
+FROSBridgeJsonView FROSBridgeCborView::GetString() const
+{
+	uint8 Major;
+	uint8 Info;
+	uint64 Length;
+	const uint8* Pos = IsValid() ? ReadHead(Begin, Major, Info, Length) : nullptr;
+	if (!Pos || Major != ROS_BRIDGE_CBOR_TEXT || Length > (uint64)(End - Pos))
+	{
+		return FROSBridgeJsonView();
+	}
+
+	// An empty string is an invalid view, same as an empty json string
+	return FROSBridgeJsonView((const ANSICHAR*)Pos, (const ANSICHAR*)(Pos + Length));
+}
+
+// Get a number
+double FROSBridgeCborView::AsNumber(double Default) const
+{
+	uint8 Major;
+	uint8 Info;
+	uint64 Argument;
+	if (!IsValid() || !ReadHead(Begin, Major, Info, Argument))
+	{
+		return Default;
+	}
+
+	switch (Major)
+	{
+	case ROS_BRIDGE_CBOR_UNSIGNED:
+		return (double)Argument;
+	case ROS_BRIDGE_CBOR_NEGATIVE:
+		return -1.0 - (double)Argument;
+	case ROS_BRIDGE_CBOR_SIMPLE:
+		if (Info >= 25 && Info <= 27)
+		{
+			return BitsToDouble(Argument, 1 << (Info - 24));
+		}
+		return Default;
+	default:
+		return Default;
+	}
+}
+
+// Get a bool
+bool FROSBridgeCborView::AsBool(bool Default) const
+{
+	if (!IsValid())
+	{
+		return Default;
+	}
+
+	// Simple values false (20) and true (21)
+	if (*Begin == 0xf4)
+	{
+		return false;
+	}
+	if (*Begin == 0xf5)
+	{
+		return true;
+	}
+	return Default;
+}
+
+// Get the content of a byte string or typed array
+bool FROSBridgeCborView::GetBytes(const uint8*& OutData, int32& OutLength) const
+{
+	uint8 Major;
+	uint8 Info;
+	uint64 Argument;
+	const uint8* Pos = IsValid() ? ReadHead(Begin, Major, Info, Argument) : nullptr;
+	if (Pos && Major == ROS_BRIDGE_CBOR_TAG)
+	{
+		if (Argument < ROS_BRIDGE_CBOR_TYPED_ARRAY_FIRST || Argument > ROS_BRIDGE_CBOR_TYPED_ARRAY_LAST)
+		{
+			return false;
+		}
+		Pos = ReadHead(Pos, Major, Info, Argument);
+	}
+	if (!Pos || Major != ROS_BRIDGE_CBOR_BYTES || Argument > (uint64)(End - Pos) || Argument > (uint64)MAX_int32)
+	{
+		return false;
+	}
+
+	OutData = Pos;
+	OutLength = (int32)Argument;
+	return true;
+}
+
+// Copy the content of a byte string or typed array
+bool FROSBridgeCborView::GetBytes(TArray<uint8>& OutBytes) const
+{
+	const uint8* Data;
+	int32 Length;
+	if (!GetBytes(Data, Length))
+	{
+		return false;
+	}
+
+	// Keeps the memory of OutBytes if it is large enough
+	OutBytes.SetNumUninitialized(Length, false);
+	FMemory::Memcpy(OutBytes.GetData(), Data, Length);
+	return true;
+}
+
+// Describe the item
+FString FROSBridgeCborView::ToString() const
+{
+	const uint8* ItemEnd = IsValid() ? SkipItem(Begin) : nullptr;
+	if (!ItemEnd)
+	{
+		return TEXT("Invalid CBOR");
+	}
+	return FString::Printf(TEXT("CBOR item of %d bytes"), (int32)(ItemEnd - Begin));
+}
+
+// Convert to a json value
+TSharedPtr<FJsonValue> FROSBridgeCborView::ToJsonValue() const
+{
+	uint8 Major;
+	uint8 Info;
+	uint64 Argument;
+	const uint8* Pos = IsValid() ? ReadHead(Begin, Major, Info, Argument) : nullptr;
+	if (!Pos)
+	{
+		return nullptr;
+	}
+
+	switch (Major)
+	{
+	case ROS_BRIDGE_CBOR_UNSIGNED:
+	case ROS_BRIDGE_CBOR_NEGATIVE:
+		return MakeShareable(new FJsonValueNumber(AsNumber()));
+
+	case ROS_BRIDGE_CBOR_BYTES:
+	{
+		const uint8* Data;
+		int32 Length;
+		if (!GetBytes(Data, Length))
+		{
+			return nullptr;
+		}
+		FString Encoded;
+		FROSBridgeBase64::Encode(Data, Length, Encoded);
+		return MakeShareable(new FJsonValueString(Encoded));
+	}
+
+	case ROS_BRIDGE_CBOR_TEXT:
+		return MakeShareable(new FJsonValueString(GetString().ToString()));
+
+	case ROS_BRIDGE_CBOR_ARRAY:
+	{
+		TArray<FROSBridgeCborView> Elements;
+		if (!GetElements(Elements))
+		{
+			return nullptr;
+		}
+		TArray<TSharedPtr<FJsonValue>> Values;
+		Values.Reserve(Elements.Num());
+		for (const FROSBridgeCborView& Element : Elements)
+		{
+			TSharedPtr<FJsonValue> Value = Element.ToJsonValue();
+			if (!Value.IsValid())
+			{
+				return nullptr;
+			}
+			Values.Add(Value);
+		}
+		return MakeShareable(new FJsonValueArray(Values));
+	}
+
+	case ROS_BRIDGE_CBOR_MAP:
+	{
+		TSharedPtr<FJsonObject> Object = MakeShareable(new FJsonObject());
+		for (uint64 i = 0; i < Argument; ++i)
+		{
+			const FROSBridgeJsonView Key = FROSBridgeCborView(Pos, End).GetString();
+			Pos = SkipItem(Pos);
+			const uint8* ValueEnd = Pos ? SkipItem(Pos) : nullptr;
+			if (!ValueEnd)
+			{
+				return nullptr;
+			}
+			TSharedPtr<FJsonValue> Value = FROSBridgeCborView(Pos, ValueEnd).ToJsonValue();
+			if (!Value.IsValid())
+			{
+				return nullptr;
+			}
+			Object->SetField(Key.ToString(), Value);
+			Pos = ValueEnd;
+		}
+		return MakeShareable(new FJsonValueObject(Object));
+	}
+
+	case ROS_BRIDGE_CBOR_TAG:
+	{
+		if (Argument < ROS_BRIDGE_CBOR_TYPED_ARRAY_FIRST || Argument > ROS_BRIDGE_CBOR_TYPED_ARRAY_LAST)
+		{
+			// Other tags only describe their item
+			return FROSBridgeCborView(Pos, End).ToJsonValue();
+		}
+
+		const uint8* Data;
+		int32 Length;
+		if (!GetBytes(Data, Length))
+		{
+			return nullptr;
+		}
+
+		// Tag bits: 010 f s e ll, float, signed, little endian, log2 of the size
+		const bool bIsFloat = (Argument & 0x10) != 0;
+		const bool bIsSigned = (Argument & 0x08) != 0;
+		const bool bIsLittleEndian = (Argument & 0x04) != 0;
+		const int32 Size = bIsFloat ? 2 << (Argument & 0x03) : 1 << (Argument & 0x03);
+		if (Size > 8)
+		{
+			return nullptr;
+		}
+
+		TArray<TSharedPtr<FJsonValue>> Values;
+		Values.Reserve(Length / Size);
+		for (int32 Offset = 0; Offset + Size <= Length; Offset += Size)
+		{
+			uint64 Bits = 0;
+			for (int32 i = 0; i < Size; ++i)
+			{
+				const int32 Shift = bIsLittleEndian ? i : Size - 1 - i;
+				Bits |= (uint64)Data[Offset + i] << (8 * Shift);
+			}
+
+			double Value;
+			if (bIsFloat)
+			{
+				Value = BitsToDouble(Bits, Size);
+			}
+			else if (bIsSigned)
+			{
+				const int32 Unused = 64 - 8 * Size;
+				Value = (double)((int64)(Bits << Unused) >> Unused);
+			}
+			else
+			{
+				Value = (double)Bits;
+			}
+			Values.Add(MakeShareable(new FJsonValueNumber(Value)));
+		}
+		return MakeShareable(new FJsonValueArray(Values));
+	}
+
+	default:
+		if (Info == 20 || Info == 21)
+		{
+			return MakeShareable(new FJsonValueBoolean(Info == 21));
+		}
+		if (Info >= 25 && Info <= 27)
+		{
+			return MakeShareable(new FJsonValueNumber(AsNumber()));
+		}
+		return MakeShareable(new FJsonValueNull());
+	}
+}
+
+// Convert to a json object
+TSharedPtr<FJsonObject> FROSBridgeCborView::ToJsonObject() const
+{
+	TSharedPtr<FJsonValue> Value = ToJsonValue();
+	if (!Value.IsValid() || Value->Type != EJson::Object)
+	{
+		return nullptr;
+	}
+	return Value->AsObject();
+}
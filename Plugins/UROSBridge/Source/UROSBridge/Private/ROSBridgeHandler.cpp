@@ -23,6 +23,11 @@ bool FROSBridgeHandlerRunnable::Init()
 	ReceivedCallback.BindRaw(this->Handler, &FROSBridgeHandler::OnMessage);
 	Handler->WSClient->SetRecieveCallBack(ReceivedCallback);
 
+	// Binary frames are the messages of subscriptions with compression "cbor"
+	FROSWebsocketPacketRecievedSignature BinaryReceivedCallback;
+	BinaryReceivedCallback.BindRaw(this->Handler, &FROSBridgeHandler::OnBinaryMessage);
+	Handler->WSClient->SetBinaryRecieveCallBack(BinaryReceivedCallback);
+
 	// Bind Connected callback
 	Handler->ConnectedCallback.AddRaw(Handler, &FROSBridgeHandler::OnConnection);
 	Handler->WSClient->SetConnectedCallBack(Handler->ConnectedCallback);
@@ -40,22 +45,27 @@ uint32 FROSBridgeHandlerRunnable::Run()
 	//Initial wait before starting
 	FPlatformProcess::Sleep(0.01);
 
-	// Counter for re-trying an initially unsuccessful connection
-	uint32 ConnectionTrialCounter = 0;
+	// Time limit for an initially unsuccessful connection
+	const double ConnectionDeadline = FPlatformTime::Seconds() + Handler->ConnectionTimeout;
 
 	// Main loop for the thread
 	while (StopCounter.GetValue() == 0)
 	{
 		if (Handler->WSClient.IsValid() && !Handler->WSClient->IsDestroyed)
 		{
-			Handler->WSClient->Tick();
+			// Blocks until the socket is ready, something is sent (FROSWebSocket::Wake) or the timeout
+			Handler->WSClient->Service(Handler->ServiceTimeoutInMs);
+		}
+		else
+		{
+			FPlatformProcess::Sleep(Handler->ServiceTimeoutInMs * 0.001f);
 		}
 
 		if (!Handler->IsConnected())
 		{
 			// We aren't yet connected
 
-			if (++ConnectionTrialCounter > 100)
+			if (FPlatformTime::Seconds() > ConnectionDeadline)
 			{
 				Stop();
 				UE_LOG(LogROS, Warning, TEXT(">> %s::%d Could not connect to the rosbridge server (IP %s, port %d)!"),
@@ -75,10 +85,11 @@ uint32 FROSBridgeHandlerRunnable::Run()
 				auto Subscriber = Handler->ListPendingSubscribers.Pop();
 				UE_LOG(LogROS, Log, TEXT(">> %s::%d Subscribing Topic %s"),
 					TEXT(__FUNCTION__), __LINE__, *Subscriber->GetTopic());
-				FString WebSocketMessage = FROSBridgeMsg::Subscribe(Subscriber->GetTopic(), Subscriber->GetType());
+				FString WebSocketMessage = FROSBridgeMsg::Subscribe(Subscriber->GetTopic(), Subscriber->GetType(), Subscriber->GetCompression());
 				Handler->WSClient->Send(WebSocketMessage);
 
 				Handler->ListSubscribers.Push(Subscriber);
+				Handler->AddTopicSubscriber(Subscriber);
 			}
 
 			// Advertise all pending topics
@@ -106,9 +117,6 @@ uint32 FROSBridgeHandlerRunnable::Run()
 			}
 		}
 
-		// Sleep the main loop
-		FPlatformProcess::Sleep(Handler->ThreadSleep);
-		
 		// Process queued messages by calling their callback functions
 		// TODO enable after testing, make private
 		//Handler->Process();
@@ -120,6 +128,7 @@ uint32 FROSBridgeHandlerRunnable::Run()
 void FROSBridgeHandlerRunnable::Stop()
 {
 	StopCounter.Increment();
+	Handler->WakeThread();
 }
 
 // Exits the runnable object
@@ -131,7 +140,8 @@ void FROSBridgeHandlerRunnable::Exit()
 FROSBridgeHandler::FROSBridgeHandler(const FString& InHost, int32 InPort) :
 	Host(InHost),
 	Port(InPort),
-	ThreadSleep(0.007),
+	ServiceTimeoutInMs(100),
+	ConnectionTimeout(1.0),
 	bIsConnected(false)
 {
 }
@@ -142,7 +152,8 @@ FROSBridgeHandler::FROSBridgeHandler(const FString& InHost, int32 InPort, FROSWe
 	Port(InPort),
 	ErrorCallback(InErrorCallback),
 	ConnectedCallback(InConnectedCallback),
-	ThreadSleep(0.007),
+	ServiceTimeoutInMs(100),
+	ConnectionTimeout(1.0),
 	bIsConnected(false)
 {
 }
@@ -215,24 +226,40 @@ void FROSBridgeHandler::Disconnect()
 
 	// Stop runnable / thread / client
 	ThreadCleanup();
+
+	// The topics are unsubscribed and the thread that routed them is stopped
+	ListSubscribers.Empty();
+	SubscribersByTopicHash.Empty();
 }
 
 // Add a new subscriber
 void FROSBridgeHandler::AddSubscriber(TSharedPtr<FROSBridgeSubscriber> InSubscriber)
 {
 	ListPendingSubscribers.Add(InSubscriber);
+	WakeThread();
 }
 
 // Add a new publisher
 void FROSBridgeHandler::AddPublisher(TSharedPtr<FROSBridgePublisher> InPublisher)
 {
 	ListPendingPublishers.Add(InPublisher);
+	WakeThread();
 }
 
 // Add a new service server
 void FROSBridgeHandler::AddServiceServer(TSharedPtr<FROSBridgeSrvServer> InServer)
 {
 	ListPendingServiceServers.Add(InServer);
+	WakeThread();
+}
+
+// Wake the communication thread, so it does not wait for the timeout
+void FROSBridgeHandler::WakeThread()
+{
+	if (WSClient.IsValid() && !WSClient->IsDestroyed)
+	{
+		WSClient->Wake();
+	}
 }
 
 // Call the received message callbacks
@@ -272,6 +299,15 @@ void FROSBridgeHandler::PublishMsg(const FString& InTopic, TSharedPtr<FROSBridge
 	WSClient->Send(MsgToSend);
 }
 
+// Publish an already serialized message
+void FROSBridgeHandler::PublishSerializedMsg(const FString& InPublishOp)
+{
+	if (!WSClient.IsValid()) return;
+	if (!bIsConnected) return;
+
+	WSClient->Send(InPublishOp);
+}
+
 // Call external ROS service
 void FROSBridgeHandler::CallService(TSharedPtr<FROSBridgeSrvClient> InSrvClient,
 	TSharedPtr<FROSBridgeSrv::SrvRequest> InRequest,
@@ -307,66 +343,118 @@ void FROSBridgeHandler::OnError()
 // Callback function when message comes from WebSocket
 void FROSBridgeHandler::OnMessage(void* InData, int32 InLength)
 {
-	char * CharMessage = new char[InLength + 1];
-	memcpy(CharMessage, InData, InLength);
-	CharMessage[InLength] = 0;
-	const FString JsonMessage = UTF8_TO_TCHAR(CharMessage);
-	delete[] CharMessage;
+	// The frame is only read in place, no copy, no FString and no FJsonObject of the whole frame
+	const ANSICHAR* Data = (const ANSICHAR*)InData;
+	const FROSBridgeJsonView Message(Data, Data + InLength);
 
 #if LOG_ROS_MSGS
-	UE_LOG(LogROS, Log, TEXT(">> %s::%d Json Message: %s"), TEXT(__FUNCTION__), __LINE__, *JsonMessage);
+	UE_LOG(LogROS, Log, TEXT(">> %s::%d Json Message: %s"), TEXT(__FUNCTION__), __LINE__, *Message.ToString());
 #endif // LOG_ROS_MSGS
 
-	// Parse Json Message Here
-	TSharedRef< TJsonReader<> > Reader = TJsonReaderFactory<>::Create(JsonMessage);
-	TSharedPtr< FJsonObject > JsonObject;
-	bool DeserializeState = FJsonSerializer::Deserialize(Reader, JsonObject);
-	if (!DeserializeState)
+	const FROSBridgeJsonView Op = Message.GetField("op").GetString();
+	if (!Op.IsValid())
 	{
 		UE_LOG(LogROS, Error, TEXT(">> %s::%d Deserialization Error. Message Contents: %s"),
-			TEXT(__FUNCTION__), __LINE__, *JsonMessage);
+			TEXT(__FUNCTION__), __LINE__, *Message.ToString());
 		return;
 	}
 
-	const FString Op = JsonObject->GetStringField(TEXT("op"));
-
-	if (Op == TEXT("publish")) // Message
+	if (!Op.Equals("publish")) // Service
 	{
-		const FString Topic = JsonObject->GetStringField(TEXT("topic"));
-		// UE_LOG(LogROS, Log, TEXT(">> %s::%d Received message at Topic [%s]."),
-		// 	TEXT(__FUNCTION__), __LINE__, *Topic);
+		OnServiceMessage(Message);
+		return;
+	}
 
-		TSharedPtr< FJsonObject > MsgObject = JsonObject->GetObjectField(TEXT("msg"));
+	const FROSBridgeJsonView Topic = Message.GetField("topic").GetString();
+	// UE_LOG(LogROS, Log, TEXT(">> %s::%d Received message at Topic [%s]."),
+	// 	TEXT(__FUNCTION__), __LINE__, *Topic.ToString());
 
-		// Find corresponding subscriber
-		bool IsTopicFound = false;
-		TSharedPtr<FROSBridgeSubscriber> Subscriber;
-		for (int i = 0; i < ListSubscribers.Num(); i++)
-		{
-			if (ListSubscribers[i]->GetTopic() == Topic)
-			{
-#if UE_BUILD_DEBUG
-				UE_LOG(LogROS, Log, TEXT(">> %s::%d Subscriber Found. Id = %d. "), TEXT(__FUNCTION__), __LINE__, i);
-#endif
-				Subscriber = ListSubscribers[i];
-				IsTopicFound = true; break;
-			}
-		}
+	// Find corresponding subscriber
+	TSharedPtr<FROSBridgeSubscriber> Subscriber = FindTopicSubscriber(Topic);
+	if (!Subscriber.IsValid())
+	{
+		UE_LOG(LogROS, Error, TEXT(">> %s::%d Error: Topic [%s] subscriber not Found. "),
+			TEXT(__FUNCTION__), __LINE__, *Topic.ToString());
+		return;
+	}
 
-		if (!IsTopicFound)
+	// Typed parsing from the bytes if the subscriber supports it, otherwise only the msg is parsed to a FJsonObject
+	const FROSBridgeJsonView MsgView = Message.GetField("msg");
+	TSharedPtr<FROSBridgeMsg> ROSBridgeMsg = Subscriber->ParseMessageFromView(MsgView);
+	if (!ROSBridgeMsg.IsValid())
+	{
+		TSharedPtr<FJsonObject> MsgObject = MsgView.ToJsonObject();
+		if (!MsgObject.IsValid())
 		{
-			UE_LOG(LogROS, Error, TEXT(">> %s::%d Error: Topic [%s] subscriber not Found. "),
-				TEXT(__FUNCTION__), __LINE__, *Topic);
+			UE_LOG(LogROS, Error, TEXT(">> %s::%d Deserialization Error. Message Contents: %s"),
+				TEXT(__FUNCTION__), __LINE__, *Message.ToString());
+			return;
 		}
-		else
+		ROSBridgeMsg = Subscriber->ParseMessage(MsgObject);
+	}
+
+	TSharedPtr<FProcessTask> ProcessTask = MakeShareable<FProcessTask>(new FProcessTask(Subscriber, Subscriber->GetTopic(), ROSBridgeMsg));
+	QueueTask.Enqueue(ProcessTask);
+}
+
+// Callback function when a binary message comes from WebSocket
+void FROSBridgeHandler::OnBinaryMessage(void* InData, int32 InLength)
+{
+	// rosbridge only sends the publish operations of CBOR subscriptions as binary frames
+	const uint8* Data = (const uint8*)InData;
+	const FROSBridgeCborView Message(Data, Data + InLength);
+
+	const FROSBridgeJsonView Op = Message.GetField("op").GetString();
+	if (!Op.Equals("publish"))
+	{
+		UE_LOG(LogROS, Error, TEXT(">> %s::%d Deserialization Error. Message Contents: %s"),
+			TEXT(__FUNCTION__), __LINE__, *Message.ToString());
+		return;
+	}
+
+	const FROSBridgeJsonView Topic = Message.GetField("topic").GetString();
+	TSharedPtr<FROSBridgeSubscriber> Subscriber = FindTopicSubscriber(Topic);
+	if (!Subscriber.IsValid())
+	{
+		UE_LOG(LogROS, Error, TEXT(">> %s::%d Error: Topic [%s] subscriber not Found. "),
+			TEXT(__FUNCTION__), __LINE__, *Topic.ToString());
+		return;
+	}
+
+	// Typed parsing from the bytes if the subscriber supports it, otherwise the msg is converted to a FJsonObject
+	const FROSBridgeCborView MsgView = Message.GetField("msg");
+	TSharedPtr<FROSBridgeMsg> ROSBridgeMsg = Subscriber->ParseMessageFromCbor(MsgView);
+	if (!ROSBridgeMsg.IsValid())
+	{
+		TSharedPtr<FJsonObject> MsgObject = MsgView.ToJsonObject();
+		if (!MsgObject.IsValid())
 		{
-			TSharedPtr<FROSBridgeMsg> ROSBridgeMsg;
-			ROSBridgeMsg = Subscriber->ParseMessage(MsgObject);
-			TSharedPtr<FProcessTask> ProcessTask = MakeShareable<FProcessTask>(new FProcessTask(Subscriber, Topic, ROSBridgeMsg));
-			QueueTask.Enqueue(ProcessTask);
+			UE_LOG(LogROS, Error, TEXT(">> %s::%d Deserialization Error. Message Contents: %s"),
+				TEXT(__FUNCTION__), __LINE__, *Message.ToString());
+			return;
 		}
+		ROSBridgeMsg = Subscriber->ParseMessage(MsgObject);
 	}
-	else if (Op == TEXT("service_response"))
+
+	TSharedPtr<FProcessTask> ProcessTask = MakeShareable<FProcessTask>(new FProcessTask(Subscriber, Subscriber->GetTopic(), ROSBridgeMsg));
+	QueueTask.Enqueue(ProcessTask);
+}
+
+// Service operations
+void FROSBridgeHandler::OnServiceMessage(const FROSBridgeJsonView& Message)
+{
+	// Services are rare, so they are parsed completely
+	TSharedPtr< FJsonObject > JsonObject = Message.ToJsonObject();
+	if (!JsonObject.IsValid())
+	{
+		UE_LOG(LogROS, Error, TEXT(">> %s::%d Deserialization Error. Message Contents: %s"),
+			TEXT(__FUNCTION__), __LINE__, *Message.ToString());
+		return;
+	}
+
+	const FString Op = JsonObject->GetStringField(TEXT("op"));
+
+	if (Op == TEXT("service_response"))
 	{
 		const FString Id = JsonObject->GetStringField(TEXT("id"));
 		const FString ServiceName = JsonObject->GetStringField(TEXT("service"));
@@ -450,6 +538,40 @@ void FROSBridgeHandler::OnMessage(void* InData, int32 InLength)
 	}
 }
 
+// Add a subscriber to the topic map
+void FROSBridgeHandler::AddTopicSubscriber(TSharedPtr<FROSBridgeSubscriber> InSubscriber)
+{
+	FTCHARToUTF8 Converter(*InSubscriber->GetTopic());
+	const FROSBridgeJsonView Topic(Converter.Get(), Converter.Get() + Converter.Length());
+
+	TArray<FTopicSubscriber>& Subscribers = SubscribersByTopicHash.FindOrAdd(Topic.GetHash());
+	FTopicSubscriber& TopicSubscriber = Subscribers[Subscribers.AddDefaulted()];
+	TopicSubscriber.Topic.Append(Converter.Get(), Converter.Length());
+	TopicSubscriber.Subscriber = InSubscriber;
+}
+
+// Find the subscriber of the topic
+TSharedPtr<FROSBridgeSubscriber> FROSBridgeHandler::FindTopicSubscriber(const FROSBridgeJsonView& Topic) const
+{
+	if (!Topic.IsValid())
+	{
+		return nullptr;
+	}
+
+	if (const TArray<FTopicSubscriber>* Subscribers = SubscribersByTopicHash.Find(Topic.GetHash()))
+	{
+		// Same as before, the first subscriber of the topic gets the message
+		for (const FTopicSubscriber& TopicSubscriber : *Subscribers)
+		{
+			if (Topic.Equals(TopicSubscriber.Topic.GetData(), TopicSubscriber.Topic.Num()))
+			{
+				return TopicSubscriber.Subscriber;
+			}
+		}
+	}
+	return nullptr;
+}
+
 // Call external ROS service implementation
 void FROSBridgeHandler::CallServiceImpl(const FString& Name, TSharedPtr<FROSBridgeSrv::SrvRequest> Request, const FString& Id)
 {
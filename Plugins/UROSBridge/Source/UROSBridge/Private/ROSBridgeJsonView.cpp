@@ -0,0 +1,250 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#include "ROSBridgeJsonView.h"
+
+// Find a field of the object
+FROSBridgeJsonView FROSBridgeJsonView::GetField(const ANSICHAR* Key) const
+{
+	if (!IsValid())
+	{
+		return FROSBridgeJsonView();
+	}
+
+	const ANSICHAR* Pos = SkipWhitespace(Begin);
+	if (Pos == End || *Pos != '{')
+	{
+		return FROSBridgeJsonView();
+	}
+
+	const int32 KeyLength = FCStringAnsi::Strlen(Key);
+	Pos = SkipWhitespace(Pos + 1);
+	while (Pos != End && *Pos == '"')
+	{
+		// Key
+		const ANSICHAR* KeyEnd = SkipString(Pos);
+		if (!KeyEnd)
+		{
+			return FROSBridgeJsonView();
+		}
+		const bool bIsKey = FROSBridgeJsonView(Pos + 1, KeyEnd - 1).Equals(Key, KeyLength);
+
+		Pos = SkipWhitespace(KeyEnd);
+		if (Pos == End || *Pos != ':')
+		{
+			return FROSBridgeJsonView();
+		}
+
+		// Value
+		const ANSICHAR* ValueBegin = SkipWhitespace(Pos + 1);
+		const ANSICHAR* ValueEnd = SkipValue(ValueBegin);
+		if (!ValueEnd)
+		{
+			return FROSBridgeJsonView();
+		}
+		if (bIsKey)
+		{
+			return FROSBridgeJsonView(ValueBegin, ValueEnd);
+		}
+
+		// Next field
+		Pos = SkipWhitespace(ValueEnd);
+		if (Pos == End || *Pos != ',')
+		{
+			break;
+		}
+		Pos = SkipWhitespace(Pos + 1);
+	}
+	return FROSBridgeJsonView();
+}
+
+// Get the elements of the array
+bool FROSBridgeJsonView::GetElements(TArray<FROSBridgeJsonView>& OutElements) const
+{
+	OutElements.Reset();
+	if (!IsValid())
+	{
+		return false;
+	}
+
+	const ANSICHAR* Pos = SkipWhitespace(Begin);
+	if (Pos == End || *Pos != '[')
+	{
+		return false;
+	}
+
+	Pos = SkipWhitespace(Pos + 1);
+	if (Pos != End && *Pos == ']')
+	{
+		return true;
+	}
+	while (Pos != End)
+	{
+		const ANSICHAR* ValueEnd = SkipValue(Pos);
+		if (!ValueEnd)
+		{
+			return false;
+		}
+		OutElements.Add(FROSBridgeJsonView(Pos, ValueEnd));
+
+		// Next element
+		Pos = SkipWhitespace(ValueEnd);
+		if (Pos == End || *Pos == ']')
+		{
+			return Pos != End;
+		}
+		if (*Pos != ',')
+		{
+			return false;
+		}
+		Pos = SkipWhitespace(Pos + 1);
+	}
+	return false;
+}
+
+// Get the content of a string
+FROSBridgeJsonView FROSBridgeJsonView::GetString() const
+{
+	if (Len() < 2 || *Begin != '"' || *(End - 1) != '"')
+	{
+		return FROSBridgeJsonView();
+	}
+	return FROSBridgeJsonView(Begin + 1, End - 1);
+}
+
+// Parse a number
+double FROSBridgeJsonView::AsNumber(double Default) const
+{
+	// Numbers are short, a copy is needed for the terminating zero
+	ANSICHAR Buffer[64];
+	const int32 Length = Len();
+	if (Length == 0 || Length >= ARRAY_COUNT(Buffer))
+	{
+		return Default;
+	}
+
+	const ANSICHAR First = *Begin;
+	if (First != '-' && (First < '0' || First > '9'))
+	{
+		return Default;
+	}
+
+	FMemory::Memcpy(Buffer, Begin, Length);
+	Buffer[Length] = 0;
+	return FCStringAnsi::Atod(Buffer);
+}
+
+// Convert to string
+FString FROSBridgeJsonView::ToString() const
+{
+	if (!IsValid())
+	{
+		return FString();
+	}
+	FUTF8ToTCHAR Converter(Begin, Len());
+	return FString(Converter.Length(), Converter.Get());
+}
+
+// Deserialize to a json object
+TSharedPtr<FJsonObject> FROSBridgeJsonView::ToJsonObject() const
+{
+	TSharedPtr<FJsonObject> JsonObject;
+	TSharedRef< TJsonReader<> > Reader = TJsonReaderFactory<>::Create(ToString());
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject))
+	{
+		return nullptr;
+	}
+	return JsonObject;
+}
+
+// Compare with a zero terminated string
+bool FROSBridgeJsonView::Equals(const ANSICHAR* Str) const
+{
+	return Equals(Str, FCStringAnsi::Strlen(Str));
+}
+
+// Compare with bytes
+bool FROSBridgeJsonView::Equals(const ANSICHAR* Data, int32 Length) const
+{
+	return Len() == Length && (Length == 0 || FMemory::Memcmp(Begin, Data, Length) == 0);
+}
+
+// Skip whitespace
+const ANSICHAR* FROSBridgeJsonView::SkipWhitespace(const ANSICHAR* Pos) const
+{
+	while (Pos < End && (*Pos == ' ' || *Pos == '\t' || *Pos == '\n' || *Pos == '\r'))
+	{
+		Pos++;
+	}
+	return Pos;
+}
+
+// Skip a string
+const ANSICHAR* FROSBridgeJsonView::SkipString(const ANSICHAR* Pos) const
+{
+	for (Pos++; Pos < End; Pos++)
+	{
+		if (*Pos == '\\')
+		{
+			Pos++;
+		}
+		else if (*Pos == '"')
+		{
+			return Pos + 1;
+		}
+	}
+	return nullptr;
+}
+
+// Skip a value
+const ANSICHAR* FROSBridgeJsonView::SkipValue(const ANSICHAR* Pos) const
+{
+	if (Pos >= End)
+	{
+		return nullptr;
+	}
+
+	if (*Pos == '"')
+	{
+		return SkipString(Pos);
+	}
+
+	if (*Pos == '{' || *Pos == '[')
+	{
+		// Only the depth is tracked, the nested values are checked when they are read
+		int32 Depth = 0;
+		while (Pos < End)
+		{
+			if (*Pos == '"')
+			{
+				Pos = SkipString(Pos);
+				if (!Pos)
+				{
+					return nullptr;
+				}
+				continue;
+			}
+			if (*Pos == '{' || *Pos == '[')
+			{
+				Depth++;
+			}
+			else if (*Pos == '}' || *Pos == ']')
+			{
+				if (--Depth == 0)
+				{
+					return Pos + 1;
+				}
+			}
+			Pos++;
+		}
+		return nullptr;
+	}
+
+	// Number, true, false or null
+	const ANSICHAR* ValueBegin = Pos;
+	while (Pos < End && *Pos != ',' && *Pos != '}' && *Pos != ']' &&
+		*Pos != ' ' && *Pos != '\t' && *Pos != '\n' && *Pos != '\r')
+	{
+		Pos++;
+	}
+	return Pos > ValueBegin ? Pos : nullptr;
+}
@@ -0,0 +1,43 @@
+// Copyright 2018, Institute for Artificial Intelligence - University of Bremen
+
+#include "ROSTime.h"
+#include "Templates/Atomic.h"
+
+// Simulated time in nanoseconds, only used while bSimulatedTime is set. Set by the game thread, read by any thread that stamps messages.
+static TAtomic<bool> bSimulatedTime(false);
+static TAtomic<int64> SimulatedNanoseconds(0);
+
+// Wall clock or simulated time.
+FROSTime FROSTime::Now()
+{
+	if (bSimulatedTime.Load())
+	{
+		const int64 Nanoseconds = SimulatedNanoseconds.Load();
+		return FROSTime((uint32)(Nanoseconds / 1000000000), (uint32)(Nanoseconds % 1000000000));
+	}
+
+	FDateTime NowDateTime = FDateTime::UtcNow();
+	uint32 Secs = (uint32)NowDateTime.ToUnixTimestamp();
+	uint32 NSecs = (uint32)NowDateTime.GetMillisecond() * 1000000;
+	return FROSTime(Secs, NSecs);
+}
+
+// Sets the simulated time.
+void FROSTime::SetSimulatedTime(double InSeconds)
+{
+	// Whole nanoseconds in one atomic, so the seconds and nanoseconds of a stamp always belong to the same time.
+	SimulatedNanoseconds.Store((int64)FMath::RoundToDouble(InSeconds * 1e9));
+	bSimulatedTime.Store(true);
+}
+
+// Back to the wall clock.
+void FROSTime::ClearSimulatedTime()
+{
+	bSimulatedTime.Store(false);
+}
+
+// Checks for a simulated time.
+bool FROSTime::IsSimulatedTime()
+{
+	return bSimulatedTime.Load();
+}
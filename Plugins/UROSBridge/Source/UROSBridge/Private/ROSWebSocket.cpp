@@ -33,6 +33,9 @@ THIRD_PARTY_INCLUDES_END
 #endif
 
 #if USE_LIBWEBSOCKET
+// Size of the ring of outgoing frames, larger frames (e.g. big images) go to the overflow queue
+#define ROS_WEBSOCKET_RING_CAPACITY (8 * 1024 * 1024)
+
 static int unreal_networking_client(struct lws *wsi, enum lws_callback_reasons reason, void *user, void *in, size_t len);
 
 static void lws_debugLogS(int level, const char *line)
@@ -41,7 +44,7 @@ static void lws_debugLogS(int level, const char *line)
 }
 #endif
 
-FROSWebSocket::FROSWebSocket(const FInternetAddr& ServerAddress) : IsServerSide(false)
+FROSWebSocket::FROSWebSocket(const FInternetAddr& ServerAddress) : OutgoingRing(nullptr), NumOverflowFrames(0), NumSentFrames(0), IsServerSide(false), IsDestroyed(false)
 {
 	// Server address as string without port
 	ServerAddressAsString = ServerAddress.ToString(false);
@@ -53,6 +56,8 @@ FROSWebSocket::FROSWebSocket(const FInternetAddr& ServerAddress) : IsServerSide(
 	//lws_set_log_level(LLL_ERR | LLL_WARN | LLL_NOTICE | LLL_DEBUG | LLL_INFO, lws_debugLogS);
 #endif
 
+	OutgoingRing = new FROSWebSocketRing(ROS_WEBSOCKET_RING_CAPACITY, LWS_PRE);
+
 	Protocols = new lws_protocols[3];
 	FMemory::Memzero(Protocols, sizeof(lws_protocols) * 3);
 
@@ -157,10 +162,14 @@ void FROSWebSocket::Connect()
 
 #if USE_LIBWEBSOCKET
 FROSWebSocket::FROSWebSocket(WebSocketInternalContext* InContext, WebSocketInternal* InWsi)
-	: Context(InContext)
+	: OutgoingRing(nullptr)
+	, NumOverflowFrames(0)
+	, NumSentFrames(0)
+	, Context(InContext)
 	, Wsi(InWsi)
 	, Protocols(nullptr)
 	, IsServerSide(true)
+	, IsDestroyed(false)
 {
 	int sock = lws_get_socket_fd(Wsi);
 	socklen_t len = sizeof RemoteAddr;
@@ -170,38 +179,54 @@ FROSWebSocket::FROSWebSocket(WebSocketInternalContext* InContext, WebSocketInter
 
 bool FROSWebSocket::Send(uint8* Data, uint32 Size)
 {
-	TArray<uint8> Buffer;
+	uint64 Position;
+	if (uint8* Frame = BeginFrame(sizeof(uint32) + Size, LWS_WRITE_BINARY, Position))
+	{
+		FMemory::Memcpy(Frame, &Size, sizeof(uint32)); // insert size.
+		FMemory::Memcpy(Frame + sizeof(uint32), Data, Size);
+		OutgoingRing->EndWrite(Position);
+	}
+	else
+	{
+		TArray<uint8> Buffer;
 
 #if USE_LIBWEBSOCKET
-	Buffer.AddDefaulted(LWS_PRE); // Reserve space for WS header data
+		Buffer.AddDefaulted(LWS_PRE); // Reserve space for WS header data
 #endif
 
-	Buffer.Append((uint8*)&Size, sizeof (uint32)); // insert size.
-	Buffer.Append((uint8*)Data, Size);
+		Buffer.Append((uint8*)&Size, sizeof (uint32)); // insert size.
+		Buffer.Append((uint8*)Data, Size);
+		AddOverflowFrame(MoveTemp(Buffer), LWS_WRITE_BINARY);
+	}
 
-	CriticalSection.Lock();
-	OutgoingBuffer.Add(Buffer);
-	OutgoingBufferType.Add( LWS_WRITE_BINARY );
-	CriticalSection.Unlock();
+	// The thread waits in Service until there is something to do
+	Wake();
 
 	return true;
 }
 
 bool FROSWebSocket::SendText(uint8* Data, uint32 Size)
 {
-	TArray<uint8> Buffer;
+	uint64 Position;
+	if (uint8* Frame = BeginFrame(Size, LWS_WRITE_TEXT, Position))
+	{
+		FMemory::Memcpy(Frame, Data, Size);
+		OutgoingRing->EndWrite(Position);
+	}
+	else
+	{
+		TArray<uint8> Buffer;
 
 #if USE_LIBWEBSOCKET
-	Buffer.AddDefaulted(LWS_PRE); // Reserve space for WS header data
+		Buffer.AddDefaulted(LWS_PRE); // Reserve space for WS header data
 #endif
 
-	// Buffer.Append((uint8*)&Size, sizeof (uint32)); // insert size.
-	Buffer.Append((uint8*)Data, Size);
+		Buffer.Append((uint8*)Data, Size);
+		AddOverflowFrame(MoveTemp(Buffer), LWS_WRITE_TEXT);
+	}
 
-	CriticalSection.Lock();
-	OutgoingBuffer.Add(Buffer);
-	OutgoingBufferType.Add( LWS_WRITE_TEXT );
-	CriticalSection.Unlock();
+	// The thread waits in Service until there is something to do
+	Wake();
 
 	return true;
 }
@@ -211,6 +236,17 @@ bool FROSWebSocket::Send(const FString &StringData)
 #if UE_BUILD_DEBUG
 	UE_LOG(LogROS, Log, TEXT("[WebSocket::Send] Output Message: %s"), *StringData);
 #endif
+	// Convert straight into the ring, without a temporary UTF-8 copy
+	const int32 Length = FTCHARToUTF8_Convert::ConvertedLength(*StringData, StringData.Len());
+	uint64 Position;
+	if (uint8* Frame = BeginFrame(Length, LWS_WRITE_TEXT, Position))
+	{
+		FTCHARToUTF8_Convert::Convert((ANSICHAR*)Frame, Length, *StringData, StringData.Len());
+		OutgoingRing->EndWrite(Position);
+		Wake();
+		return true;
+	}
+
 	FTCHARToUTF8 Conversion(*StringData);
 	uint32 DestLen = Conversion.Length();
 	uint8* Data = (uint8*)Conversion.Get();
@@ -219,11 +255,49 @@ bool FROSWebSocket::Send(const FString &StringData)
 	return SendText(Data, DestLen);
 }
 
+uint8* FROSWebSocket::BeginFrame(uint32 Size, uint8 Type, uint64& OutPosition)
+{
+	// While frames wait in the overflow queue new ones go there too, so the frames of a thread stay in order
+	if (!OutgoingRing || NumOverflowFrames.Load() > 0)
+	{
+		return nullptr;
+	}
+	return OutgoingRing->BeginWrite(Size, Type, OutPosition);
+}
+
+void FROSWebSocket::AddOverflowFrame(TArray<uint8>&& Buffer, uint8 Type)
+{
+	FScopeLock Lock(&CriticalSection);
+	OutgoingBuffer.Add(MoveTemp(Buffer));
+	OutgoingBufferType.Add(Type);
+	++NumOverflowFrames;
+}
+
+bool FROSWebSocket::PopOverflowFrame(TArray<uint8>& OutBuffer, uint8& OutType)
+{
+	FScopeLock Lock(&CriticalSection);
+	if (OutgoingBuffer.Num() == 0)
+	{
+		return false;
+	}
+	OutBuffer = MoveTemp(OutgoingBuffer[0]);
+	OutType = OutgoingBufferType[0];
+	OutgoingBuffer.RemoveAt(0, 1, false);
+	OutgoingBufferType.RemoveAt(0, 1, false);
+	--NumOverflowFrames;
+	return true;
+}
+
 void FROSWebSocket::SetRecieveCallBack(FROSWebsocketPacketRecievedSignature CallBack)
 {
 	OnRecieved = CallBack;
 }
 
+void FROSWebSocket::SetBinaryRecieveCallBack(FROSWebsocketPacketRecievedSignature CallBack)
+{
+	OnRecievedBinary = CallBack;
+}
+
 FString FROSWebSocket::RemoteEndPoint(bool bAppendPort)
 {
 	// Windows XP does not have support for inet_ntop
@@ -300,13 +374,44 @@ void FROSWebSocket::Tick()
 	HandlePacket();
 }
 
-void FROSWebSocket::HandlePacket()
+void FROSWebSocket::Service(int32 TimeoutInMs)
+{
+	HandlePacket(TimeoutInMs);
+}
+
+void FROSWebSocket::Wake()
 {
 #if USE_LIBWEBSOCKET
+	// lws_cancel_service is the only thread safe lws call, it makes lws_service return.
+	// The lock keeps Destroy from freeing the context while it is used here
+	FScopeLock Lock(&ContextCriticalSection);
+	if (Context && !IsServerSide && !IsDestroyed.Load())
+	{
+		lws_cancel_service(Context);
+	}
+#endif
+}
 
-	lws_service(Context, 0);
-	if (!IsServerSide)
+bool FROSWebSocket::HasOutgoingData()
+{
+	return (OutgoingRing && !OutgoingRing->IsEmpty()) || NumOverflowFrames.Load() > 0;
+}
+
+bool FROSWebSocket::HasCommittedData()
+{
+	// A reserved frame is committed by its writer, which wakes the servicing thread afterwards.
+	// Until then asking for the writable callback would only make lws_service return at once
+	return (OutgoingRing && OutgoingRing->HasCommittedFrame()) || NumOverflowFrames.Load() > 0;
+}
+
+void FROSWebSocket::HandlePacket(int32 TimeoutInMs)
+{
+#if USE_LIBWEBSOCKET
+
+	// Only ask for the writable callback if a frame can be sent, otherwise lws_service would not wait
+	if (!IsServerSide && HasCommittedData())
 		lws_callback_on_writable_all_protocol(Context, &Protocols[0]);
+	lws_service(Context, TimeoutInMs);
 
 #else // ! USE_LIBWEBSOCKET -- HTML5 uses BSD network API
 
@@ -341,8 +446,7 @@ void FROSWebSocket::HandlePacket()
 
 void FROSWebSocket::Flush()
 {
-	auto PendingMesssages = OutgoingBuffer.Num();
-	while (OutgoingBuffer.Num() > 0 && !IsServerSide)
+	while (HasOutgoingData() && !IsServerSide)
 	{
 #if USE_LIBWEBSOCKET
 		if (Protocols)
@@ -354,8 +458,9 @@ void FROSWebSocket::Flush()
 			lws_callback_on_writable(Wsi);
 		}
 #endif
+		const uint64 SentFrames = NumSentFrames;
 		HandlePacket();
-		if (PendingMesssages >= OutgoingBuffer.Num())
+		if (NumSentFrames == SentFrames)
 		{
 			UE_LOG(LogROS, Warning, TEXT("Unable to flush all of OutgoingBuffer in FWebSocket."));
 			break;
@@ -373,7 +478,7 @@ void FROSWebSocket::SetErrorCallBack(FROSWebsocketInfoSignature InDelegate)
 	OnError = InDelegate;
 }
 
-void FROSWebSocket::OnRawRecieve(void* Data, uint32 Size, bool isBinary)
+void FROSWebSocket::OnRawRecieve(void* Data, uint32 Size, bool isBinary, bool bIsFinal)
 {
 #if UE_BUILD_DEBUG
 	UE_LOG(LogROS, Warning, TEXT("[WebSocket::OnRawReceive] Message size = %d, isBinary = %d"), Size, isBinary);
@@ -381,34 +486,22 @@ void FROSWebSocket::OnRawRecieve(void* Data, uint32 Size, bool isBinary)
 
 #if USE_LIBWEBSOCKET
 
-	RecievedBuffer.Append((uint8*)Data, Size); // consumes all of Data
-	// UE_LOG(LogROS, Warning, TEXT("ReceivedBuffer.Num() = %d"), RecievedBuffer.Num());
-
-	if (isBinary)
+	if (!isBinary || OnRecievedBinary.IsBound())
 	{
-		while (RecievedBuffer.Num() > sizeof(uint32))
+		// Text frames and binary frames of rosbridge (e.g. CBOR) are passed whole
+		FROSWebsocketPacketRecievedSignature& FrameCallback = isBinary ? OnRecievedBinary : OnRecieved;
+		RecievedBuffer.ReceiveFrame((const uint8*)Data, Size, bIsFinal, [&FrameCallback](void* Frame, uint32 FrameSize)
 		{
-			uint32 BytesToBeRead = *(uint32*)RecievedBuffer.GetData();
-			// UE_LOG(LogROS, Warning, TEXT("BytesToBeRead = %d"), BytesToBeRead);
-
-			if (BytesToBeRead <= ((uint32)RecievedBuffer.Num() - sizeof(uint32)))
-			{
-				OnRecieved.ExecuteIfBound((void*)((uint8*)RecievedBuffer.GetData() + sizeof(uint32)), BytesToBeRead);
-				RecievedBuffer.RemoveAt(0, sizeof(uint32) + BytesToBeRead );
-			}
-			else
-			{
-				break;
-			}
-		}
-	}
-	else
-	{
-		uint8* Bytes = (uint8*)RecievedBuffer.GetData();
-		OnRecieved.ExecuteIfBound((void*)(Bytes), Size);
-		RecievedBuffer.RemoveAt(0, Size );
+			FrameCallback.ExecuteIfBound(Frame, FrameSize);
+		});
+		return;
 	}
 
+	// Binary data is a stream of messages with their size in front
+	RecievedBuffer.ReceiveSizePrefixed((const uint8*)Data, Size, [this](void* Message, uint32 MessageSize)
+	{
+		OnRecieved.ExecuteIfBound(Message, MessageSize);
+	});
 
 #else // ! USE_LIBWEBSOCKET -- HTML5 uses BSD network API
 
@@ -447,38 +540,50 @@ void FROSWebSocket::OnRawRecieve(void* Data, uint32 Size, bool isBinary)
 
 void FROSWebSocket::OnRawWebSocketWritable(WebSocketInternal* wsi)
 {
-	if (OutgoingBuffer.Num() == 0 || OutgoingBufferType.Num() == 0)
-		return;
-
-	CriticalSection.Lock();
-	TArray <uint8>& Packet = OutgoingBuffer[0];
-	lws_write_protocol OutType = (lws_write_protocol)OutgoingBufferType[0];
-	CriticalSection.Unlock();
-
 #if USE_LIBWEBSOCKET
 
-	uint32 TotalDataSize = Packet.Num() - LWS_PRE;
-	uint32 DataToSend = TotalDataSize;
-	while (DataToSend)
+	check(Wsi == wsi);
+
+	// Send as many frames as the socket takes. The ring goes first, the frames of the overflow queue are newer (see BeginFrame)
+	while (!lws_send_pipe_choked(Wsi))
 	{
-		int Sent = lws_write(Wsi, Packet.GetData() + LWS_PRE + (DataToSend-TotalDataSize), DataToSend, OutType);
+		uint32 Size;
+		uint32 Type;
+		if (uint8* Payload = OutgoingRing ? OutgoingRing->Peek(Size, Type) : nullptr)
+		{
+			if (!WriteFrame(Payload, Size, (uint8)Type))
+			{
+				return;
+			}
+			OutgoingRing->Pop();
+			continue;
+		}
 
-		if (Sent < 0)
+		if (OutgoingRing && !OutgoingRing->IsEmpty())
 		{
-			OnError.Broadcast();
-			return;
+			// The next frame is reserved but not committed, its writer wakes the thread when it is done
+			break;
+		}
+
+		TArray<uint8> Packet;
+		uint8 PacketType;
+		if (!PopOverflowFrame(Packet, PacketType))
+		{
+			break;
 		}
-		if ((uint32)Sent < DataToSend)
+		if (!WriteFrame(Packet.GetData() + LWS_PRE, Packet.Num() - LWS_PRE, PacketType))
 		{
-			UE_LOG(LogROS, Warning, TEXT("Could not write all '%d' bytes to socket"), DataToSend);
+			return;
 		}
-		DataToSend-=Sent;
 	}
 
-	check(Wsi == wsi);
-
 #else // ! USE_LIBWEBSOCKET -- HTML5 uses BSD network API
 
+	TArray<uint8> Packet;
+	uint8 PacketType;
+	if (!PopOverflowFrame(Packet, PacketType))
+		return;
+
 	uint32 TotalDataSize = Packet.Num();
 	uint32 DataToSend = TotalDataSize;
 	while (DataToSend)
@@ -495,20 +600,30 @@ void FROSWebSocket::OnRawWebSocketWritable(WebSocketInternal* wsi)
 		UE_CLOG((uint32)Result < DataToSend, LogROS, Warning, TEXT("Could not write all '%d' bytes to socket"), DataToSend);
 		DataToSend-=Result;
 	}
+	++NumSentFrames;
 
 #endif
+}
 
-	// this is very inefficient we need a constant size circular buffer to efficiently not do unnecessary allocations/deallocations.
-	CriticalSection.Lock();
-	OutgoingBuffer.RemoveAt(0);
-	OutgoingBufferType.RemoveAt(0);
-	CriticalSection.Unlock();
-
+#if USE_LIBWEBSOCKET
+bool FROSWebSocket::WriteFrame(uint8* Payload, uint32 Size, uint8 Type)
+{
+	// lws keeps what the socket does not take and reports the pipe as choked until it is sent
+	int Sent = lws_write(Wsi, Payload, Size, (lws_write_protocol)Type);
+	if (Sent < 0)
+	{
+		OnError.Broadcast();
+		return false;
+	}
+	++NumSentFrames;
+	return true;
 }
+#endif
 
 void FROSWebSocket::Destroy()
 {
 	OnRecieved.Unbind();
+	OnRecievedBinary.Unbind();
 	OnConnection.Clear();
 	OnError.Clear();
 
@@ -518,8 +633,15 @@ void FROSWebSocket::Destroy()
 
 	if (!IsServerSide)
 	{
-		lws_context_destroy(Context);
-		Context = NULL;
+		// Wake does not use the context any more once it is taken under the lock
+		WebSocketInternalContext* DestroyedContext;
+		{
+			FScopeLock Lock(&ContextCriticalSection);
+			DestroyedContext = Context;
+			Context = NULL;
+			IsDestroyed = true;
+		}
+		lws_context_destroy(DestroyedContext);
 		delete Protocols;
 		Protocols = NULL;
 	}
@@ -535,8 +657,10 @@ void FROSWebSocket::Destroy()
 
 FROSWebSocket::~FROSWebSocket()
 {
-	if (!IsDestroyed)
+	if (!IsDestroyed.Load())
 		Destroy(); 
+
+	delete OutgoingRing;
 }
 
 #if USE_LIBWEBSOCKET
@@ -567,7 +691,9 @@ static int unreal_networking_client(
 	case LWS_CALLBACK_CLIENT_RECEIVE:
 		{
 			// push it on the socket.
-			Socket->OnRawRecieve(In, (uint32)Len, !!lws_frame_is_binary(Wsi));
+			// Frames larger than rx_buffer_size, or sent in fragments, arrive in several callbacks
+			const bool bIsFinal = lws_is_final_fragment(Wsi) && lws_remaining_packet_payload(Wsi) == 0;
+			Socket->OnRawRecieve(In, (uint32)Len, !!lws_frame_is_binary(Wsi), bIsFinal);
 			check(Socket->Wsi == Wsi);
 			lws_set_timeout(Wsi, NO_PENDING_TIMEOUT, 0);
 			break;
@@ -576,7 +702,10 @@ static int unreal_networking_client(
 		{
 			check(Socket->Wsi == Wsi);
 			Socket->OnRawWebSocketWritable(Wsi);
-			lws_callback_on_writable(Wsi);
+			if (Socket->HasCommittedData())
+			{
+				lws_callback_on_writable(Wsi);
+			}
 			lws_set_timeout(Wsi, NO_PENDING_TIMEOUT, 0);
 			break;
 		}
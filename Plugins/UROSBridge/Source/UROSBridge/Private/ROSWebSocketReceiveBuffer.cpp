@@ -0,0 +1,60 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#include "ROSWebSocketReceiveBuffer.h"
+
+// Add a piece of a frame
+void FROSWebSocketReceiveBuffer::ReceiveFrame(const uint8* Data, uint32 Size, bool bIsFinal, TFunctionRef<void(void*, uint32)> OnFrame)
+{
+	// A frame that came in one piece is handed over in place, fragments are put together in the buffer
+	if (Buffer.Num() == 0 && bIsFinal)
+	{
+		OnFrame((void*)Data, Size);
+		return;
+	}
+
+	Buffer.Append(Data, Size);
+	if (bIsFinal)
+	{
+		OnFrame((void*)Buffer.GetData(), Buffer.Num());
+
+		// Keeps the memory for the next fragmented frame
+		Buffer.Reset();
+	}
+}
+
+// Add a piece of a size prefixed stream
+void FROSWebSocketReceiveBuffer::ReceiveSizePrefixed(const uint8* Data, uint32 Size, TFunctionRef<void(void*, uint32)> OnMessage)
+{
+	// The messages are read in place, only an incomplete message at the end is kept
+	const uint8* Bytes = Data;
+	uint32 Available = Size;
+	if (Buffer.Num() > 0)
+	{
+		Buffer.Append(Data, Size);
+		Bytes = Buffer.GetData();
+		Available = Buffer.Num();
+	}
+
+	uint32 Consumed = 0;
+	while (Available - Consumed > sizeof(uint32))
+	{
+		uint32 BytesToBeRead;
+		FMemory::Memcpy(&BytesToBeRead, Bytes + Consumed, sizeof(uint32));
+		if (BytesToBeRead > Available - Consumed - sizeof(uint32))
+		{
+			break;
+		}
+		OnMessage((void*)(Bytes + Consumed + sizeof(uint32)), BytesToBeRead);
+		Consumed += sizeof(uint32) + BytesToBeRead;
+	}
+
+	if (Buffer.Num() > 0)
+	{
+		// One move of the rest instead of one per message, the memory is kept
+		Buffer.RemoveAt(0, Consumed, false);
+	}
+	else if (Consumed < Size)
+	{
+		Buffer.Append(Bytes + Consumed, Size - Consumed);
+	}
+}
@@ -0,0 +1,150 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#include "ROSWebSocketRing.h"
+
+// Frames start at this alignment, so padding to the end of the ring always has room for a header
+#define ROS_WEBSOCKET_RING_ALIGNMENT (16)
+
+// Allocate the ring
+FROSWebSocketRing::FROSWebSocketRing(uint32 InCapacity, uint32 InHeadroom) :
+	Headroom(InHeadroom),
+	WritePosition(0),
+	ReadPosition(0)
+{
+	static_assert(sizeof(FFrameHeader) <= ROS_WEBSOCKET_RING_ALIGNMENT, "The header must fit into the padding.");
+
+	Capacity = FMath::RoundUpToPowerOfTwo(FMath::Max(InCapacity, (uint32)ROS_WEBSOCKET_RING_ALIGNMENT));
+	Mask = Capacity - 1;
+	Data = (uint8*)FMemory::Malloc(Capacity, ROS_WEBSOCKET_RING_ALIGNMENT);
+	FMemory::Memzero(Data, Capacity);
+}
+
+// Free the ring
+FROSWebSocketRing::~FROSWebSocketRing()
+{
+	FMemory::Free(Data);
+}
+
+// Reserve a frame
+uint8* FROSWebSocketRing::BeginWrite(uint32 Size, uint32 Type, uint64& OutPosition)
+{
+	const uint64 Total = Align((uint64)sizeof(FFrameHeader) + Headroom + Size, (uint64)ROS_WEBSOCKET_RING_ALIGNMENT);
+	if (Total > Capacity)
+	{
+		return nullptr;
+	}
+
+	// A frame is never split, if it does not fit at the end of the ring it starts at the beginning
+	uint64 Position = WritePosition.Load();
+	uint64 Padding = 0;
+	for (;;)
+	{
+		const uint64 Offset = Position & Mask;
+		Padding = Offset + Total > Capacity ? Capacity - Offset : 0;
+		if (Position + Padding + Total - ReadPosition.Load() > Capacity)
+		{
+			return nullptr;
+		}
+		if (WritePosition.CompareExchange(Position, Position + Padding + Total))
+		{
+			break;
+		}
+	}
+
+	if (Padding > 0)
+	{
+		FFrameHeader* PaddingHeader = GetHeader(Position);
+		PaddingHeader->Total = (uint32)Padding;
+		FPlatformAtomics::InterlockedExchange(&PaddingHeader->State, 2);
+		Position += Padding;
+	}
+
+	FFrameHeader* Header = GetHeader(Position);
+	Header->Size = Size;
+	Header->Type = Type;
+	Header->Total = (uint32)Total;
+
+	OutPosition = Position;
+	return (uint8*)Header + sizeof(FFrameHeader) + Headroom;
+}
+
+// Commit a frame
+void FROSWebSocketRing::EndWrite(uint64 Position)
+{
+	// Full barrier, the payload is visible before the state
+	FPlatformAtomics::InterlockedExchange(&GetHeader(Position)->State, 1);
+}
+
+// Get the oldest frame
+uint8* FROSWebSocketRing::Peek(uint32& OutSize, uint32& OutType)
+{
+	for (;;)
+	{
+		const uint64 Position = ReadPosition.Load(EMemoryOrder::Relaxed);
+		if (Position == WritePosition.Load())
+		{
+			return nullptr;
+		}
+
+		FFrameHeader* Header = GetHeader(Position);
+		const int32 State = Header->State;
+		FPlatformMisc::MemoryBarrier();
+
+		if (State == 0)
+		{
+			// Reserved, the writer is not done yet
+			return nullptr;
+		}
+		if (State == 2)
+		{
+			Release(Position, Header->Total);
+			continue;
+		}
+
+		OutSize = Header->Size;
+		OutType = Header->Type;
+		return (uint8*)Header + sizeof(FFrameHeader) + Headroom;
+	}
+}
+
+// Release the oldest frame
+void FROSWebSocketRing::Pop()
+{
+	const uint64 Position = ReadPosition.Load(EMemoryOrder::Relaxed);
+	Release(Position, GetHeader(Position)->Total);
+}
+
+// Check if empty
+bool FROSWebSocketRing::IsEmpty() const
+{
+	return ReadPosition.Load() == WritePosition.Load();
+}
+
+// Check if the oldest frame can be read
+bool FROSWebSocketRing::HasCommittedFrame() const
+{
+	// Same steps as Peek, the padding is skipped but not released
+	uint64 Position = ReadPosition.Load(EMemoryOrder::Relaxed);
+	while (Position != WritePosition.Load())
+	{
+		const FFrameHeader* Header = GetHeader(Position);
+		const int32 State = Header->State;
+		FPlatformMisc::MemoryBarrier();
+
+		if (State != 2)
+		{
+			return State == 1;
+		}
+		Position += Header->Total;
+	}
+	return false;
+}
+
+// Zero the frame and give its space back
+void FROSWebSocketRing::Release(uint64 Position, uint32 Total)
+{
+	// A header of a later frame can start anywhere in these bytes, it has to read as not committed
+	FMemory::Memzero(GetHeader(Position), Total);
+	FPlatformMisc::MemoryBarrier();
+	ReadPosition.Store(Position + Total);
+}
@@ -0,0 +1,146 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "ROSBridgeBase64.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define BASE64_BENCHMARK_WIDTH (640)
+#define BASE64_BENCHMARK_HEIGHT (480)
+#define BASE64_BENCHMARK_ROUNDS (200)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSBridgeBase64Test, "UROSBridge.Base64", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Checks the test vectors of RFC 4648, the round trip of all byte values and lengths, and the rejection of text that is not Base64.
+bool FROSBridgeBase64Test::RunTest(const FString& Parameters)
+{
+	const ANSICHAR* Vectors[][2] = {
+		{ "", "" },
+		{ "f", "Zg==" },
+		{ "fo", "Zm8=" },
+		{ "foo", "Zm9v" },
+		{ "foob", "Zm9vYg==" },
+		{ "fooba", "Zm9vYmE=" },
+		{ "foobar", "Zm9vYmFy" },
+	};
+	TArray<uint8> Decoded;
+	for (const auto& Vector : Vectors)
+	{
+		const int32 Length = FCStringAnsi::Strlen(Vector[0]);
+		const FString Text(Vector[1]);
+
+		FString Encoded;
+		FROSBridgeBase64::Encode((const uint8*)Vector[0], Length, Encoded);
+		TestEqual(FString::Printf(TEXT("Encoded '%s'"), *FString(Vector[0])), Encoded, Text);
+		TestEqual(FString::Printf(TEXT("Encoded length of '%s'"), *FString(Vector[0])), FROSBridgeBase64::GetEncodedLength(Length), Text.Len());
+
+		// The same from the text of an FString and from the bytes of a frame, with and without padding.
+		const int32 Unpadded = FCStringAnsi::Strlen(Vector[1]) - (Text.EndsWith(TEXT("==")) ? 2 : Text.EndsWith(TEXT("=")) ? 1 : 0);
+		TestTrue(FString::Printf(TEXT("Decoded '%s'"), *Text), FROSBridgeBase64::Decode(Text, Decoded) && Decoded.Num() == Length && FMemory::Memcmp(Decoded.GetData(), Vector[0], Length) == 0);
+		TestTrue(FString::Printf(TEXT("Decoded bytes of '%s'"), *Text), FROSBridgeBase64::Decode(Vector[1], FCStringAnsi::Strlen(Vector[1]), Decoded) && Decoded.Num() == Length && FMemory::Memcmp(Decoded.GetData(), Vector[0], Length) == 0);
+		TestTrue(FString::Printf(TEXT("Decoded '%s' without padding"), *Text), FROSBridgeBase64::Decode(Vector[1], Unpadded, Decoded) && Decoded.Num() == Length && FMemory::Memcmp(Decoded.GetData(), Vector[0], Length) == 0);
+	}
+
+	// Encode appends to what is in the string.
+	FString Appended(TEXT("data:"));
+	FROSBridgeBase64::Encode((const uint8*)"foo", 3, Appended);
+	FROSBridgeBase64::Encode((const uint8*)"f", 1, Appended);
+	TestEqual(TEXT("Appended text"), Appended, FString(TEXT("data:Zm9vZg==")));
+
+	// Every byte value at every position of a group, and all lengths up to some groups.
+	TArray<uint8> Bytes;
+	for (int32 i = 0; i < 256 * 3 + 2; ++i)
+	{
+		Bytes.Add(uint8(i * 7 + i / 256));
+	}
+	for (int32 Length = 0; Length < Bytes.Num(); Length += Length < 64 ? 1 : 97)
+	{
+		FString Encoded;
+		FROSBridgeBase64::Encode(Bytes.GetData(), Length, Encoded);
+		if (Encoded.Len() != FROSBridgeBase64::GetEncodedLength(Length) || !FROSBridgeBase64::Decode(Encoded, Decoded) || Decoded.Num() != Length || FMemory::Memcmp(Decoded.GetData(), Bytes.GetData(), Length) != 0)
+		{
+			AddError(FString::Printf(TEXT("Round trip of %d bytes."), Length));
+		}
+	}
+
+	// Decoding into a larger array keeps only the decoded bytes.
+	Decoded.SetNumZeroed(1000);
+	TestTrue(TEXT("Decoded into a larger array"), FROSBridgeBase64::Decode(TEXT("Zm8="), 4, Decoded) && Decoded.Num() == 2 && Decoded[0] == 'f' && Decoded[1] == 'o');
+
+	// Text that is not Base64 fails and leaves an empty array.
+	const TCHAR* Invalid[] = {
+		TEXT("Z"),
+		TEXT("Zm9vY"),
+		TEXT("Zm9v!A=="),
+		TEXT("Zm 9v"),
+		TEXT("Zm9v\nYmFy"),
+		TEXT("Zg==Zg=="),
+		TEXT("Zm-_"),
+		TEXT("\x00c4m9v"),
+		TEXT("\x0141m9v"),
+	};
+	for (const TCHAR* Text : Invalid)
+	{
+		Decoded.SetNumZeroed(10);
+		TestTrue(FString::Printf(TEXT("Invalid '%s'"), Text), !FROSBridgeBase64::Decode(Text, FCString::Strlen(Text), Decoded) && Decoded.Num() == 0);
+	}
+	const ANSICHAR InvalidBytes[] = { 'Z', 'm', (ANSICHAR)0xc3, (ANSICHAR)0x84 };
+	TestTrue(TEXT("Invalid UTF-8 bytes"), !FROSBridgeBase64::Decode(InvalidBytes, ARRAY_COUNT(InvalidBytes), Decoded) && Decoded.Num() == 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSBridgeBase64Benchmark, "UROSBridge.Benchmark.Base64", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Round trip of the data of a 640x480 rgb8 image: encoded into an FString as by WriteJson,
+// decoded from the FString as by FromJson and from the UTF-8 bytes of a frame as by FromJsonView.
+bool FROSBridgeBase64Benchmark::RunTest(const FString& Parameters)
+{
+	TArray<uint8> Image;
+	Image.SetNumUninitialized(BASE64_BENCHMARK_WIDTH * BASE64_BENCHMARK_HEIGHT * 3);
+	uint32 Random = 12345;
+	for (uint8& Pixel : Image)
+	{
+		Random = Random * 1664525 + 1013904223;
+		Pixel = (uint8)(Random >> 24);
+	}
+
+	// The string and the array keep their memory from round to round, as the messages do.
+	FString Encoded;
+	double Start = FPlatformTime::Seconds();
+	for (int32 Round = 0; Round < BASE64_BENCHMARK_ROUNDS; ++Round)
+	{
+		Encoded.Reset();
+		FROSBridgeBase64::Encode(Image.GetData(), Image.Num(), Encoded);
+	}
+	const double EncodeSeconds = (FPlatformTime::Seconds() - Start) / BASE64_BENCHMARK_ROUNDS;
+
+	TArray<uint8> Decoded;
+	bool bDecoded = true;
+	Start = FPlatformTime::Seconds();
+	for (int32 Round = 0; Round < BASE64_BENCHMARK_ROUNDS; ++Round)
+	{
+		bDecoded &= FROSBridgeBase64::Decode(Encoded, Decoded);
+	}
+	const double DecodeSeconds = (FPlatformTime::Seconds() - Start) / BASE64_BENCHMARK_ROUNDS;
+	TestTrue(TEXT("Image decoded from the string"), bDecoded && Decoded == Image);
+
+	FTCHARToUTF8 Frame(*Encoded);
+	Start = FPlatformTime::Seconds();
+	for (int32 Round = 0; Round < BASE64_BENCHMARK_ROUNDS; ++Round)
+	{
+		bDecoded &= FROSBridgeBase64::Decode(Frame.Get(), Frame.Length(), Decoded);
+	}
+	const double DecodeBytesSeconds = (FPlatformTime::Seconds() - Start) / BASE64_BENCHMARK_ROUNDS;
+	TestTrue(TEXT("Image decoded from the bytes"), bDecoded && Decoded == Image);
+
+	// GB/s of the image data, the text is 4/3 of it.
+	const double Bytes = Image.Num();
+	AddInfo(FString::Printf(TEXT("%dx%d rgb8 image (%d bytes): encode %.2f GB/s, decode from FString %.2f GB/s, decode from frame bytes %.2f GB/s, round trip %.2f GB/s."),
+		BASE64_BENCHMARK_WIDTH, BASE64_BENCHMARK_HEIGHT, Image.Num(), Bytes / EncodeSeconds * 1e-9, Bytes / DecodeSeconds * 1e-9, Bytes / DecodeBytesSeconds * 1e-9,
+		Bytes / (EncodeSeconds + DecodeBytesSeconds) * 1e-9));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,472 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Templates/Function.h"
+#include "ROSBridgeCborView.h"
+#include "ROSBridgeJsonView.h"
+#include "ROSBridgeBase64.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define CBOR_BENCHMARK_BYTES (256 * 1024 * 1024)
+#define CBOR_BENCHMARK_MIN_MESSAGES (20)
+
+// Bytes of a hex string
+static TArray<uint8> GetCborTestBytes(const ANSICHAR* Hex)
+{
+	TArray<uint8> Bytes;
+	for (; Hex[0] && Hex[1]; Hex += 2)
+	{
+		const ANSICHAR Digits[3] = { Hex[0], Hex[1], 0 };
+		Bytes.Add((uint8)strtoul(Digits, nullptr, 16));
+	}
+	return Bytes;
+}
+
+// View on the bytes of a test item
+static FROSBridgeCborView GetCborTestView(const TArray<uint8>& Bytes)
+{
+	return FROSBridgeCborView(Bytes.GetData(), Bytes.GetData() + Bytes.Num());
+}
+
+// Compares two numbers bit by bit, so -0.0 and NaN are checked too
+static bool IsSameCborTestNumber(const double A, const double B)
+{
+	return FMemory::Memcmp(&A, &B, sizeof(double)) == 0 || (A != A && B != B);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSBridgeCborViewTest, "UROSBridge.CborView", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Reads the numbers of the examples of RFC 8949 (appendix A) including half floats,
+// maps and arrays, the typed arrays of RFC 8746, and broken or indefinite items.
+bool FROSBridgeCborViewTest::RunTest(const FString& Parameters)
+{
+	struct FCborTestNumber
+	{
+		const ANSICHAR* Hex;
+		double Value;
+	};
+	const FCborTestNumber Numbers[] = {
+		{ "00", 0.0 },
+		{ "17", 23.0 },
+		{ "1818", 24.0 },
+		{ "1903e8", 1000.0 },
+		{ "1a000f4240", 1000000.0 },
+		{ "1b000000e8d4a51000", 1000000000000.0 },
+		{ "1bffffffffffffffff", 18446744073709551615.0 },
+		{ "20", -1.0 },
+		{ "3863", -100.0 },
+		{ "3903e7", -1000.0 },
+		{ "f90000", 0.0 },
+		{ "f98000", -0.0 },
+		{ "f93c00", 1.0 },
+		{ "f93e00", 1.5 },
+		{ "f97bff", 65504.0 },
+		{ "f90001", 5.960464477539063e-8 },
+		{ "f90400", 0.00006103515625 },
+		{ "f9c400", -4.0 },
+		{ "f97c00", INFINITY },
+		{ "f9fc00", -INFINITY },
+		{ "f97e00", NAN },
+		{ "fa47c35000", 100000.0 },
+		{ "fa7f7fffff", 3.4028234663852886e+38 },
+		{ "fb3ff199999999999a", 1.1 },
+		{ "fb7e37e43c8800759c", 1.0e+300 },
+		{ "fbc010666666666666", -4.1 },
+	};
+	for (const FCborTestNumber& Number : Numbers)
+	{
+		const TArray<uint8> Bytes = GetCborTestBytes(Number.Hex);
+		const double Value = GetCborTestView(Bytes).AsNumber(-12345.0);
+		if (!IsSameCborTestNumber(Value, Number.Value))
+		{
+			AddError(FString::Printf(TEXT("CBOR %s is read as %g instead of %g."), *FString(Number.Hex), Value, Number.Value));
+		}
+	}
+
+	// Not numbers, or cut off.
+	for (const ANSICHAR* Hex : { "f4", "f5", "f6", "6161", "80", "a0", "19", "1903", "fa47c350", "fb3ff1" })
+	{
+		const TArray<uint8> Bytes = GetCborTestBytes(Hex);
+		TestTrue(FString::Printf(TEXT("CBOR %s is no number"), *FString(Hex)), GetCborTestView(Bytes).AsNumber(-12345.0) == -12345.0);
+	}
+	const TArray<uint8> False = GetCborTestBytes("f4");
+	const TArray<uint8> True = GetCborTestBytes("f5");
+	TestTrue(TEXT("Bools"), !GetCborTestView(False).AsBool(true) && GetCborTestView(True).AsBool(false));
+
+	// {"a": 1, "b": [2, 3], "c": {"a": "x"}, "d": h'0102', "op": "publish"}
+	const TArray<uint8> Map = GetCborTestBytes("a561610161628202036163a161616178616442010262""6f70677075626c697368");
+	const FROSBridgeCborView MapView = GetCborTestView(Map);
+	TestTrue(TEXT("Field a"), MapView.GetField("a").AsNumber() == 1.0);
+	TestTrue(TEXT("Text field"), MapView.GetField("op").GetString().Equals("publish"));
+	TestTrue(TEXT("Field of the nested map"), MapView.GetField("c").GetField("a").GetString().Equals("x"));
+	TestFalse(TEXT("Missing field"), MapView.GetField("x").IsValid());
+	TestFalse(TEXT("Value is no key"), MapView.GetField("publish").IsValid());
+	TArray<FROSBridgeCborView> Elements;
+	TestTrue(TEXT("Array field"), MapView.GetField("b").GetElements(Elements) && Elements.Num() == 2 && Elements[0].AsNumber() == 2.0 && Elements[1].AsNumber() == 3.0);
+	TestFalse(TEXT("Map is no array"), MapView.GetElements(Elements));
+	const uint8* Data = nullptr;
+	int32 Length = 0;
+	TestTrue(TEXT("Byte string"), MapView.GetField("d").GetBytes(Data, Length) && Length == 2 && Data[0] == 1 && Data[1] == 2);
+	TestFalse(TEXT("Text is no byte string"), MapView.GetField("op").GetBytes(Data, Length));
+
+	// The same map cut off anywhere does not read past the end.
+	for (int32 Size = 1; Size < Map.Num(); ++Size)
+	{
+		const FROSBridgeCborView Cut(Map.GetData(), Map.GetData() + Size);
+		if (Cut.GetField("op").IsValid())
+		{
+			AddError(FString::Printf(TEXT("Map cut after %d bytes has the last field."), Size));
+		}
+	}
+
+	// Indefinite lengths are not sent by rosbridge and not read.
+	for (const ANSICHAR* Hex : { "9f01ff", "bf616101ff", "5f420102ff", "7f6161ff" })
+	{
+		const TArray<uint8> Bytes = GetCborTestBytes(Hex);
+		const FROSBridgeCborView View = GetCborTestView(Bytes);
+		TestTrue(FString::Printf(TEXT("Indefinite CBOR %s"), *FString(Hex)), !View.GetElements(Elements) && !View.GetField("a").IsValid() && !View.GetBytes(Data, Length) && !View.ToJsonValue().IsValid());
+	}
+
+	// Typed arrays: the raw bytes, and the numbers when converted to json.
+	struct FCborTestTypedArray
+	{
+		const ANSICHAR* Hex;
+		int32 NumBytes;
+		TArray<double> Values;
+	};
+	const FCborTestTypedArray TypedArrays[] = {
+		{ "d84043""0102ff", 3, { 1.0, 2.0, 255.0 } },
+		{ "d84842""ff80", 2, { -1.0, -128.0 } },
+		{ "d84544""feff0100", 4, { 65534.0, 1.0 } },
+		{ "d84944""fffe0100", 4, { -2.0, 256.0 } },
+		{ "d84b48""fffffffffffffffe", 8, { -2.0 } },
+		{ "d85446""003c00c4ff7b", 6, { 1.0, -4.0, 65504.0 } },
+		{ "d8554c""0000803f000020c000005040", 12, { 1.0, -2.5, 3.25 } },
+		{ "d85248""3ff199999999999a", 8, { 1.1 } },
+	};
+	for (const FCborTestTypedArray& TypedArray : TypedArrays)
+	{
+		const TArray<uint8> Bytes = GetCborTestBytes(TypedArray.Hex);
+		const FROSBridgeCborView View = GetCborTestView(Bytes);
+		const FString What = FString::Printf(TEXT("Typed array %s"), *FString(TypedArray.Hex));
+
+		TArray<uint8> Copy;
+		TestTrue(What + TEXT(": raw bytes"), View.GetBytes(Data, Length) && Length == TypedArray.NumBytes && View.GetBytes(Copy) && Copy.Num() == Length && Data == Bytes.GetData() + 3);
+
+		const TSharedPtr<FJsonValue> Json = View.ToJsonValue();
+		if (!TestTrue(What + TEXT(": json array"), Json.IsValid() && Json->Type == EJson::Array && Json->AsArray().Num() == TypedArray.Values.Num()))
+		{
+			continue;
+		}
+		for (int32 i = 0; i < TypedArray.Values.Num(); ++i)
+		{
+			const double Value = Json->AsArray()[i]->AsNumber();
+			if (!IsSameCborTestNumber(Value, TypedArray.Values[i]))
+			{
+				AddError(FString::Printf(TEXT("%s: element %d is %g instead of %g."), *What, i, Value, TypedArray.Values[i]));
+			}
+		}
+	}
+
+	// Other tags are no typed arrays, elements larger than 8 bytes are not converted.
+	const TArray<uint8> OtherTag = GetCborTestBytes("d8594100");
+	TestFalse(TEXT("Other tag has no bytes"), GetCborTestView(OtherTag).GetBytes(Data, Length));
+	const TArray<uint8> Float128 = GetCborTestBytes("d85750""00000000000000000000000000000000");
+	TestTrue(TEXT("128 bit floats"), GetCborTestView(Float128).GetBytes(Data, Length) && Length == 16 && !GetCborTestView(Float128).ToJsonValue().IsValid());
+	return true;
+}
+
+// Append the head of a CBOR item, with the shortest argument
+static void AppendCborHead(TArray<uint8>& Out, const uint8 Major, const uint64 Argument)
+{
+	if (Argument < 24)
+	{
+		Out.Add((Major << 5) | (uint8)Argument);
+		return;
+	}
+	const int32 Size = Argument <= 0xff ? 1 : Argument <= 0xffff ? 2 : Argument <= 0xffffffff ? 4 : 8;
+	Out.Add((Major << 5) | (uint8)(24 + FMath::FloorLog2(Size)));
+	for (int32 i = Size - 1; i >= 0; --i)
+	{
+		Out.Add((uint8)(Argument >> (8 * i)));
+	}
+}
+
+// Append a text string as CBOR
+static void AppendCborText(TArray<uint8>& Out, const ANSICHAR* Text)
+{
+	const int32 Length = FCStringAnsi::Strlen(Text);
+	AppendCborHead(Out, 3, Length);
+	Out.Append((const uint8*)Text, Length);
+}
+
+// Append a number as CBOR: integers as they are, other values as double like the encoder of rosbridge
+static void AppendCborNumber(TArray<uint8>& Out, const double Value)
+{
+	if (Value == FMath::FloorToDouble(Value) && FMath::Abs(Value) < 4294967296.0)
+	{
+		AppendCborHead(Out, Value < 0.0 ? 1 : 0, Value < 0.0 ? (uint64)(-1.0 - Value) : (uint64)Value);
+		return;
+	}
+	uint64 Bits;
+	FMemory::Memcpy(&Bits, &Value, sizeof(double));
+	Out.Add(0xfb);
+	for (int32 i = 7; i >= 0; --i)
+	{
+		Out.Add((uint8)(Bits >> (8 * i)));
+	}
+}
+
+// Append text to a json message
+static void AppendJsonText(TArray<uint8>& Out, const FString& Text)
+{
+	FTCHARToUTF8 Converter(*Text);
+	Out.Append((const uint8*)Converter.Get(), Converter.Length());
+}
+
+// Append a number to a json message, with all digits like the json of rosbridge
+static void AppendJsonNumber(TArray<uint8>& Out, const double Value)
+{
+	AppendJsonText(Out, Value == FMath::FloorToDouble(Value) && FMath::Abs(Value) < 4294967296.0 ? FString::Printf(TEXT("%lld"), (int64)Value) : FString::Printf(TEXT("%.17g"), Value));
+}
+
+// Start of a publish operation in both formats, the msg field follows
+static void AppendCborBenchmarkPublish(TArray<uint8>& Json, TArray<uint8>& Cbor, const ANSICHAR* Topic)
+{
+	AppendJsonText(Json, FString::Printf(TEXT("{\"op\": \"publish\", \"topic\": \"%s\", \"msg\": "), *FString(Topic)));
+	AppendCborHead(Cbor, 5, 3);
+	AppendCborText(Cbor, "op");
+	AppendCborText(Cbor, "publish");
+	AppendCborText(Cbor, "topic");
+	AppendCborText(Cbor, Topic);
+	AppendCborText(Cbor, "msg");
+}
+
+// Header of a message in both formats
+static void AppendCborBenchmarkHeader(TArray<uint8>& Json, TArray<uint8>& Cbor)
+{
+	AppendJsonText(Json, TEXT("\"header\": {\"seq\": 4711, \"stamp\": {\"secs\": 1556012345, \"nsecs\": 123456789}, \"frame_id\": \"base_link\"}"));
+	AppendCborText(Cbor, "header");
+	AppendCborHead(Cbor, 5, 3);
+	AppendCborText(Cbor, "seq");
+	AppendCborNumber(Cbor, 4711);
+	AppendCborText(Cbor, "stamp");
+	AppendCborHead(Cbor, 5, 2);
+	AppendCborText(Cbor, "secs");
+	AppendCborNumber(Cbor, 1556012345);
+	AppendCborText(Cbor, "nsecs");
+	AppendCborNumber(Cbor, 123456789);
+	AppendCborText(Cbor, "frame_id");
+	AppendCborText(Cbor, "base_link");
+}
+
+// What the handler reads of a message before the typed parser gets the msg, and the header the parser reads first
+template <class ViewType>
+static double ReadCborBenchmarkOperation(const ViewType& Message, ViewType& OutMsg, uint32& OutTopicHash)
+{
+	OutTopicHash = Message.GetField("topic").GetString().GetHash();
+	OutMsg = Message.GetField("msg");
+	const ViewType Header = OutMsg.GetField("header");
+	return Message.GetField("op").GetString().Len() + Header.GetField("seq").AsNumber() + Header.GetField("stamp").GetField("nsecs").AsNumber();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSBridgeCborJsonBenchmark, "UROSBridge.Benchmark.CborJson", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Bytes and read time of rosbridge messages as json and as CBOR: a TwistStamped, float32[] scans and images.
+// The time is what the handler and the typed parsers do with the views (the FJsonObject path is not measured).
+bool FROSBridgeCborJsonBenchmark::RunTest(const FString& Parameters)
+{
+	double Checksum = 0.0;
+	uint32 TopicHash = 0;
+
+	// Runs Read on the message as long as needed for about CBOR_BENCHMARK_BYTES, returns the microseconds per message
+	auto Measure = [&Checksum](const TArray<uint8>& Message, TFunctionRef<double(const TArray<uint8>&)> Read)
+	{
+		const int32 NumMessages = FMath::Max(CBOR_BENCHMARK_BYTES / FMath::Max(Message.Num(), 1), CBOR_BENCHMARK_MIN_MESSAGES);
+		const double Start = FPlatformTime::Seconds();
+		for (int32 i = 0; i < NumMessages; ++i)
+		{
+			Checksum += Read(Message);
+		}
+		return (FPlatformTime::Seconds() - Start) / NumMessages * 1e6;
+	};
+
+	auto Report = [this](const FString& What, const TArray<uint8>& Json, const TArray<uint8>& Cbor, const double JsonMicroseconds, const double CborMicroseconds)
+	{
+		AddInfo(FString::Printf(TEXT("%s: json %d bytes %.2f us, CBOR %d bytes (%.0f%%) %.2f us (%.1fx faster)."), *What,
+			Json.Num(), JsonMicroseconds, Cbor.Num(), 100.0 * Cbor.Num() / Json.Num(), CborMicroseconds, JsonMicroseconds / CborMicroseconds));
+	};
+
+	// geometry_msgs/TwistStamped, as the cmd_vel of the robots
+	{
+		TArray<uint8> Json, Cbor;
+		const double Twist[6] = { 0.5, -0.25, 0.0, 0.0, 0.0, 1.0471975511965976 };
+		AppendCborBenchmarkPublish(Json, Cbor, "/robot_1/cmd_vel");
+		AppendJsonText(Json, TEXT("{"));
+		AppendCborHead(Cbor, 5, 2);
+		AppendCborBenchmarkHeader(Json, Cbor);
+		AppendJsonText(Json, TEXT(", \"twist\": {"));
+		AppendCborText(Cbor, "twist");
+		AppendCborHead(Cbor, 5, 2);
+		for (int32 Part = 0; Part < 2; ++Part)
+		{
+			AppendJsonText(Json, Part == 0 ? TEXT("\"linear\": {") : TEXT(", \"angular\": {"));
+			AppendCborText(Cbor, Part == 0 ? "linear" : "angular");
+			AppendCborHead(Cbor, 5, 3);
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				const ANSICHAR* Names[3] = { "x", "y", "z" };
+				AppendJsonText(Json, FString::Printf(TEXT("%s\"%s\": "), Axis == 0 ? TEXT("") : TEXT(", "), *FString(Names[Axis])));
+				AppendJsonNumber(Json, Twist[Part * 3 + Axis]);
+				AppendCborText(Cbor, Names[Axis]);
+				AppendCborNumber(Cbor, Twist[Part * 3 + Axis]);
+			}
+			AppendJsonText(Json, TEXT("}"));
+		}
+		AppendJsonText(Json, TEXT("}}}"));
+
+		auto ReadTwist = [&TopicHash](const auto& Message)
+		{
+			auto Msg = Message;
+			const double Operation = ReadCborBenchmarkOperation(Message, Msg, TopicHash);
+			const auto TwistView = Msg.GetField("twist");
+			const auto Linear = TwistView.GetField("linear");
+			return Operation + Linear.GetField("x").AsNumber() + Linear.GetField("y").AsNumber() + TwistView.GetField("angular").GetField("z").AsNumber();
+		};
+		const double JsonMicroseconds = Measure(Json, [&ReadTwist](const TArray<uint8>& Bytes) { return ReadTwist(FROSBridgeJsonView((const ANSICHAR*)Bytes.GetData(), (const ANSICHAR*)Bytes.GetData() + Bytes.Num())); });
+		const double CborMicroseconds = Measure(Cbor, [&ReadTwist](const TArray<uint8>& Bytes) { return ReadTwist(FROSBridgeCborView(Bytes.GetData(), Bytes.GetData() + Bytes.Num())); });
+		Report(TEXT("TwistStamped"), Json, Cbor, JsonMicroseconds, CborMicroseconds);
+	}
+
+	// float32[] of a scan: numbers in json, a typed array (little endian float32) in CBOR
+	for (const int32 NumRanges : { 1081, 100000 })
+	{
+		TArray<float> Ranges;
+		for (int32 i = 0; i < NumRanges; ++i)
+		{
+			Ranges.Add(0.2f + 29.8f * FMath::Abs(FMath::Sin(i * 0.01f)));
+		}
+
+		TArray<uint8> Json, Cbor;
+		AppendCborBenchmarkPublish(Json, Cbor, "/scan");
+		AppendJsonText(Json, TEXT("{"));
+		AppendCborHead(Cbor, 5, 2);
+		AppendCborBenchmarkHeader(Json, Cbor);
+		AppendJsonText(Json, TEXT(", \"ranges\": ["));
+		AppendCborText(Cbor, "ranges");
+		AppendCborHead(Cbor, 6, 85);
+		AppendCborHead(Cbor, 2, NumRanges * sizeof(float));
+		Cbor.Append((const uint8*)Ranges.GetData(), NumRanges * sizeof(float));
+		for (int32 i = 0; i < NumRanges; ++i)
+		{
+			if (i > 0)
+			{
+				AppendJsonText(Json, TEXT(", "));
+			}
+			AppendJsonNumber(Json, Ranges[i]);
+		}
+		AppendJsonText(Json, TEXT("]}}"));
+
+		TArray<float> Read;
+		const double JsonMicroseconds = Measure(Json, [&](const TArray<uint8>& Bytes)
+		{
+			const FROSBridgeJsonView Message((const ANSICHAR*)Bytes.GetData(), (const ANSICHAR*)Bytes.GetData() + Bytes.Num());
+			FROSBridgeJsonView Msg;
+			const double Operation = ReadCborBenchmarkOperation(Message, Msg, TopicHash);
+			TArray<FROSBridgeJsonView> Elements;
+			Msg.GetField("ranges").GetElements(Elements);
+			Read.SetNumUninitialized(Elements.Num(), false);
+			for (int32 i = 0; i < Elements.Num(); ++i)
+			{
+				Read[i] = (float)Elements[i].AsNumber();
+			}
+			return Operation + Read.Last();
+		});
+		TestTrue(TEXT("Scan from json"), Read == Ranges);
+		const double CborMicroseconds = Measure(Cbor, [&](const TArray<uint8>& Bytes)
+		{
+			const FROSBridgeCborView Message(Bytes.GetData(), Bytes.GetData() + Bytes.Num());
+			const uint8* Data;
+			int32 Length;
+			FROSBridgeCborView Msg;
+			const double Operation = ReadCborBenchmarkOperation(Message, Msg, TopicHash);
+			Msg.GetField("ranges").GetBytes(Data, Length);
+			Read.SetNumUninitialized(Length / sizeof(float), false);
+			FMemory::Memcpy(Read.GetData(), Data, Length);
+			return Operation + Read.Last();
+		});
+		TestTrue(TEXT("Scan from CBOR"), Read == Ranges);
+		Report(FString::Printf(TEXT("float32[%d]"), NumRanges), Json, Cbor, JsonMicroseconds, CborMicroseconds);
+	}
+
+	// sensor_msgs/Image: uint8[] as Base64 in json, a byte string in CBOR
+	for (const int32 Width : { 640, 1920 })
+	{
+		const int32 Height = Width * 9 / 16;
+		TArray<uint8> Pixels;
+		Pixels.SetNumUninitialized(Width * Height * 3);
+		uint32 Random = 12345;
+		for (uint8& Pixel : Pixels)
+		{
+			Random = Random * 1664525 + 1013904223;
+			Pixel = (uint8)(Random >> 24);
+		}
+
+		TArray<uint8> Json, Cbor;
+		AppendCborBenchmarkPublish(Json, Cbor, "/camera/image_raw");
+		AppendJsonText(Json, TEXT("{"));
+		AppendCborHead(Cbor, 5, 7);
+		AppendCborBenchmarkHeader(Json, Cbor);
+		AppendJsonText(Json, FString::Printf(TEXT(", \"height\": %d, \"width\": %d, \"encoding\": \"rgb8\", \"is_bigendian\": 0, \"step\": %d, \"data\": \""), Height, Width, Width * 3));
+		for (const ANSICHAR* Field : { "height", "width", "encoding", "is_bigendian", "step" })
+		{
+			AppendCborText(Cbor, Field);
+			if (FCStringAnsi::Strlen(Field) == 8)
+			{
+				AppendCborText(Cbor, "rgb8");
+			}
+			else
+			{
+				AppendCborNumber(Cbor, Field[0] == 'h' ? Height : Field[0] == 'w' ? Width : Field[0] == 's' ? Width * 3 : 0);
+			}
+		}
+		FString Encoded;
+		FROSBridgeBase64::Encode(Pixels.GetData(), Pixels.Num(), Encoded);
+		AppendJsonText(Json, Encoded);
+		AppendJsonText(Json, TEXT("\"}}"));
+		AppendCborText(Cbor, "data");
+		AppendCborHead(Cbor, 2, Pixels.Num());
+		Cbor.Append(Pixels);
+
+		// As Image::FromJsonView and Image::FromCbor, the data array is kept from message to message.
+		TArray<uint8> Data;
+		const double JsonMicroseconds = Measure(Json, [&](const TArray<uint8>& Bytes)
+		{
+			const FROSBridgeJsonView Message((const ANSICHAR*)Bytes.GetData(), (const ANSICHAR*)Bytes.GetData() + Bytes.Num());
+			FROSBridgeJsonView Msg;
+			const double Operation = ReadCborBenchmarkOperation(Message, Msg, TopicHash);
+			const FROSBridgeJsonView DataView = Msg.GetField("data").GetString();
+			FROSBridgeBase64::Decode(DataView.GetData(), DataView.Len(), Data);
+			return Operation + Msg.GetField("width").AsNumber() + Msg.GetField("step").AsNumber() + Msg.GetField("encoding").GetString().Len() + Data.Last();
+		});
+		TestTrue(TEXT("Image from json"), Data == Pixels);
+		const double CborMicroseconds = Measure(Cbor, [&](const TArray<uint8>& Bytes)
+		{
+			const FROSBridgeCborView Message(Bytes.GetData(), Bytes.GetData() + Bytes.Num());
+			FROSBridgeCborView Msg;
+			const double Operation = ReadCborBenchmarkOperation(Message, Msg, TopicHash);
+			Msg.GetField("data").GetBytes(Data);
+			return Operation + Msg.GetField("width").AsNumber() + Msg.GetField("step").AsNumber() + Msg.GetField("encoding").GetString().Len() + Data.Last();
+		});
+		TestTrue(TEXT("Image from CBOR"), Data == Pixels);
+		Report(FString::Printf(TEXT("Image %dx%d rgb8"), Width, Height), Json, Cbor, JsonMicroseconds, CborMicroseconds);
+	}
+
+	AddInfo(FString::Printf(TEXT("Checksum %f, topic hash %08x."), Checksum, TopicHash));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
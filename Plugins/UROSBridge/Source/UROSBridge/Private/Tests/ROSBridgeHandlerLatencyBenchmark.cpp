@@ -0,0 +1,246 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "ROSBridgeHandler.h"
+#include "ROSBridgePublisher.h"
+#include "ROSBridgeSubscriber.h"
+#include "ROSBridgeJsonView.h"
+#include "std_msgs/String.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !PLATFORM_HTML5
+
+// Work around a conflict between a UI namespace defined by engine code and a typedef in OpenSSL
+#define UI UI_ST
+THIRD_PARTY_INCLUDES_START
+#include "libwebsockets.h"
+THIRD_PARTY_INCLUDES_END
+#undef UI
+
+#define LATENCY_BENCHMARK_PORT (9190)
+#define LATENCY_BENCHMARK_WARMUP (50)
+#define LATENCY_BENCHMARK_ROUNDS (1000)
+#define LATENCY_BENCHMARK_TIMEOUT (2.0)
+
+// Same length, so the server can send the frame back with the topic changed in place
+static const ANSICHAR* LatencyBenchmarkPingTopic = "/latency_ping";
+static const ANSICHAR* LatencyBenchmarkPongTopic = "/latency_pong";
+
+static int ros_latency_benchmark_server(struct lws* Wsi, enum lws_callback_reasons Reason, void* User, void* In, size_t Len);
+
+// Stand-in for rosbridge on localhost: every publish on the ping topic is sent back as a publish on the pong topic
+class FROSBridgeLatencyServer : public FRunnable
+{
+public:
+	FROSBridgeLatencyServer() : Context(nullptr), Thread(nullptr), bStop(false)
+	{
+		FMemory::Memzero(Protocols, sizeof(Protocols));
+	}
+
+	~FROSBridgeLatencyServer()
+	{
+		if (Thread)
+		{
+			Thread->Kill(true);
+			delete Thread;
+		}
+		if (Context)
+		{
+			lws_context_destroy(Context);
+		}
+	}
+
+	// Listen on the port and start the thread of the server
+	bool Start(const int32 Port)
+	{
+		Protocols[0].name = "binary";
+		Protocols[0].callback = ros_latency_benchmark_server;
+		Protocols[0].rx_buffer_size = 64 * 1024;
+
+		struct lws_context_creation_info Info;
+		FMemory::Memzero(&Info, sizeof(Info));
+		Info.port = Port;
+		Info.protocols = Protocols;
+		Info.gid = -1;
+		Info.uid = -1;
+		Info.user = this;
+		Context = lws_create_context(&Info);
+		if (!Context)
+		{
+			return false;
+		}
+		Thread = FRunnableThread::Create(this, TEXT("ROSBridgeLatencyServer"), 0, TPri_Normal);
+		return Thread != nullptr;
+	}
+
+	// Wait for the socket like the handler does, woken by Stop
+	virtual uint32 Run() override
+	{
+		while (!bStop.Load())
+		{
+			lws_service(Context, 100);
+		}
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStop.Store(true);
+		lws_cancel_service(Context);
+	}
+
+	// Keep a pong for every ping, advertise and subscribe operations are not answered
+	void OnReceive(struct lws* Wsi, const ANSICHAR* Data, const int32 Length)
+	{
+		const FROSBridgeJsonView Message(Data, Data + Length);
+		const FROSBridgeJsonView Topic = Message.GetField("topic").GetString();
+		if (!Message.GetField("op").GetString().Equals("publish") || !Topic.Equals(LatencyBenchmarkPingTopic))
+		{
+			return;
+		}
+
+		TArray<uint8>& Frame = Pending[Pending.AddDefaulted()];
+		Frame.SetNumUninitialized(LWS_PRE + Length);
+		FMemory::Memcpy(Frame.GetData() + LWS_PRE, Data, Length);
+		FMemory::Memcpy(Frame.GetData() + LWS_PRE + (Topic.GetData() - Data), LatencyBenchmarkPongTopic, Topic.Len());
+		lws_callback_on_writable(Wsi);
+	}
+
+	// Send the pongs
+	void OnWritable(struct lws* Wsi)
+	{
+		for (TArray<uint8>& Frame : Pending)
+		{
+			lws_write(Wsi, Frame.GetData() + LWS_PRE, Frame.Num() - LWS_PRE, LWS_WRITE_TEXT);
+		}
+		Pending.Reset();
+	}
+
+private:
+	struct lws_context* Context;
+	struct lws_protocols Protocols[2];
+	FRunnableThread* Thread;
+	TAtomic<bool> bStop;
+
+	// Frames to send back, with the headroom of libwebsockets in front. Only used by the thread of the server.
+	TArray<TArray<uint8>> Pending;
+};
+
+static int ros_latency_benchmark_server(struct lws* Wsi, enum lws_callback_reasons Reason, void* User, void* In, size_t Len)
+{
+	FROSBridgeLatencyServer* Server = (FROSBridgeLatencyServer*)lws_context_user(lws_get_context(Wsi));
+	switch (Reason)
+	{
+	case LWS_CALLBACK_RECEIVE:
+		Server->OnReceive(Wsi, (const ANSICHAR*)In, (int32)Len);
+		break;
+	case LWS_CALLBACK_SERVER_WRITEABLE:
+		Server->OnWritable(Wsi);
+		break;
+	default:
+		break;
+	}
+	return 0;
+}
+
+// Notes the time a pong is handed to the game thread by Process
+class FROSBridgeLatencySubscriber : public FROSBridgeSubscriber
+{
+public:
+	FROSBridgeLatencySubscriber() : FROSBridgeSubscriber(LatencyBenchmarkPongTopic, TEXT("std_msgs/String")), LastRound(-1), LastReceived(0.0)
+	{
+	}
+
+	virtual TSharedPtr<FROSBridgeMsg> ParseMessage(TSharedPtr<FJsonObject> JsonObject) const override
+	{
+		TSharedPtr<std_msgs::String> Message = MakeShareable(new std_msgs::String());
+		Message->FromJson(JsonObject);
+		return Message;
+	}
+
+	virtual void Callback(TSharedPtr<FROSBridgeMsg> Msg) override
+	{
+		LastRound = FCString::Atoi(*StaticCastSharedPtr<std_msgs::String>(Msg)->GetData());
+		LastReceived = FPlatformTime::Seconds();
+	}
+
+	int32 LastRound;
+	double LastReceived;
+};
+
+// Time of a round trip in ms, -1 if the pong did not come back
+static double MeasureLatencyRound(FROSBridgeHandler& Handler, FROSBridgeLatencySubscriber& Subscriber, const int32 Round)
+{
+	const double Sent = FPlatformTime::Seconds();
+	Handler.PublishMsg(LatencyBenchmarkPingTopic, MakeShareable(new std_msgs::String(FString::FromInt(Round))));
+	while (Subscriber.LastRound != Round)
+	{
+		if (FPlatformTime::Seconds() - Sent > LATENCY_BENCHMARK_TIMEOUT)
+		{
+			return -1.0;
+		}
+		Handler.Process();
+	}
+	return (Subscriber.LastReceived - Sent) * 1e3;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSBridgeHandlerLatencyBenchmark, "UROSBridge.Benchmark.HandlerLatency", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Round trip of a std_msgs/String through the handler and a stand-in rosbridge on localhost: published on the game thread,
+// sent by the bridge thread, echoed by the server, received by the bridge thread and handed to the subscriber in Process.
+// Reports the p50 and p99 of the round trips.
+bool FROSBridgeHandlerLatencyBenchmark::RunTest(const FString& Parameters)
+{
+	FROSBridgeLatencyServer Server;
+	if (!TestTrue(TEXT("Stand-in server listens"), Server.Start(LATENCY_BENCHMARK_PORT)))
+	{
+		return false;
+	}
+
+	TSharedPtr<FROSBridgeLatencySubscriber> Subscriber = MakeShareable(new FROSBridgeLatencySubscriber());
+	FROSBridgeHandler Handler(TEXT("127.0.0.1"), LATENCY_BENCHMARK_PORT);
+	Handler.AddSubscriber(Subscriber);
+	Handler.AddPublisher(MakeShareable(new FROSBridgePublisher(LatencyBenchmarkPingTopic, TEXT("std_msgs/String"))));
+	Handler.Connect();
+
+	const double ConnectStart = FPlatformTime::Seconds();
+	while (!Handler.IsConnected() && FPlatformTime::Seconds() - ConnectStart < LATENCY_BENCHMARK_TIMEOUT)
+	{
+		FPlatformProcess::Sleep(0.01f);
+	}
+	if (!TestTrue(TEXT("Handler connected"), Handler.IsConnected()))
+	{
+		Handler.Disconnect();
+		return false;
+	}
+
+	// The first rounds connect the sockets and fill the caches.
+	TArray<double> RoundTrips;
+	for (int32 Round = 0; Round < LATENCY_BENCHMARK_WARMUP + LATENCY_BENCHMARK_ROUNDS; ++Round)
+	{
+		const double RoundTrip = MeasureLatencyRound(Handler, *Subscriber, Round);
+		if (RoundTrip < 0.0)
+		{
+			AddError(FString::Printf(TEXT("No pong for round %d."), Round));
+			break;
+		}
+		if (Round >= LATENCY_BENCHMARK_WARMUP)
+		{
+			RoundTrips.Add(RoundTrip);
+		}
+	}
+	Handler.Disconnect();
+
+	if (RoundTrips.Num() == LATENCY_BENCHMARK_ROUNDS)
+	{
+		RoundTrips.Sort();
+		AddInfo(FString::Printf(TEXT("%d round trips through the handler and a local stand-in rosbridge: p50 %.3f ms, p99 %.3f ms, max %.3f ms."),
+			RoundTrips.Num(), RoundTrips[RoundTrips.Num() / 2], RoundTrips[RoundTrips.Num() * 99 / 100], RoundTrips.Last()));
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && !PLATFORM_HTML5
@@ -0,0 +1,174 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTLS.h"
+#include "ROSBridgeMsg.h"
+#include "ROSWebSocketRing.h"
+#include "sensor_msgs/JointState.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define JOINT_STATE_PUBLISH_TEST_ROBOTS (4)
+#define JOINT_STATE_PUBLISH_TEST_WHEELS (4)
+#define JOINT_STATE_PUBLISH_TEST_CYCLES (1000)
+// Capacity of the ring of FROSWebSocket, headroom as LWS_PRE of libwebsockets
+#define JOINT_STATE_PUBLISH_TEST_CAPACITY (8 * 1024 * 1024)
+#define JOINT_STATE_PUBLISH_TEST_HEADROOM (16)
+
+/**
+ * Passes everything on to the allocator of the engine and counts the allocations of one thread.
+ * Static, so a call of another thread that still runs through it after the test never finds it gone.
+ */
+class FJointStatePublishAllocationCounter : public FMalloc
+{
+public:
+	// Count the allocations of the calling thread from now on
+	void Start()
+	{
+		Inner = GMalloc;
+		ThreadId = FPlatformTLS::GetCurrentThreadId();
+		NumAllocations = 0;
+		GMalloc = this;
+	}
+
+	// Put the allocator of the engine back, returns the allocations since Start
+	int32 Stop()
+	{
+		GMalloc = Inner;
+		return NumAllocations;
+	}
+
+	virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+	{
+		Note();
+		return Inner->Malloc(Count, Alignment);
+	}
+
+	virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+	{
+		Note();
+		return Inner->Realloc(Original, Count, Alignment);
+	}
+
+	virtual void Free(void* Original) override
+	{
+		Inner->Free(Original);
+	}
+
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+	{
+		return Inner->QuantizeSize(Count, Alignment);
+	}
+
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+	{
+		return Inner->GetAllocationSize(Original, SizeOut);
+	}
+
+	virtual bool IsInternallyThreadSafe() const override
+	{
+		return Inner->IsInternallyThreadSafe();
+	}
+
+	virtual bool ValidateHeap() override
+	{
+		return Inner->ValidateHeap();
+	}
+
+	virtual const TCHAR* GetDescriptiveName() override
+	{
+		return Inner->GetDescriptiveName();
+	}
+
+private:
+	void Note()
+	{
+		if (FPlatformTLS::GetCurrentThreadId() == ThreadId)
+		{
+			++NumAllocations;
+		}
+	}
+
+	FMalloc* Inner = nullptr;
+	uint32 ThreadId = 0;
+	int32 NumAllocations = 0;
+};
+
+// One publish cycle of AROSMWControllerJointStatePublisher: the values of every message are written in place, the json
+// goes into the reused buffer and from there straight into the ring as UTF-8, as FROSWebSocket::Send does.
+// The websocket thread is played by popping the frame right away. Returns the bytes of the last frame.
+static int32 PublishJointStateTestCycle(TArray<sensor_msgs::JointState>& Messages, const TArray<FString>& Topics, FString& Buffer,
+	FROSWebSocketRing& Ring, const uint32 Seq, const FROSTime& Stamp, const double Value)
+{
+	int32 Length = 0;
+	for (int32 Robot = 0; Robot < Messages.Num(); ++Robot)
+	{
+		sensor_msgs::JointState& Message = Messages[Robot];
+		Message.GetHeaderRef().SetSeq(Seq);
+		Message.GetHeaderRef().SetStamp(Stamp);
+		for (int32 Wheel = 0; Wheel < JOINT_STATE_PUBLISH_TEST_WHEELS; ++Wheel)
+		{
+			Message.Positions[Wheel] = Value * (Robot + 1);
+			Message.Velocities[Wheel] = -Value * (Wheel + 1);
+		}
+
+		FROSBridgeMsg::WritePublish(Topics[Robot], Message, Buffer);
+
+		Length = FTCHARToUTF8_Convert::ConvertedLength(*Buffer, Buffer.Len());
+		uint64 Position;
+		uint8* Frame = Ring.BeginWrite(Length, 0, Position);
+		if (!Frame)
+		{
+			return -1;
+		}
+		FTCHARToUTF8_Convert::Convert((ANSICHAR*)Frame, Length, *Buffer, Buffer.Len());
+		Ring.EndWrite(Position);
+
+		uint32 Size, Type;
+		Ring.Peek(Size, Type);
+		Ring.Pop();
+	}
+	return Length;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSBridgeJointStatePublishTest, "UROSBridge.JointState.PublishWithoutAllocation", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// After a warm-up cycle with the longest values, publishing the wheel joint states of several robots allocates nothing.
+bool FROSBridgeJointStatePublishTest::RunTest(const FString& Parameters)
+{
+	TArray<FString> WheelNames = { TEXT("wheel_left_front_joint"), TEXT("wheel_right_front_joint"), TEXT("wheel_left_rear_joint"), TEXT("wheel_right_rear_joint") };
+	TArray<sensor_msgs::JointState> Messages;
+	TArray<FString> Topics;
+	Messages.SetNum(JOINT_STATE_PUBLISH_TEST_ROBOTS);
+	for (int32 Robot = 0; Robot < JOINT_STATE_PUBLISH_TEST_ROBOTS; ++Robot)
+	{
+		Topics.Add(FString::Printf(TEXT("/MWRobotBaseActor_%d/joint_states"), Robot));
+		Messages[Robot].Names = WheelNames;
+		Messages[Robot].Positions.SetNumZeroed(JOINT_STATE_PUBLISH_TEST_WHEELS);
+		Messages[Robot].Velocities.SetNumZeroed(JOINT_STATE_PUBLISH_TEST_WHEELS);
+	}
+	FString Buffer;
+	FROSWebSocketRing Ring(JOINT_STATE_PUBLISH_TEST_CAPACITY, JOINT_STATE_PUBLISH_TEST_HEADROOM);
+
+	// The longest numbers the cycles write, so the buffer has its final size.
+	const int32 WarmUpLength = PublishJointStateTestCycle(Messages, Topics, Buffer, Ring, MAX_uint32, FROSTime(MAX_uint32, 999999999), -1.2345678901234567e-100);
+	TestTrue(TEXT("Frame is a publish operation"), Buffer.StartsWith(TEXT("{\"op\": \"publish\", \"topic\": \"/MWRobotBaseActor_")));
+
+	static FJointStatePublishAllocationCounter Counter;
+	Counter.Start();
+	int32 MaxLength = 0;
+	for (int32 Cycle = 0; Cycle < JOINT_STATE_PUBLISH_TEST_CYCLES; ++Cycle)
+	{
+		const FROSTime Stamp(Cycle / 50, (Cycle % 50) * 20000000);
+		MaxLength = FMath::Max(MaxLength, PublishJointStateTestCycle(Messages, Topics, Buffer, Ring, Cycle, Stamp, FMath::Sin(Cycle * 0.01f)));
+	}
+	const int32 NumAllocations = Counter.Stop();
+
+	TestTrue(TEXT("No frame is longer than the one of the warm-up"), MaxLength > 0 && MaxLength <= WarmUpLength);
+	TestEqual(FString::Printf(TEXT("Allocations in %d cycles of %d robots"), JOINT_STATE_PUBLISH_TEST_CYCLES, JOINT_STATE_PUBLISH_TEST_ROBOTS), NumAllocations, 0);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
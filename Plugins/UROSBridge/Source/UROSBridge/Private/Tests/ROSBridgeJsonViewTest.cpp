@@ -0,0 +1,103 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "ROSBridgeJsonView.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// View on a zero terminated test string
+static FROSBridgeJsonView MakeJsonTestView(const ANSICHAR* Json)
+{
+	return FROSBridgeJsonView(Json, Json + FCStringAnsi::Strlen(Json));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSBridgeJsonViewTest, "UROSBridge.JsonView", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Walks the fields and arrays of rosbridge like messages, with the whitespace, escapes and nesting that must be skipped,
+// and checks that broken json gives invalid views instead of reading past the end.
+bool FROSBridgeJsonViewTest::RunTest(const FString& Parameters)
+{
+	const FROSBridgeJsonView Message = MakeJsonTestView(
+		"{ \"op\" : \"publish\",\n"
+		"  \"topic\":\"/robot_1/cmd_vel\",\n"
+		"  \"id\": \"a \\\"quoted\\\" {key}: [1,2]\",\n"
+		"  \"msg\": {\"header\": {\"seq\": 7, \"stamp\": {\"secs\": 12, \"nsecs\": 500}, \"frame_id\": \"\"},\n"
+		"           \"twist\": {\"linear\": {\"x\": -1.5e-1, \"y\": 2, \"z\": 0.0}, \"angular\": {\"x\": 0, \"y\": 0, \"z\": 3.25}},\n"
+		"           \"list\": [ 1 , [2, {\"x\": \"]\"}], \"three\", true, null, { } ],\n"
+		"           \"empty\": [],\n"
+		"           \"flag\": false},\n"
+		"  \"x\": 99\n"
+		"}");
+
+	// Fields, whitespace around the colon and strings with escapes and brackets.
+	TestTrue(TEXT("Op"), Message.GetField("op").GetString().Equals("publish"));
+	TestTrue(TEXT("Topic"), Message.GetField("topic").GetString().Equals("/robot_1/cmd_vel"));
+	TestTrue(TEXT("String with escapes is kept as it is"), Message.GetField("id").GetString().Equals("a \\\"quoted\\\" {key}: [1,2]"));
+	TestFalse(TEXT("Missing field"), Message.GetField("service").IsValid());
+	TestFalse(TEXT("Key inside a string is no field"), Message.GetField("key").IsValid());
+
+	// Only the fields of this object are searched, not the ones of nested objects.
+	TestTrue(TEXT("Field after the nested objects"), Message.GetField("x").AsNumber() == 99.0);
+	const FROSBridgeJsonView Msg = Message.GetField("msg");
+	const FROSBridgeJsonView Twist = Msg.GetField("twist");
+	TestTrue(TEXT("Nested field x"), Twist.GetField("linear").GetField("x").AsNumber() == -0.15);
+	TestTrue(TEXT("Nested field y"), Twist.GetField("linear").GetField("y").AsNumber() == 2.0);
+	TestTrue(TEXT("Nested field z"), Twist.GetField("angular").GetField("z").AsNumber() == 3.25);
+	TestTrue(TEXT("Nested stamp"), Msg.GetField("header").GetField("stamp").GetField("nsecs").AsNumber() == 500.0);
+	TestFalse(TEXT("Empty string is an invalid view"), Msg.GetField("header").GetField("frame_id").GetString().IsValid());
+	TestTrue(TEXT("Bool"), !Msg.GetField("flag").AsBool(true));
+
+	// Hashes and comparisons of the same bytes in different frames are equal.
+	const FROSBridgeJsonView OtherTopic = MakeJsonTestView("/robot_1/cmd_vel");
+	TestTrue(TEXT("Topic equals the same bytes"), Message.GetField("topic").GetString().Equals(OtherTopic.GetData(), OtherTopic.Len()));
+	TestEqual(TEXT("Hash of the topic"), Message.GetField("topic").GetString().GetHash(), OtherTopic.GetHash());
+
+	// Arrays with nested arrays and objects, brackets inside strings.
+	TArray<FROSBridgeJsonView> Elements;
+	if (TestTrue(TEXT("List is an array"), Msg.GetField("list").GetElements(Elements)) && TestEqual(TEXT("Elements of the list"), Elements.Num(), 6))
+	{
+		TestTrue(TEXT("Number element"), Elements[0].AsNumber() == 1.0);
+		TArray<FROSBridgeJsonView> Nested;
+		TestTrue(TEXT("Nested array"), Elements[1].GetElements(Nested) && Nested.Num() == 2 && Nested[1].GetField("x").GetString().Equals("]"));
+		TestTrue(TEXT("String element"), Elements[2].GetString().Equals("three"));
+		TestTrue(TEXT("Bool element"), Elements[3].AsBool());
+		TestTrue(TEXT("Null element"), Elements[4].Equals("null") && Elements[4].AsNumber(-1.0) == -1.0);
+		TestTrue(TEXT("Empty object element"), Elements[5].Equals("{ }") && !Elements[5].GetField("x").IsValid());
+	}
+	TestTrue(TEXT("Empty array"), Msg.GetField("empty").GetElements(Elements) && Elements.Num() == 0);
+	TestFalse(TEXT("Object is no array"), Msg.GetElements(Elements));
+	TestFalse(TEXT("Array has no fields"), Msg.GetField("list").GetField("x").IsValid());
+
+	// Broken json ends the walk, nothing is read past the end.
+	const ANSICHAR* Broken[] = {
+		"{\"op\": \"publ",
+		"{\"op\" \"publish\"}",
+		"{\"msg\": {\"x\": 1, \"y\": [2}",
+		"{\"msg\": [1, 2",
+		"{\"op\": }",
+		"[1, 2",
+		"[1 2]",
+		"",
+	};
+	for (const ANSICHAR* Json : Broken)
+	{
+		const FROSBridgeJsonView View = MakeJsonTestView(Json);
+		const FString What = FString::Printf(TEXT("Broken json '%s'"), *FString(Json));
+		TestFalse(What + TEXT(" has no op"), View.GetField("op").IsValid());
+		TestFalse(What + TEXT(" has no msg"), View.GetField("msg").IsValid());
+		TestFalse(What + TEXT(" has no elements"), View.GetElements(Elements));
+	}
+
+	// Only the bytes up to the field are walked, the end of a cut message is not looked at.
+	TestTrue(TEXT("Field before the cut"), MakeJsonTestView("{\"op\": \"publish\", \"msg\": {\"x\": 1").GetField("op").GetString().Equals("publish"));
+
+	// Numbers are only read from number values.
+	TestTrue(TEXT("Negative number"), MakeJsonTestView("-12.5").AsNumber() == -12.5);
+	TestTrue(TEXT("Exponent"), MakeJsonTestView("1e3").AsNumber() == 1000.0);
+	TestTrue(TEXT("String is no number"), MakeJsonTestView("\"12\"").AsNumber(-1.0) == -1.0);
+	TestTrue(TEXT("Invalid view is no number"), FROSBridgeJsonView().AsNumber(-1.0) == -1.0);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,243 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "ROSWebSocketReceiveBuffer.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define RECEIVE_BUFFER_TEST_MESSAGES (200)
+// Size of the pieces lws hands over when a frame does not come in one callback
+#define RECEIVE_BUFFER_BENCHMARK_PIECE (64 * 1024)
+#define RECEIVE_BUFFER_BENCHMARK_BYTES (256 * 1024 * 1024)
+#define RECEIVE_BUFFER_BENCHMARK_MESSAGE (1024)
+
+// Byte of a test message, every byte tells its message and offset
+static uint8 GetReceiveTestByte(const uint32 Message, const uint32 Offset)
+{
+	return uint8(Message * 17 + Offset * 3);
+}
+
+// Stream of messages with their size in front, the sizes go from one byte to larger than most pieces
+static void GetReceiveTestStream(TArray<uint8>& OutStream)
+{
+	for (uint32 Message = 0; Message < RECEIVE_BUFFER_TEST_MESSAGES; ++Message)
+	{
+		const uint32 Size = 1 + (Message * 37) % 500;
+		OutStream.Append((const uint8*)&Size, sizeof(uint32));
+		for (uint32 Offset = 0; Offset < Size; ++Offset)
+		{
+			OutStream.Add(GetReceiveTestByte(Message, Offset));
+		}
+	}
+}
+
+// Checks a message passed by the receive buffer against the test message it should be
+static bool IsReceiveTestMessage(const void* Data, const uint32 Size, const uint32 Message)
+{
+	if (Size != 1 + (Message * 37) % 500)
+	{
+		return false;
+	}
+	for (uint32 Offset = 0; Offset < Size; ++Offset)
+	{
+		if (((const uint8*)Data)[Offset] != GetReceiveTestByte(Message, Offset))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSWebSocketReceiveBufferTest, "UROSBridge.WebSocketReceiveBuffer", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Checks that whole frames are passed in place, fragments are put together,
+// and a stream of size prefixed messages is read the same however it is cut into pieces.
+bool FROSWebSocketReceiveBufferTest::RunTest(const FString& Parameters)
+{
+	FROSWebSocketReceiveBuffer Buffer;
+	TArray<uint8> Frame;
+	for (int32 i = 0; i < 1000; ++i)
+	{
+		Frame.Add(GetReceiveTestByte(0, i));
+	}
+
+	int32 NumFrames = 0;
+	const void* FrameData = nullptr;
+	uint32 FrameSize = 0;
+	auto OnFrame = [&](void* Data, uint32 Size)
+	{
+		++NumFrames;
+		FrameData = Data;
+		FrameSize = Size;
+	};
+
+	// A frame in one piece is not copied.
+	Buffer.ReceiveFrame(Frame.GetData(), Frame.Num(), true, OnFrame);
+	TestTrue(TEXT("Whole frame is passed in place"), NumFrames == 1 && FrameData == Frame.GetData() && FrameSize == Frame.Num());
+	TestEqual(TEXT("Nothing is kept of a whole frame"), Buffer.Num(), 0);
+
+	// A frame in pieces is passed once, after the final piece.
+	NumFrames = 0;
+	const int32 Pieces[] = { 0, 1, 300, 699, 1000 };
+	for (int32 Piece = 0; Piece + 1 < ARRAY_COUNT(Pieces); ++Piece)
+	{
+		const bool bIsFinal = Piece + 2 == ARRAY_COUNT(Pieces);
+		Buffer.ReceiveFrame(Frame.GetData() + Pieces[Piece], Pieces[Piece + 1] - Pieces[Piece], bIsFinal, OnFrame);
+		TestEqual(FString::Printf(TEXT("Frames after piece %d"), Piece), NumFrames, bIsFinal ? 1 : 0);
+	}
+	TestTrue(TEXT("Fragmented frame is put together"), FrameSize == Frame.Num() && FMemory::Memcmp(FrameData, Frame.GetData(), Frame.Num()) == 0);
+	TestEqual(TEXT("Nothing is kept after the final piece"), Buffer.Num(), 0);
+
+	// The same stream of messages, cut into pieces of different sizes.
+	TArray<uint8> Stream;
+	GetReceiveTestStream(Stream);
+	for (const int32 PieceSize : { 1, 3, 4, 5, 7, 64, 333, 4096, Stream.Num() })
+	{
+		uint32 NextMessage = 0;
+		uint32 NumInPlace = 0;
+		bool bInOrder = true;
+		for (int32 Offset = 0; Offset < Stream.Num(); Offset += PieceSize)
+		{
+			const uint8* Piece = Stream.GetData() + Offset;
+			const int32 Size = FMath::Min(PieceSize, Stream.Num() - Offset);
+			Buffer.ReceiveSizePrefixed(Piece, Size, [&](void* Data, uint32 MessageSize)
+			{
+				bInOrder &= IsReceiveTestMessage(Data, MessageSize, NextMessage);
+				NumInPlace += (const uint8*)Data >= Piece && (const uint8*)Data + MessageSize <= Piece + Size;
+				++NextMessage;
+			});
+		}
+
+		const FString What = FString::Printf(TEXT("Pieces of %d bytes"), PieceSize);
+		TestTrue(What + TEXT(": messages in order"), bInOrder);
+		TestEqual(What + TEXT(": number of messages"), NextMessage, uint32(RECEIVE_BUFFER_TEST_MESSAGES));
+		TestEqual(What + TEXT(": nothing is kept at the end"), Buffer.Num(), 0);
+		if (PieceSize == Stream.Num())
+		{
+			TestEqual(What + TEXT(": messages passed in place"), NumInPlace, uint32(RECEIVE_BUFFER_TEST_MESSAGES));
+		}
+	}
+
+	// An incomplete message is kept until the rest comes.
+	int32 NumMessages = 0;
+	auto OnMessage = [&NumMessages](void* Data, uint32 Size) { ++NumMessages; };
+	const uint32 SecondMessage = sizeof(uint32) + 1;
+	Buffer.ReceiveSizePrefixed(Stream.GetData(), SecondMessage + 10, OnMessage);
+	TestTrue(TEXT("Incomplete message is kept"), NumMessages == 1 && Buffer.Num() == 10);
+	return true;
+}
+
+// Receive a piece as FROSWebSocket::OnRawRecieve did before the receive buffer: everything is appended,
+// every message is removed from the front of the buffer.
+static void ReceiveSizePrefixedBefore(TArray<uint8>& RecievedBuffer, const uint8* Data, uint32 Size, uint64& Checksum)
+{
+	RecievedBuffer.Append(Data, Size);
+	while (RecievedBuffer.Num() > sizeof(uint32))
+	{
+		uint32 BytesToBeRead = *(uint32*)RecievedBuffer.GetData();
+		if (BytesToBeRead <= ((uint32)RecievedBuffer.Num() - sizeof(uint32)))
+		{
+			Checksum += RecievedBuffer[sizeof(uint32) + BytesToBeRead - 1];
+			RecievedBuffer.RemoveAt(0, sizeof(uint32) + BytesToBeRead);
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSWebSocketReceiveBufferBenchmark, "UROSBridge.Benchmark.WebSocketReceiveBuffer", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Receives large frames in one callback and in pieces, and streams of small size prefixed messages,
+// with the receive buffer and with the code it replaced.
+bool FROSWebSocketReceiveBufferBenchmark::RunTest(const FString& Parameters)
+{
+	uint64 Checksum = 0;
+	auto OnData = [&Checksum](void* Data, uint32 Size) { Checksum += ((const uint8*)Data)[Size - 1]; };
+
+	for (const uint32 FrameSize : { 1024 * 1024, 4 * 1024 * 1024, 10 * 1024 * 1024 })
+	{
+		TArray<uint8> Frame;
+		Frame.SetNumUninitialized(FrameSize);
+		for (uint32 i = 0; i < FrameSize; ++i)
+		{
+			Frame[i] = uint8(i * 13);
+		}
+		const uint32 NumFrames = FMath::Max(RECEIVE_BUFFER_BENCHMARK_BYTES / FrameSize, 8u);
+		const double Bytes = double(NumFrames) * FrameSize;
+
+		// Frames up to rx_buffer_size come in one callback.
+		FROSWebSocketReceiveBuffer Buffer;
+		double Start = FPlatformTime::Seconds();
+		for (uint32 i = 0; i < NumFrames; ++i)
+		{
+			Buffer.ReceiveFrame(Frame.GetData(), FrameSize, true, OnData);
+		}
+		const double WholeSeconds = FPlatformTime::Seconds() - Start;
+
+		// Before, every frame was appended to the buffer and removed again.
+		TArray<uint8> RecievedBuffer;
+		Start = FPlatformTime::Seconds();
+		for (uint32 i = 0; i < NumFrames; ++i)
+		{
+			RecievedBuffer.Append(Frame.GetData(), FrameSize);
+			OnData(RecievedBuffer.GetData(), FrameSize);
+			RecievedBuffer.RemoveAt(0, FrameSize);
+		}
+		const double WholeBeforeSeconds = FPlatformTime::Seconds() - Start;
+
+		// Fragmented frames are put together, before they were passed on piece by piece.
+		Start = FPlatformTime::Seconds();
+		for (uint32 i = 0; i < NumFrames; ++i)
+		{
+			for (uint32 Offset = 0; Offset < FrameSize; Offset += RECEIVE_BUFFER_BENCHMARK_PIECE)
+			{
+				const uint32 Size = FMath::Min((uint32)RECEIVE_BUFFER_BENCHMARK_PIECE, FrameSize - Offset);
+				Buffer.ReceiveFrame(Frame.GetData() + Offset, Size, Offset + Size == FrameSize, OnData);
+			}
+		}
+		const double PiecesSeconds = FPlatformTime::Seconds() - Start;
+
+		AddInfo(FString::Printf(TEXT("%u MB frames: in one callback passed in place in %.0f ns (before copied at %.2f GB/s), in pieces of %d KB put together at %.2f GB/s."),
+			FrameSize >> 20, WholeSeconds / NumFrames * 1e9, Bytes / WholeBeforeSeconds * 1e-9, RECEIVE_BUFFER_BENCHMARK_PIECE >> 10, Bytes / PiecesSeconds * 1e-9));
+
+		// Callbacks of up to this size full of small size prefixed messages.
+		TArray<uint8> Stream;
+		const uint32 MessageSize = RECEIVE_BUFFER_BENCHMARK_MESSAGE;
+		while (Stream.Num() + sizeof(uint32) + MessageSize <= FrameSize)
+		{
+			Stream.Append((const uint8*)&MessageSize, sizeof(uint32));
+			Stream.Append(Frame.GetData(), MessageSize);
+		}
+
+		const uint32 NumStreamPieces = FMath::Max(NumFrames / 4, 2u);
+		Start = FPlatformTime::Seconds();
+		for (uint32 i = 0; i < NumStreamPieces; ++i)
+		{
+			Buffer.ReceiveSizePrefixed(Stream.GetData(), Stream.Num(), OnData);
+		}
+		const double StreamSeconds = FPlatformTime::Seconds() - Start;
+
+		// Before, every message moved the rest of the buffer, so only a few pieces are measured.
+		RecievedBuffer.Reset();
+		const uint32 NumStreamPiecesBefore = 2;
+		Start = FPlatformTime::Seconds();
+		for (uint32 i = 0; i < NumStreamPiecesBefore; ++i)
+		{
+			ReceiveSizePrefixedBefore(RecievedBuffer, Stream.GetData(), Stream.Num(), Checksum);
+		}
+		const double StreamBeforeSeconds = FPlatformTime::Seconds() - Start;
+
+		AddInfo(FString::Printf(TEXT("%u MB of %d byte messages per callback: %.2f GB/s (before %.4f GB/s)."),
+			FrameSize >> 20, RECEIVE_BUFFER_BENCHMARK_MESSAGE, double(NumStreamPieces) * Stream.Num() / StreamSeconds * 1e-9,
+			double(NumStreamPiecesBefore) * Stream.Num() / StreamBeforeSeconds * 1e-9));
+	}
+
+	AddInfo(FString::Printf(TEXT("Checksum %llu."), Checksum));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
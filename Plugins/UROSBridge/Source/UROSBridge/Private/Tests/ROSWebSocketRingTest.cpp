@@ -0,0 +1,317 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeLock.h"
+#include "ROSWebSocketRing.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Headroom of the frames, as LWS_PRE of libwebsockets
+#define WEBSOCKET_RING_TEST_HEADROOM (16)
+#define WEBSOCKET_RING_TEST_PRODUCERS (4)
+#define WEBSOCKET_RING_TEST_FRAMES (20000)
+// Capacity of the ring of FROSWebSocket
+#define WEBSOCKET_RING_BENCHMARK_CAPACITY (8 * 1024 * 1024)
+#define WEBSOCKET_RING_BENCHMARK_BYTES (512 * 1024 * 1024)
+
+// Byte of the payload of a test frame, every byte tells its producer, frame and offset
+static uint8 GetRingTestByte(const uint32 Producer, const uint32 Frame, const uint32 Offset)
+{
+	return uint8(Producer * 31 + Frame * 7 + Offset);
+}
+
+// Size of a test frame, varies so frames end everywhere in the ring
+static uint32 GetRingTestSize(const uint32 Producer, const uint32 Frame)
+{
+	return 8 + (Producer * 13 + Frame * 29) % 300;
+}
+
+/**
+ * Writes test frames into the ring from its own thread, waits while the ring is full.
+ */
+class FROSWebSocketRingTestProducer : public FRunnable
+{
+public:
+	FROSWebSocketRingTestProducer(FROSWebSocketRing& InRing, uint32 InProducer) :
+		Ring(InRing), Producer(InProducer), NumFullRing(0)
+	{
+	}
+
+	virtual uint32 Run() override
+	{
+		for (uint32 Frame = 0; Frame < WEBSOCKET_RING_TEST_FRAMES; ++Frame)
+		{
+			const uint32 Size = GetRingTestSize(Producer, Frame);
+			uint64 Position;
+			uint8* Payload = Ring.BeginWrite(Size, Producer, Position);
+			while (!Payload)
+			{
+				++NumFullRing;
+				FPlatformProcess::Sleep(0.f);
+				Payload = Ring.BeginWrite(Size, Producer, Position);
+			}
+
+			FMemory::Memcpy(Payload, &Frame, sizeof(uint32));
+			for (uint32 Offset = sizeof(uint32); Offset < Size; ++Offset)
+			{
+				Payload[Offset] = GetRingTestByte(Producer, Frame, Offset);
+			}
+			Ring.EndWrite(Position);
+		}
+		return 0;
+	}
+
+	FROSWebSocketRing& Ring;
+	uint32 Producer;
+	uint32 NumFullRing;
+};
+
+// Checks a frame read from the ring against the test frame it should be
+static bool IsRingTestFrame(const uint8* Payload, const uint32 Size, const uint32 Producer, const uint32 Frame)
+{
+	if (Size != GetRingTestSize(Producer, Frame) || FMemory::Memcmp(Payload, &Frame, sizeof(uint32)) != 0)
+	{
+		return false;
+	}
+	for (uint32 Offset = sizeof(uint32); Offset < Size; ++Offset)
+	{
+		if (Payload[Offset] != GetRingTestByte(Producer, Frame, Offset))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSWebSocketRingTest, "UROSBridge.WebSocketRing", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Checks order, headroom, full ring, uncommitted frames and the padding at the end of the ring,
+// then lets several threads write into a small ring while this thread reads.
+bool FROSWebSocketRingTest::RunTest(const FString& Parameters)
+{
+	{
+		FROSWebSocketRing Ring(1024, WEBSOCKET_RING_TEST_HEADROOM);
+		TestTrue(TEXT("New ring is empty"), Ring.IsEmpty());
+		TestFalse(TEXT("New ring has no committed frame"), Ring.HasCommittedFrame());
+
+		uint32 Size, Type;
+		TestTrue(TEXT("Nothing to peek in a new ring"), Ring.Peek(Size, Type) == nullptr);
+
+		// Frames come out in order, with their size and type.
+		for (uint32 Frame = 0; Frame < 3; ++Frame)
+		{
+			uint64 Position;
+			uint8* Payload = Ring.BeginWrite(10 + Frame, Frame, Position);
+			if (!TestTrue(FString::Printf(TEXT("Frame %u is reserved"), Frame), Payload != nullptr))
+			{
+				return false;
+			}
+			FMemory::Memset(Payload, uint8(Frame + 1), 10 + Frame);
+			Ring.EndWrite(Position);
+		}
+		for (uint32 Frame = 0; Frame < 3; ++Frame)
+		{
+			uint8* Payload = Ring.Peek(Size, Type);
+			if (!TestTrue(FString::Printf(TEXT("Frame %u is read"), Frame), Payload != nullptr))
+			{
+				return false;
+			}
+			TestEqual(FString::Printf(TEXT("Size of frame %u"), Frame), Size, 10 + Frame);
+			TestEqual(FString::Printf(TEXT("Type of frame %u"), Frame), Type, Frame);
+			TestTrue(FString::Printf(TEXT("Payload of frame %u"), Frame), Payload[0] == Frame + 1 && Payload[Size - 1] == Frame + 1);
+			// The headroom in front of the payload is free for the websocket header.
+			TestTrue(FString::Printf(TEXT("Headroom of frame %u"), Frame), ((UPTRINT)(Payload - WEBSOCKET_RING_TEST_HEADROOM)) % 16 == 0);
+			Ring.Pop();
+		}
+		TestTrue(TEXT("Ring is empty after reading all frames"), Ring.IsEmpty());
+
+		// A frame larger than the ring never fits, frames that do not fit now wait for the reader.
+		uint64 Position;
+		TestTrue(TEXT("Frame larger than the ring"), Ring.BeginWrite(1024, 0, Position) == nullptr);
+		uint8* First = Ring.BeginWrite(600, 1, Position);
+		const uint64 FirstPosition = Position;
+		TestTrue(TEXT("Frame of half the ring"), First != nullptr);
+		TestTrue(TEXT("Second frame of half the ring while the first is not read"), Ring.BeginWrite(600, 2, Position) == nullptr);
+
+		// A reserved frame that is not committed yet is not read, also not the committed frames after it.
+		uint8* Second = Ring.BeginWrite(100, 2, Position);
+		TestTrue(TEXT("Small frame behind the reserved one"), Second != nullptr);
+		Ring.EndWrite(Position);
+		TestTrue(TEXT("Reserved frame is not read"), Ring.Peek(Size, Type) == nullptr);
+		TestFalse(TEXT("Ring with a reserved frame is not empty"), Ring.IsEmpty());
+		TestFalse(TEXT("Committed frame behind a reserved one is not reported"), Ring.HasCommittedFrame());
+		Ring.EndWrite(FirstPosition);
+		TestTrue(TEXT("Committed frame is reported"), Ring.HasCommittedFrame());
+		TestTrue(TEXT("Committed frame is read"), Ring.Peek(Size, Type) == First && Size == 600 && Type == 1);
+		Ring.Pop();
+		TestTrue(TEXT("Frame behind it is read"), Ring.Peek(Size, Type) == Second && Size == 100 && Type == 2);
+		Ring.Pop();
+
+		// The read position is now in the middle, a frame that does not fit at the end starts at the beginning.
+		uint8* Wrapped = Ring.BeginWrite(600, 3, Position);
+		if (TestTrue(TEXT("Frame behind the padding is reserved"), Wrapped != nullptr))
+		{
+			FMemory::Memset(Wrapped, 0xab, 600);
+			TestFalse(TEXT("Reserved frame behind the padding is not reported"), Ring.HasCommittedFrame());
+			Ring.EndWrite(Position);
+			TestTrue(TEXT("Committed frame behind the padding is reported"), Ring.HasCommittedFrame());
+			uint8* Payload = Ring.Peek(Size, Type);
+			TestTrue(TEXT("Frame behind the padding is read"), Payload == Wrapped && Size == 600 && Type == 3 && Payload[0] == 0xab && Payload[599] == 0xab);
+			TestTrue(TEXT("Frame behind the padding starts at the beginning"), Payload < First);
+			Ring.Pop();
+		}
+		TestTrue(TEXT("Ring is empty after the padding"), Ring.IsEmpty());
+		TestFalse(TEXT("Empty ring has no committed frame"), Ring.HasCommittedFrame());
+	}
+
+	// Many producers and one reader on a ring that wraps every few frames.
+	FROSWebSocketRing Ring(4096, WEBSOCKET_RING_TEST_HEADROOM);
+	TArray<FROSWebSocketRingTestProducer*> Producers;
+	TArray<FRunnableThread*> Threads;
+	for (uint32 Producer = 0; Producer < WEBSOCKET_RING_TEST_PRODUCERS; ++Producer)
+	{
+		Producers.Add(new FROSWebSocketRingTestProducer(Ring, Producer));
+		Threads.Add(FRunnableThread::Create(Producers.Last(), *FString::Printf(TEXT("ROSWebSocketRingTest%u"), Producer), 0, TPri_Normal));
+	}
+
+	uint32 NextFrame[WEBSOCKET_RING_TEST_PRODUCERS] = { 0 };
+	uint32 NumRead = 0;
+	uint32 NumErrors = 0;
+	const double TimeOut = FPlatformTime::Seconds() + 60.0;
+	while (NumRead < WEBSOCKET_RING_TEST_PRODUCERS * WEBSOCKET_RING_TEST_FRAMES && NumErrors < 10 && FPlatformTime::Seconds() < TimeOut)
+	{
+		uint32 Size, Producer;
+		uint8* Payload = Ring.Peek(Size, Producer);
+		if (!Payload)
+		{
+			FPlatformProcess::Sleep(0.f);
+			continue;
+		}
+
+		// The frames of every producer come in the order it wrote them.
+		if (Producer >= WEBSOCKET_RING_TEST_PRODUCERS || !IsRingTestFrame(Payload, Size, Producer, NextFrame[Producer]))
+		{
+			AddError(FString::Printf(TEXT("Frame %u of %u bytes from producer %u is not the expected frame."), NumRead, Size, Producer));
+			++NumErrors;
+		}
+		else
+		{
+			++NextFrame[Producer];
+		}
+		Ring.Pop();
+		++NumRead;
+	}
+
+	uint32 NumFullRing = 0;
+	for (int32 i = 0; i < Threads.Num(); ++i)
+	{
+		Threads[i]->WaitForCompletion();
+		NumFullRing += Producers[i]->NumFullRing;
+		delete Threads[i];
+		delete Producers[i];
+	}
+
+	TestEqual(TEXT("Frames read from all producers"), NumRead, uint32(WEBSOCKET_RING_TEST_PRODUCERS * WEBSOCKET_RING_TEST_FRAMES));
+	TestTrue(TEXT("Ring is empty after all producers"), Ring.IsEmpty());
+	AddInfo(FString::Printf(TEXT("%d producers wrote %d frames, the ring was full %u times."), WEBSOCKET_RING_TEST_PRODUCERS, WEBSOCKET_RING_TEST_PRODUCERS * WEBSOCKET_RING_TEST_FRAMES, NumFullRing));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FROSWebSocketRingBenchmark, "UROSBridge.Benchmark.WebSocketRing", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+// Queues and takes out large frames through the ring of FROSWebSocket and through the locked TArray queue it replaced
+// (a TArray with the headroom per frame, copied into the queue and removed from its front). Sending itself is not measured.
+bool FROSWebSocketRingBenchmark::RunTest(const FString& Parameters)
+{
+	FROSWebSocketRing Ring(WEBSOCKET_RING_BENCHMARK_CAPACITY, WEBSOCKET_RING_TEST_HEADROOM);
+
+	for (const uint32 FrameSize : { 1024 * 1024, 4 * 1024 * 1024, 10 * 1024 * 1024 })
+	{
+		TArray<uint8> Message;
+		Message.SetNumUninitialized(FrameSize);
+		for (uint32 i = 0; i < FrameSize; ++i)
+		{
+			Message[i] = uint8(i * 13);
+		}
+		const uint32 NumFrames = FMath::Max(WEBSOCKET_RING_BENCHMARK_BYTES / FrameSize, 8u);
+		const double Bytes = double(NumFrames) * FrameSize;
+
+		// The writer queues as many frames as fit before the socket thread takes them.
+		uint64 Checksum = 0;
+		uint32 NumRingFrames = 0;
+		double Start = FPlatformTime::Seconds();
+		for (uint32 Frame = 0; Frame < NumFrames;)
+		{
+			uint64 Position;
+			uint8* Payload = Ring.BeginWrite(FrameSize, 0, Position);
+			if (Payload)
+			{
+				FMemory::Memcpy(Payload, Message.GetData(), FrameSize);
+				Ring.EndWrite(Position);
+				++NumRingFrames;
+				++Frame;
+			}
+			uint32 Size, Type;
+			while (!Payload || Frame == NumFrames)
+			{
+				uint8* Queued = Ring.Peek(Size, Type);
+				if (!Queued)
+				{
+					break;
+				}
+				Checksum += Queued[Size - 1];
+				Ring.Pop();
+			}
+			if (!Payload && Ring.IsEmpty())
+			{
+				// Larger than the ring, FROSWebSocket sends it through the overflow queue.
+				++Frame;
+			}
+		}
+		const double RingSeconds = FPlatformTime::Seconds() - Start;
+
+		FCriticalSection CriticalSection;
+		TArray<TArray<uint8>> OutgoingBuffer;
+		Start = FPlatformTime::Seconds();
+		for (uint32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			TArray<uint8> Buffer;
+			Buffer.AddDefaulted(WEBSOCKET_RING_TEST_HEADROOM);
+			Buffer.Append(Message.GetData(), FrameSize);
+			{
+				FScopeLock Lock(&CriticalSection);
+				OutgoingBuffer.Add(Buffer);
+			}
+			if (OutgoingBuffer.Num() * uint64(FrameSize) >= WEBSOCKET_RING_BENCHMARK_CAPACITY || Frame + 1 == NumFrames)
+			{
+				while (OutgoingBuffer.Num() > 0)
+				{
+					Checksum += OutgoingBuffer[0].Last();
+					FScopeLock Lock(&CriticalSection);
+					OutgoingBuffer.RemoveAt(0);
+				}
+			}
+		}
+		const double QueueSeconds = FPlatformTime::Seconds() - Start;
+
+		if (NumRingFrames == 0)
+		{
+			AddInfo(FString::Printf(TEXT("%u MB frames: larger than the %d MB ring, they go through the overflow queue. Locked TArray queue %.2f GB/s (checksum %llu)."),
+				FrameSize >> 20, WEBSOCKET_RING_BENCHMARK_CAPACITY >> 20, Bytes / QueueSeconds * 1e-9, Checksum));
+		}
+		else
+		{
+			AddInfo(FString::Printf(TEXT("%u MB frames: ring %.2f GB/s, locked TArray queue %.2f GB/s (checksum %llu)."),
+				FrameSize >> 20, Bytes / RingSeconds * 1e-9, Bytes / QueueSeconds * 1e-9, Checksum));
+		}
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
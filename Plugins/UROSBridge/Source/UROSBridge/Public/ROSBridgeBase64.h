@@ -0,0 +1,35 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Base64 of the uint8[] arrays of rosbridge (images, point clouds).
+* Unlike FBase64 it encodes straight into the memory of the output string and decodes into the memory of the
+* output array, so a message that is read again and again keeps its buffer. Both use lookup tables, 3 bytes at a time.
+*/
+class UROSBRIDGE_API FROSBridgeBase64
+{
+public:
+	// Length of the text of Length bytes, with padding
+	static int32 GetEncodedLength(int32 Length)
+	{
+		return ((Length + 2) / 3) * 4;
+	}
+
+	// Append the text of the bytes to Out
+	static void Encode(const uint8* Data, int32 Length, FString& Out);
+
+	// Decode the text into Out, false if it is not Base64
+	static bool Decode(const TCHAR* Source, int32 Length, TArray<uint8>& Out);
+
+	// Decode the text into Out, for the bytes of a received json frame
+	static bool Decode(const ANSICHAR* Source, int32 Length, TArray<uint8>& Out);
+
+	// Decode the string into Out
+	static bool Decode(const FString& Source, TArray<uint8>& Out)
+	{
+		return Decode(*Source, Source.Len(), Out);
+	}
+};
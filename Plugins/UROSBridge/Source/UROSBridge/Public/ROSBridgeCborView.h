@@ -0,0 +1,74 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Json.h"
+#include "ROSBridgeJsonView.h"
+
+/**
+* Read-only view on a CBOR item, as received from rosbridge for subscriptions with compression "cbor".
+* Same use as FROSBridgeJsonView: fields are found by walking the bytes, nothing is decoded that is not asked for.
+* uint8[] arrays are byte strings and the other numeric arrays are typed arrays (RFC 8746), both are read as raw bytes.
+* Only definite lengths are supported, which is what rosbridge sends.
+* The view does not own the bytes, it is only valid as long as the received frame.
+*/
+class UROSBRIDGE_API FROSBridgeCborView
+{
+public:
+	// Invalid view
+	FROSBridgeCborView() : Begin(nullptr), End(nullptr)
+	{
+	}
+
+	// View on the item at InBegin, InEnd is the end of the data
+	FROSBridgeCborView(const uint8* InBegin, const uint8* InEnd) : Begin(InBegin), End(InEnd)
+	{
+	}
+
+	// Check if the view points to an item
+	bool IsValid() const
+	{
+		return Begin != nullptr && End > Begin;
+	}
+
+	// Get the value of a field of this map (nested maps are not searched), invalid if not found
+	FROSBridgeCborView GetField(const ANSICHAR* Key) const;
+
+	// Get the elements of this array, false if it is not an array
+	bool GetElements(TArray<FROSBridgeCborView>& OutElements) const;
+
+	// Get the content of a text string, as a json view so strings are compared and hashed like the ones of json messages
+	FROSBridgeJsonView GetString() const;
+
+	// Get a number value, Default if not a number
+	double AsNumber(double Default = 0.0) const;
+
+	// Get a bool value, Default if not a bool
+	bool AsBool(bool Default = false) const;
+
+	// Get the content of a byte string or typed array, false if it is neither
+	bool GetBytes(const uint8*& OutData, int32& OutLength) const;
+
+	// Copy the content of a byte string or typed array, false if it is neither
+	bool GetBytes(TArray<uint8>& OutBytes) const;
+
+	// Describe the item for logs
+	FString ToString() const;
+
+	// Convert the item to a json value, byte strings become Base64 strings like in the json messages of rosbridge
+	TSharedPtr<FJsonValue> ToJsonValue() const;
+
+	// Convert the map to a json object, only for the parts that have no typed parser
+	TSharedPtr<FJsonObject> ToJsonObject() const;
+
+private:
+	// Read the initial byte and argument of the item at Pos, nullptr if it does not fit or has an indefinite length
+	const uint8* ReadHead(const uint8* Pos, uint8& OutMajor, uint8& OutInfo, uint64& OutArgument) const;
+
+	// Skip the item at Pos, nullptr if it does not fit
+	const uint8* SkipItem(const uint8* Pos, int32 Depth = 0) const;
+
+	const uint8* Begin;
+	const uint8* End;
+};
@@ -107,6 +107,14 @@ private:
 	FThreadSafeCounter StopCounter;
 	FROSBridgeHandler* Handler;
 };
+/**
+* FTopicSubscriber: Subscriber with the UTF-8 bytes of its topic, to compare it with the received bytes
+*/
+struct FTopicSubscriber
+{
+	TArray<ANSICHAR> Topic;
+	TSharedPtr<FROSBridgeSubscriber> Subscriber;
+};
 /* End Subclasses */
 
 class UROSBRIDGE_API FROSBridgeHandler
@@ -148,6 +156,9 @@ public:
 	// Publish ROS message to topics
 	void PublishMsg(const FString& Topic, TSharedPtr<FROSBridgeMsg> Msg);
 
+	// Publish a message that is already serialized with FROSBridgeMsg::WritePublish
+	void PublishSerializedMsg(const FString& PublishOp);
+
 	// Call external ROS service
 	void CallService(TSharedPtr<FROSBridgeSrvClient> SrvClient,
 		TSharedPtr<FROSBridgeSrv::SrvRequest> Request,
@@ -171,20 +182,38 @@ private:
 	// When a new message arrives, create a FProcessTask and push it to the QueueTask
 	void OnMessage(void* Data, int32 Length);
 
+	// Same for the binary CBOR messages of subscriptions with compression "cbor"
+	void OnBinaryMessage(void* Data, int32 Length);
+
+	// Handle the service operations, they are parsed to a FJsonObject
+	void OnServiceMessage(const FROSBridgeJsonView& Message);
+
+	// Add a subscriber to the topic map
+	void AddTopicSubscriber(TSharedPtr<FROSBridgeSubscriber> Subscriber);
+
+	// Find the subscriber of the topic, nullptr if not found
+	TSharedPtr<FROSBridgeSubscriber> FindTopicSubscriber(const FROSBridgeJsonView& Topic) const;
+
 	// Call service to send msg
 	void CallServiceImpl(const FString& Name, TSharedPtr<FROSBridgeSrv::SrvRequest> Request, const FString& Id);
 
 	// Stop runnable / thread / client
 	void ThreadCleanup();
 
+	// Wake the communication thread
+	void WakeThread();
+
 	// ROS server ip as string
 	FString Host;
 
 	// ROS server port
 	int32 Port;
 
-	// Communication thread sleep duration
-	float ThreadSleep;
+	// Longest time the communication thread waits for the socket, it is woken earlier by sends and new subscribers/publishers
+	int32 ServiceTimeoutInMs;
+
+	// Time to wait for the connection
+	double ConnectionTimeout;
 
 	// Websocket client
 	TSharedPtr<FROSWebSocket> WSClient;
@@ -202,6 +231,9 @@ private:
 	TArray< TSharedPtr<FROSBridgePublisher> >  ListPublishers;
 	TArray< TSharedPtr<FROSBridgeSrvServer> > ListServiceServers;
 
+	// Subscribers by the hash of their topic, only used by the communication thread
+	TMap< uint32, TArray<FTopicSubscriber> > SubscribersByTopicHash;
+
 	// Messages/services to be processed
 	TQueue< TSharedPtr<FProcessTask> > QueueTask;
 	TArray< TSharedPtr<FServiceTask> > ArrayService;
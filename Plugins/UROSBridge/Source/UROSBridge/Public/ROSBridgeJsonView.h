@@ -0,0 +1,92 @@
+// Copyright 2019, Institute for Artificial Intelligence - University of Bremen
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Json.h"
+
+/**
+* Read-only view on the UTF-8 bytes of a json value, as received from rosbridge.
+* Fields are found by scanning the bytes, no FString and no FJsonObject is created.
+* The view does not own the bytes, it is only valid as long as the received frame.
+*/
+class UROSBRIDGE_API FROSBridgeJsonView
+{
+public:
+	// Invalid view
+	FROSBridgeJsonView() : Begin(nullptr), End(nullptr)
+	{
+	}
+
+	// View on the bytes [InBegin, InEnd)
+	FROSBridgeJsonView(const ANSICHAR* InBegin, const ANSICHAR* InEnd) : Begin(InBegin), End(InEnd)
+	{
+	}
+
+	// Check if the view points to a value
+	bool IsValid() const
+	{
+		return Begin != nullptr && End > Begin;
+	}
+
+	// Number of bytes
+	int32 Len() const
+	{
+		return IsValid() ? (int32)(End - Begin) : 0;
+	}
+
+	// First byte
+	const ANSICHAR* GetData() const
+	{
+		return Begin;
+	}
+
+	// Get the value of a field of this object (nested objects are not searched), invalid if not found
+	FROSBridgeJsonView GetField(const ANSICHAR* Key) const;
+
+	// Get the elements of this array, false if it is not an array
+	bool GetElements(TArray<FROSBridgeJsonView>& OutElements) const;
+
+	// Get the content of a string value without the quotes (escapes are not resolved), invalid if not a string
+	FROSBridgeJsonView GetString() const;
+
+	// Get a number value, Default if not a number
+	double AsNumber(double Default = 0.0) const;
+
+	// Get a bool value, Default if not a bool
+	bool AsBool(bool Default = false) const
+	{
+		return Equals("true") ? true : Equals("false") ? false : Default;
+	}
+
+	// Convert the bytes to a string
+	FString ToString() const;
+
+	// Deserialize the value to a json object, only for the parts that have no typed parser
+	TSharedPtr<FJsonObject> ToJsonObject() const;
+
+	// Compare the bytes with a zero terminated string
+	bool Equals(const ANSICHAR* Str) const;
+
+	// Compare the bytes with other bytes
+	bool Equals(const ANSICHAR* Data, int32 Length) const;
+
+	// Hash of the bytes
+	uint32 GetHash() const
+	{
+		return FCrc::MemCrc32(Begin, Len());
+	}
+
+private:
+	// Skip whitespace, returns End if there is nothing else
+	const ANSICHAR* SkipWhitespace(const ANSICHAR* Pos) const;
+
+	// Skip the string starting at Pos (on the opening quote), nullptr if it is not terminated
+	const ANSICHAR* SkipString(const ANSICHAR* Pos) const;
+
+	// Skip the value starting at Pos, nullptr if it is not terminated
+	const ANSICHAR* SkipValue(const ANSICHAR* Pos) const;
+
+	const ANSICHAR* Begin;
+	const ANSICHAR* End;
+};
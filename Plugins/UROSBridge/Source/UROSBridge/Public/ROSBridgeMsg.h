@@ -6,6 +6,7 @@
 #include "Json.h"
 
 #include "ROSTime.h"
+#include "ROSBridgeCborView.h"
 
 class UROSBRIDGE_API FROSBridgeMsg 
 {
@@ -20,6 +21,20 @@ public:
 
 	virtual void FromJson(TSharedPtr<FJsonObject> JsonObject) { }
 
+	// Read the message straight from the received json bytes, for messages with large arrays that are then decoded in place.
+	// Returns false if not supported, then the message is read with FromJson.
+	virtual bool FromJsonView(const FROSBridgeJsonView& View)
+	{
+		return false;
+	}
+
+	// Read the message from a CBOR map, for messages with large arrays that are then copied as raw bytes.
+	// Returns false if not supported, then the message is read with FromJson.
+	virtual bool FromCbor(const FROSBridgeCborView& View)
+	{
+		return false;
+	}
+
 	virtual TSharedPtr<FJsonObject> ToJsonObject() const 
 	{
 		return MakeShareable<FJsonObject>(new FJsonObject());
@@ -38,6 +53,62 @@ public:
 		return OutputString;
 	}
 
+	// Append the message as json to Out, messages that are published often write it without a FJsonObject
+	virtual void WriteJson(FString& Out) const
+	{
+		Out += ToYamlString();
+	}
+
+	// Append a number as json
+	static FORCEINLINE void WriteJsonNumber(double Value, FString& Out)
+	{
+		// NaN and infinity are not valid json
+		if (Value != Value || Value - Value != 0.0)
+		{
+			Value = 0.0;
+		}
+
+		// Whole numbers (covariances, stamps, sequence numbers) are written without the printf
+		if (FMath::Abs(Value) < 1e15 && Value == (double)(int64)Value)
+		{
+			const int64 Whole = (int64)Value;
+			uint64 Magnitude = Whole < 0 ? 0 - (uint64)Whole : (uint64)Whole;
+			TCHAR Digits[24];
+			TCHAR* const End = Digits + ARRAY_COUNT(Digits);
+			TCHAR* Digit = End;
+			do
+			{
+				*--Digit = TEXT('0') + (TCHAR)(Magnitude % 10);
+				Magnitude /= 10;
+			} while (Magnitude > 0);
+			if (Whole < 0)
+			{
+				*--Digit = TEXT('-');
+			}
+			Out.AppendChars(Digit, (int32)(End - Digit));
+			return;
+		}
+
+		TCHAR Buffer[32];
+		FCString::Snprintf(Buffer, ARRAY_COUNT(Buffer), TEXT("%.17g"), Value);
+		Out += Buffer;
+	}
+
+	// Append a string as json
+	static FORCEINLINE void WriteJsonString(const FString& Value, FString& Out)
+	{
+		Out += TEXT("\"");
+		for (const TCHAR Char : Value)
+		{
+			if (Char == TEXT('"') || Char == TEXT('\\'))
+			{
+				Out += TEXT('\\');
+			}
+			Out += Char;
+		}
+		Out += TEXT("\"");
+	}
+
 	static FORCEINLINE FString Advertise(const FString& InMessageTopic, const FString& InMessageType)
 	{
 		return TEXT("{\"op\": \"advertise\", \"topic\": \"") + InMessageTopic +
@@ -57,6 +128,17 @@ public:
 			   TEXT("}";)
 	}
 
+	// Serialize the publish operation to Out, the memory of Out is reused
+	static FORCEINLINE void WritePublish(const FString& InMessageTopic, const FROSBridgeMsg& Message, FString& Out)
+	{
+		Out.Reset();
+		Out += TEXT("{\"op\": \"publish\", \"topic\": \"");
+		Out += InMessageTopic;
+		Out += TEXT("\", \"msg\": ");
+		Message.WriteJson(Out);
+		Out += TEXT("}");
+	}
+
 	static FORCEINLINE FString Publish(const FString& InMessageTopic, const FString& Message)
 	{
 		return TEXT("{\"op\": \"publish\", \"topic\": \"") + InMessageTopic +
@@ -76,6 +158,18 @@ public:
 			   TEXT("\"}";)
 	}
 
+	// Subscribe with a rosbridge compression, e.g. "cbor", the messages of the topic then come as binary frames
+	static FORCEINLINE FString Subscribe(const FString& InMessageTopic, const FString& InMessageType, const FString& InCompression)
+	{
+		if (InCompression.IsEmpty())
+			return Subscribe(InMessageTopic, InMessageType);
+
+		return TEXT("{\"op\": \"subscribe\", \"topic\": \"") + InMessageTopic +
+			   TEXT("\", \"type\": \"") + InMessageType +
+			   TEXT("\", \"compression\": \"") + InCompression +
+			   TEXT("\"}");
+	}
+
 	static FORCEINLINE FString UnSubscribe(const FString& InMessageTopic)
 	{
 		return TEXT("{\"op\": \"unsubscribe\", \"topic\": \"") + InMessageTopic + TEXT("\"}";)
@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "Json.h"
 #include "ROSBridgeMsg.h"
+#include "ROSBridgeJsonView.h"
+#include "ROSBridgeCborView.h"
 
 class UROSBRIDGE_API FROSBridgeSubscriber 
 {
@@ -12,6 +14,9 @@ protected:
 	FString Topic;
 	FString Type;
 
+	// rosbridge compression of the subscription, empty for json, "cbor" for binary frames
+	FString Compression;
+
 public:
 
 	FROSBridgeSubscriber(FString InTopic, FString InType):
@@ -33,7 +38,32 @@ public:
 		return Topic;
 	}
 
+	virtual FString GetCompression() const
+	{
+		return Compression;
+	}
+
+	// Set before the subscriber is added to the handler
+	void SetCompression(const FString& InCompression)
+	{
+		Compression = InCompression;
+	}
+
 	virtual TSharedPtr<FROSBridgeMsg> ParseMessage(TSharedPtr<FJsonObject> JsonObject) const = 0;
 
+	// Typed parsing straight from the received bytes, without a FJsonObject.
+	// Returns nullptr if not supported, then the message is parsed with ParseMessage.
+	virtual TSharedPtr<FROSBridgeMsg> ParseMessageFromView(const FROSBridgeJsonView& MsgView) const
+	{
+		return nullptr;
+	}
+
+	// Typed parsing of messages subscribed with compression "cbor".
+	// Returns nullptr if not supported, then the message is converted to a FJsonObject and parsed with ParseMessage.
+	virtual TSharedPtr<FROSBridgeMsg> ParseMessageFromCbor(const FROSBridgeCborView& MsgView) const
+	{
+		return nullptr;
+	}
+
 	virtual void Callback(TSharedPtr<FROSBridgeMsg> Msg) = 0;
 };
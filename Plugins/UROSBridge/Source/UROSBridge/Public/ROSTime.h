@@ -22,14 +22,25 @@ public:
 		NSecs = NowTime.NSecs;
 	}
 
-	static FROSTime Now() 
+	// Wall clock, or the simulated time if one is set.
+	static FROSTime Now();
+
+	// Converts seconds to a time.
+	static FROSTime FromSeconds(double InSeconds)
 	{
-		FDateTime NowDateTime = FDateTime::UtcNow();
-		uint32 Secs = (uint32)NowDateTime.ToUnixTimestamp();
-		uint32 NSecs = (uint32)NowDateTime.GetMillisecond() * 1000000;
-		return FROSTime(Secs, NSecs);
+		const double WholeSecs = FMath::FloorToDouble(InSeconds);
+		return FROSTime((uint32)WholeSecs, (uint32)FMath::Min((InSeconds - WholeSecs) * 1e9, 999999999.0));
 	}
 
+	// Lets Now() return a simulated time instead of the wall clock, e.g. in a headless run with fixed steps.
+	static void SetSimulatedTime(double InSeconds);
+
+	// Lets Now() return the wall clock again.
+	static void ClearSimulatedTime();
+
+	// Checks if Now() returns a simulated time.
+	static bool IsSimulatedTime();
+
 	static FROSTime GetFromJson(TSharedPtr<FJsonObject> JsonObject) 
 	{
 		uint32 Secs = (uint32)(JsonObject->GetNumberField("secs"));
@@ -73,6 +73,15 @@ namespace geometry_msgs
 			return Object;
 		}
 
+		virtual void WriteJson(FString& Out) const override
+		{
+			Out += TEXT("{\"position\": ");
+			Position.WriteJson(Out);
+			Out += TEXT(", \"orientation\": ");
+			Orientation.WriteJson(Out);
+			Out += TEXT("}");
+		}
+
 		virtual FString ToYamlString() const override 
 		{
 			FString OutputString;
@@ -88,6 +88,19 @@ namespace geometry_msgs
 			return Object;
 		}
 
+		virtual void WriteJson(FString& Out) const override
+		{
+			Out += TEXT("{\"pose\": ");
+			Pose.WriteJson(Out);
+			Out += TEXT(", \"covariance\": [");
+			for (int32 i = 0; i < Covariance.Num(); i++)
+			{
+				if (i > 0) Out += TEXT(", ");
+				WriteJsonNumber(Covariance[i], Out);
+			}
+			Out += TEXT("]}");
+		}
+
 		virtual FString ToYamlString() const override 
 		{
 			FString OutputString;
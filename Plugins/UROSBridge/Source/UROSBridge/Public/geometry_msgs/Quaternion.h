@@ -126,6 +126,19 @@ namespace geometry_msgs
 			return Object;
 		}
 
+		virtual void WriteJson(FString& Out) const override
+		{
+			Out += TEXT("{\"x\": ");
+			WriteJsonNumber(X, Out);
+			Out += TEXT(", \"y\": ");
+			WriteJsonNumber(Y, Out);
+			Out += TEXT(", \"z\": ");
+			WriteJsonNumber(Z, Out);
+			Out += TEXT(", \"w\": ");
+			WriteJsonNumber(W, Out);
+			Out += TEXT("}");
+		}
+
 		virtual FString ToYamlString() const override 
 		{
 			FString OutputString;
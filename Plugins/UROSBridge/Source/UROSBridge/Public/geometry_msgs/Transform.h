@@ -75,6 +75,15 @@ namespace geometry_msgs
 			return Object;
 		}
 
+		virtual void WriteJson(FString& Out) const override
+		{
+			Out += TEXT("{\"translation\": ");
+			Translation.WriteJson(Out);
+			Out += TEXT(", \"rotation\": ");
+			Rotation.WriteJson(Out);
+			Out += TEXT("}");
+		}
+
 		virtual FString ToYamlString() const override 
 		{
 			FString OutputString;
@@ -91,6 +91,17 @@ namespace geometry_msgs
 			return Object;
 		}
 
+		virtual void WriteJson(FString& Out) const override
+		{
+			Out += TEXT("{\"header\": ");
+			Header.WriteJson(Out);
+			Out += TEXT(", \"child_frame_id\": ");
+			WriteJsonString(ChildFrameId, Out);
+			Out += TEXT(", \"transform\": ");
+			Transform.WriteJson(Out);
+			Out += TEXT("}");
+		}
+
 		virtual FString ToYamlString() const override 
 		{
 			FString OutputString;
@@ -72,6 +72,15 @@ namespace geometry_msgs
 			return Object;
 		}
 
+		virtual void WriteJson(FString& Out) const override
+		{
+			Out += TEXT("{\"linear\": ");
+			Linear.WriteJson(Out);
+			Out += TEXT(", \"angular\": ");
+			Angular.WriteJson(Out);
+			Out += TEXT("}");
+		}
+
 		virtual FString ToYamlString() const override 
 		{
 			FString OutputString;
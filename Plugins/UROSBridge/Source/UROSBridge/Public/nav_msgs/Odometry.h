@@ -91,6 +91,19 @@ namespace nav_msgs
 			return Object;
 		}
 
+		virtual void WriteJson(FString& Out) const override
+		{
+			Out += TEXT("{\"header\": ");
+			Header.WriteJson(Out);
+			Out += TEXT(", \"child_frame_id\": ");
+			WriteJsonString(ChildFrameId, Out);
+			Out += TEXT(", \"pose\": ");
+			Pose.WriteJson(Out);
+			Out += TEXT(", \"twist\": ");
+			Twist.WriteJson(Out);
+			Out += TEXT("}");
+		}
+
 		virtual FString ToYamlString() const override
 		{
 			FString OutputString;
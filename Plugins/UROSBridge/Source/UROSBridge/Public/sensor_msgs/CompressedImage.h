@@ -1,9 +1,7 @@
 #pragma once
 #include "ROSBridgeMsg.h"
 #include "std_msgs/Header.h"
-#include "Base64.h"
-#include <iostream>
-#include <chrono>  // for high_resolution_clock
+#include "ROSBridgeBase64.h"
 
 namespace sensor_msgs
 {
@@ -43,7 +41,7 @@ namespace sensor_msgs
 			return Format;
 		}
 
-		TArray<uint8> GetData() const
+		const TArray<uint8>& GetData() const
 		{
 			return Data;
 		}
@@ -63,12 +61,29 @@ namespace sensor_msgs
 			Data = InData;
 		}
 
+		void SetData(TArray<uint8>&& InData)
+		{
+			Data = MoveTemp(InData);
+		}
+
 		virtual void FromJson(TSharedPtr<FJsonObject> JsonObject) override
 		{
 			Header = std_msgs::Header::GetFromJson(JsonObject->GetObjectField(TEXT("header")));
 			Format = JsonObject->GetStringField(TEXT("format"));
-			Data.Empty();
-			FBase64::Decode(JsonObject->GetStringField(TEXT("data")), Data);
+			FROSBridgeBase64::Decode(JsonObject->GetStringField(TEXT("data")), Data);
+		}
+
+		// The data is decoded from the received bytes into the memory of Data
+		virtual bool FromJsonView(const FROSBridgeJsonView& View) override
+		{
+			const FROSBridgeJsonView DataView = View.GetField("data").GetString();
+			return ReadFields(View) && DataView.GetData() && FROSBridgeBase64::Decode(DataView.GetData(), DataView.Len(), Data);
+		}
+
+		// The data is a byte string, copied without Base64
+		virtual bool FromCbor(const FROSBridgeCborView& View) override
+		{
+			return ReadFields(View) && View.GetField("data").GetBytes(Data);
 		}
 
 		static CompressedImage GetFromJson(TSharedPtr<FJsonObject> JsonObject)
@@ -95,53 +110,48 @@ namespace sensor_msgs
 		{
 			TSharedPtr<FJsonObject> Object = MakeShareable<FJsonObject>(new FJsonObject());
 
-			TArray<TSharedPtr<FJsonValue>> DataArray;
-			for (auto &datum : Data)
-			{
-				TSharedPtr<FJsonValue> Ptr = MakeShareable(new FJsonValueNumber(datum));
-				DataArray.Add(Ptr);
-			}
+			FString DataString;
+			FROSBridgeBase64::Encode(Data.GetData(), Data.Num(), DataString);
 
 			Object->SetObjectField(TEXT("header"), Header.ToJsonObject());
 			Object->SetStringField(TEXT("format"), Format);
-			Object->SetStringField(TEXT("data"), *(FBase64::Encode(Data)));
+			Object->SetStringField(TEXT("data"), DataString);
 
 			return Object;
 		}
 
-		virtual FString ToYamlString() const override
+		virtual void WriteJson(FString& Out) const override
 		{
-			// Record start time
-			auto start = std::chrono::high_resolution_clock::now();
+			Out.Reserve(Out.Len() + FROSBridgeBase64::GetEncodedLength(Data.Num()) + 256);
+			Out += TEXT("{\"header\": ");
+			Header.WriteJson(Out);
+			Out += TEXT(", \"format\": ");
+			WriteJsonString(Format, Out);
+			Out += TEXT(", \"data\": \"");
+			FROSBridgeBase64::Encode(Data.GetData(), Data.Num(), Out);
+			Out += TEXT("\"}");
+		}
 
+		virtual FString ToYamlString() const override
+		{
+			// Written without a FJsonObject, the Base64 of the data goes straight into the string
 			FString OutputString;
-			TSharedRef< TJsonWriter<> > Writer = TJsonWriterFactory<>::Create(&OutputString);
-
-			// Record end time
-			auto finish = std::chrono::high_resolution_clock::now();
-			std::chrono::duration<double> elapsed = finish - start;
-			UE_LOG(LogUnrealCV, Error, TEXT("TJsonWriterFactory<>::Create(&OutputString) elapsed time: %fs"), elapsed.count());
-
-			// Record start time
-			start = std::chrono::high_resolution_clock::now();
-
-			auto test = ToJsonObject().ToSharedRef();
-
-			// Record end time
-			finish = std::chrono::high_resolution_clock::now();
-			elapsed = finish - start;
-			UE_LOG(LogUnrealCV, Error, TEXT("ToJsonObject().ToSharedRef() elapsed time: %fs"), elapsed.count());
-
-			// Record start time
-			start = std::chrono::high_resolution_clock::now();
+			WriteJson(OutputString);
+			return OutputString;
+		}
 
-			FJsonSerializer::Serialize(test, Writer);
+	private:
 
-			// Record end time
-			finish = std::chrono::high_resolution_clock::now();
-			elapsed = finish - start;
-			UE_LOG(LogUnrealCV, Error, TEXT("FJsonSerializer::Serialize(test, Writer) elapsed time: %fs"), elapsed.count());
-			return OutputString;
+		// Read everything but the data from a json or CBOR view
+		template<typename ViewType>
+		bool ReadFields(const ViewType& View)
+		{
+			if (!Header.FromView(View.GetField("header")))
+			{
+				return false;
+			}
+			Format = View.GetField("format").GetString().ToString();
+			return true;
 		}
 	};
 } // namespace sensor_msgs#pragma once
@@ -1,7 +1,7 @@
 #pragma once
 #include "ROSBridgeMsg.h"
 #include "std_msgs/Header.h"
-#include "Base64.h"
+#include "ROSBridgeBase64.h"
 
 namespace sensor_msgs
 {
@@ -71,7 +71,7 @@ namespace sensor_msgs
 			return Step;
 		}
 
-		TArray<uint8> GetData() const
+		const TArray<uint8>& GetData() const
 		{
 			return Data;
 		}
@@ -111,6 +111,11 @@ namespace sensor_msgs
 			Data = InData;
 		}
 
+		void SetData(TArray<uint8>&& InData)
+		{
+			Data = MoveTemp(InData);
+		}
+
 		virtual void FromJson(TSharedPtr<FJsonObject> JsonObject) override
 		{
 			Header = std_msgs::Header::GetFromJson(JsonObject->GetObjectField(TEXT("header")));
@@ -119,8 +124,20 @@ namespace sensor_msgs
 			Encoding = JsonObject->GetStringField(TEXT("encoding"));
 			IsBigEndian = JsonObject->GetNumberField(TEXT("is_bigendian"));
 			Step = JsonObject->GetNumberField(TEXT("step"));
-			Data.Empty();
-			FBase64::Decode(JsonObject->GetStringField(TEXT("data")), Data);
+			FROSBridgeBase64::Decode(JsonObject->GetStringField(TEXT("data")), Data);
+		}
+
+		// The data is decoded from the received bytes into the memory of Data
+		virtual bool FromJsonView(const FROSBridgeJsonView& View) override
+		{
+			const FROSBridgeJsonView DataView = View.GetField("data").GetString();
+			return ReadFields(View) && DataView.GetData() && FROSBridgeBase64::Decode(DataView.GetData(), DataView.Len(), Data);
+		}
+
+		// The data is a byte string, copied without Base64
+		virtual bool FromCbor(const FROSBridgeCborView& View) override
+		{
+			return ReadFields(View) && View.GetField("data").GetBytes(Data);
 		}
 
 		static Image GetFromJson(TSharedPtr<FJsonObject> JsonObject)
@@ -151,12 +168,8 @@ namespace sensor_msgs
 		{
 			TSharedPtr<FJsonObject> Object = MakeShareable<FJsonObject>(new FJsonObject());
 
-			TArray<TSharedPtr<FJsonValue>> DataArray;
-			for (auto &datum : Data)
-			{
-				TSharedPtr<FJsonValue> Ptr = MakeShareable(new FJsonValueNumber(datum));
-				DataArray.Add(Ptr);
-			}
+			FString DataString;
+			FROSBridgeBase64::Encode(Data.GetData(), Data.Num(), DataString);
 
 			Object->SetObjectField(TEXT("header"), Header.ToJsonObject());
 			Object->SetNumberField(TEXT("height"), Height);
@@ -164,17 +177,55 @@ namespace sensor_msgs
 			Object->SetStringField(TEXT("encoding"), Encoding);
 			Object->SetNumberField(TEXT("is_bigendian"), IsBigEndian);
 			Object->SetNumberField(TEXT("step"), Step);
-			Object->SetStringField(TEXT("data"), *(FBase64::Encode(Data)));
+			Object->SetStringField(TEXT("data"), DataString);
 
 			return Object;
 		}
 
+		virtual void WriteJson(FString& Out) const override
+		{
+			Out.Reserve(Out.Len() + FROSBridgeBase64::GetEncodedLength(Data.Num()) + 256);
+			Out += TEXT("{\"header\": ");
+			Header.WriteJson(Out);
+			Out += TEXT(", \"height\": ");
+			WriteJsonNumber(Height, Out);
+			Out += TEXT(", \"width\": ");
+			WriteJsonNumber(Width, Out);
+			Out += TEXT(", \"encoding\": ");
+			WriteJsonString(Encoding, Out);
+			Out += TEXT(", \"is_bigendian\": ");
+			WriteJsonNumber(IsBigEndian, Out);
+			Out += TEXT(", \"step\": ");
+			WriteJsonNumber(Step, Out);
+			Out += TEXT(", \"data\": \"");
+			FROSBridgeBase64::Encode(Data.GetData(), Data.Num(), Out);
+			Out += TEXT("\"}");
+		}
+
 		virtual FString ToYamlString() const override
 		{
+			// Written without a FJsonObject, the Base64 of the data goes straight into the string
 			FString OutputString;
-			TSharedRef< TJsonWriter<> > Writer = TJsonWriterFactory<>::Create(&OutputString);
-			FJsonSerializer::Serialize(ToJsonObject().ToSharedRef(), Writer);
+			WriteJson(OutputString);
 			return OutputString;
 		}
+
+	private:
+
+		// Read everything but the data from a json or CBOR view
+		template<typename ViewType>
+		bool ReadFields(const ViewType& View)
+		{
+			if (!Header.FromView(View.GetField("header")))
+			{
+				return false;
+			}
+			Height = View.GetField("height").AsNumber();
+			Width = View.GetField("width").AsNumber();
+			Encoding = View.GetField("encoding").GetString().ToString();
+			IsBigEndian = View.GetField("is_bigendian").AsNumber();
+			Step = View.GetField("step").AsNumber();
+			return true;
+		}
 	};
 } // namespace sensor_msgs
\ No newline at end of file
@@ -42,6 +42,12 @@ namespace sensor_msgs
 			return Header;
 		}
 
+		// Header that is changed in place by publishers that reuse the message
+		std_msgs::Header& GetHeaderRef()
+		{
+			return Header;
+		}
+
 		TArray<FString> GetName() const 
 		{
 			return Names;
@@ -172,6 +178,32 @@ namespace sensor_msgs
 			return Object;
 		}
 
+		virtual void WriteJson(FString& Out) const override
+		{
+			Out += TEXT("{\"header\": ");
+			Header.WriteJson(Out);
+
+			Out += TEXT(", \"name\": [");
+			for (int32 i = 0; i < Names.Num(); i++)
+			{
+				if (i > 0) Out += TEXT(", ");
+				WriteJsonString(Names[i], Out);
+			}
+
+			const TArray<double>* const Values[] = { &Positions, &Velocities, &Efforts };
+			const TCHAR* const Keys[] = { TEXT("], \"position\": ["), TEXT("], \"velocity\": ["), TEXT("], \"effort\": [") };
+			for (int32 k = 0; k < 3; k++)
+			{
+				Out += Keys[k];
+				for (int32 i = 0; i < Values[k]->Num(); i++)
+				{
+					if (i > 0) Out += TEXT(", ");
+					WriteJsonNumber((*Values[k])[i], Out);
+				}
+			}
+			Out += TEXT("]}");
+		}
+
 		virtual FString ToYamlString() const override 
 		{
 			FString OutputString;
@@ -3,7 +3,7 @@
 
 #include "std_msgs/Header.h"
 #include "sensor_msgs/PointField.h"
-#include "Base64.h"
+#include "ROSBridgeBase64.h"
 
 namespace sensor_msgs
 {
@@ -62,7 +62,7 @@ namespace sensor_msgs
 			return Width;
 		}
 
-		TArray<sensor_msgs::PointField> GetFields() const 
+		const TArray<sensor_msgs::PointField>& GetFields() const 
 		{
 			return Fields;
 		}
@@ -82,7 +82,7 @@ namespace sensor_msgs
 			return RowStep; 
 		}
 
-		TArray<uint8> GetData() const 
+		const TArray<uint8>& GetData() const 
 		{
 			return Data; 
 		}
@@ -132,6 +132,11 @@ namespace sensor_msgs
 			Data = InData; 
 		}
 
+		void SetData(TArray<uint8>&& InData)
+		{
+			Data = MoveTemp(InData);
+		}
+
 		void SetIsDense(bool bInIsDense) 
 		{
 			bIsDense = bInIsDense; 
@@ -149,11 +154,23 @@ namespace sensor_msgs
 			bIsBigEndian = JsonObject->GetBoolField(TEXT("is_bigendian"));
 			PointStep = JsonObject->GetNumberField(TEXT("point_step"));
 			RowStep = JsonObject->GetNumberField(TEXT("row_step"));
-			Data.Empty();
-			FBase64::Decode(JsonObject->GetStringField(TEXT("data")), Data);
+			FROSBridgeBase64::Decode(JsonObject->GetStringField(TEXT("data")), Data);
 			bIsDense = JsonObject->GetBoolField(TEXT("is_dense"));
 		}
 
+		// The data is decoded from the received bytes into the memory of Data
+		virtual bool FromJsonView(const FROSBridgeJsonView& View) override
+		{
+			const FROSBridgeJsonView DataView = View.GetField("data").GetString();
+			return ReadFields(View) && DataView.GetData() && FROSBridgeBase64::Decode(DataView.GetData(), DataView.Len(), Data);
+		}
+
+		// The data is a byte string, copied without Base64
+		virtual bool FromCbor(const FROSBridgeCborView& View) override
+		{
+			return ReadFields(View) && View.GetField("data").GetBytes(Data);
+		}
+
 		static PointCloud2 GetFromJson(TSharedPtr<FJsonObject> JsonObject)
 		{
 			PointCloud2 Result;
@@ -196,12 +213,8 @@ namespace sensor_msgs
 				FieldsPtrArray.Add(Ptr);
 			}
 
-			TArray<TSharedPtr<FJsonValue>> DataArray;
-			for (auto &datum : Data)
-			{
-				TSharedPtr<FJsonValue> Ptr = MakeShareable(new FJsonValueNumber(datum));
-				DataArray.Add(Ptr);
-			}
+			FString DataString;
+			FROSBridgeBase64::Encode(Data.GetData(), Data.Num(), DataString);
 
 			Object->SetObjectField(TEXT("header"), Header.ToJsonObject());
 			Object->SetNumberField(TEXT("height"), Height);
@@ -210,18 +223,71 @@ namespace sensor_msgs
 			Object->SetBoolField(TEXT("is_bigendian"), bIsBigEndian);
 			Object->SetNumberField(TEXT("point_step"), PointStep);
 			Object->SetNumberField(TEXT("row_step"), RowStep);
-			Object->SetStringField(TEXT("data"), *(FBase64::Encode(Data)));
+			Object->SetStringField(TEXT("data"), DataString);
 			Object->SetBoolField(TEXT("is_dense"), bIsDense);
 
 			return Object;
 		}
 
-		virtual FString ToYamlString() const override 
+		virtual void WriteJson(FString& Out) const override
+		{
+			Out.Reserve(Out.Len() + FROSBridgeBase64::GetEncodedLength(Data.Num()) + 256 + 64 * Fields.Num());
+			Out += TEXT("{\"header\": ");
+			Header.WriteJson(Out);
+			Out += TEXT(", \"height\": ");
+			WriteJsonNumber(Height, Out);
+			Out += TEXT(", \"width\": ");
+			WriteJsonNumber(Width, Out);
+			Out += TEXT(", \"fields\": [");
+			for (int32 i = 0; i < Fields.Num(); i++)
+			{
+				if (i > 0) Out += TEXT(", ");
+				Fields[i].WriteJson(Out);
+			}
+			Out += bIsBigEndian ? TEXT("], \"is_bigendian\": true") : TEXT("], \"is_bigendian\": false");
+			Out += TEXT(", \"point_step\": ");
+			WriteJsonNumber(PointStep, Out);
+			Out += TEXT(", \"row_step\": ");
+			WriteJsonNumber(RowStep, Out);
+			Out += TEXT(", \"data\": \"");
+			FROSBridgeBase64::Encode(Data.GetData(), Data.Num(), Out);
+			Out += bIsDense ? TEXT("\", \"is_dense\": true}") : TEXT("\", \"is_dense\": false}");
+		}
+
+		virtual FString ToYamlString() const override
 		{
+			// Written without a FJsonObject, the Base64 of the data goes straight into the string
 			FString OutputString;
-			TSharedRef< TJsonWriter<> > Writer = TJsonWriterFactory<>::Create(&OutputString);
-			FJsonSerializer::Serialize(ToJsonObject().ToSharedRef(), Writer);
+			WriteJson(OutputString);
 			return OutputString;
 		}
+
+	private:
+
+		// Read everything but the data from a json or CBOR view
+		template<typename ViewType>
+		bool ReadFields(const ViewType& View)
+		{
+			TArray<ViewType> FieldViews;
+			if (!Header.FromView(View.GetField("header")) || !View.GetField("fields").GetElements(FieldViews))
+			{
+				return false;
+			}
+			Height = View.GetField("height").AsNumber();
+			Width = View.GetField("width").AsNumber();
+			Fields.SetNum(FieldViews.Num());
+			for (int32 i = 0; i < FieldViews.Num(); i++)
+			{
+				if (!Fields[i].FromView(FieldViews[i]))
+				{
+					return false;
+				}
+			}
+			bIsBigEndian = View.GetField("is_bigendian").AsBool();
+			PointStep = View.GetField("point_step").AsNumber();
+			RowStep = View.GetField("row_step").AsNumber();
+			bIsDense = View.GetField("is_dense").AsBool();
+			return true;
+		}
 	};
 } // namespace sensor_msgs
\ No newline at end of file
@@ -145,6 +145,30 @@ namespace sensor_msgs
 				TEXT(" } ");
 		}
 
+		// Read from a json or CBOR view, both have the same accessors
+		template<typename ViewType>
+		bool FromView(const ViewType& View)
+		{
+			Name = View.GetField("name").GetString().ToString();
+			Offset = View.GetField("offset").AsNumber();
+			Datatype = (EDatatype)((uint8)View.GetField("datatype").AsNumber());
+			Count = View.GetField("count").AsNumber();
+			return View.IsValid();
+		}
+
+		virtual void WriteJson(FString& Out) const override
+		{
+			Out += TEXT("{\"name\": ");
+			WriteJsonString(Name, Out);
+			Out += TEXT(", \"offset\": ");
+			WriteJsonNumber(Offset, Out);
+			Out += TEXT(", \"datatype\": ");
+			WriteJsonNumber(Datatype, Out);
+			Out += TEXT(", \"count\": ");
+			WriteJsonNumber(Count, Out);
+			Out += TEXT("}");
+		}
+
 		virtual TSharedPtr<FJsonObject> ToJsonObject() const override 
 		{
 			TSharedPtr<FJsonObject> Object = MakeShareable<FJsonObject>(new FJsonObject());
@@ -65,6 +65,27 @@ namespace std_msgs
 			FrameId = JsonObject->GetStringField(TEXT("frame_id"));
 		}
 
+		// Read from a json or CBOR view, both have the same accessors
+		template<typename ViewType>
+		bool FromView(const ViewType& View)
+		{
+			const ViewType StampView = View.GetField("stamp");
+			Seq = (uint32)View.GetField("seq").AsNumber();
+			Stamp = FROSTime((uint32)StampView.GetField("secs").AsNumber(), (uint32)StampView.GetField("nsecs").AsNumber());
+			FrameId = View.GetField("frame_id").GetString().ToString();
+			return View.IsValid();
+		}
+
+		virtual bool FromJsonView(const FROSBridgeJsonView& View) override
+		{
+			return FromView(View);
+		}
+
+		virtual bool FromCbor(const FROSBridgeCborView& View) override
+		{
+			return FromView(View);
+		}
+
 		static Header GetFromJson(TSharedPtr<FJsonObject> JsonObject)
 		{
 			Header Result;
@@ -88,6 +109,19 @@ namespace std_msgs
 			return Object;
 		}
 
+		virtual void WriteJson(FString& Out) const override
+		{
+			Out += TEXT("{\"seq\": ");
+			WriteJsonNumber(Seq, Out);
+			Out += TEXT(", \"stamp\": {\"secs\": ");
+			WriteJsonNumber(Stamp.Secs, Out);
+			Out += TEXT(", \"nsecs\": ");
+			WriteJsonNumber(Stamp.NSecs, Out);
+			Out += TEXT("}, \"frame_id\": ");
+			WriteJsonString(FrameId, Out);
+			Out += TEXT("}");
+		}
+
 		virtual FString ToYamlString() const override 
 		{
 			FString OutputString;
@@ -96,6 +96,17 @@ namespace tf2_msgs
 			return Object;
 		}
 
+		virtual void WriteJson(FString& Out) const override
+		{
+			Out += TEXT("{\"transforms\": [");
+			for (int32 i = 0; i < Transforms.Num(); i++)
+			{
+				if (i > 0) Out += TEXT(", ");
+				Transforms[i].WriteJson(Out);
+			}
+			Out += TEXT("]}");
+		}
+
 		virtual FString ToYamlString() const override 
 		{
 			FString OutputString;
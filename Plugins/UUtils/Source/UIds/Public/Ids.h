@@ -6,6 +6,7 @@
 #include "EngineMinimal.h"
 #include "Misc/Guid.h"
 #include "Misc/Base64.h"
+#include "Misc/SecureHash.h"
 #include "Ids.generated.h"
 
 /**
@@ -34,6 +35,27 @@ struct UIDS_API FIds
 		return GuidToBase64(NewGuid);
 	}
 
+	// Creates a GUID from a name, the same name always gives the same GUID (MD5 of the name)
+	static FGuid NameToGuid(const FString& InName)
+	{
+		const FTCHARToUTF8 Utf8Name(*InName);
+		uint8 Digest[16];
+		FMD5 Md5;
+		Md5.Update((const uint8*)Utf8Name.Get(), Utf8Name.Length());
+		Md5.Final(Digest);
+		return FGuid(
+			((uint32)Digest[0] << 24) | ((uint32)Digest[1] << 16) | ((uint32)Digest[2] << 8) | Digest[3],
+			((uint32)Digest[4] << 24) | ((uint32)Digest[5] << 16) | ((uint32)Digest[6] << 8) | Digest[7],
+			((uint32)Digest[8] << 24) | ((uint32)Digest[9] << 16) | ((uint32)Digest[10] << 8) | Digest[11],
+			((uint32)Digest[12] << 24) | ((uint32)Digest[13] << 16) | ((uint32)Digest[14] << 8) | Digest[15]);
+	}
+
+	// Creates a GUID from a name and encodes it to Base64Url
+	static FString NameToGuidInBase64Url(const FString& InName)
+	{
+		return GuidToBase64Url(NameToGuid(InName));
+	}
+
 	// Encodes GUID to Base64
 	static FString GuidToBase64Url(FGuid InGuid)
 	{